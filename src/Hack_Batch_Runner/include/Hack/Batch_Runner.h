@@ -0,0 +1,129 @@
+/**
+ * @file    Batch_Runner.h
+ * @author  William Weston
+ * @brief   Runs many Hack programs across all cores and reports their final state
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A task is a program, an instruction budget, words of RAM to set before it runs and ranges of
+ *    RAM to report after.  run() loads each distinct program once into a Shared_ROM and then runs
+ *    the tasks on a Scheduler, a quantum of instructions at a time, so that workers whose tasks end
+ *    early steal the pending and suspended tasks of the others, see Scheduler.h.  Computers are
+ *    reused from task to task, a task costs a reset and its run.  Results are stored by task index.
+ *
+ *    A manifest is text, a header line and then one task per line.  Blank lines and lines that
+ *    start with # are skipped, and program paths are relative to the manifest:
+ *
+ *       hack-batch 1
+ *       <program.asm | program.hack> <max instructions> [<address>=<value> ...] [<first>:<last> ...]
+ *
+ *    A result file has one line per task, in the order of the tasks:
+ *
+ *       hack-batch-results 1
+ *       <task> <stop reason> <instructions> [<first>:<last> <word> ...] ...
+ *       <task> error <message>
+ */
+#ifndef HACK_EMULATOR_2026_10_16_BATCH_RUNNER_H
+#define HACK_EMULATOR_2026_10_16_BATCH_RUNNER_H
+
+#include "Hack/Computer.h"    // for Computer
+#include "Hack/Scheduler.h"   // for Scheduler
+
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint16_t, uint64_t
+#include <filesystem>         // for path
+#include <iosfwd>             // for istream, ostream
+#include <optional>           // for optional
+#include <span>               // for span
+#include <string>             // for string
+#include <string_view>        // for string_view
+#include <vector>             // for vector
+
+namespace Hack
+{
+
+class Batch_Runner final
+{
+public:
+   using word_t      = std::uint16_t;
+   using Stop_Reason = Computer::Stop_Reason;
+
+   struct Range
+   {
+      word_t first;
+      word_t last;         // inclusive
+
+      friend constexpr auto operator==( Range const&, Range const& ) -> bool = default;
+   };
+
+   struct Assignment
+   {
+      word_t address;
+      word_t value;
+
+      friend constexpr auto operator==( Assignment const&, Assignment const& ) -> bool = default;
+   };
+
+   struct Task
+   {
+      std::filesystem::path   program;            // .asm or .hack
+      std::uint64_t           max_instructions;
+      std::vector<Assignment> ram{};              // set after the reset, before the run
+      std::vector<Range>      report{};           // RAM words to report when the run stops
+   };
+
+   struct Result
+   {
+      std::optional<Stop_Reason>    reason{};        // std::nullopt if the task could not run, see error
+      std::uint64_t                 instructions{ 0 };
+      std::vector<word_t>           ram{};           // the words of Task::report, range after range
+      std::string                   error{};
+      Scheduler::Machine_Statistics statistics{};    // how the task was scheduled
+   };
+
+   struct Options
+   {
+      unsigned                             threads;      // 0 for one per core
+      Computer::Engine                     engine;
+      std::optional<std::filesystem::path> cache;        // a ROM_Cache directory to load programs through
+      std::uint64_t                        quantum{ Scheduler::default_quantum };
+      std::size_t                          resident{ Scheduler::default_resident };
+   };
+
+   // one thread per core, Engine::Tiered and no ROM cache
+   Batch_Runner();
+   explicit Batch_Runner( Options options );
+
+   // run every task, the result of each is at its index, std::runtime_error if the cache directory cannot be created
+   auto run( std::span<Task const> tasks ) const -> std::vector<Result>;
+
+   // and report how busy the workers were
+   auto run( std::span<Task const> tasks, Scheduler::Statistics& statistics ) const -> std::vector<Result>;
+
+   // the worker threads run() starts
+   auto threads() const noexcept -> unsigned;
+
+   // the tasks of a manifest, std::runtime_error naming the line of the first error
+   static auto load_manifest( std::filesystem::path const& path ) -> std::vector<Task>;
+   static auto read_manifest( std::istream& input, std::filesystem::path const& directory ) -> std::vector<Task>;
+
+   // write the results of tasks to a result file, std::runtime_error if it cannot be written
+   static auto save_results( std::filesystem::path const& path, std::span<Task const> tasks, std::span<Result const> results ) -> void;
+   static auto write_results( std::ostream& output, std::span<Task const> tasks, std::span<Result const> results ) -> void;
+
+   // one line of Result::statistics for each task, times in microseconds:
+   //    <task> <slices> <migrations> <run time> <started> <finished>
+   static auto write_statistics( std::ostream& output, std::span<Result const> results ) -> void;
+
+   // the name of reason in a result file, e.g. "halted"
+   static auto name( Stop_Reason reason ) noexcept -> std::string_view;
+
+private:
+   Options options_;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_BATCH_RUNNER_H
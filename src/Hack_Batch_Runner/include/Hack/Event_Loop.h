@@ -0,0 +1,250 @@
+/**
+ * @file    Event_Loop.h
+ * @author  William Weston
+ * @brief   Hosts many interactive Hack machines on one thread as coroutines
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A session is a coroutine, a Task, that the loop resumes for one slice at a time.  host()
+ *    starts the usual one: it runs a Computer for a slice, then awaits its next slice, or a key
+ *    press when the program is waiting for the keyboard to change, and ends when the program
+ *    halts or faults.  A session waiting for a key costs nothing until press() gives it one, so a
+ *    thread can keep hundreds of them, one per user, where each mostly waits for its user.
+ *
+ *    The ready sessions are run in batches of resident, each session of a batch running up to
+ *    rounds slices in turn before the batch goes to the back of the queue.  The RAM of a batch
+ *    stays in cache from one slice to the next, and computers that share a Shared_ROM share its
+ *    decode table.  A session woken by a key goes to the front, so that it answers its user within
+ *    a batch.
+ *
+ *    Sessions of one's own are written with the awaitables:
+ *
+ *       auto session( Hack::Computer& computer ) -> Hack::Event_Loop::Task
+ *       {
+ *          while ( true )
+ *          {
+ *             if ( auto const key = co_await Hack::Event_Loop::take_key() )  ...
+ *             co_await Hack::Event_Loop::next_slice();
+ *             co_await Hack::Event_Loop::key_press();
+ *          }
+ *       }
+ *
+ *    The loop and its sessions belong to one thread.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_EVENT_LOOP_H
+#define HACK_EMULATOR_2026_10_16_EVENT_LOOP_H
+
+#include "Hack/Computer.h"    // for Computer
+
+#include <chrono>             // for microseconds, steady_clock
+#include <coroutine>          // for coroutine_handle, suspend_always
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint8_t, uint64_t
+#include <deque>              // for deque
+#include <exception>          // for exception_ptr
+#include <optional>           // for optional
+#include <vector>             // for vector
+
+namespace Hack
+{
+
+class Event_Loop final
+{
+public:
+   using Clock   = std::chrono::steady_clock;
+   using Session = std::size_t;
+   using word_t  = Computer::word_t;
+
+   // instructions in a slice of host(), a slice also ends after slice_time
+   static constexpr std::uint64_t default_quantum    = 1u << 18;
+   static constexpr auto          default_slice_time = std::chrono::microseconds( 1'000 );
+
+   // sessions run together in a batch, and the slices each runs before the next batch
+   static constexpr std::size_t   default_resident   = 8;
+   static constexpr std::size_t   default_rounds     = 4;
+
+   struct Options
+   {
+      std::uint64_t             quantum;
+      std::chrono::microseconds slice_time;
+      std::size_t               resident;
+      std::size_t               rounds;
+   };
+
+   enum class State : std::uint8_t
+   {
+      Ready,            // will run in a slice
+      Waiting,          // for a key, see key_press()
+      Finished          // its coroutine has returned or thrown, see result()
+   };
+
+   struct Session_Statistics
+   {
+      std::uint64_t slices{ 0 };        // times it was resumed
+      std::uint64_t waits{ 0 };         // times it waited for a key
+   };
+
+   class Task;
+   class Key_Press;
+   class Take_Key;
+
+   Event_Loop();
+   explicit Event_Loop( Options options );
+   ~Event_Loop();
+
+   Event_Loop( Event_Loop const& )                    = delete;
+   Event_Loop( Event_Loop&& )                         = delete;
+   auto operator=( Event_Loop const& ) -> Event_Loop& = delete;
+   auto operator=( Event_Loop&& )      -> Event_Loop& = delete;
+
+   // run computer from its state until it halts, faults or stops at a breakpoint, computer must outlive the session
+   auto host( Computer& computer ) -> Session;
+
+   // run task, which starts in its first slice
+   auto spawn( Task task ) -> Session;
+
+   // press key for session, 0 releases it, waking session if it waits for a key
+   auto press( Session session, word_t key ) -> void;
+
+   // run slices until no session is ready, or until deadline, returns whether any still is
+   auto run() -> void;
+   auto run( Clock::time_point deadline ) -> bool;
+
+   // destroy the coroutine of session and free its number for reuse, not from a session of this loop
+   auto remove( Session session ) -> void;
+
+   auto state( Session session )      const -> State;
+   auto statistics( Session session ) const -> Session_Statistics const&;
+
+   // how session ended, nullopt until it has, rethrows what it threw
+   auto result( Session session )     const -> std::optional<Computer::Run_Result>;
+
+   // sessions that will run in a slice, and sessions not removed
+   auto ready()    const noexcept -> std::size_t;
+   auto sessions() const noexcept -> std::size_t;
+
+   // suspend a task until its next slice
+   static constexpr auto next_slice() noexcept -> std::suspend_always;
+
+   // suspend a task until a key is pressed or released for it, unless one has since take_key() last took it
+   static constexpr auto key_press()  noexcept -> Key_Press;
+
+   // the key pressed or released for a task since this last took it, without suspending it
+   static constexpr auto take_key()   noexcept -> Take_Key;
+
+private:
+   struct Slot
+   {
+      std::coroutine_handle<>             handle{};       // nullptr once finished
+      State                               state{ State::Ready };
+      bool                                used{ false };
+      bool                                queued{ false };   // in ready_ or the running batch
+      bool                                key_pending{ false };
+      word_t                              key{ 0 };
+      Session_Statistics                  statistics{};
+      std::optional<Computer::Run_Result> result{};
+      std::exception_ptr                  error{};
+   };
+
+   Options              options_;
+   std::vector<Slot>    slots_{};
+   std::vector<Session> free_{};       // slots of removed sessions
+   std::deque<Session>  ready_{};
+   std::vector<Session> batch_{};
+   std::size_t          sessions_{ 0 };
+
+   auto machine( Computer& computer ) -> Task;
+   auto resume( Session session )     -> void;
+   auto slot( Session session )       -> Slot&;
+   auto slot( Session session ) const -> Slot const&;
+};
+
+
+// the coroutine of a session, its co_return ends the session
+class Event_Loop::Task final
+{
+public:
+   struct promise_type
+   {
+      Event_Loop* loop{ nullptr };     // set by spawn()
+      Session     session{ 0 };
+
+      auto get_return_object() noexcept -> Task;
+
+      static constexpr auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+      static constexpr auto final_suspend()   noexcept -> std::suspend_always { return {}; }
+
+      auto return_value( Computer::Run_Result result ) noexcept -> void;
+      auto unhandled_exception() noexcept -> void;
+   };
+
+   using Handle = std::coroutine_handle<promise_type>;
+
+   Task( Task&& other ) noexcept;
+   ~Task();
+
+   Task( Task const& )                    = delete;
+   auto operator=( Task const& ) -> Task& = delete;
+   auto operator=( Task&& )      -> Task& = delete;
+
+private:
+   friend class Event_Loop;
+
+   Handle handle_;     // nullptr once spawned
+
+   explicit Task( Handle handle ) noexcept;
+};
+
+
+class Event_Loop::Key_Press final
+{
+public:
+   static constexpr auto await_ready() noexcept -> bool { return false; }
+
+   auto await_suspend( Task::Handle task ) const noexcept -> bool;
+
+   static constexpr auto await_resume() noexcept -> void {}
+};
+
+
+class Event_Loop::Take_Key final
+{
+public:
+   static constexpr auto await_ready() noexcept -> bool { return false; }
+
+   auto await_suspend( Task::Handle task ) noexcept -> bool;
+   auto await_resume() const noexcept -> std::optional<word_t>;
+
+private:
+   std::optional<word_t> key_{};
+};
+
+}  // namespace Hack
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+constexpr auto
+Hack::Event_Loop::next_slice() noexcept -> std::suspend_always
+{
+   return {};
+}
+
+
+constexpr auto
+Hack::Event_Loop::key_press() noexcept -> Key_Press
+{
+   return {};
+}
+
+
+constexpr auto
+Hack::Event_Loop::take_key() noexcept -> Take_Key
+{
+   return {};
+}
+
+#endif      // HACK_EMULATOR_2026_10_16_EVENT_LOOP_H
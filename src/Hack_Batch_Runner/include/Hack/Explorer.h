@@ -0,0 +1,124 @@
+/**
+ * @file    Explorer.h
+ * @author  William Weston
+ * @brief   Explores every run of a keyboard driven Hack program over an alphabet of keys
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A program's runs branch where it reads the keyboard, an instruction reading M with A holding
+ *    KBD.  The Explorer stops a run before each such read, and follows it once for each key of the
+ *    alphabet, so that every sequence of keys the program can read is covered, a key per read.
+ *    Between reads a run is deterministic.
+ *
+ *    The state at a read is RAM below the keyboard, A, D and pc, and is hashed to 128 bits.  Only
+ *    the hashes of the states seen are kept, a state whose hash has been seen is not explored
+ *    again, so loops that wait for a key end once they come round to the same state.  The states
+ *    still to be explored are kept as the runs of RAM words that differ from the computer's RAM at
+ *    the start, with the registers and the keys that led to them.
+ *
+ *    The states are explored breadth-first, a key per level, by worker threads that each restore a
+ *    state into a computer forked from the one explored and run it to its next read.  A run that
+ *    stops for any other reason than a halt, a read or its budget is a finding: a watchpoint or
+ *    breakpoint of the computer, or a fault, with the keys that reproduce it.  e.g. to prove that
+ *    a program never writes the keyboard, nor RAM it must leave alone, here the words from 0x3000 up
+ *    to the screen:
+ *
+ *       computer.add_watchpoint( Hack::Memory::keyboard_address, Hack::Memory::keyboard_address );
+ *       computer.add_watchpoint( 0x3000, Hack::Computer::screen_start_address - 1 );
+ *
+ *       auto const report = Hack::Explorer( { { 0, 'a', 'b' }, 0 } ).explore( computer );
+ *
+ *    where report.complete and no findings is the proof.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_EXPLORER_H
+#define HACK_EMULATOR_2026_10_16_EXPLORER_H
+
+#include "Hack/Computer.h"    // for Computer
+
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint32_t, uint64_t
+#include <optional>           // for optional
+#include <vector>             // for vector
+
+namespace Hack
+{
+
+class Explorer final
+{
+public:
+   using word_t = Computer::word_t;
+
+   static constexpr std::size_t   default_max_states   = 1u << 22;
+   static constexpr std::size_t   default_max_depth    = 1'024;      // keys on a path
+   static constexpr std::uint64_t default_step_budget  = 1u << 20;   // instructions from one read to the next
+   static constexpr std::size_t   default_max_findings = 64;
+
+   struct Options
+   {
+      std::vector<word_t> alphabet;                                // the keys a read may return, 0 for none
+      unsigned            threads;                                 // 0 for one per core
+      std::size_t         max_states{ default_max_states };
+      std::size_t         max_depth{ default_max_depth };
+      std::uint64_t       step_budget{ default_step_budget };
+      std::size_t         max_findings{ default_max_findings };
+   };
+
+   struct Hash
+   {
+      std::uint64_t low;
+      std::uint64_t high;
+
+      friend constexpr auto operator==( Hash const&, Hash const& ) -> bool = default;
+   };
+
+   // a run that stopped at a watchpoint, a breakpoint or a fault
+   struct Finding
+   {
+      Computer::Stop_Reason              reason;
+      word_t                             pc;              // where it stopped
+      std::optional<Computer::Watch_Hit> watch_hit;       // of a Stop_Reason::Watchpoint
+      std::vector<word_t>                keys;            // the keys read, in order, that lead to it
+   };
+
+   struct Statistics
+   {
+      std::uint64_t states{ 0 };               // distinct states at reads
+      std::uint64_t transitions{ 0 };          // runs from a state to the next read or the end
+      std::uint64_t duplicates{ 0 };           // runs that reached a state already seen
+      std::uint64_t halted{ 0 };               // runs that reached a halt loop
+      std::uint64_t truncated{ 0 };            // runs and states not followed, for a limit of Options
+      std::uint64_t findings{ 0 };             // including those past max_findings
+      std::uint64_t instructions{ 0 };
+      std::uint64_t depth{ 0 };                // the longest path explored, in keys
+      std::uint64_t peak_frontier_words{ 0 };  // the most words of RAM held at once for states to explore
+   };
+
+   struct Report
+   {
+      Statistics           statistics{};
+      std::vector<Finding> findings{};         // by the number of keys, then the keys
+      bool                 complete{ false };  // every run ended in a halt, a finding or a state seen
+   };
+
+   explicit Explorer( Options options );
+
+   // explore the runs of computer from its state, it is forked and does not run itself
+   auto explore( Computer& computer ) const -> Report;
+
+   // of RAM below the keyboard, A, D and pc
+   static auto hash( Computer const& computer ) noexcept -> Hash;
+
+   // is pc at an instruction that reads the keyboard
+   static auto at_keyboard_read( Computer const& computer ) -> bool;
+
+   auto threads() const noexcept -> unsigned;
+
+private:
+   Options options_;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_EXPLORER_H
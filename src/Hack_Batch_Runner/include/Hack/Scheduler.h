@@ -0,0 +1,110 @@
+/**
+ * @file    Scheduler.h
+ * @author  William Weston
+ * @brief   Runs many Hack machines in quanta on worker threads that steal work from each other
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Batches mix programs that halt after a few thousand instructions with programs that run for
+ *    billions.  The Scheduler runs each machine, a job and the Computer it runs on, a quantum of
+ *    instructions at a time, so that no machine holds a worker for longer than a quantum.
+ *
+ *    Each worker owns a deque of pending jobs, dealt out in contiguous runs when the batch starts,
+ *    and a deque of its suspended machines.  A worker resumes its suspended machines in turn, and
+ *    starts a pending job whenever fewer than resident of them are waiting, so long machines share
+ *    it with short ones without every job holding a Computer at once.  A worker with nothing left
+ *    steals from the others: the last pending job of one that has some, otherwise the suspended
+ *    machine that has waited longest, and when there is none sleeps until a machine is suspended
+ *    or the batch ends.  A machine that finishes gives its Computer back to the worker that ran it,
+ *    which reuses it for the next job it starts.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_SCHEDULER_H
+#define HACK_EMULATOR_2026_10_16_SCHEDULER_H
+
+#include "Hack/Computer.h"    // for Computer
+
+#include <chrono>             // for nanoseconds, steady_clock
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint32_t, uint64_t
+#include <exception>          // for exception_ptr
+#include <functional>         // for function
+#include <vector>             // for vector
+
+namespace Hack
+{
+
+class Scheduler final
+{
+public:
+   using Clock = std::chrono::steady_clock;
+
+   // instructions a machine runs before it is suspended, about a millisecond
+   static constexpr std::uint64_t default_quantum  = 1u << 20;
+
+   // suspended machines a worker keeps before it starts no more pending jobs
+   static constexpr std::size_t   default_resident = 2;
+
+   struct Options
+   {
+      unsigned      threads;                        // 0 for one per core
+      std::uint64_t quantum{ default_quantum };
+      std::size_t   resident{ default_resident };
+   };
+
+   // how a machine was treated, all times from the start of the batch
+   struct Machine_Statistics
+   {
+      std::uint32_t            slices{ 0 };           // quanta it ran
+      std::uint32_t            migrations{ 0 };       // slices run by another worker than the one before
+      std::chrono::nanoseconds run_time{};            // spent running its slices
+      std::chrono::nanoseconds started{};             // when its first slice began
+      std::chrono::nanoseconds finished{};            // when its last slice ended
+   };
+
+   struct Worker_Statistics
+   {
+      std::chrono::nanoseconds busy{};                // spent running slices
+      std::chrono::nanoseconds idle{};                // spent looking for work and waiting for it
+      std::uint64_t            slices{ 0 };
+      std::uint64_t            steals{ 0 };           // jobs and machines taken from other workers
+   };
+
+   struct Statistics
+   {
+      std::chrono::nanoseconds       wall{};
+      std::vector<Worker_Statistics> workers{};
+
+      // the share of wall time the workers spent running slices, from 0 to 1
+      auto utilisation() const noexcept -> double;
+   };
+
+   struct Outcome
+   {
+      Computer::Run_Result result;                    // the reason of its last slice, the instructions of all of them
+      std::exception_ptr   error;                     // thrown by start or by a slice, result then counts the slices before it
+      Machine_Statistics   statistics;
+   };
+
+   // prepare computer for job and return its budget, computer may have run another job before
+   using Start  = std::function<std::uint64_t( std::size_t job, Computer& computer )>;
+
+   // collect the results of job from computer, which is reused once it returns
+   using Finish = std::function<void( std::size_t job, Computer& computer, Outcome const& outcome )>;
+
+   explicit Scheduler( Options options );
+
+   // run jobs [0, jobs) to the end, finish is called once for each, on the worker that ends it
+   auto run( std::size_t jobs, Start const& start, Finish const& finish ) const -> Statistics;
+
+   // the worker threads run() starts, the calling thread among them
+   auto threads() const noexcept -> unsigned;
+
+private:
+   Options options_;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_SCHEDULER_H
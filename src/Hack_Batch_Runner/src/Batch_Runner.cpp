@@ -0,0 +1,528 @@
+/**
+ * @file    Batch_Runner.cpp
+ * @author  William Weston
+ * @brief   Runs many Hack programs across all cores and reports their final state
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Batch_Runner.h"
+
+#include "Hack/ROM_Cache.h"                 // for ROM_Cache
+#include "Hack/Shared_ROM.h"                // for Shared_ROM
+#include "Hack/Utilities/exceptions.hpp"    // for file_error, parse_error, FileErrorData
+
+#include <algorithm>        // for max, min
+#include <atomic>           // for atomic, memory_order_relaxed
+#include <charconv>         // for from_chars
+#include <chrono>           // for duration_cast, microseconds
+#include <cstddef>          // for size_t
+#include <exception>        // for exception, exception_ptr, rethrow_exception
+#include <fstream>          // for ifstream, ofstream
+#include <istream>          // for istream
+#include <map>              // for map
+#include <memory>           // for make_shared, shared_ptr
+#include <ostream>          // for ostream
+#include <sstream>          // for istringstream, ostringstream
+#include <stdexcept>        // for runtime_error
+#include <thread>           // for jthread, thread
+#include <utility>          // for move
+
+
+namespace
+{
+   using word_t = Hack::Batch_Runner::word_t;
+
+   constexpr auto manifest_header   = "hack-batch 1";
+   constexpr auto results_header    = "hack-batch-results 1";
+   constexpr auto statistics_header = "hack-batch-statistics 1";
+
+   auto bad_manifest( std::size_t line_no ) -> std::runtime_error
+   {
+      return std::runtime_error( "Not a batch manifest, line " + std::to_string( line_no ) );
+   }
+
+   template <typename Integer>
+   auto parse( std::string_view text ) -> std::optional<Integer>
+   {
+      auto       value  = Integer{};
+      auto const* last  = text.data() + text.size();
+      auto const result = std::from_chars( text.data(), last, value );
+
+      if ( result.ec != std::errc() || result.ptr != last )
+      {
+         return std::nullopt;
+      }
+
+      return value;
+   }
+
+   // a RAM address
+   auto parse_address( std::string_view text ) -> std::optional<word_t>
+   {
+      auto const value = parse<unsigned>( text );
+
+      if ( !value || *value >= Hack::Memory::address_space )
+      {
+         return std::nullopt;
+      }
+
+      return static_cast<word_t>( *value );
+   }
+
+   // a word, -32768 to 65535, as a program would write it
+   auto parse_word( std::string_view text ) -> std::optional<word_t>
+   {
+      auto const value = parse<int>( text );
+
+      if ( !value || *value < -32'768 || *value > 65'535 )
+      {
+         return std::nullopt;
+      }
+
+      return static_cast<word_t>( *value );
+   }
+
+   // the ROM of a .asm or .hack file
+   auto load_program( std::filesystem::path const& program, std::optional<Hack::ROM_Cache>& cache ) -> std::shared_ptr<Hack::Shared_ROM>
+   {
+      if ( cache )
+      {
+         auto const image = cache->open( program );
+
+         return std::make_shared<Hack::Shared_ROM>( image.rom(), image.decoded() );
+      }
+
+      auto const format = Hack::ROM_Cache::format_of( program );
+      auto       input  = std::ifstream( program, std::ios::binary );
+
+      if ( !( input && input.is_open() ) )
+      {
+         throw Hack::Utils::file_error( "Could not open file", Hack::Utils::FileErrorData{ program.string() } );
+      }
+
+      auto source = std::ostringstream();
+
+      source << input.rdbuf();
+
+      return std::make_shared<Hack::Shared_ROM>( Hack::ROM_Cache::build( source.view(), format ) );
+   }
+
+   // the error a task reports for thrown
+   auto describe_error( std::exception_ptr const& thrown ) -> std::string
+   {
+      try
+      {
+         std::rethrow_exception( thrown );
+      }
+      catch ( Hack::Utils::parse_error const& error )
+      {
+         return error.what() + " at line " + std::to_string( error.data().line_no ) + ": " + error.data().text;
+      }
+      catch ( Hack::Utils::file_error const& error )
+      {
+         return error.what() + " " + error.data().filename;
+      }
+      catch ( std::exception const& error )
+      {
+         return error.what();
+      }
+   }
+
+   /**
+    * @brief   Run indices [0, count) on up to threads threads, the calling thread among them
+    *
+    * @param make_worker   called once on each thread for the function it calls with each index it
+    *                      takes, which must not throw
+    *
+    *    Indices are taken one at a time, so a thread that draws a slow program does not hold up
+    *    the others.
+    */
+   template <typename Make_Worker>
+   auto share( unsigned threads, std::size_t count, Make_Worker const& make_worker ) -> void
+   {
+      auto next = std::atomic<std::size_t>{ 0 };
+
+      auto const body = [&next, count, &make_worker]
+      {
+         auto work = make_worker();
+
+         for ( auto index = next.fetch_add( 1, std::memory_order_relaxed ); index < count;
+                    index = next.fetch_add( 1, std::memory_order_relaxed ) )
+         {
+            work( index );
+         }
+      };
+
+      auto       pool    = std::vector<std::jthread>();
+      auto const helpers = std::min<std::size_t>( threads, count ) - ( count > 0 ? 1 : 0 );
+
+      pool.reserve( helpers );
+
+      for ( auto thread = 0uz; thread != helpers; ++thread )
+      {
+         pool.emplace_back( body );
+      }
+
+      if ( count > 0 )
+      {
+         body();
+      }
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Batch_Runner::Batch_Runner()
+   : Batch_Runner( Options{ 0, Computer::Engine::Tiered, std::nullopt } )
+{}
+
+
+Hack::Batch_Runner::Batch_Runner( Options options )
+   : options_( std::move( options ) )
+{}
+
+
+/**
+ * @brief   Run every task
+ *
+ * @param tasks                  the programs to run with their budgets and RAM
+ * @return std::vector<Result>   the result of each task at its index
+ *
+ *    A task whose program cannot be read or assembled, or whose run throws, reports the error and
+ *    the others still run.  Computers flag rather than throw on a pc outside of ROM or an M access
+ *    outside of RAM, those tasks stop with Stop_Reason::PC_Out_Of_ROM or Memory_Out_Of_Range.
+ * @throws std::runtime_error if the ROM cache directory cannot be created
+ */
+auto
+Hack::Batch_Runner::run( std::span<Task const> tasks ) const -> std::vector<Result>
+{
+   auto statistics = Scheduler::Statistics();
+
+   return run( tasks, statistics );
+}
+
+
+/**
+ * @brief   Run every task and report how busy the workers were
+ *
+ * @param tasks        the programs to run with their budgets and RAM
+ * @param statistics   set to the statistics of the Scheduler that ran the tasks
+ * @return std::vector<Result>   the result of each task at its index
+ */
+auto
+Hack::Batch_Runner::run( std::span<Task const> tasks, Scheduler::Statistics& statistics ) const -> std::vector<Result>
+{
+   // each program is loaded once, however many tasks run it
+   auto programs   = std::vector<std::filesystem::path const*>();
+   auto program_of = std::vector<std::size_t>( tasks.size() );
+
+   {
+      auto index = std::map<std::filesystem::path, std::size_t>();
+
+      for ( auto task = 0uz; task != tasks.size(); ++task )
+      {
+         auto const [found, added] = index.try_emplace( tasks[task].program, programs.size() );
+
+         if ( added )
+         {
+            programs.push_back( &tasks[task].program );
+         }
+
+         program_of[task] = found->second;
+      }
+   }
+
+   auto roms   = std::vector<std::shared_ptr<Shared_ROM>>( programs.size() );
+   auto errors = std::vector<std::string>( programs.size() );
+
+   // created on the calling thread, a directory that cannot be created throws here rather than on
+   // a worker, and each worker loads through a copy that keeps its own statistics
+   auto const cache = options_.cache ? std::optional<ROM_Cache>( std::in_place, *options_.cache ) : std::nullopt;
+
+   share( threads(), programs.size(), [&programs, &roms, &errors, &cache]
+   {
+      return [&programs, &roms, &errors, cache = cache]( std::size_t index ) mutable
+      {
+         try
+         {
+            roms[index] = load_program( *programs[index], cache );
+         }
+         catch ( ... )
+         {
+            errors[index] = describe_error( std::current_exception() );
+         }
+      };
+   } );
+
+   auto results   = std::vector<Result>( tasks.size() );
+   auto scheduler = Scheduler( Scheduler::Options{ threads(), options_.quantum, options_.resident } );
+
+   auto const start = [this, tasks, &program_of, &roms, &errors]( std::size_t index, Computer& computer ) -> std::uint64_t
+   {
+      auto const& task = tasks[index];
+      auto const  rom  = roms[program_of[index]];
+
+      if ( !rom )
+      {
+         throw std::runtime_error( errors[program_of[index]] );
+      }
+
+      computer.set_engine( options_.engine );
+      computer.set_bounds_check( Computer::Bounds_Check::Flagging );
+      computer.load_rom( rom );
+      computer.reset();
+
+      for ( auto const& [address, value] : task.ram )
+      {
+         computer.RAM()[address] = value;
+      }
+
+      return task.max_instructions;
+   };
+
+   auto const finish = [tasks, &results]( std::size_t index, Computer& computer, Scheduler::Outcome const& outcome )
+   {
+      auto& result = results[index];
+
+      result.statistics = outcome.statistics;
+
+      if ( outcome.error )
+      {
+         result.error = describe_error( outcome.error );
+         return;
+      }
+
+      result.reason       = outcome.result.reason;
+      result.instructions = outcome.result.executed;
+
+      for ( auto const& [first, last] : tasks[index].report )
+      {
+         for ( auto address = std::size_t{ first }; address <= last; ++address )
+         {
+            result.ram.push_back( computer.RAM()[address] );
+         }
+      }
+   };
+
+   statistics = scheduler.run( tasks.size(), start, finish );
+
+   return results;
+}
+
+
+auto
+Hack::Batch_Runner::threads() const noexcept -> unsigned
+{
+   return options_.threads != 0 ? options_.threads : std::max( std::thread::hardware_concurrency(), 1u );
+}
+
+
+/**
+ * @brief   Read a manifest file
+ *
+ * @param path                 the manifest, program paths in it are relative to its directory
+ * @return std::vector<Task>   its tasks in order
+ * @throws std::runtime_error if path cannot be read or is not a manifest
+ */
+auto
+Hack::Batch_Runner::load_manifest( std::filesystem::path const& path ) -> std::vector<Task>
+{
+   auto input = std::ifstream( path );
+
+   if ( !input.is_open() )
+   {
+      throw std::runtime_error( "Could not read batch manifest " + path.string() );
+   }
+
+   try
+   {
+      return read_manifest( input, path.parent_path() );
+   }
+   catch ( std::runtime_error const& error )
+   {
+      throw std::runtime_error( path.string() + ": " + error.what() );
+   }
+}
+
+
+/**
+ * @brief   Read the tasks of a manifest
+ *
+ * @param input       the text of the manifest, see Batch_Runner.h
+ * @param directory   relative program paths are taken from here
+ * @return std::vector<Task>   its tasks in order
+ * @throws std::runtime_error naming the first line that is not a task
+ */
+auto
+Hack::Batch_Runner::read_manifest( std::istream& input, std::filesystem::path const& directory ) -> std::vector<Task>
+{
+   auto line  = std::string();
+   auto tasks = std::vector<Task>();
+
+   if ( !std::getline( input, line ) || line != manifest_header )
+   {
+      throw bad_manifest( 1 );
+   }
+
+   for ( auto line_no = 2uz; std::getline( input, line ); ++line_no )
+   {
+      auto fields  = std::istringstream( line );
+      auto program = std::string();
+      auto budget  = std::string();
+
+      if ( !( fields >> program ) || program.starts_with( '#' ) )
+      {
+         continue;
+      }
+
+      auto const max_instructions = ( fields >> budget ) ? parse<std::uint64_t>( budget ) : std::nullopt;
+
+      if ( !max_instructions )
+      {
+         throw bad_manifest( line_no );
+      }
+
+      auto task = Task{ directory / program, *max_instructions };
+
+      for ( auto field = std::string(); fields >> field; )
+      {
+         auto const view = std::string_view( field );
+
+         if ( auto const equals = view.find( '=' ); equals != std::string_view::npos )
+         {
+            auto const address = parse_address( view.substr( 0, equals ) );
+            auto const value   = parse_word( view.substr( equals + 1 ) );
+
+            if ( !address || !value )
+            {
+               throw bad_manifest( line_no );
+            }
+
+            task.ram.push_back( Assignment{ *address, *value } );
+         }
+         else if ( auto const colon = view.find( ':' ); colon != std::string_view::npos )
+         {
+            auto const first = parse_address( view.substr( 0, colon ) );
+            auto const last  = parse_address( view.substr( colon + 1 ) );
+
+            if ( !first || !last || *first > *last )
+            {
+               throw bad_manifest( line_no );
+            }
+
+            task.report.push_back( Range{ *first, *last } );
+         }
+         else
+         {
+            throw bad_manifest( line_no );
+         }
+      }
+
+      tasks.push_back( std::move( task ) );
+   }
+
+   return tasks;
+}
+
+
+auto
+Hack::Batch_Runner::save_results( std::filesystem::path const& path, std::span<Task const> tasks, std::span<Result const> results ) -> void
+{
+   auto file = std::ofstream( path, std::ios::trunc );
+
+   write_results( file, tasks, results );
+   file.close();
+
+   if ( !file )
+   {
+      throw std::runtime_error( "Could not write batch results " + path.string() );
+   }
+}
+
+
+/**
+ * @brief   Write the results of run( tasks ) in the result file format, see Batch_Runner.h
+ *
+ * @param output    where to write them
+ * @param tasks     for the ranges each result reports
+ * @param results   as run() returned them
+ */
+auto
+Hack::Batch_Runner::write_results( std::ostream& output, std::span<Task const> tasks, std::span<Result const> results ) -> void
+{
+   output << results_header << '\n';
+
+   for ( auto index = 0uz; index != results.size(); ++index )
+   {
+      auto const& result = results[index];
+
+      output << index;
+
+      if ( !result.reason )
+      {
+         output << " error " << result.error << '\n';
+         continue;
+      }
+
+      output << ' ' << name( *result.reason ) << ' ' << result.instructions;
+
+      auto word = result.ram.begin();
+
+      for ( auto const& [first, last] : tasks[index].report )
+      {
+         output << ' ' << first << ':' << last;
+
+         for ( auto address = std::size_t{ first }; address <= last; ++address, ++word )
+         {
+            output << ' ' << *word;
+         }
+      }
+
+      output << '\n';
+   }
+}
+
+
+auto
+Hack::Batch_Runner::write_statistics( std::ostream& output, std::span<Result const> results ) -> void
+{
+   using std::chrono::duration_cast;
+   using std::chrono::microseconds;
+
+   output << statistics_header << '\n';
+
+   for ( auto index = 0uz; index != results.size(); ++index )
+   {
+      auto const& statistics = results[index].statistics;
+
+      output << index << ' ' << statistics.slices << ' ' << statistics.migrations
+             << ' ' << duration_cast<microseconds>( statistics.run_time ).count()
+             << ' ' << duration_cast<microseconds>( statistics.started ).count()
+             << ' ' << duration_cast<microseconds>( statistics.finished ).count() << '\n';
+   }
+}
+
+
+auto
+Hack::Batch_Runner::name( Stop_Reason reason ) noexcept -> std::string_view
+{
+   switch ( reason )
+   {
+      case Stop_Reason::Budget:              return "budget";
+      case Stop_Reason::PC_Out_Of_ROM:       return "pc_out_of_rom";
+      case Stop_Reason::Memory_Out_Of_Range: return "memory_out_of_range";
+      case Stop_Reason::Halted:              return "halted";
+      case Stop_Reason::Breakpoint:          return "breakpoint";
+      case Stop_Reason::Watchpoint:          return "watchpoint";
+      case Stop_Reason::Predicate:           return "predicate";
+      case Stop_Reason::Deadline:            return "deadline";
+      case Stop_Reason::Keyboard_Wait:       return "keyboard_wait";
+   }
+
+   return "unknown";
+}
@@ -0,0 +1,286 @@
+/**
+ * @file    Batch_Runner.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Batch_Runner.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Batch_Runner.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>             // random_device
+#include <sstream>            // istringstream, ostringstream
+#include <stdexcept>          // runtime_error
+#include <string>
+#include <vector>
+
+
+namespace
+{
+   // a scratch directory of programs, removed when the test ends
+   struct Scratch_Directory
+   {
+      std::filesystem::path path = std::filesystem::temp_directory_path() / ( "hack_batch_runner_" + std::to_string( std::random_device()() ) );
+
+      Scratch_Directory()                                            { std::filesystem::create_directories( path ); }
+      Scratch_Directory( Scratch_Directory const& )                  = delete;
+      auto operator=( Scratch_Directory const& ) -> Scratch_Directory& = delete;
+
+      ~Scratch_Directory() { std::filesystem::remove_all( path ); }
+
+      auto write( std::string const& name, std::string const& text ) const -> std::filesystem::path
+      {
+         auto file = std::ofstream( path / name );
+
+         file << text;
+
+         return path / name;
+      }
+   };
+
+   // R2 = R0 * R1
+   auto const multiply = std::string(
+      "   @R2\n"
+      "   M=0\n"
+      "(LOOP)\n"
+      "   @R0\n"
+      "   D=M\n"
+      "   @END\n"
+      "   D;JEQ\n"
+      "   @R1\n"
+      "   D=M\n"
+      "   @R2\n"
+      "   M=D+M\n"
+      "   @R0\n"
+      "   M=M-1\n"
+      "   @LOOP\n"
+      "   0;JMP\n"
+      "(END)\n"
+      "   @END\n"
+      "   0;JMP\n" );
+
+   // @5  D=A  @3  M=D  @4  0;JMP
+   auto const store = std::string(
+      "0000000000000101\n"
+      "1110110000010000\n"
+      "0000000000000011\n"
+      "1110001100001000\n"
+      "0000000000000100\n"
+      "1110101010000111\n" );
+}
+
+
+TEST_CASE( "Batch_Runner: manifests" )
+{
+   using namespace Hack;
+   using Task = Batch_Runner::Task;
+
+   auto const read = []( std::string const& text )
+   {
+      auto input = std::istringstream( text );
+
+      return Batch_Runner::read_manifest( input, "suite" );
+   };
+
+   SECTION( "tasks" )
+   {
+      auto const tasks = read( "hack-batch 1\n"
+                               "# R2 = 6 * 7\n"
+                               "\n"
+                               "Mult.asm 10000 0=6 1=7 2:2\n"
+                               "/abs/Store.hack 100 16=-1 3:3 0:4\n" );
+
+      REQUIRE( tasks.size() == 2 );
+      REQUIRE( tasks[0].program == std::filesystem::path( "suite" ) / "Mult.asm" );
+      REQUIRE( tasks[0].max_instructions == 10'000 );
+      REQUIRE( tasks[0].ram    == std::vector<Batch_Runner::Assignment>{ { 0, 6 }, { 1, 7 } } );
+      REQUIRE( tasks[0].report == std::vector<Batch_Runner::Range>{ { 2, 2 } } );
+      REQUIRE( tasks[1].program == "/abs/Store.hack" );
+      REQUIRE( tasks[1].ram    == std::vector<Batch_Runner::Assignment>{ { 16, 0xFFFF } } );
+      REQUIRE( tasks[1].report == std::vector<Batch_Runner::Range>{ { 3, 3 }, { 0, 4 } } );
+   }
+
+   SECTION( "errors name the line" )
+   {
+      for ( auto const* const text : { "hack-batch 2\n", "hack-batch 1\nMult.asm\n", "hack-batch 1\nMult.asm x\n",
+                                       "hack-batch 1\nMult.asm 1 24577=0\n", "hack-batch 1\nMult.asm 1 0=65536\n",
+                                       "hack-batch 1\nMult.asm 1 5:4\n", "hack-batch 1\nMult.asm 1 7\n" } )
+      {
+         INFO( text );
+         REQUIRE_THROWS_AS( read( text ), std::runtime_error );
+      }
+
+      REQUIRE_THROWS_AS( Batch_Runner::load_manifest( "no/such/manifest" ), std::runtime_error );
+   }
+
+   SECTION( "an empty manifest has no tasks" )
+   {
+      REQUIRE( read( "hack-batch 1\n" ).empty() );
+      REQUIRE( Batch_Runner().run( std::vector<Task>() ).empty() );
+   }
+}
+
+
+TEST_CASE( "Batch_Runner: runs" )
+{
+   using namespace Hack;
+   using Task        = Batch_Runner::Task;
+   using Stop_Reason = Batch_Runner::Stop_Reason;
+
+   auto const directory = Scratch_Directory();
+   auto const mult      = directory.write( "Mult.asm", multiply );
+   auto const hack      = directory.write( "Store.hack", store );
+   auto const loop      = directory.write( "Loop.asm", "(LOOP)\n@1\nM=M+1\n@LOOP\n0;JMP\n" );
+   auto const bad       = directory.write( "Bad.asm", "@0\nD=Q\n" );
+   auto const fault     = directory.write( "Fault.asm", "@32767\nD=M\n" );
+
+   auto tasks = std::vector<Task>();
+
+   for ( auto i = 0u; i != 200; ++i )
+   {
+      tasks.push_back( Task{ mult, 100'000, { { 0, static_cast<std::uint16_t>( i ) }, { 1, 7 } }, { { 0, 2 } } } );
+   }
+
+   tasks.push_back( Task{ hack, 100, {}, { { 3, 3 } } } );
+   tasks.push_back( Task{ loop, 1'000, {}, { { 1, 1 } } } );
+   tasks.push_back( Task{ bad, 100, {}, {} } );
+   tasks.push_back( Task{ directory.path / "Missing.asm", 100, {}, {} } );
+   tasks.push_back( Task{ fault, 100, {}, {} } );
+   tasks.push_back( Task{ directory.path / "Mult.txt", 100, {}, {} } );
+
+   auto const engine  = GENERATE( Computer::Engine::Interpreter, Computer::Engine::Tiered );
+   auto const threads = GENERATE( 1u, 4u );
+   auto const quantum = GENERATE( Scheduler::default_quantum, std::uint64_t{ 64 } );
+   auto const runner  = Batch_Runner( Batch_Runner::Options{ threads, engine, std::nullopt, quantum } );
+   auto const results = runner.run( tasks );
+
+   REQUIRE( runner.threads() == threads );
+   REQUIRE( results.size() == tasks.size() );
+
+   for ( auto i = 0u; i != 200; ++i )
+   {
+      INFO( i );
+      REQUIRE( results[i].reason == Stop_Reason::Halted );
+      REQUIRE( results[i].ram    == std::vector<std::uint16_t>{ 0, 7, static_cast<std::uint16_t>( i * 7 ) } );
+      REQUIRE( results[i].error.empty() );
+   }
+
+   REQUIRE( results[0].instructions < results[199].instructions );
+
+   REQUIRE( results[200].reason == Stop_Reason::Halted );
+   REQUIRE( results[200].ram    == std::vector<std::uint16_t>{ 5 } );
+
+   REQUIRE( results[201].reason       == Stop_Reason::Budget );
+   REQUIRE( results[201].instructions == 1'000 );
+   REQUIRE( results[201].ram          == std::vector<std::uint16_t>{ 250 } );
+
+   REQUIRE_FALSE( results[202].reason );
+   REQUIRE( results[202].error.find( "line 2" ) != std::string::npos );
+
+   REQUIRE_FALSE( results[203].reason );
+   REQUIRE( results[203].error.find( "Missing.asm" ) != std::string::npos );
+
+   REQUIRE( results[204].reason == Stop_Reason::Memory_Out_Of_Range );
+
+   REQUIRE_FALSE( results[205].reason );
+   REQUIRE( results[205].error.find( "Mult.txt" ) != std::string::npos );
+
+   SECTION( "result files" )
+   {
+      auto output = std::ostringstream();
+
+      Batch_Runner::write_results( output, tasks, results );
+
+      auto input = std::istringstream( output.str() );
+      auto line  = std::string();
+
+      REQUIRE( std::getline( input, line ) );
+      REQUIRE( line == "hack-batch-results 1" );
+
+      REQUIRE( std::getline( input, line ) );
+      REQUIRE( line == "0 halted " + std::to_string( results[0].instructions ) + " 0:2 0 7 0" );
+
+      for ( auto i = 0; i != 200; ++i )
+      {
+         REQUIRE( std::getline( input, line ) );
+      }
+
+      REQUIRE( line == "200 halted " + std::to_string( results[200].instructions ) + " 3:3 5" );
+
+      REQUIRE( std::getline( input, line ) );
+      REQUIRE( line == "201 budget 1000 1:1 250" );
+
+      REQUIRE( std::getline( input, line ) );
+      REQUIRE( line.starts_with( "202 error " ) );
+   }
+
+   SECTION( "statistics files" )
+   {
+      auto output = std::ostringstream();
+
+      Batch_Runner::write_statistics( output, results );
+
+      auto input = std::istringstream( output.str() );
+      auto line  = std::string();
+
+      REQUIRE( std::getline( input, line ) );
+      REQUIRE( line == "hack-batch-statistics 1" );
+
+      REQUIRE( std::getline( input, line ) );
+      REQUIRE( line.starts_with( "0 " + std::to_string( results[0].statistics.slices ) + ' ' ) );
+   }
+
+   SECTION( "long tasks run in quanta" )
+   {
+      REQUIRE( results[201].statistics.slices == ( quantum == 64 ? 16u : 1u ) );
+   }
+}
+
+
+TEST_CASE( "Batch_Runner: programs can be loaded through a ROM cache" )
+{
+   using namespace Hack;
+   using Task = Batch_Runner::Task;
+
+   auto const directory = Scratch_Directory();
+   auto const mult      = directory.write( "Mult.asm", multiply );
+   auto const tasks     = std::vector<Task>{ Task{ mult, 100'000, { { 0, 6 }, { 1, 7 } }, { { 2, 2 } } } };
+   auto const runner    = Batch_Runner( Batch_Runner::Options{ 2, Computer::Engine::Interpreter, directory.path / "cache" } );
+
+   for ( auto run = 0; run != 2; ++run )
+   {
+      auto const results = runner.run( tasks );
+
+      REQUIRE( results[0].reason == Computer::Stop_Reason::Halted );
+      REQUIRE( results[0].ram    == std::vector<std::uint16_t>{ 42 } );
+   }
+
+   REQUIRE_FALSE( std::filesystem::is_empty( directory.path / "cache" ) );
+}
+
+
+TEST_CASE( "Batch_Runner: a cache directory that cannot be created is reported by run" )
+{
+   using namespace Hack;
+   using Task = Batch_Runner::Task;
+
+   auto const directory = Scratch_Directory();
+   auto const blocker   = directory.write( "blocker", "a file, not a directory" );
+   auto const tasks     = std::vector<Task>
+   {
+      Task{ directory.write( "Mult.asm", multiply ), 100'000, {}, {} },
+      Task{ directory.write( "Store.hack", store ),  100'000, {}, {} },
+      Task{ directory.write( "Again.asm", multiply ), 100'000, {}, {} }
+   };
+
+   auto const runner = Batch_Runner( Batch_Runner::Options{ 4, Computer::Engine::Interpreter, blocker / "sub" } );
+
+   REQUIRE_THROWS_AS( runner.run( tasks ), std::runtime_error );
+}
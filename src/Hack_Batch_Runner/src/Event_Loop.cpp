@@ -0,0 +1,399 @@
+/**
+ * @file    Event_Loop.cpp
+ * @author  William Weston
+ * @brief   Hosts many interactive Hack machines on one thread as coroutines
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Event_Loop.h"
+
+#include <algorithm>        // for max
+#include <stdexcept>        // for out_of_range
+#include <string>           // for to_string
+#include <utility>          // for exchange
+
+
+auto
+Hack::Event_Loop::Task::promise_type::get_return_object() noexcept -> Task
+{
+   return Task( Handle::from_promise( *this ) );
+}
+
+
+auto
+Hack::Event_Loop::Task::promise_type::return_value( Computer::Run_Result result ) noexcept -> void
+{
+   loop->slots_[session].result = result;
+}
+
+
+auto
+Hack::Event_Loop::Task::promise_type::unhandled_exception() noexcept -> void
+{
+   loop->slots_[session].error = std::current_exception();
+}
+
+
+Hack::Event_Loop::Task::Task( Handle handle ) noexcept
+   : handle_( handle )
+{}
+
+
+Hack::Event_Loop::Task::Task( Task&& other ) noexcept
+   : handle_( std::exchange( other.handle_, nullptr ) )
+{}
+
+
+Hack::Event_Loop::Task::~Task()
+{
+   if ( handle_ )
+   {
+      handle_.destroy();
+   }
+}
+
+
+auto
+Hack::Event_Loop::Key_Press::await_suspend( Task::Handle task ) const noexcept -> bool
+{
+   auto& slot = task.promise().loop->slots_[task.promise().session];
+
+   if ( slot.key_pending )
+   {
+      return false;
+   }
+
+   slot.state = State::Waiting;
+   ++slot.statistics.waits;
+
+   return true;
+}
+
+
+auto
+Hack::Event_Loop::Take_Key::await_suspend( Task::Handle task ) noexcept -> bool
+{
+   auto& slot = task.promise().loop->slots_[task.promise().session];
+
+   if ( slot.key_pending )
+   {
+      key_             = slot.key;
+      slot.key_pending = false;
+   }
+
+   return false;
+}
+
+
+auto
+Hack::Event_Loop::Take_Key::await_resume() const noexcept -> std::optional<word_t>
+{
+   return key_;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Event_Loop::Event_Loop()
+   : Event_Loop( Options{ default_quantum, default_slice_time, default_resident, default_rounds } )
+{}
+
+
+Hack::Event_Loop::Event_Loop( Options options )
+   : options_( options )
+{}
+
+
+Hack::Event_Loop::~Event_Loop()
+{
+   for ( auto& slot : slots_ )
+   {
+      if ( slot.handle )
+      {
+         slot.handle.destroy();
+      }
+   }
+}
+
+
+auto
+Hack::Event_Loop::host( Computer& computer ) -> Session
+{
+   return spawn( machine( computer ) );
+}
+
+
+auto
+Hack::Event_Loop::spawn( Task task ) -> Session
+{
+   auto const handle  = std::exchange( task.handle_, nullptr );
+   auto const session = free_.empty() ? slots_.size() : free_.back();
+
+   if ( free_.empty() )
+   {
+      slots_.emplace_back();
+   }
+   else
+   {
+      free_.pop_back();
+   }
+
+   slots_[session]        = Slot{};
+   slots_[session].handle = handle;
+   slots_[session].used   = true;
+   slots_[session].queued = true;
+
+   handle.promise().loop    = this;
+   handle.promise().session = session;
+
+   ready_.push_back( session );
+   ++sessions_;
+
+   return session;
+}
+
+
+/**
+ * @brief   Press key for session
+ *
+ * @throws std::out_of_range if there is no such session
+ *
+ *    The key replaces one that session has not taken yet.  A session waiting for a key is woken,
+ *    and runs before the sessions that were already ready.
+ */
+auto
+Hack::Event_Loop::press( Session session, word_t key ) -> void
+{
+   auto& pressed = slot( session );
+
+   pressed.key         = key;
+   pressed.key_pending = true;
+
+   if ( pressed.state == State::Waiting )
+   {
+      pressed.state = State::Ready;
+
+      if ( !pressed.queued )
+      {
+         pressed.queued = true;
+         ready_.push_front( session );
+      }
+   }
+}
+
+
+auto
+Hack::Event_Loop::run() -> void
+{
+   run( Clock::time_point::max() );
+}
+
+
+/**
+ * @brief   Run batches of ready sessions
+ *
+ * @param deadline    checked between slices, a slice that has started runs to its end
+ * @return true       if sessions are still ready
+ *
+ *    A batch is the first resident sessions of the queue.  Each runs a slice in turn, for up to
+ *    rounds rounds or until none of them is ready, and those still ready then go to the back of
+ *    the queue.
+ */
+auto
+Hack::Event_Loop::run( Clock::time_point deadline ) -> bool
+{
+   auto const resident = std::max<std::size_t>( options_.resident, 1 );
+   auto const rounds   = std::max<std::size_t>( options_.rounds, 1 );
+
+   while ( !ready_.empty() && Clock::now() < deadline )
+   {
+      batch_.clear();
+
+      while ( batch_.size() < resident && !ready_.empty() )
+      {
+         batch_.push_back( ready_.front() );
+         ready_.pop_front();
+      }
+
+      for ( auto round = 0uz, resumed = 1uz; round != rounds && resumed != 0 && Clock::now() < deadline; ++round )
+      {
+         resumed = 0;
+
+         for ( auto const session : batch_ )
+         {
+            if ( slots_[session].state == State::Ready )
+            {
+               resume( session );
+               ++resumed;
+            }
+         }
+      }
+
+      for ( auto const session : batch_ )
+      {
+         auto& batched = slots_[session];
+
+         batched.queued = batched.state == State::Ready;
+
+         if ( batched.queued )
+         {
+            ready_.push_back( session );
+         }
+      }
+   }
+
+   return !ready_.empty();
+}
+
+
+/**
+ * @brief   Destroy the coroutine of session and free its number
+ *
+ * @throws std::out_of_range if there is no such session
+ */
+auto
+Hack::Event_Loop::remove( Session session ) -> void
+{
+   auto& removed = slot( session );
+
+   if ( removed.handle )
+   {
+      removed.handle.destroy();
+   }
+
+   std::erase( ready_, session );
+
+   removed = Slot{};
+   free_.push_back( session );
+   --sessions_;
+}
+
+
+auto
+Hack::Event_Loop::state( Session session ) const -> State
+{
+   return slot( session ).state;
+}
+
+
+auto
+Hack::Event_Loop::statistics( Session session ) const -> Session_Statistics const&
+{
+   return slot( session ).statistics;
+}
+
+
+auto
+Hack::Event_Loop::result( Session session ) const -> std::optional<Computer::Run_Result>
+{
+   auto const& ended = slot( session );
+
+   if ( ended.error )
+   {
+      std::rethrow_exception( ended.error );
+   }
+
+   return ended.result;
+}
+
+
+auto
+Hack::Event_Loop::ready() const noexcept -> std::size_t
+{
+   return ready_.size();
+}
+
+
+auto
+Hack::Event_Loop::sessions() const noexcept -> std::size_t
+{
+   return sessions_;
+}
+
+
+/**
+ * @brief   The session host() starts
+ *
+ *    A slice runs until a deadline so that Computer::run_until() reports a keyboard poll loop,
+ *    rather than fast-forwarding through it.  The key the session took is written to the
+ *    keyboard before each slice.
+ */
+auto
+Hack::Event_Loop::machine( Computer& computer ) -> Task
+{
+   auto executed = std::uint64_t{ 0 };
+
+   while ( true )
+   {
+      if ( auto const key = co_await take_key() )
+      {
+         computer.keyboard() = *key;
+      }
+
+      auto const result = computer.run_until( Clock::now() + options_.slice_time, options_.quantum );
+
+      executed += result.executed;
+
+      switch ( result.reason )
+      {
+         case Computer::Stop_Reason::Budget:
+         case Computer::Stop_Reason::Deadline:
+            co_await next_slice();
+            break;
+
+         case Computer::Stop_Reason::Keyboard_Wait:
+            co_await key_press();
+            break;
+
+         default:
+            co_return Computer::Run_Result{ result.reason, executed };
+      }
+   }
+}
+
+
+// resume session for a slice, and end it if its coroutine has returned
+auto
+Hack::Event_Loop::resume( Session session ) -> void
+{
+   ++slots_[session].statistics.slices;
+   slots_[session].handle.resume();
+
+   // the coroutine may have spawned sessions, which moves the slots
+   auto& resumed = slots_[session];
+
+   if ( resumed.handle.done() )
+   {
+      resumed.handle.destroy();
+      resumed.handle = nullptr;
+      resumed.state  = State::Finished;
+   }
+}
+
+
+auto
+Hack::Event_Loop::slot( Session session ) -> Slot&
+{
+   if ( session >= slots_.size() || !slots_[session].used )
+   {
+      throw std::out_of_range( "Hack::Event_Loop: no session " + std::to_string( session ) );
+   }
+
+   return slots_[session];
+}
+
+
+auto
+Hack::Event_Loop::slot( Session session ) const -> Slot const&
+{
+   if ( session >= slots_.size() || !slots_[session].used )
+   {
+      throw std::out_of_range( "Hack::Event_Loop: no session " + std::to_string( session ) );
+   }
+
+   return slots_[session];
+}
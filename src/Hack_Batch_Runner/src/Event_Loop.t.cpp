@@ -0,0 +1,216 @@
+/**
+ * @file    Event_Loop.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Event_Loop.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Event_Loop.h"
+
+#include "Hack/Computer.h"
+#include "Hack/Shared_ROM.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>             // make_shared, make_unique, unique_ptr
+#include <stdexcept>          // out_of_range, runtime_error
+#include <vector>
+
+
+namespace
+{
+   using Hack::Test_Programs::counting;
+   using Hack::Test_Programs::typing;
+
+   auto make_computers( std::vector<std::uint16_t> const& program, std::size_t count ) -> std::vector<std::unique_ptr<Hack::Computer>>
+   {
+      auto const rom       = std::make_shared<Hack::Shared_ROM>( program );
+      auto       computers = std::vector<std::unique_ptr<Hack::Computer>>();
+
+      for ( auto idx = 0uz; idx != count; ++idx )
+      {
+         computers.push_back( std::make_unique<Hack::Computer>() );
+         computers.back()->load_rom( rom );
+         computers.back()->set_engine( Hack::Computer::Engine::Tiered );
+      }
+
+      return computers;
+   }
+
+   auto slices( int& count, int limit ) -> Hack::Event_Loop::Task
+   {
+      while ( true )
+      {
+         if ( ++count == limit )
+         {
+            throw std::runtime_error( "limit" );
+         }
+
+         co_await Hack::Event_Loop::next_slice();
+      }
+   }
+
+   auto read_key() -> Hack::Event_Loop::Task
+   {
+      co_await Hack::Event_Loop::key_press();
+
+      auto const key = co_await Hack::Event_Loop::take_key();
+
+      co_return Hack::Computer::Run_Result{ Hack::Computer::Stop_Reason::Halted, key.value_or( 0 ) };
+   }
+}
+
+
+TEST_CASE( "Event_Loop: sessions wait for their keys without running" )
+{
+   using State = Hack::Event_Loop::State;
+
+   auto const count     = 300uz;
+   auto       computers = make_computers( typing, count );
+   auto       loop      = Hack::Event_Loop();
+   auto       sessions  = std::vector<Hack::Event_Loop::Session>();
+
+   for ( auto const& computer : computers )
+   {
+      sessions.push_back( loop.host( *computer ) );
+   }
+
+   REQUIRE( loop.sessions() == count );
+   REQUIRE( loop.ready() == count );
+
+   loop.run();
+
+   REQUIRE( loop.ready() == 0 );
+
+   for ( auto idx = 0uz; idx != count; ++idx )
+   {
+      REQUIRE( loop.state( sessions[idx] ) == State::Waiting );
+      REQUIRE( loop.statistics( sessions[idx] ).waits == 1 );
+      REQUIRE( computers[idx]->instruction_count() < 100 );
+
+      loop.press( sessions[idx], static_cast<std::uint16_t>( 'a' + idx % 26 ) );
+   }
+
+   REQUIRE( loop.ready() == count );
+
+   loop.run();
+
+   for ( auto idx = 0uz; idx != count; ++idx )
+   {
+      REQUIRE( loop.state( sessions[idx] ) == State::Waiting );
+      REQUIRE( computers[idx]->RAM()[0] == 'a' + idx % 26 );
+      REQUIRE( computers[idx]->RAM()[1] == 1 );
+
+      loop.press( sessions[idx], 0 );
+   }
+
+   loop.run();
+
+   for ( auto idx = 0uz; idx != count; ++idx )
+   {
+      REQUIRE( loop.state( sessions[idx] ) == State::Waiting );
+      REQUIRE( loop.statistics( sessions[idx] ).waits == 3 );
+
+      loop.press( sessions[idx], 'Q' );
+   }
+
+   loop.run();
+
+   for ( auto idx = 0uz; idx != count; ++idx )
+   {
+      auto const result = loop.result( sessions[idx] );
+
+      REQUIRE( loop.state( sessions[idx] ) == State::Finished );
+      REQUIRE( result );
+      REQUIRE( result->reason == Hack::Computer::Stop_Reason::Halted );
+      REQUIRE( result->executed == computers[idx]->instruction_count() );
+      REQUIRE( computers[idx]->RAM()[1] == 2 );
+   }
+}
+
+
+TEST_CASE( "Event_Loop: a busy session does not hold up the others" )
+{
+   using State = Hack::Event_Loop::State;
+
+   auto busy        = make_computers( counting, 1 );
+   auto interactive = make_computers( typing, 1 );
+   auto loop        = Hack::Event_Loop( Hack::Event_Loop::Options{ 1'000, std::chrono::microseconds( 1'000 ), 1, 1 } );
+
+   auto const counter = loop.host( *busy[0] );
+   auto const typist  = loop.host( *interactive[0] );
+
+   REQUIRE( loop.run( Hack::Event_Loop::Clock::now() + std::chrono::milliseconds( 20 ) ) );
+   REQUIRE( loop.state( typist ) == State::Waiting );
+   REQUIRE( loop.state( counter ) == State::Ready );
+   REQUIRE( loop.statistics( counter ).slices > 1 );
+
+   loop.press( typist, 'Q' );
+   loop.run( Hack::Event_Loop::Clock::now() + std::chrono::milliseconds( 20 ) );
+
+   REQUIRE( loop.state( typist ) == State::Finished );
+   REQUIRE( interactive[0]->RAM()[0] == 'Q' );
+   REQUIRE_FALSE( loop.result( counter ) );
+
+   loop.remove( counter );
+
+   REQUIRE( loop.ready() == 0 );
+   REQUIRE( loop.sessions() == 1 );
+   REQUIRE_THROWS_AS( loop.state( counter ), std::out_of_range );
+}
+
+
+TEST_CASE( "Event_Loop: tasks of one's own" )
+{
+   using State = Hack::Event_Loop::State;
+
+   auto loop = Hack::Event_Loop();
+
+   SECTION( "run a slice at a time and end with what they throw" )
+   {
+      auto       count   = 0;
+      auto const session = loop.spawn( slices( count, 5 ) );
+
+      loop.run();
+
+      REQUIRE( count == 5 );
+      REQUIRE( loop.state( session ) == State::Finished );
+      REQUIRE( loop.statistics( session ).slices == 5 );
+      REQUIRE_THROWS_AS( loop.result( session ), std::runtime_error );
+   }
+
+   SECTION( "take the keys pressed for them" )
+   {
+      auto const waiting = loop.spawn( read_key() );
+      auto const pressed = loop.spawn( read_key() );
+
+      loop.press( pressed, 7 );
+      loop.run();
+
+      REQUIRE( loop.state( waiting ) == State::Waiting );
+      REQUIRE( loop.state( pressed ) == State::Finished );
+      REQUIRE( loop.result( pressed )->executed == 7 );
+
+      loop.press( waiting, 9 );
+      loop.run();
+
+      REQUIRE( loop.result( waiting )->executed == 9 );
+   }
+
+   SECTION( "reuse the numbers of removed sessions" )
+   {
+      auto const first = loop.spawn( read_key() );
+
+      loop.run();
+      loop.remove( first );
+
+      REQUIRE( loop.sessions() == 0 );
+      REQUIRE( loop.spawn( read_key() ) == first );
+   }
+}
@@ -0,0 +1,569 @@
+/**
+ * @file    Explorer.cpp
+ * @author  William Weston
+ * @brief   Explores every run of a keyboard driven Hack program over an alphabet of keys
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Explorer.h"
+
+#include "Hack/Condition.h"   // for Condition
+#include "Hack/Decoder.h"     // for decode
+#include "Hack/Memory.h"      // for Memory
+
+#include <algorithm>          // for copy, max, move, reverse, sort
+#include <array>              // for array
+#include <atomic>             // for atomic
+#include <barrier>            // for barrier
+#include <cstring>            // for memcpy
+#include <cstddef>            // for ptrdiff_t, size_t
+#include <exception>          // for exception_ptr, current_exception, rethrow_exception
+#include <iterator>           // for back_inserter
+#include <memory>             // for make_shared, shared_ptr, unique_ptr
+#include <mutex>              // for mutex, scoped_lock
+#include <span>               // for span
+#include <string>             // for to_string
+#include <thread>             // for jthread, thread
+#include <utility>            // for as_const, move
+
+
+namespace
+{
+   using word_t = Hack::Explorer::word_t;
+   using Hash   = Hack::Explorer::Hash;
+
+   // the words of a state, RAM below the keyboard
+   constexpr auto state_words = std::size_t{ Hack::Memory::keyboard_address };
+
+   // the keys chosen on the way to a state, shared by the states that follow it
+   struct Trace
+   {
+      std::shared_ptr<Trace const> parent;
+      word_t                       key;
+   };
+
+   struct State
+   {
+      std::vector<word_t>          diff;        // runs of RAM that differ from the root's: start, length, words
+      word_t                       A;
+      word_t                       D;
+      word_t                       pc;
+      bool                         at_read;     // its runs choose a key, only the root may not be
+      std::uint32_t                depth;       // keys chosen on the way
+      std::shared_ptr<Trace const> trace;
+   };
+
+   // -------------------------------------------- hash --------------------------------------------
+
+#if defined( __SIZEOF_INT128__ )
+   __extension__ typedef unsigned __int128 Wide;
+
+   // the 128-bit product of a and b folded to 64 bits
+   constexpr auto fold( std::uint64_t a, std::uint64_t b ) noexcept -> std::uint64_t
+   {
+      auto const product = Wide{ a } * b;
+
+      return static_cast<std::uint64_t>( product ) ^ static_cast<std::uint64_t>( product >> 64 );
+   }
+#else
+   constexpr auto fold( std::uint64_t a, std::uint64_t b ) noexcept -> std::uint64_t
+   {
+      auto const a_low  = a & 0xFFFF'FFFFu;
+      auto const a_high = a >> 32;
+      auto const b_low  = b & 0xFFFF'FFFFu;
+      auto const b_high = b >> 32;
+      auto const middle = a_high * b_low + ( ( a_low * b_low ) >> 32 );
+      auto const cross  = a_low * b_high + ( middle & 0xFFFF'FFFFu );
+      auto const high   = a_high * b_high + ( middle >> 32 ) + ( cross >> 32 );
+
+      return ( a * b ) ^ high;
+   }
+#endif
+
+   constexpr auto secrets = std::array<std::uint64_t, 4>
+   {
+      0xA076'1D64'78BD'642Full, 0xE703'7ED1'A0B4'28DBull, 0x8EBC'6AF0'9C88'C6E3ull, 0x5899'65CC'7537'4CC3ull
+   };
+
+   constexpr auto avalanche( std::uint64_t hash ) noexcept -> std::uint64_t
+   {
+      hash ^= hash >> 37;
+      hash *= 0x1656'6791'9E37'79F9ull;
+      return hash ^ ( hash >> 32 );
+   }
+
+   // two chains of multiply folds over 16 bytes at a time, independent so that they overlap
+   auto hash_state( word_t const* words, word_t A, word_t D, word_t pc ) noexcept -> Hash
+   {
+      static_assert( state_words % 8 == 0 );
+
+      auto low  = secrets[0];
+      auto high = secrets[1];
+
+      for ( auto offset = 0uz; offset != state_words; offset += 8 )
+      {
+         auto first  = std::uint64_t{ 0 };
+         auto second = std::uint64_t{ 0 };
+
+         std::memcpy( &first,  words + offset,     sizeof( first ) );
+         std::memcpy( &second, words + offset + 4, sizeof( second ) );
+
+         low  = fold( first ^ secrets[2], second ^ low );
+         high = fold( second ^ secrets[3], first ^ high );
+      }
+
+      auto const registers = std::uint64_t{ A } | std::uint64_t{ D } << 16 | std::uint64_t{ pc } << 32;
+
+      low  = fold( registers ^ secrets[2], low ^ secrets[1] );
+      high = fold( registers ^ secrets[3], high ^ secrets[0] );
+
+      return { avalanche( low ), avalanche( high ) };
+   }
+
+   // ------------------------------------------ visited -------------------------------------------
+
+   // the hashes of the states seen, in open addressed tables of 16 bytes a slot behind a lock each
+   class Visited final
+   {
+   public:
+      // was hash not seen before
+      auto insert( Hash hash ) -> bool
+      {
+         // {0, 0} marks an empty slot
+         if ( hash == Hash{ 0, 0 } )
+         {
+            hash.low = 1;
+         }
+
+         auto& shard = shards_[hash.high >> ( 64 - shard_bits )];
+         auto  lock  = std::scoped_lock( shard.mutex );
+
+         if ( ( shard.count + 1 ) * 2 > shard.slots.size() )
+         {
+            grow( shard );
+         }
+
+         if ( !place( shard.slots, hash ) )
+         {
+            return false;
+         }
+
+         ++shard.count;
+         size_.fetch_add( 1, std::memory_order_relaxed );
+
+         return true;
+      }
+
+      auto size() const noexcept -> std::size_t
+      {
+         return size_.load( std::memory_order_relaxed );
+      }
+
+   private:
+      static constexpr auto shard_bits = 6;
+
+      struct alignas( 64 ) Shard
+      {
+         std::mutex        mutex{};
+         std::vector<Hash> slots = std::vector<Hash>( 64, Hash{ 0, 0 } );
+         std::size_t       count{ 0 };
+      };
+
+      std::array<Shard, 1uz << shard_bits> shards_{};
+      std::atomic<std::size_t>             size_{ 0 };
+
+      // put hash in slots unless it is there, slots has an empty slot
+      static auto place( std::vector<Hash>& slots, Hash hash ) noexcept -> bool
+      {
+         auto const mask = slots.size() - 1;
+
+         for ( auto slot = hash.low & mask; ; slot = ( slot + 1 ) & mask )
+         {
+            if ( slots[slot] == hash )
+            {
+               return false;
+            }
+
+            if ( slots[slot] == Hash{ 0, 0 } )
+            {
+               slots[slot] = hash;
+               return true;
+            }
+         }
+      }
+
+      static auto grow( Shard& shard ) -> void
+      {
+         auto slots = std::vector<Hash>( shard.slots.size() * 2, Hash{ 0, 0 } );
+
+         for ( auto const& hash : shard.slots )
+         {
+            if ( hash != Hash{ 0, 0 } )
+            {
+               place( slots, hash );
+            }
+         }
+
+         shard.slots = std::move( slots );
+      }
+   };
+
+   // ------------------------------------------- state --------------------------------------------
+
+   // the runs of words that differ from base, joined across gaps of up to two equal words
+   auto make_diff( word_t const* words, std::span<word_t const> base ) -> std::vector<word_t>
+   {
+      auto diff = std::vector<word_t>();
+
+      for ( auto address = 0uz; address != state_words; )
+      {
+         if ( words[address] == base[address] )
+         {
+            ++address;
+            continue;
+         }
+
+         auto end = address + 1;
+
+         for ( auto next = end; next != state_words && next < end + 3; ++next )
+         {
+            if ( words[next] != base[next] )
+            {
+               end = next + 1;
+            }
+         }
+
+         diff.push_back( static_cast<word_t>( address ) );
+         diff.push_back( static_cast<word_t>( end - address ) );
+         diff.insert( diff.end(), words + address, words + end );
+
+         address = end;
+      }
+
+      return diff;
+   }
+
+   // put computer in state, with the root's keyboard
+   auto load( Hack::Computer& computer, State const& state, std::span<word_t const> base ) -> void
+   {
+      auto* const words = computer.RAM().data();
+
+      std::copy( base.begin(), base.end(), words );
+
+      for ( auto idx = 0uz; idx != state.diff.size(); )
+      {
+         auto const start  = state.diff[idx];
+         auto const length = state.diff[idx + 1];
+
+         std::copy( state.diff.begin() + static_cast<std::ptrdiff_t>( idx + 2 ),
+                    state.diff.begin() + static_cast<std::ptrdiff_t>( idx + 2 + length ),
+                    words + start );
+
+         idx += 2uz + length;
+      }
+
+      computer.A_Register() = state.A;
+      computer.D_Register() = state.D;
+      computer.pc()         = state.pc;
+      computer.RAM().clear_fault();
+      computer.clear_fault();
+   }
+
+   auto keys_of( std::shared_ptr<Trace const> const& trace ) -> std::vector<word_t>
+   {
+      auto keys = std::vector<word_t>();
+
+      for ( auto const* step = trace.get(); step != nullptr; step = step->parent.get() )
+      {
+         keys.push_back( step->key );
+      }
+
+      std::ranges::reverse( keys );
+
+      return keys;
+   }
+
+   struct alignas( 64 ) Worker
+   {
+      std::unique_ptr<Hack::Computer>      computer{};
+      std::vector<State>                   next{};          // states of the next level it found
+      std::vector<Hack::Explorer::Finding> findings{};
+      Hack::Explorer::Statistics           statistics{};
+   };
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Explorer::Explorer( Options options )
+   : options_( std::move( options ) )
+{}
+
+
+/**
+ * @brief   Explore every run of computer from its state
+ *
+ * @param computer    its ROM, RAM, registers, watchpoints, breakpoints and settings are explored,
+ *                    its keyboard is the one the first run reads unless it starts at a read
+ * @return Report     what was found, and whether the runs were all followed to their end
+ *
+ *    Runs are checked an instruction at a time, for the breakpoints that stop them at reads.  A
+ *    run that does not reach a read, a halt or a finding within step_budget is truncated, as is
+ *    a state past max_depth keys or max_states states.
+ */
+auto
+Hack::Explorer::explore( Computer& computer ) const -> Report
+{
+   auto const count = threads();
+   auto       root  = computer.fork();
+
+   // stop before every read of M while A holds KBD
+   auto const reads_keyboard = Condition( "A == " + std::to_string( Memory::keyboard_address ) );
+
+   for ( auto address = 0uz; address != Computer::ROM_SIZE; ++address )
+   {
+      if ( decode( std::as_const( *root ).ROM()[address] ).reads_M() )
+      {
+         root->add_breakpoint( static_cast<word_t>( address ), reads_keyboard );
+      }
+   }
+
+   auto const base = std::vector<word_t>( root->RAM().data(), root->RAM().data() + Memory::address_space );
+   auto       workers = std::vector<Worker>( count );
+   auto       forks   = root->fork( count );
+
+   for ( auto worker = 0uz; worker != count; ++worker )
+   {
+      workers[worker].computer = std::move( forks[worker] );
+   }
+
+   auto visited = Visited();
+   auto level   = std::vector<State>();
+
+   level.push_back( State{ {}, root->A_Register(), root->D_Register(), root->pc(), at_keyboard_read( *root ), 0, nullptr } );
+
+   if ( level.front().at_read )
+   {
+      visited.insert( hash( *root ) );
+   }
+
+   auto index      = std::atomic<std::size_t>{ 0 };
+   auto stop       = std::atomic<bool>{ false };
+   auto error      = std::exception_ptr();
+   auto error_lock = std::mutex();
+   auto done       = false;
+   auto peak       = std::uint64_t{ 0 };
+   auto depth      = std::uint64_t{ 0 };
+
+   auto const keep_error = [&]
+   {
+      auto lock = std::scoped_lock( error_lock );
+
+      if ( !error )
+      {
+         error = std::current_exception();
+      }
+
+      stop = true;
+   };
+
+   // run state in worker for each of its keys, and keep the states it reaches
+   auto const expand = [&]( Worker& worker, State const& state )
+   {
+      auto& machine    = *worker.computer;
+      auto& statistics = worker.statistics;
+      auto  keys       = state.at_read ? std::span<word_t const>( options_.alphabet ) : std::span<word_t const>();
+      auto  choices    = state.at_read ? keys.size() : 1uz;
+
+      for ( auto choice = 0uz; choice != choices; ++choice )
+      {
+         load( machine, state, base );
+
+         auto trace = state.trace;
+
+         if ( state.at_read )
+         {
+            machine.keyboard() = keys[choice];
+            trace              = std::make_shared<Trace const>( Trace{ state.trace, keys[choice] } );
+         }
+
+         auto const result = machine.run( options_.step_budget );
+         auto const keyed  = state.depth + ( state.at_read ? 1u : 0u );
+
+         ++statistics.transitions;
+         statistics.instructions += result.executed;
+
+         if ( result.reason == Computer::Stop_Reason::Halted )
+         {
+            ++statistics.halted;
+         }
+         else if ( result.reason == Computer::Stop_Reason::Budget )
+         {
+            ++statistics.truncated;
+         }
+         else if ( result.reason == Computer::Stop_Reason::Breakpoint && at_keyboard_read( machine ) )
+         {
+            if ( keyed >= options_.max_depth || visited.size() >= options_.max_states )
+            {
+               ++statistics.truncated;
+            }
+            else if ( !visited.insert( hash( machine ) ) )
+            {
+               ++statistics.duplicates;
+            }
+            else
+            {
+               auto* const words = machine.RAM().data();
+
+               worker.next.push_back( State{ make_diff( words, base ), machine.A_Register(), machine.D_Register(),
+                                             machine.pc(), true, keyed, std::move( trace ) } );
+            }
+         }
+         else
+         {
+            ++statistics.findings;
+
+            if ( worker.findings.size() < options_.max_findings )
+            {
+               worker.findings.push_back( Finding{ result.reason, machine.pc(), machine.watch_hit(), keys_of( trace ) } );
+            }
+         }
+      }
+   };
+
+   // the next level once every worker has finished this one
+   auto const advance = [&]() noexcept
+   {
+      try
+      {
+         level.clear();
+
+         for ( auto& worker : workers )
+         {
+            std::ranges::move( worker.next, std::back_inserter( level ) );
+            worker.next.clear();
+         }
+
+         auto words = std::uint64_t{ 0 };
+
+         for ( auto const& state : level )
+         {
+            words += state.diff.size();
+         }
+
+         peak  = std::max( peak, words );
+         depth = level.empty() ? depth : level.front().depth;
+      }
+      catch ( ... )
+      {
+         keep_error();
+      }
+
+      index = 0;
+      done  = level.empty() || stop;
+   };
+
+   auto sync = std::barrier( static_cast<std::ptrdiff_t>( count ), advance );
+
+   auto const body = [&]( unsigned self )
+   {
+      while ( true )
+      {
+         for ( auto next = index++; next < level.size() && !stop; next = index++ )
+         {
+            try
+            {
+               expand( workers[self], level[next] );
+            }
+            catch ( ... )
+            {
+               keep_error();
+            }
+         }
+
+         sync.arrive_and_wait();
+
+         if ( done )
+         {
+            return;
+         }
+      }
+   };
+
+   {
+      auto pool = std::vector<std::jthread>();
+
+      pool.reserve( count - 1 );
+
+      for ( auto self = 1u; self != count; ++self )
+      {
+         pool.emplace_back( body, self );
+      }
+
+      body( 0u );
+   }
+
+   if ( error )
+   {
+      std::rethrow_exception( error );
+   }
+
+   auto report = Report();
+
+   for ( auto& worker : workers )
+   {
+      auto const& statistics = worker.statistics;
+
+      report.statistics.transitions  += statistics.transitions;
+      report.statistics.duplicates   += statistics.duplicates;
+      report.statistics.halted       += statistics.halted;
+      report.statistics.truncated    += statistics.truncated;
+      report.statistics.findings     += statistics.findings;
+      report.statistics.instructions += statistics.instructions;
+
+      std::ranges::move( worker.findings, std::back_inserter( report.findings ) );
+   }
+
+   std::ranges::sort( report.findings, []( Finding const& lhs, Finding const& rhs )
+   {
+      return lhs.keys.size() != rhs.keys.size() ? lhs.keys.size() < rhs.keys.size() : lhs.keys < rhs.keys;
+   } );
+
+   if ( report.findings.size() > options_.max_findings )
+   {
+      report.findings.erase( report.findings.begin() + static_cast<std::ptrdiff_t>( options_.max_findings ), report.findings.end() );
+   }
+
+   report.statistics.states              = visited.size();
+   report.statistics.depth               = depth;
+   report.statistics.peak_frontier_words = peak;
+   report.complete                       = report.statistics.truncated == 0;
+
+   return report;
+}
+
+
+auto
+Hack::Explorer::hash( Computer const& computer ) noexcept -> Hash
+{
+   return hash_state( computer.RAM().data(), computer.A_Register(), computer.D_Register(), computer.pc() );
+}
+
+
+auto
+Hack::Explorer::at_keyboard_read( Computer const& computer ) -> bool
+{
+   return computer.pc() < Computer::ROM_SIZE && computer.A_Register() == Memory::keyboard_address &&
+          decode( computer.ROM()[computer.pc()] ).reads_M();
+}
+
+
+auto
+Hack::Explorer::threads() const noexcept -> unsigned
+{
+   return options_.threads != 0 ? options_.threads : std::max( std::thread::hardware_concurrency(), 1u );
+}
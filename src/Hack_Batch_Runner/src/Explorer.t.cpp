@@ -0,0 +1,181 @@
+/**
+ * @file    Explorer.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Explorer.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Explorer.h"
+
+#include "Hack/Computer.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace
+{
+   using Hack::Test_Programs::counting;
+   using Hack::Test_Programs::typing;
+
+   // each A flips RAM[0] between 0 and -1 and fills the word at SCREEN + RAM[0], Q halts
+   auto const toggle = std::vector<std::uint16_t>
+   {
+      0x6000, 0xFC10, 0x0000, 0xE302,     // @KBD D=M  @0   D;JEQ             (wait)
+      0x0051, 0xE4D0, 0x0014, 0xE302,     // @81  D=D-A  @20  D;JEQ
+      0x0000, 0xFC48, 0xFC10,             // @0   M=!M  D=M
+      0x4000, 0xE0A0, 0xEE88,             // @SCREEN  A=D+A  M=-1
+      0x6000, 0xFC10, 0x000E, 0xE305,     // @KBD D=M  @14  D;JNE             (release)
+      0x0000, 0xEA87,                     // @0   0;JMP
+      0x0014, 0xEA87                      // @20  0;JMP                       (end)
+   };
+
+   // RAM[key] = 1 for a single key, then halts
+   auto const pointer = std::vector<std::uint16_t>{ 0x6000, 0xFC10, 0xE320, 0xEFC8, 0x0004, 0xEA87 };
+}
+
+
+TEST_CASE( "Explorer: a program with few states is explored to the end" )
+{
+   using Hack::Explorer;
+
+   auto computer = Hack::Computer();
+
+   computer.load_rom( toggle );
+
+   auto const threads = GENERATE( 1u, 4u );
+
+   SECTION( "without findings" )
+   {
+      auto const report = Explorer( Explorer::Options{ { 0, 'A', 'Q' }, threads } ).explore( computer );
+
+      REQUIRE( report.complete );
+      REQUIRE( report.findings.empty() );
+      REQUIRE( report.statistics.truncated == 0 );
+      REQUIRE( report.statistics.halted > 0 );
+      REQUIRE( report.statistics.duplicates > 0 );
+      REQUIRE( report.statistics.transitions == 1 + 3 * report.statistics.states );
+
+      // explored from a fork, the computer has not run
+      REQUIRE( computer.instruction_count() == 0 );
+
+      // the same states on any number of threads
+      auto const single = Explorer( Explorer::Options{ { 0, 'A', 'Q' }, 1 } ).explore( computer );
+
+      REQUIRE( single.statistics.states       == report.statistics.states );
+      REQUIRE( single.statistics.transitions  == report.statistics.transitions );
+      REQUIRE( single.statistics.halted       == report.statistics.halted );
+      REQUIRE( single.statistics.instructions == report.statistics.instructions );
+   }
+
+   SECTION( "writes below the screen are found with the keys that make them" )
+   {
+      computer.add_watchpoint( 0x3FFF, 0x3FFF );
+
+      auto const report = Explorer( Explorer::Options{ { 0, 'A', 'Q' }, threads } ).explore( computer );
+
+      REQUIRE( report.complete );
+      REQUIRE( report.findings.size() == 1 );
+      REQUIRE( report.findings[0].reason == Hack::Computer::Stop_Reason::Watchpoint );
+      REQUIRE( report.findings[0].pc == 14 );
+      REQUIRE( report.findings[0].watch_hit );
+      REQUIRE( report.findings[0].watch_hit->address == 0x3FFF );
+      REQUIRE( report.findings[0].keys == std::vector<std::uint16_t>{ 'A' } );
+   }
+}
+
+
+TEST_CASE( "Explorer: limits leave the exploration incomplete" )
+{
+   using Hack::Explorer;
+
+   auto computer = Hack::Computer();
+
+   SECTION( "keys on a path" )
+   {
+      computer.load_rom( typing );
+
+      auto options = Explorer::Options{ { 0, 'A' }, 2 };
+
+      options.max_depth = 5;
+
+      auto const report = Explorer( options ).explore( computer );
+
+      REQUIRE_FALSE( report.complete );
+      REQUIRE( report.statistics.truncated > 0 );
+      REQUIRE( report.statistics.depth == 4 );
+   }
+
+   SECTION( "instructions between reads" )
+   {
+      computer.load_rom( counting );
+
+      auto options = Explorer::Options{ { 0 }, 1 };
+
+      options.step_budget = 1'000;
+
+      auto const report = Explorer( options ).explore( computer );
+
+      REQUIRE_FALSE( report.complete );
+      REQUIRE( report.statistics.truncated == 1 );
+      REQUIRE( report.statistics.instructions == 1'000 );
+   }
+}
+
+
+TEST_CASE( "Explorer: faults are findings" )
+{
+   using Hack::Explorer;
+
+   auto computer = Hack::Computer();
+
+   computer.load_rom( pointer );
+
+   auto const report = Explorer( Explorer::Options{ { 0, 5, 30'000 }, 2 } ).explore( computer );
+
+   REQUIRE( report.complete );
+   REQUIRE( report.statistics.halted == 2 );
+   REQUIRE( report.findings.size() == 1 );
+   REQUIRE( report.findings[0].reason == Hack::Computer::Stop_Reason::Memory_Out_Of_Range );
+   REQUIRE( report.findings[0].pc == 3 );
+   REQUIRE( report.findings[0].keys == std::vector<std::uint16_t>{ 30'000 } );
+}
+
+
+TEST_CASE( "Explorer: the hash of a state" )
+{
+   using Hack::Explorer;
+
+   auto first  = Hack::Computer();
+   auto second = Hack::Computer();
+
+   first.RAM()[100]  = 7;
+   second.RAM()[100] = 7;
+
+   REQUIRE( Explorer::hash( first ) == Explorer::hash( second ) );
+
+   // the keyboard is not part of the state
+   second.keyboard() = 'A';
+
+   REQUIRE( Explorer::hash( first ) == Explorer::hash( second ) );
+
+   second.RAM()[16'383] = 1;
+
+   REQUIRE_FALSE( Explorer::hash( first ) == Explorer::hash( second ) );
+
+   second.RAM()[16'383] = 0;
+   second.D_Register()  = 1;
+
+   REQUIRE_FALSE( Explorer::hash( first ) == Explorer::hash( second ) );
+
+   second.D_Register() = 0;
+   second.pc()         = 1;
+
+   REQUIRE_FALSE( Explorer::hash( first ) == Explorer::hash( second ) );
+}
@@ -0,0 +1,333 @@
+/**
+ * @file    Scheduler.cpp
+ * @author  William Weston
+ * @brief   Runs many Hack machines in quanta on worker threads that steal work from each other
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Scheduler.h"
+
+#include <algorithm>            // for max, min
+#include <atomic>               // for atomic, memory_order_acquire, memory_order_release
+#include <condition_variable>   // for condition_variable
+#include <deque>                // for deque
+#include <memory>               // for make_unique, unique_ptr
+#include <mutex>                // for mutex, scoped_lock, unique_lock
+#include <optional>             // for optional
+#include <thread>               // for jthread, thread
+#include <utility>              // for move
+
+
+namespace
+{
+   using Clock              = Hack::Scheduler::Clock;
+   using Machine_Statistics = Hack::Scheduler::Machine_Statistics;
+   using Worker_Statistics  = Hack::Scheduler::Worker_Statistics;
+
+   // a job, and once it has started the computer it runs on
+   struct Machine
+   {
+      std::size_t                     job;
+      std::unique_ptr<Hack::Computer> computer{};     // nullptr while the job is pending
+      std::uint64_t                   budget{ 0 };
+      std::uint64_t                   executed{ 0 };
+      unsigned                        worker{ 0 };    // that ran its last slice
+      Machine_Statistics              statistics{};
+   };
+
+   // the deques are shared with thieves, the rest belongs to the worker's own thread
+   struct alignas( 64 ) Worker
+   {
+      std::mutex              mutex{};
+      std::deque<std::size_t> pending{};
+      std::deque<Machine>     suspended{};
+
+      std::vector<std::unique_ptr<Hack::Computer>> spare{};     // left by the machines it finished
+      Worker_Statistics                            statistics{};
+   };
+
+   auto since( Clock::time_point start, Clock::time_point end ) -> std::chrono::nanoseconds
+   {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>( end - start );
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+auto
+Hack::Scheduler::Statistics::utilisation() const noexcept -> double
+{
+   if ( workers.empty() || wall.count() == 0 )
+   {
+      return 0.0;
+   }
+
+   auto busy = std::chrono::nanoseconds{ 0 };
+
+   for ( auto const& worker : workers )
+   {
+      busy += worker.busy;
+   }
+
+   return static_cast<double>( busy.count() ) / ( static_cast<double>( wall.count() ) * static_cast<double>( workers.size() ) );
+}
+
+
+Hack::Scheduler::Scheduler( Options options )
+   : options_( options )
+{}
+
+
+/**
+ * @brief   Run every job to the end
+ *
+ * @param jobs        the number of jobs
+ * @param start       called on a worker before the first slice of each job
+ * @param finish      called on a worker after the last slice of each job, must not throw
+ * @return Statistics how busy each worker was
+ *
+ *    A job ends when its budget is spent, when a slice stops for another reason than its quantum,
+ *    or when start or a slice throws.
+ */
+auto
+Hack::Scheduler::run( std::size_t jobs, Start const& start, Finish const& finish ) const -> Statistics
+{
+   auto const count    = threads();
+   auto const quantum  = std::max<std::uint64_t>( options_.quantum, 1 );
+   auto const resident = std::max<std::size_t>( options_.resident, 1 );
+   auto       workers  = std::vector<Worker>( count );
+   auto       running  = std::atomic<std::size_t>{ jobs };     // jobs not yet finished
+
+   // workers that find nothing to run sleep until a machine is suspended or the last job finishes
+   auto idle      = std::mutex();
+   auto wake      = std::condition_variable();
+   auto published = std::atomic<std::uint64_t>{ 0 };           // suspensions and the end of the batch
+   auto sleeping  = std::atomic<unsigned>{ 0 };
+
+   for ( auto worker = 0uz; worker != count; ++worker )
+   {
+      for ( auto job = worker * jobs / count; job != ( worker + 1 ) * jobs / count; ++job )
+      {
+         workers[worker].pending.push_back( job );
+      }
+   }
+
+   // own suspended machines in turn, a pending job while few are suspended, then another worker's
+   auto const next = [&workers, count, resident]( unsigned self ) -> std::optional<Machine>
+   {
+      {
+         auto& own  = workers[self];
+         auto  lock = std::scoped_lock( own.mutex );
+
+         if ( !own.pending.empty() && own.suspended.size() < resident )
+         {
+            auto const job = own.pending.front();
+
+            own.pending.pop_front();
+            return Machine{ job };
+         }
+
+         if ( !own.suspended.empty() )
+         {
+            auto machine = std::move( own.suspended.front() );
+
+            own.suspended.pop_front();
+            return machine;
+         }
+      }
+
+      for ( auto const pending : { true, false } )
+      {
+         for ( auto offset = 1u; offset != count; ++offset )
+         {
+            auto& victim = workers[( self + offset ) % count];
+            auto  lock   = std::scoped_lock( victim.mutex );
+
+            if ( pending && !victim.pending.empty() )
+            {
+               auto const job = victim.pending.back();
+
+               victim.pending.pop_back();
+               ++workers[self].statistics.steals;
+               return Machine{ job };
+            }
+
+            if ( !pending && !victim.suspended.empty() )
+            {
+               auto machine = std::move( victim.suspended.front() );
+
+               victim.suspended.pop_front();
+               ++workers[self].statistics.steals;
+               return machine;
+            }
+         }
+      }
+
+      return std::nullopt;
+   };
+
+   // wake sleepers once work is published: a worker about to sleep either sees the new count or is
+   // already counted in sleeping, and taking the lock waits for it to be inside wait()
+   auto const publish = [&idle, &wake, &published, &sleeping]( bool all )
+   {
+      published.fetch_add( 1 );
+
+      if ( sleeping.load() != 0 )
+      {
+         {
+            auto lock = std::scoped_lock( idle );
+         }
+
+         if ( all )
+         {
+            wake.notify_all();
+         }
+         else
+         {
+            wake.notify_one();
+         }
+      }
+   };
+
+   auto const batch_start = Clock::now();
+
+   auto const body = [&]( unsigned self )
+   {
+      auto& worker = workers[self];
+
+      while ( running.load( std::memory_order_acquire ) != 0 )
+      {
+         auto const looked = Clock::now();
+         auto const seen   = published.load();
+         auto       found  = next( self );
+
+         if ( !found )
+         {
+            auto lock = std::unique_lock( idle );
+
+            sleeping.fetch_add( 1 );
+            wake.wait( lock, [&] { return published.load() != seen || running.load( std::memory_order_acquire ) == 0; } );
+            sleeping.fetch_sub( 1 );
+
+            worker.statistics.idle += since( looked, Clock::now() );
+            continue;
+         }
+
+         auto const now = Clock::now();
+
+         worker.statistics.idle += since( looked, now );
+
+         auto& machine = *found;
+         auto  error   = std::exception_ptr();
+         auto  reason  = Computer::Stop_Reason::Budget;
+
+         if ( !machine.computer )
+         {
+            if ( worker.spare.empty() )
+            {
+               machine.computer = std::make_unique<Computer>();
+            }
+            else
+            {
+               machine.computer = std::move( worker.spare.back() );
+               worker.spare.pop_back();
+            }
+
+            machine.statistics.started = since( batch_start, now );
+
+            try
+            {
+               machine.budget = start( machine.job, *machine.computer );
+            }
+            catch ( ... )
+            {
+               error = std::current_exception();
+            }
+         }
+         else if ( machine.worker != self )
+         {
+            ++machine.statistics.migrations;
+         }
+
+         if ( !error )
+         {
+            try
+            {
+               auto const result = machine.computer->run( std::min( quantum, machine.budget - machine.executed ) );
+
+               machine.executed += result.executed;
+               reason            = result.reason;
+            }
+            catch ( ... )
+            {
+               error = std::current_exception();
+            }
+         }
+
+         auto const end = Clock::now();
+
+         machine.worker = self;
+         ++machine.statistics.slices;
+         machine.statistics.run_time += since( now, end );
+         worker.statistics.busy      += since( now, end );
+         ++worker.statistics.slices;
+
+         if ( error || reason != Computer::Stop_Reason::Budget || machine.executed >= machine.budget )
+         {
+            machine.statistics.finished = since( batch_start, end );
+
+            finish( machine.job, *machine.computer, Outcome{ { reason, machine.executed }, error, machine.statistics } );
+            worker.spare.push_back( std::move( machine.computer ) );
+
+            if ( running.fetch_sub( 1, std::memory_order_release ) == 1 )
+            {
+               publish( true );
+            }
+         }
+         else
+         {
+            {
+               auto lock = std::scoped_lock( worker.mutex );
+
+               worker.suspended.push_back( std::move( machine ) );
+            }
+
+            publish( false );
+         }
+      }
+   };
+
+   {
+      auto pool = std::vector<std::jthread>();
+
+      pool.reserve( count - 1 );
+
+      for ( auto self = 1u; self != count; ++self )
+      {
+         pool.emplace_back( body, self );
+      }
+
+      body( 0u );
+   }
+
+   auto statistics = Statistics{ since( batch_start, Clock::now() ), {} };
+
+   for ( auto const& worker : workers )
+   {
+      statistics.workers.push_back( worker.statistics );
+   }
+
+   return statistics;
+}
+
+
+auto
+Hack::Scheduler::threads() const noexcept -> unsigned
+{
+   return options_.threads != 0 ? options_.threads : std::max( std::thread::hardware_concurrency(), 1u );
+}
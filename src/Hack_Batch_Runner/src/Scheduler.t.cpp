@@ -0,0 +1,180 @@
+/**
+ * @file    Scheduler.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Scheduler.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Scheduler.h"
+
+#include "Hack/Computer.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>          // runtime_error
+#include <vector>
+
+
+namespace
+{
+   using Hack::Test_Programs::multiply;
+
+   struct Job_Result
+   {
+      std::uint16_t                       product{ 0 };
+      Hack::Computer::Run_Result          result{ Hack::Computer::Stop_Reason::Budget, 0 };
+      Hack::Scheduler::Machine_Statistics statistics{};
+      bool                                failed{ false };
+      int                                 finished{ 0 };
+   };
+}
+
+
+TEST_CASE( "Scheduler: every job runs to the end once" )
+{
+   using namespace Hack;
+
+   // a few jobs loop thousands of times, most only a few
+   auto const factor = []( std::size_t job ) { return static_cast<std::uint16_t>( job % 50 == 0 ? 5'000 : job % 7 ); };
+
+   auto const jobs      = 400uz;
+   auto const threads   = GENERATE( 1u, 4u );
+   auto const quantum   = GENERATE( std::uint64_t{ 100 }, Scheduler::default_quantum );
+   auto const scheduler = Scheduler( Scheduler::Options{ threads, quantum } );
+
+   auto results = std::vector<Job_Result>( jobs );
+
+   auto const start = [&factor]( std::size_t job, Computer& computer ) -> std::uint64_t
+   {
+      computer.load_rom( multiply );
+      computer.reset();
+      computer.RAM()[0] = factor( job );
+      computer.RAM()[1] = 3;
+
+      return 1'000'000;
+   };
+
+   auto const finish = [&results]( std::size_t job, Computer& computer, Scheduler::Outcome const& outcome )
+   {
+      results[job].product    = computer.RAM()[2];
+      results[job].result     = outcome.result;
+      results[job].statistics = outcome.statistics;
+      results[job].failed     = outcome.error != nullptr;
+      ++results[job].finished;
+   };
+
+   auto const statistics = scheduler.run( jobs, start, finish );
+
+   REQUIRE( scheduler.threads() == threads );
+   REQUIRE( statistics.workers.size() == threads );
+   REQUIRE( statistics.utilisation() > 0.0 );
+   REQUIRE( statistics.utilisation() <= 1.0 );
+
+   auto slices = std::uint64_t{ 0 };
+
+   for ( auto job = 0uz; job != jobs; ++job )
+   {
+      INFO( job );
+      REQUIRE( results[job].finished == 1 );
+      REQUIRE_FALSE( results[job].failed );
+      REQUIRE( results[job].result.reason == Computer::Stop_Reason::Halted );
+      REQUIRE( results[job].product == static_cast<std::uint16_t>( factor( job ) * 3 ) );
+      REQUIRE( results[job].statistics.started <= results[job].statistics.finished );
+
+      slices += results[job].statistics.slices;
+   }
+
+   auto worker_slices = std::uint64_t{ 0 };
+
+   for ( auto const& worker : statistics.workers )
+   {
+      worker_slices += worker.slices;
+   }
+
+   REQUIRE( slices == worker_slices );
+
+   // a long job takes 9 instructions a loop
+   REQUIRE( results[0].statistics.slices == ( quantum == 100 ? ( results[0].result.executed + 99 ) / 100 : 1u ) );
+   REQUIRE( results[1].statistics.slices == 1 );
+}
+
+
+TEST_CASE( "Scheduler: idle workers steal from busy ones" )
+{
+   using namespace Hack;
+
+   // the jobs of the first worker are long, the others have nothing to do
+   auto const jobs      = 8uz;
+   auto const scheduler = Scheduler( Scheduler::Options{ 4, 1'000 } );
+   auto       finished  = std::atomic<int>{ 0 };
+
+   auto const start = []( std::size_t job, Computer& computer ) -> std::uint64_t
+   {
+      computer.load_rom( multiply );
+      computer.reset();
+      computer.RAM()[0] = job < 2 ? std::uint16_t{ 20'000 } : std::uint16_t{ 1 };
+      computer.RAM()[1] = 1;
+
+      return 1'000'000;
+   };
+
+   auto const finish = [&finished]( std::size_t, Computer&, Scheduler::Outcome const& )
+   {
+      ++finished;
+   };
+
+   auto const statistics = scheduler.run( jobs, start, finish );
+   auto       steals     = std::uint64_t{ 0 };
+
+   for ( auto const& worker : statistics.workers )
+   {
+      steals += worker.steals;
+   }
+
+   REQUIRE( finished == 8 );
+   REQUIRE( steals > 0 );
+}
+
+
+TEST_CASE( "Scheduler: a job that throws ends with its error" )
+{
+   using namespace Hack;
+
+   auto const scheduler = Scheduler( Scheduler::Options{ 2 } );
+   auto       results   = std::vector<Job_Result>( 3 );
+
+   auto const start = []( std::size_t job, Computer& computer ) -> std::uint64_t
+   {
+      if ( job == 1 )
+      {
+         throw std::runtime_error( "no program" );
+      }
+
+      computer.load_rom( multiply );
+      computer.reset();
+
+      return 100;
+   };
+
+   auto const finish = [&results]( std::size_t job, Computer&, Scheduler::Outcome const& outcome )
+   {
+      results[job].failed = outcome.error != nullptr;
+      results[job].result = outcome.result;
+      ++results[job].finished;
+   };
+
+   scheduler.run( 3, start, finish );
+
+   REQUIRE( results[1].failed );
+   REQUIRE( results[1].result.executed == 0 );
+   REQUIRE_FALSE( results[0].failed );
+   REQUIRE_FALSE( results[2].failed );
+   REQUIRE( results[0].finished + results[1].finished + results[2].finished == 3 );
+}
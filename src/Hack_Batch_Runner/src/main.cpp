@@ -0,0 +1,208 @@
+/**
+ * @file    main.cpp
+ * @author  William Weston
+ * @brief   Command line front end of the Batch_Runner
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Usage:  Hack_Batch_Runner_CLI <manifest> [-o <results>] [-j <threads>] [-q <quantum>] [--engine <engine>]
+ *                                  [--cache <directory>] [--stats <file>]
+ *
+ *    Runs the tasks of the manifest, see Batch_Runner.h, and writes their results to standard
+ *    output unless -o is given.  engine is interpreter, threaded, jit or tiered, the default.
+ *    quantum is the instructions a task runs before another may take its worker, see Scheduler.h,
+ *    and --stats writes how each task was scheduled.  A summary goes to standard error.  The exit
+ *    status is a failure only when the manifest cannot be read or the results cannot be written,
+ *    a task's errors are in its result.
+ */
+#include "Hack/Batch_Runner.h"              // for Batch_Runner
+
+#include <algorithm>                        // for count_if
+#include <charconv>                         // for from_chars
+#include <chrono>                           // for steady_clock, duration
+#include <cstdint>                          // for uint64_t
+#include <cstdlib>                          // for EXIT_SUCCESS, EXIT_FAILURE
+#include <exception>                        // for exception
+#include <fstream>                          // for ofstream
+#include <iostream>                         // for cout, cerr
+#include <optional>                         // for optional
+#include <span>                             // for span
+#include <stdexcept>                        // for runtime_error
+#include <string>                           // for string
+#include <string_view>                      // for string_view
+
+
+namespace
+{
+   constexpr auto usage = "usage: Hack_Batch_Runner_CLI <manifest> [-o <results>] [-j <threads>] [-q <quantum>] "
+                          "[--engine interpreter|threaded|jit|tiered] [--cache <directory>] [--stats <file>]\n";
+
+   auto parse_engine( std::string_view name ) -> std::optional<Hack::Computer::Engine>
+   {
+      using Engine = Hack::Computer::Engine;
+
+      if ( name == "interpreter" ) { return Engine::Interpreter; }
+      if ( name == "threaded" )    { return Engine::Threaded; }
+      if ( name == "jit" )         { return Engine::JIT; }
+      if ( name == "tiered" )      { return Engine::Tiered; }
+
+      return std::nullopt;
+   }
+
+   // a count greater than 0
+   template <typename Integer>
+   auto parse_count( std::string_view text ) -> std::optional<Integer>
+   {
+      auto       value  = Integer{ 0 };
+      auto const* last  = text.data() + text.size();
+      auto const result = std::from_chars( text.data(), last, value );
+
+      if ( result.ec != std::errc() || result.ptr != last || value == 0 )
+      {
+         return std::nullopt;
+      }
+
+      return value;
+   }
+}
+
+
+auto main( int argc, char* argv[] ) -> int
+{
+   auto const args = std::span( argv, static_cast<std::size_t>( argc ) );
+
+   auto manifest = std::string();
+   auto output   = std::string();
+   auto stats    = std::string();
+   auto options  = Hack::Batch_Runner::Options{ 0, Hack::Computer::Engine::Tiered, std::nullopt };
+
+   for ( auto arg = 1zu; arg < args.size(); ++arg )
+   {
+      auto const current   = std::string_view( args[arg] );
+      auto const has_value = arg + 1 < args.size();
+
+      if ( current == "-o" && has_value )
+      {
+         output = args[++arg];
+      }
+      else if ( current == "-j" && has_value )
+      {
+         auto const threads = parse_count<unsigned>( args[++arg] );
+
+         if ( !threads )
+         {
+            std::cerr << usage;
+            return EXIT_FAILURE;
+         }
+
+         options.threads = *threads;
+      }
+      else if ( current == "-q" && has_value )
+      {
+         auto const quantum = parse_count<std::uint64_t>( args[++arg] );
+
+         if ( !quantum )
+         {
+            std::cerr << usage;
+            return EXIT_FAILURE;
+         }
+
+         options.quantum = *quantum;
+      }
+      else if ( current == "--engine" && has_value )
+      {
+         auto const engine = parse_engine( args[++arg] );
+
+         if ( !engine )
+         {
+            std::cerr << usage;
+            return EXIT_FAILURE;
+         }
+
+         options.engine = *engine;
+      }
+      else if ( current == "--cache" && has_value )
+      {
+         options.cache = args[++arg];
+      }
+      else if ( current == "--stats" && has_value )
+      {
+         stats = args[++arg];
+      }
+      else if ( manifest.empty() && !current.starts_with( '-' ) )
+      {
+         manifest = current;
+      }
+      else
+      {
+         std::cerr << usage;
+         return EXIT_FAILURE;
+      }
+   }
+
+   if ( manifest.empty() )
+   {
+      std::cerr << usage;
+      return EXIT_FAILURE;
+   }
+
+   try
+   {
+      auto const runner     = Hack::Batch_Runner( options );
+      auto const tasks      = Hack::Batch_Runner::load_manifest( manifest );
+      auto       statistics = Hack::Scheduler::Statistics();
+      auto const start      = std::chrono::steady_clock::now();
+      auto const results    = runner.run( tasks, statistics );
+      auto const seconds    = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+      if ( output.empty() )
+      {
+         Hack::Batch_Runner::write_results( std::cout, tasks, results );
+      }
+      else
+      {
+         Hack::Batch_Runner::save_results( output, tasks, results );
+      }
+
+      if ( !stats.empty() )
+      {
+         auto file = std::ofstream( stats, std::ios::trunc );
+
+         Hack::Batch_Runner::write_statistics( file, results );
+         file.close();
+
+         if ( !file )
+         {
+            throw std::runtime_error( "Could not write batch statistics " + stats );
+         }
+      }
+
+      auto instructions = std::uint64_t{ 0 };
+      auto steals       = std::uint64_t{ 0 };
+
+      for ( auto const& result : results )
+      {
+         instructions += result.instructions;
+      }
+
+      for ( auto const& worker : statistics.workers )
+      {
+         steals += worker.steals;
+      }
+
+      auto const errors = std::ranges::count_if( results, []( auto const& result ) { return !result.reason; } );
+
+      std::cerr << tasks.size() << " tasks, " << errors << " errors, " << instructions << " instructions in "
+                << seconds << " s on " << runner.threads() << " threads, "
+                << statistics.utilisation() * 100.0 << "% busy, " << steals << " steals\n";
+   }
+   catch ( std::exception const& error )
+   {
+      std::cerr << error.what() << '\n';
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -20,6 +20,9 @@
 #include "Hack/Disassembler.h"                // for Disassembler
 #include "Hack/Memory.h"                      // for Memory
 #include "Hack/Computer.h"                    // for Computer
+#include "Hack/Keyboard_Log.h"                // for Keyboard_Log
+#include "Hack/ROM_Cache.h"                   // for ROM_Cache
+#include "Hack/ROM_Image.h"                   // for ROM_Image
 #include "Hack/Utilities/exceptions.hpp"      // for operator<<, ParseErrorData
 #include "Hack/Utilities/utilities.hpp"       // for binary_to_uint16, signe...
 #include "GUI_Core/GUI_Frame.h"               // for GUI_Frame
@@ -31,16 +34,17 @@
 #include <imgui_impl_sdl2.h>                  // for ImGui_ImplSDL2_ProcessE...
 #include <imgui_stdlib.h>                     // for InputText
 #include <SDL_scancode.h>                     // for SDL_SCANCODE_0, SDL_SCA...
-#include <SDL_events.h>                       // for SDL_PollEvent, SDL_KEYDOWN
+#include <SDL_events.h>                       // for SDL_PollEvent, SDL_WaitEventTimeout, SDL_KEYDOWN
 #include <SDL_log.h>                          // for SDL_Log
 #include <algorithm>                          // for max
 #include <cstdint>                            // for uint16_t
 #include <exception>                          // for exception
+#include <filesystem>                         // for is_regular_file, path
 #include <iostream>                           // for basic_ostream, operator<<
-#include <stdexcept>                          // for out_of_range
+#include <stdexcept>                          // for out_of_range, runtime_error
 #include <string>                             // for allocator, operator+
 #include <string_view>                        // for string_view
-#include <utility>                            // for move
+#include <utility>                            // for as_const, move
 #include <vector>                             // for vector
 
 
@@ -59,7 +63,23 @@ namespace
 Hack::Emulator::Emulator( std::string_view title, int width, int height, bool fullscreen )
    :  core_( title, width, height, fullscreen ),
       screen_texture_( computer_.screen_cbegin(), computer_.screen_cend(), core_.renderer() )
-{}
+{
+   // short programs stay in the interpreter, long simulations promote their hot loops
+   computer_.set_engine( Computer::Engine::Tiered );
+
+   // reopening a program maps its cached image instead of assembling it again
+   if ( auto const directory = ROM_Cache::default_directory() )
+   {
+      try
+      {
+         rom_cache_.emplace( *directory );
+      }
+      catch ( std::runtime_error const& error )
+      {
+         std::cerr << "ROM cache disabled: " << error.what() << '\n';
+      }
+   }
+}
 
 
 auto
@@ -105,28 +125,7 @@ Hack::Emulator::run() -> void
       {
          std::cerr << error.what() << '\n';
 
-         auto error_msg = std::string();
-   
-         if ( computer_.pc() >= Computer::ROM_SIZE )
-         {
-            error_msg = "Illegal Memory Access to ROM at address: " + std::to_string( computer_.pc() ) + "\n" 
-                      + "Stopping Hack Program";
-         }
-         else if( computer_.A_Register() >= Computer::RAM_SIZE )
-         {
-            error_msg = "Illegal Memory Access to RAM at address: " + std::to_string( computer_.A_Register() ) + "\n"
-                      + "Stopping Hack Program";
-         }
-         else
-         {
-            error_msg = "Out of bounds";
-         }
-
-         user_error_ = UserError{ "Out of Range Error", std::move( error_msg ), true };
-
-         play_ = false;
-         step_ = false;
-         computer_.reset();
+         report_out_of_range();
       }
       catch( std::exception const& error )
       {
@@ -142,6 +141,13 @@ Hack::Emulator::run() -> void
 auto
 Hack::Emulator::handle_events() -> void
 {
+   // a halted program has nothing left to show, sleep until there is input instead of redrawing
+   // every frame
+   if ( !play_ && !step_ && computer_.status() == Computer::Status::Halted )
+   {
+      SDL_WaitEventTimeout( nullptr, idle_timeout_ms );
+   }
+
    SDL_Event event;
    while ( SDL_PollEvent( &event ) )
    {
@@ -172,6 +178,9 @@ Hack::Emulator::handle_events() -> void
    }
 
    handle_keyboard_events();
+
+   // a key changes between runs, so the instruction count places it exactly for replay()
+   keyboard_log_.record( computer_ );
 }
 
 
@@ -837,6 +846,17 @@ Hack::Emulator::handle_keyboard_events() -> void
 auto 
 Hack::Emulator::open_file( std::string const& path )  -> void
 {
+   keyboard_log_.clear();
+
+   if ( rom_cache_ && std::filesystem::is_regular_file( path ) && ( path.ends_with( ".hack" ) || path.ends_with( ".asm" ) ) )
+   {
+      auto const image = rom_cache_->open( path );
+
+      computer_.clear();
+      computer_.load_rom( image.rom(), image.decoded() );
+      return;
+   }
+
    auto data = [&path] 
    {
       if ( path.ends_with( ".hack" ) )
@@ -863,6 +883,13 @@ Hack::Emulator::update_Hack_Computer()       -> void
 {
    // ImGui operates at the monitor refresh rate with vsync enabled
    //std::cerr << "FPS: " << ImGui::GetIO().Framerate << '\n'; 
+   if ( step_back_ )
+   {
+      play_      = false;
+      step_back_ = false;
+      computer_.rewind( 1 );
+   }
+
    if ( play_ || step_ )
    {
       if ( computer_.pc() > Hack::Computer::ROM_SIZE )
@@ -888,29 +915,94 @@ Hack::Emulator::update_Hack_Computer()       -> void
             }
             else
             {
-               computer_.execute();
+               run_Hack_Computer( 1 );
                count = 0;
             }
          }
          else
          {
-            auto const instructions = static_cast<int>( speed_ / FPS );
+            auto const instructions = static_cast<std::uint64_t>( speed_ / FPS );
             
-            for ( auto cnt = 0; cnt < instructions; ++cnt )
-            {
-               computer_.execute();
-            }
+            run_Hack_Computer( instructions );
          }
       }
       else if ( step_ )
       {
-         computer_.execute();
+         run_Hack_Computer( 1 );
          step_ = false;
       }
    }
 }
 
 
+auto 
+Hack::Emulator::run_Hack_Computer( std::uint64_t instructions ) -> void
+{
+   using Stop_Reason = Computer::Stop_Reason;
+
+   switch ( computer_.run( instructions ).reason )
+   {
+      case Stop_Reason::Budget:
+      case Stop_Reason::Predicate:
+      case Stop_Reason::Deadline:
+      case Stop_Reason::Keyboard_Wait:
+         break;
+
+      case Stop_Reason::Halted:
+         play_ = false;
+         break;
+
+      case Stop_Reason::Breakpoint:
+         play_         = false;
+         stop_message_ = "Breakpoint at " + std::to_string( computer_.pc() );
+         break;
+
+      case Stop_Reason::Watchpoint:
+      {
+         auto const& hit = *computer_.watch_hit();
+
+         play_         = false;
+         stop_message_ = std::string( hit.access == Computer::Access::Read ? "Read" : "Write" ) + " of RAM[" +
+                         std::to_string( hit.address ) + "] at " + std::to_string( hit.pc );
+         break;
+      }
+
+      case Stop_Reason::PC_Out_Of_ROM:
+      case Stop_Reason::Memory_Out_Of_Range:
+         report_out_of_range();
+         break;
+   }
+}
+
+
+auto 
+Hack::Emulator::report_out_of_range() -> void
+{
+   auto error_msg = std::string();
+
+   if ( computer_.pc() >= Computer::ROM_SIZE )
+   {
+      error_msg = "Illegal Memory Access to ROM at address: " + std::to_string( computer_.pc() ) + "\n" 
+                + "Stopping Hack Program";
+   }
+   else if( computer_.A_Register() >= Computer::RAM_SIZE )
+   {
+      error_msg = "Illegal Memory Access to RAM at address: " + std::to_string( computer_.A_Register() ) + "\n"
+                + "Stopping Hack Program";
+   }
+   else
+   {
+      error_msg = "Out of bounds";
+   }
+
+   user_error_ = UserError{ "Out of Range Error", std::move( error_msg ), true };
+
+   play_ = false;
+   step_ = false;
+   computer_.reset();
+}
+
+
 auto 
 Hack::Emulator::update_GUI_interface() -> void
 {
@@ -1024,6 +1116,21 @@ Hack::Emulator::menu_bar() -> void
             config.path   = "../";
             ImGuiFileDialog::Instance()->OpenDialog( "ChooseFileDlgKey", "Open File", ".hack,.asm,.*", config );
          }
+
+         // program.keys next to program.asm, for replay() by headless runs
+         if ( ImGui::MenuItem( " Save Keyboard Log", nullptr, false, !current_file_.empty() && !keyboard_log_.empty() ) )
+         {
+            auto path = std::filesystem::path( current_file_ );
+
+            try
+            {
+               keyboard_log_.save( path.replace_extension( ".keys" ) );
+            }
+            catch ( std::runtime_error const& error )
+            {
+               user_error_ = UserError{ "File Error", error.what(), true };
+            }
+         }
       }
 
       with_Menu( "Edit" )
@@ -1077,13 +1184,24 @@ Hack::Emulator::command_GUI() -> main_options
       ImGui::SameLine();
       if ( ImGui::Button( "Step" ) )
       {
-         step_  = true;
+         step_         = true;
+         stop_message_.clear();
+      }
+
+      // undoes the last instruction recorded while Record is checked
+      ImGui::SameLine();
+      ImGui::BeginDisabled( computer_.journal_depth() == 0 );
+      if ( ImGui::Button( "Step Back" ) )
+      {
+         step_back_ = true;
       }
+      ImGui::EndDisabled();
 
       ImGui::SameLine();
       if ( ImGui::Button( "Play" ) )
       {
-         play_ = true;
+         play_         = true;
+         stop_message_.clear();
       }
 
       ImGui::SameLine();
@@ -1108,6 +1226,21 @@ Hack::Emulator::command_GUI() -> main_options
       ImGui::PushItemWidth( 200 );
       ImGui::SliderFloat( "##Speed", &speed_, 0.3F, 5'000'000.0F, "%.1f", ImGuiSliderFlags_Logarithmic );
       ImGui::PopItemWidth();
+
+      // recording runs every instruction through the interpreter, so it is off until asked for
+      ImGui::SameLine();
+      auto record = computer_.journal_enabled();
+      if ( ImGui::Checkbox( "Record", &record ) )
+      {
+         record ? computer_.enable_journal() : computer_.disable_journal();
+      }
+
+      // why the last run stopped before the program ended
+      if ( !stop_message_.empty() )
+      {
+         ImGui::SameLine();
+         ImGui::TextUnformatted( stop_message_.c_str() );
+      }
    }
  
    return { track_pc, RAMFormat::DECIMAL };
@@ -1193,10 +1326,20 @@ Hack::Emulator::ROM_GUI( bool highlight_pc ) -> void
 auto
 Hack::Emulator::ROM_Display( ROMFormat const fmt, int const idx ) -> void
 {  
-   static auto& rom      = computer_.ROM();
-   static auto const& pc = computer_.pc();
+   auto const&        rom = std::as_const( computer_ ).ROM();     // not static, the ROM moves when the image is copied
+   static auto const& pc  = computer_.pc();
 
-   auto& instruction = rom[static_cast<Hack::Computer::ROM_t::size_type>( idx )];
+   auto const address     = static_cast<Hack::Computer::ROM_t::size_type>( idx );
+   auto const instruction = rom[address];
+
+   // only an edit takes the ROM for writing, which copies a shared image and redecodes the word
+   auto const store = [this, address, instruction]( Hack::Computer::word_t const value )
+   {
+      if ( value != instruction )
+      {
+         computer_.ROM()[address] = value;
+      }
+   };
 
    switch ( fmt )
    {
@@ -1241,7 +1384,7 @@ Hack::Emulator::ROM_Display( ROMFormat const fmt, int const idx ) -> void
       auto const value_opt = Hack::Utils::binary_to_uint16( *binary_opt );
       if ( value_opt )
       {
-         instruction = *value_opt;
+         store( *value_opt );
       }  
       
       return;
@@ -1269,7 +1412,7 @@ Hack::Emulator::ROM_Display( ROMFormat const fmt, int const idx ) -> void
          ImGui::InputScalar( "##rom", ImGuiDataType_S16, &value );
       }
  
-      instruction = Hack::Utils::signed_to_unsigned_16( value );
+      store( Hack::Utils::signed_to_unsigned_16( value ) );
       
       return;
    }
@@ -1296,7 +1439,7 @@ Hack::Emulator::ROM_Display( ROMFormat const fmt, int const idx ) -> void
          ImGui::InputScalar( "##rom", ImGuiDataType_U16, &value, nullptr, nullptr, "%04X", ImGuiInputTextFlags_CharsUppercase );
       }
     
-      instruction = value;
+      store( value );
     
       return;
    }
@@ -1325,7 +1468,7 @@ Hack::Emulator::ROM_Display( ROMFormat const fmt, int const idx ) -> void
 
       if ( auto const value = Hack::Utils::binary_to_uint16( binary ); value )
       {
-         instruction = *value; 
+         store( *value );
       }
       return;
    }
@@ -1613,7 +1756,7 @@ Hack::Emulator::display_cpu() -> void
 
       am_register = ( from_m_register ) ? computer_.M_Register() : computer_.A_Register();
       d_register  = computer_.D_Register();
-      instruction = computer_.ROM()[computer_.pc()];
+      instruction = std::as_const( computer_ ).ROM()[computer_.pc()];
       update_alu  = true;
    }
 
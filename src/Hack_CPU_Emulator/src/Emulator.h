@@ -20,9 +20,12 @@
 #include <Hack/Assembler.h>     // for Assembler
 #include <Hack/Computer.h>      // for Computer
 #include <Hack/Disassembler.h>  // for Disassembler
+#include <Hack/Keyboard_Log.h>  // for Keyboard_Log
+#include <Hack/ROM_Cache.h>     // for ROM_Cache
 
 #include <SDL_render.h>         // for SDL_Renderer
 #include <SDL_video.h>          // for SDL_Window
+#include <cstdint>              // for uint64_t
 #include <optional>             // for optional
 #include <string>               // for string
 #include <string_view>          // for string_view
@@ -46,6 +49,10 @@ public:
 
 private:
    using UserError_t = std::optional<UserError>;
+   using ROM_Cache_t = std::optional<ROM_Cache>;
+
+   // longest wait for input while the program is halted, keeps the interface responsive to timers
+   static constexpr int idle_timeout_ms = 250;
 
    GUI_Core           core_;
    Computer           computer_{};              // must be initialized before screen_
@@ -53,11 +60,15 @@ private:
    Assembler const    assembler_{};
    Disassembler const disasmblr_{};
    Keyboard_Handler   keyboard_handler_{};
+   Keyboard_Log       keyboard_log_{};          // the keys of the session since the program was opened
    std::string        current_file_{};
+   std::string        stop_message_{};          // the breakpoint or watchpoint that stopped the program
+   ROM_Cache_t        rom_cache_{};             // std::nullopt when there is no cache directory
    UserError_t        user_error_{};
    float              speed_{ 0.33F };            // instructions per second to execute on Hack Computer
    bool               play_{ false };             // run the program in the Hack computer ROM
    bool               step_{ false };             // execute the next instruction
+   bool               step_back_{ false };        // undo the last instruction, see Computer::rewind()
    bool               running_{ true };           // is the emulator running
    bool               open_new_file_{ false };
    bool               animating_{ false };
@@ -74,6 +85,8 @@ private:
    auto open_file( std::string const& path )     -> void;
 
    auto update_Hack_Computer()                   -> void;
+   auto run_Hack_Computer( std::uint64_t instructions ) -> void;
+   auto report_out_of_range()                    -> void;
    auto update_GUI_interface()                   -> void;
    
    auto main_window()                            -> void;
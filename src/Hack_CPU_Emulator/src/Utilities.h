@@ -22,12 +22,8 @@
 namespace Hack::EMULATOR::Utils
 {
 
-struct FileError
-{
-   std::string filename;
-};
-
-using file_error                 = Hack::Utils::Exception<FileError>;
+using FileError                  = Hack::Utils::FileErrorData;
+using file_error                 = Hack::Utils::file_error;
 using unsupported_filetype_error = Hack::Utils::Exception<void*>;
 
 auto open_hack_file( std::string const& path ) -> std::vector<std::uint16_t>;
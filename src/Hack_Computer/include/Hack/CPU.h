@@ -47,6 +47,7 @@
 #define HACK_EMULATOR_2024_03_11_CPU_H
 
 
+#include "Decoder.h"
 #include "Memory.h"
 
 #include <cstdint>
@@ -70,10 +71,15 @@ public:
    // returns address of next instruction to execute
    auto execute_instruction( word_t instruction ) -> word_t;
 
+   // M accesses are checked according to Policy, instantiated for each Bounds policy in CPU.cpp
+   template <Bounds::Policy Policy = Bounds::Throwing>
+   auto execute_instruction( Decoded_Instruction const& instruction ) -> word_t;
+
    constexpr auto ALU_Output() const noexcept -> word_t;
    constexpr auto A_Register() const noexcept -> word_t;
    constexpr auto D_Register() const noexcept -> word_t;
    constexpr auto M_Register() const          -> word_t;
+   constexpr auto PC()         const noexcept -> word_t;
 
    constexpr auto A_Register()       noexcept -> word_t&;
    constexpr auto D_Register()       noexcept -> word_t&;
@@ -81,6 +87,8 @@ public:
 
    constexpr auto set_A_Register( word_t value ) noexcept -> void;
    constexpr auto set_D_Register( word_t value ) noexcept -> void;
+   constexpr auto set_PC( word_t value )         noexcept -> void;
+   constexpr auto set_ALU_Output( word_t value ) noexcept -> void;
 
    constexpr auto reset()                        noexcept -> void;
 
@@ -93,6 +101,9 @@ private:
 
    auto do_a_instruction( word_t instruction ) -> word_t;
    auto do_c_instruction( word_t instruction ) -> word_t;
+
+   template <Bounds::Policy Policy>
+   auto do_c_instruction( Decoded_Instruction const& instruction ) -> word_t;
 };
 
 }     // namespace Hack
@@ -133,6 +144,12 @@ Hack::CPU::M_Register() const -> word_t
    return RAM_[A_Register_];
 }
 
+constexpr auto
+Hack::CPU::PC() const noexcept -> word_t
+{
+   return PC_;
+}
+
 constexpr auto
 Hack::CPU::A_Register()       noexcept -> word_t&
 {
@@ -164,6 +181,18 @@ Hack::CPU::set_D_Register( word_t value ) noexcept -> void
    D_Register_ = value;
 }
 
+constexpr auto
+Hack::CPU::set_PC( word_t value ) noexcept -> void
+{
+   PC_ = value;
+}
+
+constexpr auto
+Hack::CPU::set_ALU_Output( word_t value ) noexcept -> void
+{
+   ALU_output_ = value;
+}
+
 constexpr auto
 Hack::CPU::reset()                        noexcept -> void
 {
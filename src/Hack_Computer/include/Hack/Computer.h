@@ -12,13 +12,25 @@
 #define HACK_EMULATOR_2024_03_11_COMPUTER_H
 
 #include "CPU.h"     // for CPU
+#include "Condition.h" // for Condition
+#include "Decoder.h" // for Decoded_Instruction
 #include "Memory.h"  // for Memory
+#include "Shared_ROM.h" // for Shared_ROM
 
 #include <array>     // for array
-#include <concepts>  // for same_as
+#include <chrono>    // for nanoseconds
+#include <concepts>  // for predicate, same_as
 #include <cstdint>   // for uint16_t
+#include <filesystem> // for path
 #include <iterator>  // for input_iterator, iter_value_t, sentinel_for
+#include <limits>    // for numeric_limits
+#include <memory>    // for shared_ptr, unique_ptr
+#include <optional>  // for optional
 #include <span>      // for span
+#include <stdexcept> // for out_of_range
+#include <unordered_map> // for unordered_map
+#include <utility>   // for as_const, move
+#include <vector>    // for vector
 
 namespace Hack
 {
@@ -29,11 +41,15 @@ concept RomIterator =
     std::sentinel_for<I, I> &&
     std::same_as<std::iter_value_t<I>, std::uint16_t>;
 
+class JIT_Engine;
+class Journal;
+class Loop_Idioms;
+class Threaded_Engine;
 
 class Computer final
 {
 public:
-   static constexpr auto ROM_SIZE             = 32'758u;                         // 32K
+   static constexpr auto ROM_SIZE             = Shared_ROM::size;                // 32K
    static constexpr auto RAM_SIZE             = Memory::address_space;           // 16K + 8K + 1 byte
    static constexpr auto screen_start_address = Memory::screen_start_address;
    static constexpr auto screen_end_address   = Memory::screen_end_address;
@@ -41,20 +57,231 @@ public:
    using Screen_iterator       = Memory::Screen_iterator;
    using Screen_const_iterator = Memory::Screen_const_iterator;
    using word_t                = std::uint16_t;
-   using ROM_t                 = std::array<word_t, ROM_SIZE>;
+   using ROM_t                 = Shared_ROM::ROM_t;
+   using Decoded_ROM_t         = Shared_ROM::Decoded_ROM_t;
+
+   // how instructions are executed, every engine produces identical results
+   enum class Engine : std::uint8_t
+   {
+      Interpreter,      // decode table + CPU::execute_instruction
+      Threaded,         // per-instruction handlers specialised on comp/dest/jump
+      JIT,              // native x86-64 basic blocks, interprets where blocks cannot be used
+      Tiered            // interprets, promotes hot blocks to Threaded and then to JIT, and hot loops to bulk operations
+   };
+
+   // the form a block runs in under Engine::Tiered
+   enum class Tier : std::uint8_t
+   {
+      Interpreter,      // cold, every block starts here
+      Predecoded,       // threaded handlers
+      Native,           // JIT compiled
+      Idiom             // a loop run as bulk operations, see Loop_Idioms.h
+   };
+
+   static constexpr auto tier_count = 4uz;
+
+   struct Tier_Statistics
+   {
+      std::array<std::uint64_t, tier_count>            instructions{};   // executed in each tier
+      std::array<std::chrono::nanoseconds, tier_count> time{};           // spent executing in each tier
+      std::array<std::uint64_t, tier_count>            promotions{};     // blocks that entered each tier
+      std::chrono::nanoseconds                         promotion_time{}; // spent building blocks, not part of time
+      std::uint64_t                                    demotions{};      // native blocks and loops dropped after a ROM write
+   };
+
+   // why run() returned
+   enum class Stop_Reason : std::uint8_t
+   {
+      Budget,                 // max_instructions have executed
+      PC_Out_Of_ROM,          // pc does not address ROM
+      Memory_Out_Of_Range,    // an M access does not address RAM, pc holds the failing instruction
+      Halted,                 // pc is where a halt loop starts, (END) @END 0;JMP, which has not executed
+      Breakpoint,             // pc reached a breakpoint, the instruction there has not executed
+      Watchpoint,             // an instruction accessed a watched RAM word, it has executed, see watch_hit()
+      Predicate,              // the run_until predicate holds
+      Deadline,               // the run_until deadline has passed
+      Keyboard_Wait           // run_until a deadline is in a loop that only a keyboard change can leave
+   };
+
+   struct Run_Result
+   {
+      Stop_Reason   reason;
+      std::uint64_t executed;
+   };
+
+   // how a pc outside of ROM and an M access outside of RAM are handled, see Bounds in Memory.h
+   enum class Bounds_Check : std::uint8_t
+   {
+      Throwing,         // std::out_of_range, the default
+      Flagging,         // execution stops and the fault is recorded, see fault()
+      Masked            // addresses wrap to the buffer without checks, for trusted ROMs
+   };
+
+   // what the computer is doing
+   enum class Status : std::uint8_t
+   {
+      Running,          // the next instruction can execute
+      Halted,           // pc is in a halt loop, the program has ended and execute() does nothing
+      Faulted           // pc is outside of ROM, or a fault has been recorded, see fault()
+   };
+
+   // the accesses of an instruction to its M word that trigger a watchpoint
+   enum class Access : std::uint8_t
+   {
+      Read       = 0b01,
+      Write      = 0b10,
+      Read_Write = 0b11
+   };
+
+   struct Watch_Hit
+   {
+      word_t pc;                // the instruction that accessed the word
+      word_t address;
+      Access access;            // the watched accesses it made
+   };
+
+   struct Fault
+   {
+      word_t      pc;           // the failing instruction
+      std::size_t address;      // the ROM or RAM address that was out of range
+      bool        fetch;        // the instruction fetch failed rather than its M access
+   };
+
+   using Clock = std::chrono::steady_clock;
+
+   // instructions executed in one batch between halt and deadline checks
+   static constexpr std::uint64_t batch_size = 1u << 16;
+
+   // Bounds_Check::Masked wraps pc to the decode table
+   static constexpr word_t rom_mask = Memory::address_mask;
+
+   // the longest keyboard poll loop that is fast-forwarded, in instructions
+   static constexpr std::size_t max_poll_loop = 16;
+
+   // executions of a block entry before it is promoted
+   static constexpr std::uint32_t predecoded_threshold = 16;
+   static constexpr std::uint32_t native_threshold     = 1'024;
+
+   // words of records kept by the journal, about a million instructions, and the instructions between its snapshots
+   static constexpr std::size_t   journal_capacity     = 1u << 22;
+   static constexpr std::uint64_t checkpoint_interval  = 1u << 24;
+
+   Computer();
+   ~Computer();
+
+   class Snapshot;
+
+   // RAM, registers, pc, counters and faults, not ROM or settings, restored by restore()
+   auto snapshot() const -> Snapshot;
+   auto restore( Snapshot const& snapshot ) -> void;
+
+   // a computer in the state of this one, its RAM shares pages with this one's until either writes them
+   auto fork() -> std::unique_ptr<Computer>;
+
+   // count such computers made from one snapshot of RAM, see Memory::Snapshot
+   auto fork( std::size_t count ) -> std::vector<std::unique_ptr<Computer>>;
+
+   Computer( Computer const& )                    = delete;
+   Computer( Computer&& )                         = delete;
+   auto operator=( Computer const& ) -> Computer& = delete;
+   auto operator=( Computer&& )      -> Computer& = delete;
 
    auto load_rom( std::span<word_t const> instructions ) -> void;
 
+   // load instructions with their decode table, e.g. from a cached ROM_Image, instead of decoding them
+   auto load_rom( std::span<word_t const> instructions, std::span<Decoded_Instruction const> decoded ) -> void;
+
    template <RomIterator Iter>
    auto load_rom( Iter begin, Iter end ) -> void;
 
+   // run the program of image without copying it, see Shared_ROM.h
+   auto load_rom( std::shared_ptr<Shared_ROM> image ) -> void;
+
    // execute next instruction
    auto execute() -> void;
 
+   // execute the next count instructions, stops early at a halt loop
+   auto execute( std::uint64_t count ) -> void;
+
+   // execute up to max_instructions in batches of the selected engine
+   auto run( std::uint64_t max_instructions ) -> Run_Result;
+
+   // execute until predicate holds, it is checked after every instruction, breakpoints and
+   // watchpoints stop it as they stop run()
+   template <std::predicate<Computer const&> Predicate>
+   auto run_until( Predicate predicate, std::uint64_t max_instructions ) -> Run_Result;
+
+   // execute until deadline, it is checked between batches
+   auto run_until( Clock::time_point deadline,
+                   std::uint64_t max_instructions = std::numeric_limits<std::uint64_t>::max() ) -> Run_Result;
+
+   auto add_breakpoint( word_t address )          -> void;
+
+   // stop run() at address when condition holds, or any other condition added there
+   auto add_breakpoint( word_t address, Condition condition ) -> void;
+   auto remove_breakpoint( word_t address )       -> void;
+   auto clear_breakpoints()                       -> void;
+   auto has_breakpoint( word_t address ) const    -> bool;
+
+   // the conditions of the breakpoint at address, none if it is unconditional or there is none
+   auto breakpoint_conditions( word_t address ) const -> std::span<Condition const>;
+
+   // stop run() after an instruction that makes one of access to a RAM word in [first, last]
+   auto add_watchpoint( word_t first, word_t last, Access access = Access::Write ) -> void;
+   auto remove_watchpoint( word_t first, word_t last ) -> void;
+   auto clear_watchpoints()                       -> void;
+   auto watchpoint( word_t address ) const        -> std::optional<Access>;
+
+   // the access that stopped the last run() with Stop_Reason::Watchpoint
+   auto watch_hit()                         const noexcept -> std::optional<Watch_Hit> const&;
+
+   // record what each instruction overwrites so that rewind() can undo it, see Journal.h
+   auto enable_journal( std::size_t capacity = journal_capacity, std::uint64_t interval = checkpoint_interval ) -> void;
+   auto disable_journal()                         -> void;
+   auto journal_enabled()                   const noexcept -> bool;
+
+   // the instructions rewind() can undo one by one
+   auto journal_depth()                     const noexcept -> std::uint64_t;
+
+   // undo the last count instructions, returns how many were undone
+   auto rewind( std::uint64_t count )             -> std::uint64_t;
+
+   // is pc where a loop that only jumps to itself starts, the loop is never executed
+   auto in_halt_loop() const -> bool;
+
+   auto status()       const -> Status;
+
+   // instructions executed since the ROM was loaded or the computer was reset
+   constexpr auto instruction_count() const noexcept -> std::uint64_t;
+
+   // the part of instruction_count() that run() skipped in keyboard poll loops
+   constexpr auto skipped_instructions() const noexcept -> std::uint64_t;
+
+   auto set_engine( Engine engine ) -> void;
+   constexpr auto engine()         const noexcept -> Engine;
+
+   auto set_bounds_check( Bounds_Check check ) -> void;
+   constexpr auto bounds_check()   const noexcept -> Bounds_Check;
+
+   // the fault that stopped execution under Bounds_Check::Flagging, or that stopped run()
+   constexpr auto fault()          const noexcept -> std::optional<Fault> const&;
+   constexpr auto clear_fault()          noexcept -> void;
+
+   // can Engine::JIT generate native code on this host, otherwise it interprets
+   static auto jit_supported() noexcept -> bool;
+
+   auto set_tier_thresholds( std::uint32_t predecoded, std::uint32_t native ) -> void;
+   auto tier( word_t address )     const          -> Tier;
+   auto hotness( word_t address )  const          -> std::uint32_t;
+   auto tier_statistics()          const noexcept -> Tier_Statistics const&;
+
+   // decoded form of the instruction at address, re-decoded if the ROM word has been changed
+   auto decoded( word_t address ) -> Decoded_Instruction const&;
+
    constexpr auto RAM()            const noexcept -> Memory const&;
    constexpr auto RAM()                  noexcept -> Memory&;
    constexpr auto ROM()            const noexcept -> ROM_t  const&;
-   constexpr auto ROM()                  noexcept -> ROM_t&;
+   auto           ROM()                           -> ROM_t&;     // copies a shared image first
 
    constexpr auto A_Register()     const noexcept -> word_t;
    constexpr auto D_Register()     const noexcept -> word_t;
@@ -92,11 +319,138 @@ public:
    
 
 private:
-   Memory RAM_{};
-   ROM_t  ROM_{};
-   CPU    cpu_{ RAM_ };
-   word_t pc_{ 0 };     // program counter address of next instruction in ROM
+   Computer( Computer const& parent, Memory::Snapshot const& ram );
 
+   // a straight run of instructions ending in a jump back to its start that writes no memory
+   struct Poll_Loop
+   {
+      word_t head;
+      word_t length;
+   };
+
+   Memory        RAM_{};
+   CPU           cpu_{ RAM_ };
+   word_t        pc_{ 0 };     // program counter address of next instruction in ROM
+   Engine        engine_{ Engine::Interpreter };
+   std::uint64_t instructions_{ 0 };
+   std::uint64_t skipped_{ 0 };
+
+   std::shared_ptr<Shared_ROM> rom_{ Shared_ROM::empty() };     // words and decode table, written only while unshared
+   bool                        rom_written_{ false };           // ROM() has been handed out since the table was decoded
+   word_t const*               words_{ rom_->words_.data() };     // of rom_, saves the interpreter a load per fetch
+   Decoded_Instruction*        decoded_{ rom_->decoded_.data() };
+
+   Bounds_Check         bounds_check_{ Bounds_Check::Throwing };
+   std::optional<Fault> fault_{};
+
+   std::vector<bool> breakpoints_ = std::vector<bool>( ROM_SIZE );
+   std::size_t       breakpoint_count_{ 0 };
+
+   std::unordered_map<word_t, std::vector<Condition>> conditions_{};   // of the conditional breakpoints
+
+   static constexpr auto watch_pages = ( RAM_SIZE + Memory::page_size - 1 ) / Memory::page_size;
+
+   std::vector<std::uint8_t>             watches_{};          // Access bits of each RAM word, sized when the first is added
+   std::array<std::uint8_t, watch_pages> watch_pages_{};      // the Access bits of any word in each page
+   std::size_t                           watch_count_{ 0 };   // words watched
+   std::optional<Watch_Hit>              watch_hit_{};
+
+   std::unique_ptr<Threaded_Engine> threaded_{};       // created when first selected
+   std::unique_ptr<JIT_Engine>      jit_{};            // created when first selected, if supported
+   std::unique_ptr<Loop_Idioms>     idioms_{};         // created when the first loop is promoted
+   std::unique_ptr<Journal>         journal_{};        // while enabled
+
+   std::vector<std::uint32_t> hotness_{};      // executions of each block entry, sized when Engine::Tiered is first selected
+   std::vector<Tier>          tier_{};         // tier of the block entered at each address, sized with hotness_
+   std::uint32_t              predecoded_threshold_{ predecoded_threshold };
+   std::uint32_t              native_threshold_{ native_threshold };
+   Tier_Statistics            tier_statistics_{};
+
+   auto run_batches( std::uint64_t max_instructions, std::optional<Clock::time_point> deadline ) -> Run_Result;
+   auto end_of_run( std::uint64_t executed ) const -> Run_Result;
+   auto record_thrown_fault()                 -> void;
+
+   template <std::predicate Stop>
+   auto run_checked( std::uint64_t count, bool resume, Stop after ) -> std::optional<Stop_Reason>;
+
+   auto watched_access()                      -> std::optional<Watch_Hit>;
+   auto breaks_at( word_t address )     const -> bool;
+   auto poll_loop()                     const -> std::optional<Poll_Loop>;
+   auto keyboard_wait( std::uint64_t budget ) -> std::uint64_t;
+   constexpr auto attach_rom( std::shared_ptr<Shared_ROM> image ) noexcept -> void;
+   auto unshare_rom()                         -> Shared_ROM&;
+   auto decode_rom( std::span<Decoded_Instruction const> decoded = {} ) -> void;
+   auto reload_rom()                          -> void;
+   auto refresh( std::size_t address )        -> Decoded_Instruction const&;
+   auto interpret()                           -> bool;
+
+   template <Bounds::Policy Policy>
+   auto interpret()                           -> bool;
+
+   template <Bounds::Policy Policy>
+   auto interpret( std::uint64_t count )      -> void;
+
+   template <Bounds::Policy Policy>
+   auto journaled( std::uint64_t count )      -> void;
+
+   auto load_state( Snapshot const& snapshot ) -> void;
+
+   auto execute_tiered( std::uint64_t count ) -> void;
+   auto run_tier( Tier tier, std::uint64_t count ) -> void;
+   auto promote( word_t address, Tier tier )  -> void;
+};
+
+
+// the state of a computer, in memory or in a file that is mapped back without parsing
+class Computer::Snapshot final
+{
+public:
+   static constexpr std::uint64_t file_magic     = 0x5041'4E53'4B43'4148;     // "HACKSNAP" on a little endian host
+   static constexpr std::uint32_t format_version = 1;
+   static constexpr std::uint32_t ram_offset     = 65'536;     // RAM in a file, aligned to the pages of any host
+   static constexpr std::uint64_t file_size      = ram_offset + std::uint64_t{ Memory::buffer_size } * sizeof( word_t );
+
+   // the first bytes of a snapshot file, in the byte order of the host
+   struct Header
+   {
+      std::uint64_t magic;
+      std::uint64_t instructions;        // instruction_count()
+      std::uint64_t skipped;             // skipped_instructions()
+      std::uint64_t fault_address;       // of fault(), when flags has has_fault
+      std::uint64_t ram_fault;           // of RAM().fault(), when flags has has_ram_fault
+      std::uint64_t file_size;
+      std::uint32_t format;
+      std::uint32_t ram_offset;
+      std::uint32_t ram_words;
+      std::uint32_t flags;
+      word_t        A;
+      word_t        D;
+      word_t        ALU_output;
+      word_t        pc;
+      word_t        cpu_pc;              // the last instruction the CPU executed
+      word_t        fault_pc;
+      word_t        reserved[2];
+   };
+
+   static constexpr std::uint32_t has_fault     = 0b001;
+   static constexpr std::uint32_t fault_fetch   = 0b010;
+   static constexpr std::uint32_t has_ram_fault = 0b100;
+
+   // write the snapshot to path, replacing it only once it is complete
+   auto save( std::filesystem::path const& path ) const -> void;
+
+   // a snapshot saved to path, its RAM is mapped rather than read where the host can
+   static auto load( std::filesystem::path const& path ) -> Snapshot;
+
+   auto header() const noexcept -> Header const&;
+
+private:
+   friend class Computer;
+
+   Header           header_;
+   Memory::Snapshot ram_;
+
+   Snapshot( Header const& header, Memory::Snapshot ram ) noexcept;
 };
 
 }  // namespace Hack
@@ -105,29 +459,169 @@ private:
 template <Hack::RomIterator Iter> auto
 Hack::Computer::load_rom( Iter begin, Iter end ) -> void
 {
-   auto count = 0uz;
+   auto& words = unshare_rom().words_;
+   auto  count = 0uz;
 
    while ( begin != end )
    {
-      ROM_[count] = *begin;
+      words[count] = *begin;
       ++count;
       ++begin;
    }
-   pc_ = 0;
+   decode_rom();
+   pc_           = 0;
+   instructions_ = 0;
+   skipped_      = 0;
+}
+
+
+/**
+ * @brief   Execute until predicate holds
+ * 
+ * @param predicate         checked after every instruction
+ * @param max_instructions  the maximum number of instructions to execute
+ * @return Run_Result       Stop_Reason::Predicate once predicate holds, or why the run stopped first
+ * 
+ *    Instructions are interpreted one at a time, stopping at breakpoints and watchpoints as run()
+ *    does.  A breakpoint at pc does not stop the first instruction, so that a run can resume from
+ *    the breakpoint it stopped at.
+ */
+template <std::predicate<Hack::Computer const&> Predicate> auto
+Hack::Computer::run_until( Predicate predicate, std::uint64_t max_instructions ) -> Run_Result
+{
+   auto const start = instructions_;
+
+   clear_fault();
+   watch_hit_.reset();
+
+   try
+   {
+      auto const holds  = [&] { return predicate( std::as_const( *this ) ); };
+      auto const reason = run_checked( max_instructions, true, holds );
+
+      if ( reason )
+      {
+         return { *reason, instructions_ - start };
+      }
+   }
+   catch ( std::out_of_range const& )
+   {
+      record_thrown_fault();
+   }
+
+   return end_of_run( instructions_ - start );
+}
+
+
+/**
+ * @brief   Execute up to count instructions one at a time, checking breakpoints and watchpoints
+ * 
+ * @param count    the maximum number of instructions to execute
+ * @param resume   the run starts here, a breakpoint at pc does not stop it
+ * @param after    checked after each instruction that executed without a fault
+ * @return std::optional<Stop_Reason>   Breakpoint, Watchpoint, or Predicate once after returns
+ *                                      true, if one stopped execution
+ * 
+ *    The accesses an instruction will make are found from its decoded entry and A before it
+ *    executes.  A RAM page none of whose words is watched costs one load.  The instructions are
+ *    interpreted from the decode table, through execute() only while the journal records them.
+ */
+template <std::predicate Stop> auto
+Hack::Computer::run_checked( std::uint64_t count, bool resume, Stop after ) -> std::optional<Stop_Reason>
+{
+   for ( auto const end = instructions_ + count; instructions_ < end; resume = false )
+   {
+      if ( pc_ < ROM_SIZE && breakpoints_[pc_] && !resume && !in_halt_loop() && breaks_at( pc_ ) )
+      {
+         return Stop_Reason::Breakpoint;
+      }
+
+      auto const hit   = watch_count_ > 0 ? watched_access() : std::nullopt;
+      auto const start = instructions_;
+
+      if ( journal_ )
+      {
+         execute( 1 );
+      }
+      else
+      {
+         static_cast<void>( interpret() );
+      }
+
+      // pc is in a halt loop, or outside of ROM under Bounds_Check::Flagging
+      if ( instructions_ == start )
+      {
+         return std::nullopt;
+      }
+
+      if ( hit )
+      {
+         watch_hit_ = hit;
+         return Stop_Reason::Watchpoint;
+      }
+
+      if ( fault_ )
+      {
+         return std::nullopt;
+      }
+
+      if ( after() )
+      {
+         return Stop_Reason::Predicate;
+      }
+   }
+
+   return std::nullopt;
 }
 
 
 constexpr auto 
-Hack::Computer::ROM() const noexcept -> ROM_t const&
+Hack::Computer::instruction_count() const noexcept -> std::uint64_t
+{
+   return instructions_;
+}
+
+
+constexpr auto 
+Hack::Computer::skipped_instructions() const noexcept -> std::uint64_t
+{
+   return skipped_;
+}
+
+
+constexpr auto 
+Hack::Computer::bounds_check() const noexcept -> Bounds_Check
+{
+   return bounds_check_;
+}
+
+
+constexpr auto 
+Hack::Computer::fault() const noexcept -> std::optional<Fault> const&
+{
+   return fault_;
+}
+
+
+constexpr auto 
+Hack::Computer::clear_fault() noexcept -> void
+{
+   fault_.reset();
+   RAM_.clear_fault();
+}
+
+
+constexpr auto 
+Hack::Computer::engine() const noexcept -> Engine
 {
-   return ROM_;
+   return engine_;
 }
 
 
 constexpr auto 
-Hack::Computer::ROM() noexcept -> ROM_t&
+Hack::Computer::ROM() const noexcept -> ROM_t const&
 {
-   return ROM_;
+   return rom_->words_;
 }
 
 constexpr auto 
@@ -253,6 +747,8 @@ Hack::Computer::reset()                noexcept -> void
    clear_pc();
    clear_registers();
    cpu_.reset();
+   instructions_ = 0;
+   skipped_      = 0;
 }
 
 constexpr auto 
@@ -263,6 +759,8 @@ Hack::Computer::clear()                noexcept -> void
    clear_pc();
    clear_registers();
    cpu_.reset();
+   instructions_ = 0;
+   skipped_      = 0;
 }
 
 constexpr auto 
@@ -280,7 +778,23 @@ Hack::Computer::clear_ram()            noexcept -> void
 constexpr auto 
 Hack::Computer::clear_rom()            noexcept -> void
 {
-   ROM_.fill( 0 );
+   if ( rom_.use_count() == 1 )
+   {
+      rom_->words_.fill( 0 );
+      rom_written_ = true;
+   }
+   else
+   {
+      attach_rom( Shared_ROM::empty() );
+   }
+}
+
+constexpr auto 
+Hack::Computer::attach_rom( std::shared_ptr<Shared_ROM> image ) noexcept -> void
+{
+   rom_     = std::move( image );
+   words_   = rom_->words_.data();
+   decoded_ = rom_->decoded_.data();
 }
 
 constexpr auto 
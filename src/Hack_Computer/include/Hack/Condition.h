@@ -0,0 +1,82 @@
+/**
+ * @file    Condition.h
+ * @author  William Weston
+ * @brief   A condition on the state of a Hack computer, compiled once for conditional breakpoints
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A condition is parsed when it is constructed and kept as postfix code over a small stack,
+ *    so evaluating it at a breakpoint costs a few loads and compares rather than any parsing:
+ *
+ *       condition   :=  or
+ *       or          :=  and { ( "||" | "or" ) and }
+ *       and         :=  not { ( "&&" | "and" ) not }
+ *       not         :=  ( "!" | "not" ) not  |  compare
+ *       compare     :=  sum [ ( "==" | "=" | "!=" | "<" | "<=" | ">" | ">=" ) sum ]
+ *       sum         :=  unary { ( "+" | "-" ) unary }
+ *       unary       :=  "-" unary  |  primary
+ *       primary     :=  number | "A" | "D" | "M" | "PC" | "RAM" "[" sum "]" | "(" or ")"
+ *
+ *    e.g. RAM[256] > 1000 && D == 0.  Names are not case sensitive and numbers are decimal or
+ *    0x hexadecimal.  Words are read as signed 16-bit values, as the ALU sees them, and
+ *    arithmetic does not wrap.  M and RAM[n] outside of RAM read as 0.  A comparison or logical
+ *    operator yields 1 or 0 and a condition holds when its value is not 0.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_CONDITION_H
+#define HACK_EMULATOR_2026_10_16_CONDITION_H
+
+#include "Memory.h"     // for Memory
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, uint8_t, uint16_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class Condition final
+{
+public:
+   using word_t = std::uint16_t;
+
+   // the deepest expression accepted, in values waiting for an operator
+   static constexpr std::size_t max_depth = 32;
+
+   // compile expression, throws std::invalid_argument naming the column of the first error
+   explicit Condition( std::string_view expression );
+
+   // does the condition hold with these registers and RAM
+   auto operator()( word_t A, word_t D, word_t pc, Memory const& ram ) const noexcept -> bool;
+
+   auto text() const noexcept -> std::string const&;
+
+private:
+   enum class Op : std::uint8_t
+   {
+      Constant, A, D, M, PC,
+      RAM,              // the word at the address on the stack
+      RAM_At,           // the word at a constant address
+      Negate, Not, Add, Subtract,
+      Equal, Not_Equal, Less, Less_Equal, Greater, Greater_Equal,
+      And, Or
+   };
+
+   struct Instruction
+   {
+      Op           op;
+      std::int32_t operand;
+   };
+
+   class Parser;
+
+   std::string              text_;
+   std::vector<Instruction> code_{};
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_CONDITION_H
@@ -0,0 +1,131 @@
+/**
+ * @file    Decoder.h
+ * @author  William Weston
+ * @brief   Hack instruction decoder
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Splits a 16-bit Hack instruction into the fields the CPU needs to execute it, so that a ROM
+ *    word only has to be taken apart once instead of on every execution.
+ *
+ *       A-Instruction:    0vvvvvvvvvvvvvvv     •  value is the instruction word itself
+ *
+ *       C-Instruction:    111accccccdddjjj     •  operand     a             y input of the ALU
+ *                                              •  comp        cccccc        zx nx zy ny f no
+ *                                              •  dest        ddd           A D M
+ *                                              •  jump        jjj           lt eq gt
+ */
+#ifndef HACK_EMULATOR_2026_10_16_DECODER_H
+#define HACK_EMULATOR_2026_10_16_DECODER_H
+
+#include <cstdint>      // for uint8_t, uint16_t
+
+namespace Hack
+{
+
+struct Decoded_Instruction
+{
+   enum class Kind    : std::uint8_t { A_Instruction, C_Instruction };
+   enum class Operand : std::uint8_t { A_Register, M_Register };      // y input to the ALU
+
+   // dest bits
+   static constexpr std::uint8_t dest_M = 0b001;
+   static constexpr std::uint8_t dest_D = 0b010;
+   static constexpr std::uint8_t dest_A = 0b100;
+
+   // jump bits
+   static constexpr std::uint8_t jump_gt = 0b001;
+   static constexpr std::uint8_t jump_eq = 0b010;
+   static constexpr std::uint8_t jump_lt = 0b100;
+
+   // comp bits
+   static constexpr std::uint8_t comp_zx = 0b10'0000;
+   static constexpr std::uint8_t comp_nx = 0b01'0000;
+   static constexpr std::uint8_t comp_zy = 0b00'1000;
+   static constexpr std::uint8_t comp_ny = 0b00'0100;
+   static constexpr std::uint8_t comp_f  = 0b00'0010;
+   static constexpr std::uint8_t comp_no = 0b00'0001;
+
+   std::uint16_t word    = 0;                       // the instruction this entry was decoded from
+   Kind          kind    = Kind::A_Instruction;
+   Operand       operand = Operand::A_Register;
+   std::uint8_t  comp    = 0;                       // ALU operation id: zx nx zy ny f no
+   std::uint8_t  dest    = 0;
+   std::uint8_t  jump    = 0;
+
+   constexpr auto is_a_instruction() const noexcept -> bool { return kind == Kind::A_Instruction; }
+   constexpr auto reads_M()          const noexcept -> bool;
+   constexpr auto writes_M()         const noexcept -> bool;
+   constexpr auto is_jump()          const noexcept -> bool { return jump != 0; }
+   constexpr auto is_halt_jump()     const noexcept -> bool;      // always jumps to A, writes no register or memory
+
+   friend constexpr auto operator==( Decoded_Instruction const&, Decoded_Instruction const& ) -> bool = default;
+};
+
+
+// decode a single instruction
+constexpr auto decode( std::uint16_t instruction ) noexcept -> Decoded_Instruction;
+
+
+}  // namespace Hack
+
+
+// ---------------------------------------- Implementation ----------------------------------------
+
+
+constexpr auto
+Hack::Decoded_Instruction::reads_M() const noexcept -> bool
+{
+   return kind == Kind::C_Instruction && operand == Operand::M_Register;
+}
+
+constexpr auto
+Hack::Decoded_Instruction::writes_M() const noexcept -> bool
+{
+   return kind == Kind::C_Instruction && ( dest & dest_M );
+}
+
+
+constexpr auto
+Hack::Decoded_Instruction::is_halt_jump() const noexcept -> bool
+{
+   return kind == Kind::C_Instruction && dest == 0 && jump == ( jump_lt | jump_eq | jump_gt );
+}
+
+
+/**
+ * @brief   Decode a Hack instruction into its fields
+ *
+ * @param instruction            the instruction to decode
+ * @return Decoded_Instruction   the decoded instruction, a default constructed entry decodes @0
+ */
+constexpr auto
+Hack::decode( std::uint16_t instruction ) noexcept -> Decoded_Instruction
+{
+   // 1111'1100'0000'0000
+   // 5432'1098'7654'3210
+   // 111a'cccc'ccdd'djjj
+   constexpr auto c_instruction_mask = std::uint16_t{ 0b1000'0000'0000'0000 };
+   constexpr auto a_bit_mask         = std::uint16_t{ 0b0001'0000'0000'0000 };
+
+   if ( !( instruction & c_instruction_mask ) )
+   {
+      return { .word = instruction };
+   }
+
+   using Kind    = Decoded_Instruction::Kind;
+   using Operand = Decoded_Instruction::Operand;
+
+   return {
+      .word    = instruction,
+      .kind    = Kind::C_Instruction,
+      .operand = ( instruction & a_bit_mask ) ? Operand::M_Register : Operand::A_Register,
+      .comp    = static_cast<std::uint8_t>( ( instruction >> 6 ) & 0b11'1111 ),
+      .dest    = static_cast<std::uint8_t>( ( instruction >> 3 ) & 0b111 ),
+      .jump    = static_cast<std::uint8_t>( instruction & 0b111 )
+   };
+}
+
+#endif      // HACK_EMULATOR_2026_10_16_DECODER_H
@@ -0,0 +1,73 @@
+/**
+ * @file    Keyboard_Log.h
+ * @author  William Weston
+ * @brief   Keyboard input tied to the instruction count, so that a session can be replayed exactly
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    An event says that from the instruction count it was recorded at the keyboard held its key.
+ *    Recording notes the keyboard of a computer whenever it changed, between the runs that the
+ *    events fall between.  replay() runs a computer from the same start in runs that end at the
+ *    events, so every key reaches the program at the instruction it did when it was recorded,
+ *    with any engine, at full speed and without a window.
+ *
+ *    A log file is text, a header line and then one event per line:
+ *
+ *       hack-keyboard-log 1
+ *       <instruction count> <key>
+ */
+#ifndef HACK_EMULATOR_2026_10_16_KEYBOARD_LOG_H
+#define HACK_EMULATOR_2026_10_16_KEYBOARD_LOG_H
+
+#include "Computer.h"   // for Computer
+
+#include <cstdint>      // for uint16_t, uint64_t
+#include <filesystem>   // for path
+#include <span>         // for span
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class Keyboard_Log final
+{
+public:
+   using word_t = std::uint16_t;
+
+   struct Event
+   {
+      std::uint64_t instruction;     // instruction_count() when the key was set
+      word_t        key;
+
+      friend constexpr auto operator==( Event const&, Event const& ) -> bool = default;
+   };
+
+   // note the keyboard of computer, if it has changed since the last event
+   auto record( Computer const& computer ) -> void;
+
+   // note key at instruction, events after it are dropped first, they belong to a run that was reset or rewound
+   auto record( std::uint64_t instruction, word_t key ) -> void;
+
+   auto events() const noexcept -> std::span<Event const>;
+   auto empty()  const noexcept -> bool;
+   auto clear()        noexcept -> void;
+
+   // write the log to path
+   auto save( std::filesystem::path const& path ) const -> void;
+
+   // a log written by save()
+   static auto load( std::filesystem::path const& path ) -> Keyboard_Log;
+
+private:
+   std::vector<Event> events_{};     // by instruction, each key differs from the one before it
+};
+
+
+// run computer for up to max_instructions, setting its keyboard to each event of log as its instruction count reaches it
+auto replay( Computer& computer, Keyboard_Log const& log, std::uint64_t max_instructions ) -> Computer::Run_Result;
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_KEYBOARD_LOG_H
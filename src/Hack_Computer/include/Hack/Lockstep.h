@@ -0,0 +1,112 @@
+/**
+ * @file    Lockstep.h
+ * @author  William Weston
+ * @brief   Runs 8, 16 or 32 Hack machines on one ROM in lockstep, in structure-of-arrays form
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Fuzzing and parameter sweeps run one program many times from different RAM.  A Lockstep holds
+ *    the A, D and pc registers of its machines as one array each, and their RAM as rows of one word
+ *    per machine, so that the machines executing the same instruction do so with vector operations:
+ *    an M access through an A all of them share is one row load or store.  The ALU is the one of
+ *    ALU.h, applied to every machine.
+ *
+ *    Machines at the same pc form a group and step together.  A jump that some of them take and
+ *    others do not, or that takes them to different addresses, splits the group, and groups that
+ *    reach the same pc merge again.  The group with the lowest pc steps first, so machines that
+ *    leave a loop early wait where the others will join them.
+ *
+ *    Every machine executes exactly the instructions a Computer would from the same RAM: run() stops
+ *    a machine at its budget, at a halt loop without executing it, and at a pc outside of ROM.  An M
+ *    access outside of RAM faults the machine before the instruction executes, pc holds it.
+ *
+ *    The step loop is compiled for AVX-512 and AVX2 as well as for the baseline of the target, and
+ *    the widest the host supports is selected when the program starts, see vector_width().
+ */
+#ifndef HACK_EMULATOR_2026_10_16_LOCKSTEP_H
+#define HACK_EMULATOR_2026_10_16_LOCKSTEP_H
+
+#include "Computer.h"     // for Computer
+#include "Shared_ROM.h"   // for Shared_ROM
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint16_t, uint32_t, uint64_t
+#include <memory>         // for shared_ptr, unique_ptr
+#include <string_view>    // for string_view
+
+namespace Hack
+{
+
+// the registers, RAM and groups of the machines of a Lockstep, see Lockstep.cpp
+template <std::size_t Lanes>
+struct Lockstep_Machines;
+
+template <std::size_t Lanes>
+class Lockstep final
+{
+public:
+   static_assert( Lanes == 8 || Lanes == 16 || Lanes == 32, "Lockstep runs 8, 16 or 32 machines" );
+
+   using word_t = std::uint16_t;
+   using Status = Computer::Status;
+
+   static constexpr auto lanes = Lanes;     // machines run side by side
+
+   struct Run_Result
+   {
+      std::uint64_t executed;     // instructions, summed over the machines
+      std::uint64_t steps;        // group steps, each executes one instruction on every machine of a group
+   };
+
+   // machines with an empty ROM
+   Lockstep();
+
+   // machines running image, reset
+   explicit Lockstep( std::shared_ptr<Shared_ROM const> image );
+
+   ~Lockstep();
+
+   Lockstep( Lockstep const& )                    = delete;
+   Lockstep( Lockstep&& )                         = delete;
+   auto operator=( Lockstep const& ) -> Lockstep& = delete;
+   auto operator=( Lockstep&& )      -> Lockstep& = delete;
+
+   // run the program of image on every machine and reset them
+   auto load_rom( std::shared_ptr<Shared_ROM const> image ) -> void;
+
+   // clear the RAM, registers, pc and instruction count of every machine
+   auto reset() -> void;
+
+   // execute up to max_instructions on each machine that is running
+   auto run( std::uint64_t max_instructions ) -> Run_Result;
+
+   // std::out_of_range unless machine < lanes and address < Memory::address_space
+   auto RAM( std::size_t machine, word_t address ) const -> word_t;
+   auto set_RAM( std::size_t machine, word_t address, word_t value ) -> void;
+
+   // std::out_of_range unless machine < lanes
+   auto A_Register( std::size_t machine )        const -> word_t;
+   auto D_Register( std::size_t machine )        const -> word_t;
+   auto pc( std::size_t machine )                const -> word_t;
+   auto instruction_count( std::size_t machine ) const -> std::uint64_t;
+   auto status( std::size_t machine )            const -> Status;
+
+   // distinct pcs among the running machines, 1 while they all agree
+   auto groups() const -> std::size_t;
+
+   // the instruction set the step loop was selected for on this host: "avx512", "avx2" or "baseline"
+   static auto vector_width() noexcept -> std::string_view;
+
+private:
+   std::unique_ptr<Lockstep_Machines<Lanes>> machines_;
+};
+
+extern template class Lockstep<8>;
+extern template class Lockstep<16>;
+extern template class Lockstep<32>;
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_LOCKSTEP_H
@@ -7,21 +7,49 @@
  * 
  * @copyright Copyright (c) 2024
  * 
+ *    RAM, screen and keyboard share one contiguous buffer laid out at their Hack addresses, so
+ *    an access is a single compare and an indexed load.  The buffer is padded to 32K words so
+ *    that any 15-bit address masked by unchecked() stays inside it.
+ * 
+ *    access<Policy>() selects at compile time what an address outside of the address space does:
+ *    throw (operator[] and at()), record a fault for the caller to poll, or nothing at all.
+ * 
+ *    On Linux the buffer is mapped from the host so that copies can share it page by page.  A
+ *    Snapshot holds the words of a Memory in a memory file, and every Memory made from it maps that
+ *    file privately: the host copies a page the first time one of them writes it, so a copy costs
+ *    the pages it touches rather than the whole buffer.  Elsewhere a Snapshot is a plain copy.
  */
 #ifndef HACK_EMULATOR_2024_03_11_MEMORY_H
 #define HACK_EMULATOR_2024_03_11_MEMORY_H
 
 
+#include <algorithm>    // fill
 #include <array>
+#include <concepts>     // same_as
+#include <cstddef>      // ptrdiff_t, size_t
 #include <cstdint>
+#include <filesystem>   // path
+#include <optional>
 #include <span>
 #include <stdexcept>
 #include <string>
 #include <utility>      // as_const
+#include <vector>
 
 namespace Hack
 {
 
+// bounds check policies for addresses outside of RAM and ROM
+namespace Bounds
+{
+   struct Throwing {};     // throw std::out_of_range
+   struct Flagging {};     // record the fault for the caller to poll, the access goes to a scratch word
+   struct Masked   {};     // no check, addresses are masked to 15 bits
+
+   template <typename P>
+   concept Policy = std::same_as<P, Throwing> || std::same_as<P, Flagging> || std::same_as<P, Masked>;
+}
+
 class Memory final
 {
 public:
@@ -29,6 +57,9 @@ public:
    static constexpr auto screen_start_address = 16'384u;
    static constexpr auto screen_end_address   = 24'576u;     // one past the last valid address of the screen 
    static constexpr auto keyboard_address     = 24'576u;
+   static constexpr auto buffer_size          = 32'768u;     // address_space padded to a power of two
+   static constexpr auto address_mask         = buffer_size - 1u;
+   static constexpr auto page_size            = 2'048u;      // words in a 4K host page, the unit snapshots share
 
    using value_type            = std::uint16_t;
    using size_type             = std::size_t;
@@ -37,18 +68,44 @@ public:
    using const_reference       = value_type const&;
    using pointer               = value_type*;
    using const_pointer         = value_type const*;
-   using RAM_iterator          = std::array<std::uint16_t, 16384>::iterator;
-   using RAM_const_iterator    = std::array<std::uint16_t, 16384>::const_iterator;
-   using Screen_iterator       = std::array<std::uint16_t, 81924>::iterator;
-   using Screen_const_iterator = std::array<std::uint16_t, 81924>::const_iterator;
+   using RAM_iterator          = pointer;
+   using RAM_const_iterator    = const_pointer;
+   using Screen_iterator       = pointer;
+   using Screen_const_iterator = const_pointer;
+
+   class Snapshot;
+
+   explicit Memory();
+   explicit Memory( Snapshot const& snapshot );     // the words of snapshot, sharing its pages until they are written
+   Memory( Memory const& other );
+   auto operator=( Memory const& other ) -> Memory&;
+   ~Memory();
+
+   // the words and fault of this memory, for any number of copies made by Memory( Snapshot const& )
+   auto snapshot() const -> Snapshot;
 
-   constexpr explicit Memory() noexcept = default;
+   // replace the words and fault of this memory with those of snapshot, data() may change
+   auto restore( Snapshot const& snapshot ) -> void;
 
    auto operator[]( size_type index )       -> reference;
    auto operator[]( size_type index ) const -> const_reference;
    auto at( size_type index )               -> reference;
    auto at( size_type index )         const -> const_reference;
 
+   template <Bounds::Policy Policy> auto access( size_type index )       -> reference;
+   template <Bounds::Policy Policy> auto access( size_type index ) const -> const_reference;
+
+   // no bounds check, the address is masked to 15 bits, addresses past the keyboard reach padding
+   constexpr auto unchecked( size_type index )       noexcept -> reference;
+   constexpr auto unchecked( size_type index ) const noexcept -> const_reference;
+
+   // the first address outside of the address space accessed with Bounds::Flagging since clear_fault()
+   constexpr auto fault()          const noexcept -> std::optional<size_type>;
+   constexpr auto clear_fault()          noexcept -> void;
+
+   constexpr auto data()                 noexcept -> pointer;
+   constexpr auto data()           const noexcept -> const_pointer;
+
    constexpr auto ram_begin()            noexcept -> RAM_iterator;
    constexpr auto ram_begin()      const noexcept -> RAM_const_iterator;
    constexpr auto ram_cbegin()     const noexcept -> RAM_const_iterator;
@@ -72,9 +129,44 @@ public:
    constexpr auto clear_keyboard()       noexcept -> void;
 
 private:
-   std::array<std::uint16_t, 16'384> RAM16K{};
-   std::array<std::uint16_t, 8'192>  Screen{};
-   std::uint16_t                     Keyboard{};
+   value_type*                      words_;          // buffer_size words, RAM 0 - 16383, screen 16384 - 24575, keyboard 24576
+   mutable std::optional<size_type> fault_{};
+   mutable value_type               scratch_{};      // target of a flagged access
+
+   [[noreturn]] static auto out_of_range( size_type index ) -> void;
+};
+
+
+class Memory::Snapshot final
+{
+public:
+   Snapshot( Snapshot&& other ) noexcept;
+   auto operator=( Snapshot&& other ) noexcept -> Snapshot&;
+   ~Snapshot();
+
+   Snapshot( Snapshot const& )                    = delete;
+   auto operator=( Snapshot const& ) -> Snapshot& = delete;
+
+   // the buffer_size words at offset bytes into file, with fault, std::runtime_error if it cannot be read
+   static auto open( std::filesystem::path const& file, std::uint64_t offset, std::optional<size_type> fault ) -> Snapshot;
+
+   // is the snapshot a file whose pages copies share, otherwise copies copy its words
+   auto shared() const noexcept -> bool;
+
+   // copy the words into words, which holds buffer_size of them
+   auto read( std::span<value_type> words ) const -> void;
+
+   auto fault()  const noexcept -> std::optional<size_type>;
+
+private:
+   friend class Memory;
+
+   int                      file_{ -1 };     // a file holding buffer_size words at offset_, or -1 when words_ holds them
+   std::uint64_t            offset_{ 0 };    // a multiple of the host page size
+   std::vector<value_type>  words_{};
+   std::optional<size_type> fault_{};
+
+   Snapshot() = default;
 };
 
 }  // namespace Hack
@@ -90,21 +182,43 @@ Hack::Memory::operator[] ( size_type index )       -> reference
 inline auto 
 Hack::Memory::operator[] ( size_type index ) const -> const_reference
 {
-   if ( index < 16'384 )
-   {
-      return RAM16K[index];
-   }
-   else if ( index < 24'576 )
-   {
-      return Screen[index - 16'384];
-   }
-   else if ( index == 24'576 )
+   return access<Bounds::Throwing>( index );
+}
+
+template <Hack::Bounds::Policy Policy> inline auto 
+Hack::Memory::access( size_type index ) -> reference
+{
+   return const_cast<reference>( std::as_const( *this ).access<Policy>( index ) );
+}
+
+template <Hack::Bounds::Policy Policy> inline auto 
+Hack::Memory::access( size_type index ) const -> const_reference
+{
+   if constexpr ( std::same_as<Policy, Bounds::Masked> )
    {
-      return Keyboard;
+      return words_[index & address_mask];
    }
    else
    {
-      throw std::out_of_range( "RAM: Memory access out of bounds: " + std::to_string( index ) );
+      if ( index >= address_space ) [[unlikely]]
+      {
+         if constexpr ( std::same_as<Policy, Bounds::Throwing> )
+         {
+            out_of_range( index );
+         }
+         else
+         {
+            if ( !fault_ )
+            {
+               fault_ = index;
+            }
+
+            scratch_ = 0;
+            return scratch_;
+         }
+      }
+
+      return words_[index];
    }
 }
 
@@ -120,89 +234,131 @@ Hack::Memory::at( size_type index ) const -> const_reference
    return operator[]( index );
 }
 
+inline auto 
+Hack::Memory::out_of_range( size_type index ) -> void
+{
+   throw std::out_of_range( "RAM: Memory access out of bounds: " + std::to_string( index ) );
+}
+
+constexpr auto 
+Hack::Memory::unchecked( size_type index ) noexcept -> reference
+{
+   return words_[index & address_mask];
+}
+
+constexpr auto 
+Hack::Memory::unchecked( size_type index ) const noexcept -> const_reference
+{
+   return words_[index & address_mask];
+}
+
+constexpr auto 
+Hack::Memory::fault() const noexcept -> std::optional<size_type>
+{
+   return fault_;
+}
+
+constexpr auto 
+Hack::Memory::clear_fault() noexcept -> void
+{
+   fault_.reset();
+}
+
+constexpr auto 
+Hack::Memory::data() noexcept -> pointer
+{
+   return words_;
+}
+
+constexpr auto 
+Hack::Memory::data() const noexcept -> const_pointer
+{
+   return words_;
+}
+
 constexpr auto 
 Hack::Memory::screen_begin() noexcept -> Screen_iterator
 {
-   return Screen.begin();
+   return words_ + screen_start_address;
 }
 
 
 constexpr auto 
 Hack::Memory::ram_begin() noexcept -> RAM_iterator
 {
-   return RAM16K.begin();
+   return words_;
 }
 
 constexpr auto 
 Hack::Memory::ram_begin() const noexcept -> RAM_const_iterator
 {
-   return RAM16K.begin();
+   return words_;
 }
 
 constexpr auto 
 Hack::Memory::ram_cbegin() const noexcept -> RAM_const_iterator
 {
-   return RAM16K.begin();
+   return words_;
 }
 
 constexpr auto 
 Hack::Memory::ram_end()         noexcept  -> RAM_iterator
 {
-   return RAM16K.end();
+   return words_ + screen_start_address;
 }
 
 constexpr auto 
 Hack::Memory::ram_end()        const noexcept -> RAM_const_iterator
 {
-   return RAM16K.end();
+   return words_ + screen_start_address;
 }
 
 constexpr auto 
 Hack::Memory::ram_cend()       const noexcept -> RAM_const_iterator
 {
-   return RAM16K.cend();
+   return words_ + screen_start_address;
 }
 
 constexpr auto 
 Hack::Memory::screen_begin()   const noexcept -> Screen_const_iterator
 {
-   return Screen.begin();
+   return words_ + screen_start_address;
 }
 
 constexpr auto 
 Hack::Memory::screen_cbegin()  const noexcept -> Screen_const_iterator
 {
-   return Screen.cbegin();
+   return words_ + screen_start_address;
 }
 
 constexpr auto 
 Hack::Memory::screen_end()          noexcept -> Screen_iterator
 {
-   return Screen.end();
+   return words_ + screen_end_address;
 }
 
 constexpr auto 
 Hack::Memory::screen_end()     const noexcept -> Screen_const_iterator
 {
-   return Screen.end();
+   return words_ + screen_end_address;
 }
 
 constexpr auto 
 Hack::Memory::screen_cend()    const noexcept -> Screen_const_iterator
 {
-   return Screen.cend();
+   return words_ + screen_end_address;
 }
 
 constexpr auto 
 Hack::Memory::keyboard()           noexcept  -> reference
 {
-   return Keyboard;
+   return words_[keyboard_address];
 }
 
 constexpr auto 
 Hack::Memory::keyboard()       const noexcept -> const_reference
 {
-   return Keyboard;
+   return words_[keyboard_address];
 }
 
 constexpr auto 
@@ -216,19 +372,19 @@ Hack::Memory::clear()                noexcept -> void
 constexpr auto 
 Hack::Memory::clear_screen()         noexcept -> void
 {
-   Screen.fill( 0 );
+   std::fill( words_ + screen_start_address, words_ + screen_end_address, std::uint16_t{ 0 } );
 }
 
 constexpr auto 
 Hack::Memory::clear_ram()            noexcept -> void
 {
-   RAM16K.fill( 0 );
+   std::fill( words_, words_ + screen_start_address, std::uint16_t{ 0 } );
 }
 
 constexpr auto 
 Hack::Memory::clear_keyboard()       noexcept -> void
 {
-   Keyboard = 0;
+   words_[keyboard_address] = 0;
 }
 
 #endif      // HACK_EMULATOR_2024_03_11_MEMORY_H
\ No newline at end of file
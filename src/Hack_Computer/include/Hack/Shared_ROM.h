@@ -0,0 +1,79 @@
+/**
+ * @file    Shared_ROM.h
+ * @author  William Weston
+ * @brief   A ROM and its decode table, shared read only by the computers that run it
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Every computer needs its ROM words and a decode table four times their size.  A Shared_ROM
+ *    holds both once, behind a std::shared_ptr, so that any number of computers can run the same
+ *    program from one copy.  Only Computer can change an image, and only while it holds the sole
+ *    reference: a computer asked for a mutable ROM() while others share its image first makes a
+ *    copy of its own.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_SHARED_ROM_H
+#define HACK_EMULATOR_2026_10_16_SHARED_ROM_H
+
+#include "Decoder.h"    // for Decoded_Instruction
+#include "Memory.h"     // for Memory
+
+#include <array>        // for array
+#include <cstdint>      // for uint16_t
+#include <memory>       // for shared_ptr
+#include <span>         // for span
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class Computer;
+
+class Shared_ROM final
+{
+public:
+   static constexpr auto size = 32'758u;
+
+   using word_t        = std::uint16_t;
+   using ROM_t         = std::array<word_t, size>;
+   using Decoded_ROM_t = std::vector<Decoded_Instruction>;
+
+   // a ROM of zeros
+   Shared_ROM() = default;
+
+   // instructions from address 0, the rest zeros, with decoded as their decode table if it is given
+   explicit Shared_ROM( std::span<word_t const> instructions, std::span<Decoded_Instruction const> decoded = {} );
+
+   auto words()   const noexcept -> ROM_t const&;
+
+   // parallel to words(), padded to Memory::buffer_size entries for masked fetches
+   auto decoded() const noexcept -> std::span<Decoded_Instruction const>;
+
+   // the image of an empty ROM, shared by every computer that has not loaded a program
+   static auto empty() -> std::shared_ptr<Shared_ROM> const&;
+
+private:
+   friend class Computer;
+
+   ROM_t         words_{};
+   Decoded_ROM_t decoded_ = Decoded_ROM_t( Memory::buffer_size );   // each entry tagged with the word it decodes
+};
+
+}  // namespace Hack
+
+
+inline auto
+Hack::Shared_ROM::words() const noexcept -> ROM_t const&
+{
+   return words_;
+}
+
+
+inline auto
+Hack::Shared_ROM::decoded() const noexcept -> std::span<Decoded_Instruction const>
+{
+   return decoded_;
+}
+
+#endif      // HACK_EMULATOR_2026_10_16_SHARED_ROM_H
@@ -35,6 +35,30 @@ Hack::CPU::execute_instruction( word_t instruction ) -> word_t
 }
 
 
+/**
+ * @brief   Execute an instruction that has already been decoded
+ * 
+ * @tparam Policy       how an M access outside of RAM is handled
+ * @param instruction   the decoded instruction to execute
+ * @return word_t       the next instruction to fetch from the instruction ROM
+ */
+template <Hack::Bounds::Policy Policy>
+auto 
+Hack::CPU::execute_instruction( Decoded_Instruction const& instruction ) -> word_t
+{
+   if ( instruction.is_a_instruction() )
+   {
+      return do_a_instruction( instruction.word );
+   }
+   
+   return do_c_instruction<Policy>( instruction );
+}
+
+template auto Hack::CPU::execute_instruction<Hack::Bounds::Throwing>( Decoded_Instruction const& ) -> word_t;
+template auto Hack::CPU::execute_instruction<Hack::Bounds::Flagging>( Decoded_Instruction const& ) -> word_t;
+template auto Hack::CPU::execute_instruction<Hack::Bounds::Masked>(   Decoded_Instruction const& ) -> word_t;
+
+
 
 // ----------------------------------------- Implementation ---------------------------------------
 
@@ -130,4 +154,48 @@ Hack::CPU::do_c_instruction( word_t instruction ) -> word_t
    }
 
    return ++PC_;     // increment PC_ and return
-}
\ No newline at end of file
+}
+
+
+/**
+ * @brief   Execute decoded C-instruction
+ * 
+ * @param instruction   the decoded instruction to execute
+ * @return word_t       next instruction to be fetched from ROM
+ * 
+ *    Same semantics as do_c_instruction( word_t ) without re-extracting the instruction bits.  M
+ *    is written before the registers, so an access that throws leaves the CPU as it was.
+ */
+template <Hack::Bounds::Policy Policy>
+auto 
+Hack::CPU::do_c_instruction( Decoded_Instruction const& instruction ) -> word_t
+{
+   using Op = Decoded_Instruction;
+
+   auto const comp = instruction.comp;
+   auto const x    = D_Register_;
+   auto const y    = ( instruction.operand == Op::Operand::M_Register ) ? RAM_.access<Policy>( A_Register_ ) : A_Register_;
+
+   auto const [out, zr, ng] = ALU( ALU_in{ x, y, 
+                                           ( comp & Op::comp_zx ) != 0, ( comp & Op::comp_nx ) != 0, 
+                                           ( comp & Op::comp_zy ) != 0, ( comp & Op::comp_ny ) != 0, 
+                                           ( comp & Op::comp_f  ) != 0, ( comp & Op::comp_no ) != 0 } );
+
+   if ( instruction.dest & Op::dest_M ) { RAM_.access<Policy>( A_Register_ ) = out; }
+
+   ALU_output_ = out;
+
+   if ( instruction.dest & Op::dest_A ) { A_Register_ = out; }
+   if ( instruction.dest & Op::dest_D ) { D_Register_ = out; }
+
+   // exactly one of lt, eq, gt holds for the ALU output
+   auto const condition = ng ? Op::jump_lt : ( zr ? Op::jump_eq : Op::jump_gt );
+
+   if ( instruction.jump & condition )
+   {
+      PC_ = A_Register_;
+      return PC_;
+   }
+
+   return ++PC_;
+}
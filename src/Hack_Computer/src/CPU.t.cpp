@@ -466,4 +466,41 @@ TEST_CASE( "Computer: Jump Operations" )
          CHECK( cpu.M_Register() == 0 );
       }
    }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Computer: Decoded instructions execute identically to raw instructions" )
+{
+   using namespace Hack;
+
+   auto const values = { std::uint16_t{ 0 }, std::uint16_t{ 1 }, std::uint16_t{ 42 }, std::uint16_t{ 0x7FFF }, 
+                         std::uint16_t{ 0x8000 }, std::uint16_t{ 0xFFFF } };
+
+   for ( auto const a_value : { std::uint16_t{ 0 }, std::uint16_t{ 17 }, std::uint16_t{ 24'576 } } )
+   {
+      for ( auto const d_value : values )
+      {
+         for ( auto word = 0u; word <= 0xFFFF; word += 7 )
+         {
+            auto const instruction = static_cast<std::uint16_t>( word );
+
+            auto ram_raw = Memory();
+            auto ram_dec = Memory();
+            auto raw     = CPU( ram_raw );
+            auto dec     = CPU( ram_dec );
+
+            raw.set_A_Register( a_value );    dec.set_A_Register( a_value );
+            raw.set_D_Register( d_value );    dec.set_D_Register( d_value );
+            raw.M_Register() = d_value;       dec.M_Register() = d_value;
+
+            auto const next_raw = raw.execute_instruction( instruction );
+            auto const next_dec = dec.execute_instruction( decode( instruction ) );
+
+            REQUIRE( next_raw == next_dec );
+            REQUIRE( raw.A_Register() == dec.A_Register() );
+            REQUIRE( raw.D_Register() == dec.D_Register() );
+            REQUIRE( raw.ALU_Output() == dec.ALU_Output() );
+            REQUIRE( ram_raw[a_value] == ram_dec[a_value] );
+         }
+      }
+   }
+}
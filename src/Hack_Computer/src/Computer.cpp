@@ -10,9 +10,52 @@
  */
 #include "Computer.h"
 
-#include <algorithm>    // for __copy_fn, copy
-#include <stdexcept>    // for runtime_error
+#include "JIT_Engine.h"          // for JIT_Engine
+#include "Journal.h"             // for Journal
+#include "Loop_Idioms.h"         // for Loop_Idioms
+#include "Threaded_Engine.h"     // for Threaded_Engine
+
+#include <algorithm>    // for __copy_fn, any_of, copy, fill, min, transform
+#include <cstddef>      // for ptrdiff_t
+#include <chrono>       // for steady_clock
+#include <memory>       // for make_unique, unique_ptr
+#include <numeric>      // for accumulate
+#include <stdexcept>    // for invalid_argument, out_of_range, runtime_error
+#include <optional>     // for nullopt, optional
 #include <string>       // for operator+, to_string
+#include <utility>      // for move
+
+Hack::Computer::Computer()  = default;
+Hack::Computer::~Computer() = default;
+
+
+// the child of a fork, registers and settings are copied, RAM is mapped from the parent's snapshot
+Hack::Computer::Computer( Computer const& parent, Memory::Snapshot const& ram )
+   : RAM_( ram ),
+     pc_( parent.pc_ ),
+     instructions_( parent.instructions_ ),
+     skipped_( parent.skipped_ ),
+     rom_( parent.rom_ ),
+     words_( parent.words_ ),
+     decoded_( parent.decoded_ ),
+     bounds_check_( parent.bounds_check_ ),
+     fault_( parent.fault_ ),
+     breakpoints_( parent.breakpoints_ ),
+     breakpoint_count_( parent.breakpoint_count_ ),
+     conditions_( parent.conditions_ ),
+     watches_( parent.watches_ ),
+     watch_pages_( parent.watch_pages_ ),
+     watch_count_( parent.watch_count_ ),
+     predecoded_threshold_( parent.predecoded_threshold_ ),
+     native_threshold_( parent.native_threshold_ )
+{
+   cpu_.set_A_Register( parent.cpu_.A_Register() );
+   cpu_.set_D_Register( parent.cpu_.D_Register() );
+   cpu_.set_PC( parent.cpu_.PC() );
+   cpu_.set_ALU_Output( parent.cpu_.ALU_Output() );
+   set_engine( parent.engine_ );
+}
+
 
 auto 
 Hack::Computer::load_rom( std::span<word_t const> instructions ) -> void
@@ -24,13 +67,1588 @@ Hack::Computer::load_rom( std::span<word_t const> instructions ) -> void
       throw std::runtime_error( "ROM overflow: " + std::to_string( instructions.size() ) );        // TODO: display proper error message 
    }
 
-   rng::copy( instructions, ROM_.begin() );
+   rng::copy( instructions, unshare_rom().words_.begin() );
+   decode_rom();
+
+   pc_           = 0;
+   instructions_ = 0;
+   skipped_      = 0;
+}
+
+
+/**
+ * @brief   Load a ROM with its decode table
+ * 
+ * @param instructions   the program, instruction 0 first
+ * @param decoded        decode( instructions[i] ) for every instruction
+ * @throws std::runtime_error if instructions do not fit in ROM, std::invalid_argument unless
+ *         decoded has an entry for every instruction
+ */
+auto 
+Hack::Computer::load_rom( std::span<word_t const> instructions, std::span<Decoded_Instruction const> decoded ) -> void
+{
+   namespace rng = std::ranges;
+   
+   if ( instructions.size() > ROM_SIZE )
+   {
+      throw std::runtime_error( "ROM overflow: " + std::to_string( instructions.size() ) );
+   }
+
+   if ( decoded.size() != instructions.size() )
+   {
+      throw std::invalid_argument( "Decode table does not match ROM: " + std::to_string( decoded.size() ) );
+   }
+
+   rng::copy( instructions, unshare_rom().words_.begin() );
+   decode_rom( decoded );
+
+   pc_           = 0;
+   instructions_ = 0;
+   skipped_      = 0;
+}
+
+
+/**
+ * @brief   Run the program of a shared image
+ * 
+ * @param image   the ROM to attach, it is not copied unless a mutable ROM() is asked for
+ * @throws std::invalid_argument if image is null
+ * 
+ *    References from an earlier ROM() refer to the previous image and must not be used after.
+ */
+auto 
+Hack::Computer::load_rom( std::shared_ptr<Shared_ROM> image ) -> void
+{
+   if ( !image )
+   {
+      throw std::invalid_argument( "No ROM image" );
+   }
+
+   attach_rom( std::move( image ) );
+   rom_written_ = false;
+   reload_rom();
+
+   pc_           = 0;
+   instructions_ = 0;
+   skipped_      = 0;
+}
+
+
+/**
+ * @brief   Take a snapshot of the state of the computer
+ * 
+ * @return Snapshot   RAM, screen and keyboard, A, D, ALU output, pc, the instruction counters and
+ *                    the faults, see Computer::Snapshot
+ * 
+ *    ROM, breakpoints, the engine and the other settings are not part of a snapshot, it is
+ *    restored into a computer that runs the same program.
+ */
+auto 
+Hack::Computer::snapshot() const -> Snapshot
+{
+   auto const ram_fault = RAM_.fault();
+   auto       header    = Snapshot::Header{
+      .magic         = Snapshot::file_magic,
+      .instructions  = instructions_,
+      .skipped       = skipped_,
+      .fault_address = fault_ ? fault_->address : 0u,
+      .ram_fault     = ram_fault.value_or( 0u ),
+      .file_size     = Snapshot::file_size,
+      .format        = Snapshot::format_version,
+      .ram_offset    = Snapshot::ram_offset,
+      .ram_words     = Memory::buffer_size,
+      .flags         = 0,
+      .A             = cpu_.A_Register(),
+      .D             = cpu_.D_Register(),
+      .ALU_output    = cpu_.ALU_Output(),
+      .pc            = pc_,
+      .cpu_pc        = cpu_.PC(),
+      .fault_pc      = fault_ ? fault_->pc : word_t{ 0 },
+      .reserved      = { 0, 0 }
+   };
+
+   header.flags |= fault_                  ? Snapshot::has_fault     : 0u;
+   header.flags |= fault_ && fault_->fetch ? Snapshot::fault_fetch   : 0u;
+   header.flags |= ram_fault               ? Snapshot::has_ram_fault : 0u;
+
+   return Snapshot( header, RAM_.snapshot() );
+}
+
+
+/**
+ * @brief   Return the computer to the state of a snapshot
+ * 
+ * @param snapshot   taken of this or any computer, or loaded from a file
+ * @throws std::bad_alloc if its RAM cannot be mapped, the computer is unchanged then
+ */
+auto 
+Hack::Computer::restore( Snapshot const& snapshot ) -> void
+{
+   load_state( snapshot );
+
+   if ( journal_ )
+   {
+      journal_->clear( instructions_ );
+   }
+}
+
+
+/**
+ * @brief   Make a computer in the state of this one
+ * 
+ * @return std::unique_ptr<Computer>   see fork( count )
+ */
+auto 
+Hack::Computer::fork() -> std::unique_ptr<Computer>
+{
+   return std::move( fork( 1 ).front() );
+}
+
+
+/**
+ * @brief   Make count computers in the state of this one
+ * 
+ * @param count   how many
+ * @return std::vector<std::unique_ptr<Computer>>   computers with this one's ROM image, registers,
+ *                pc, counters, breakpoints, watchpoints and settings, and RAM made from one
+ *                Memory::Snapshot
+ * @throws std::bad_alloc if their RAM cannot be mapped
+ * 
+ *    RAM is written to a snapshot once, the children map it and copy a page only when they
+ *    write it.  They share this computer's ROM image, see Shared_ROM.h, so references from an
+ *    earlier ROM() must not be written after a fork.  Tiers and engine code are not inherited:
+ *    each child starts cold and builds its engine when it is first selected, so Threaded and JIT
+ *    children pay for translating the ROM.  Children share nothing that they write and may run
+ *    on different threads; this computer must not run while it forks.
+ */
+auto 
+Hack::Computer::fork( std::size_t count ) -> std::vector<std::unique_ptr<Computer>>
+{
+   // the decode table of an image written through ROM() may be stale, and must not be written
+   // once it is shared, see refresh()
+   if ( rom_written_ )
+   {
+      for ( auto address = 0uz; address < ROM_SIZE; ++address )
+      {
+         refresh( address );
+      }
+
+      rom_written_ = false;
+   }
+
+   auto const ram      = RAM_.snapshot();
+   auto       children = std::vector<std::unique_ptr<Computer>>();
+
+   children.reserve( count );
+
+   for ( auto child = 0uz; child < count; ++child )
+   {
+      children.push_back( std::unique_ptr<Computer>( new Computer( *this, ram ) ) );
+   }
 
-   pc_ = 0;
+   return children;
 }
 
+
 auto 
 Hack::Computer::execute() -> void
 {  
-   pc_ = cpu_.execute_instruction( ROM_.at( pc_ ) );
-}
\ No newline at end of file
+   execute( 1 );
+}
+
+
+/**
+ * @brief   Execute the next count instructions
+ * 
+ * @param count   the maximum number of instructions to execute, execution stops early where a halt
+ *                loop starts, see in_halt_loop()
+ * @throws std::out_of_range with Bounds_Check::Throwing for a pc outside of ROM or an M access
+ *         outside of RAM, the computer is left in the state before the failing instruction
+ * 
+ *    With Bounds_Check::Flagging execution stops at the fault, see fault().  The threaded handlers
+ *    always check, an access they reject is executed again by the interpreter under the selected
+ *    policy.  While the journal is enabled every engine interprets, recording each instruction.
+ */
+auto 
+Hack::Computer::execute( std::uint64_t count ) -> void
+{
+   if ( in_halt_loop() )
+   {
+      return;
+   }
+
+   if ( journal_ )
+   {
+      switch ( bounds_check_ )
+      {
+         case Bounds_Check::Throwing:  journaled<Bounds::Throwing>( count );  return;
+         case Bounds_Check::Flagging:  journaled<Bounds::Flagging>( count );  return;
+         case Bounds_Check::Masked:    journaled<Bounds::Masked>( count );    return;
+      }
+      return;
+   }
+
+   switch ( engine_ )
+   {
+      case Engine::Interpreter:
+      {
+         switch ( bounds_check_ )
+         {
+            case Bounds_Check::Throwing:  interpret<Bounds::Throwing>( count );  return;
+            case Bounds_Check::Flagging:  interpret<Bounds::Flagging>( count );  return;
+            case Bounds_Check::Masked:    interpret<Bounds::Masked>( count );    return;
+         }
+         return;
+      }
+
+      case Engine::Threaded:
+      {
+         while ( count > 0 )
+         {
+            auto const start = instructions_;
+
+            try
+            {
+               threaded_->run( cpu_, rom_->words_, pc_, count, instructions_ );
+               return;
+            }
+            catch ( std::out_of_range const& )
+            {
+               if ( bounds_check_ == Bounds_Check::Throwing )
+               {
+                  throw;
+               }
+
+               count -= instructions_ - start;
+            }
+
+            if ( !interpret() )
+            {
+               return;
+            }
+            --count;
+         }
+         return;
+      }
+
+      case Engine::JIT:
+      {
+         while ( count > 0 && !in_halt_loop() )
+         {
+            auto const executed = jit_ ? jit_->run( cpu_, rom_->words_, pc_, count ) : 0;
+
+            if ( executed == 0 )
+            {
+               if ( !interpret() )
+               {
+                  return;
+               }
+               --count;
+            }
+            else
+            {
+               count         -= executed;
+               instructions_ += executed;
+            }
+         }
+         return;
+      }
+
+      case Engine::Tiered:
+      {
+         execute_tiered( count );
+         return;
+      }
+   }
+}
+
+
+/**
+ * @brief   Execute up to max_instructions
+ * 
+ * @param max_instructions  the maximum number of instructions to execute
+ * @return Run_Result       why the run stopped and how many instructions it executed
+ * 
+ *    The selected engine runs batches of up to batch_size instructions.  Every engine stops where a
+ *    halt loop starts, without executing it, and the run returns Stop_Reason::Halted.  With
+ *    breakpoints or watchpoints set the run executes one instruction at a time instead, checking
+ *    each for a breakpoint, except for the first so that a run can resume from the breakpoint it
+ *    stopped at, and for an access to a watched word.  Without any the batches pay nothing for
+ *    them.  Out of range accesses are reported as a stop reason instead of an exception.
+ * 
+ *    A keyboard poll loop that leaves the computer unchanged is not executed: the whole iterations
+ *    that fit in the budget are counted as executed, and skipped_instructions(), without running
+ *    them.  The state is exactly what executing them would leave, the keyboard cannot change
+ *    during a run.  While the journal is enabled, or breakpoints or watchpoints are set, they are
+ *    executed so that they can be rewound or checked.
+ */
+auto 
+Hack::Computer::run( std::uint64_t max_instructions ) -> Run_Result
+{
+   return run_batches( max_instructions, std::nullopt );
+}
+
+
+/**
+ * @brief   Execute until deadline has passed
+ * 
+ * @param deadline          checked between batches
+ * @param max_instructions  the maximum number of instructions to execute
+ * @return Run_Result       Stop_Reason::Deadline once the deadline has passed, or why run() stopped
+ *                          first
+ */
+auto 
+Hack::Computer::run_until( Clock::time_point deadline, std::uint64_t max_instructions ) -> Run_Result
+{
+   return run_batches( max_instructions, deadline );
+}
+
+
+/**
+ * @brief   Stop run() before the instruction at address is executed
+ * 
+ * @throws std::out_of_range if address is not a valid ROM address
+ * 
+ *    A conditional breakpoint at address becomes unconditional.
+ */
+auto 
+Hack::Computer::add_breakpoint( word_t address ) -> void
+{
+   if ( !breakpoints_.at( address ) )
+   {
+      breakpoints_[address] = true;
+      ++breakpoint_count_;
+   }
+
+   conditions_.erase( address );
+}
+
+
+/**
+ * @brief   Stop run() before the instruction at address is executed, if condition holds
+ * 
+ * @param address     the ROM address
+ * @param condition   compiled once, evaluated only when pc reaches address
+ * @throws std::out_of_range if address is not a valid ROM address
+ * 
+ *    The breakpoint stops a run when any of the conditions added at address holds.  Adding a
+ *    condition to an unconditional breakpoint does not change it, it stops a run every time.
+ */
+auto 
+Hack::Computer::add_breakpoint( word_t address, Condition condition ) -> void
+{
+   if ( !breakpoints_.at( address ) )
+   {
+      breakpoints_[address] = true;
+      ++breakpoint_count_;
+      conditions_[address].push_back( std::move( condition ) );
+   }
+   else if ( auto const found = conditions_.find( address ); found != conditions_.end() )
+   {
+      found->second.push_back( std::move( condition ) );
+   }
+}
+
+
+auto 
+Hack::Computer::remove_breakpoint( word_t address ) -> void
+{
+   if ( breakpoints_.at( address ) )
+   {
+      breakpoints_[address] = false;
+      --breakpoint_count_;
+   }
+
+   conditions_.erase( address );
+}
+
+
+auto 
+Hack::Computer::clear_breakpoints() -> void
+{
+   breakpoints_.assign( ROM_SIZE, false );
+   breakpoint_count_ = 0;
+   conditions_.clear();
+}
+
+
+auto 
+Hack::Computer::has_breakpoint( word_t address ) const -> bool
+{
+   return breakpoints_.at( address );
+}
+
+
+auto 
+Hack::Computer::breakpoint_conditions( word_t address ) const -> std::span<Condition const>
+{
+   auto const found = conditions_.find( address );
+
+   return found != conditions_.end() ? std::span<Condition const>( found->second ) : std::span<Condition const>();
+}
+
+
+/**
+ * @brief   Stop run() after an instruction accesses a RAM word in a range
+ * 
+ * @param first    the first word watched
+ * @param last     the last word watched, e.g. screen_end_address - 1 to watch the screen
+ * @param access   the accesses that stop a run, added to those already watched
+ * @throws std::out_of_range if last is not a RAM address or first is after it
+ * 
+ *    The words are checked only while a watchpoint or a breakpoint is set, see run().
+ */
+auto 
+Hack::Computer::add_watchpoint( word_t first, word_t last, Access access ) -> void
+{
+   if ( last >= RAM_SIZE || first > last )
+   {
+      throw std::out_of_range( "RAM: Watchpoint out of bounds: " + std::to_string( first ) + "-" + std::to_string( last ) );
+   }
+
+   if ( watches_.empty() )
+   {
+      watches_.assign( RAM_SIZE, 0u );
+   }
+
+   auto const bits = static_cast<std::uint8_t>( access );
+
+   for ( auto address = std::size_t{ first }; address <= last; ++address )
+   {
+      watch_count_ += watches_[address] == 0;
+      watches_[address]                         |= bits;
+      watch_pages_[address / Memory::page_size] |= bits;
+   }
+}
+
+
+// stop watching every access to the words in [first, last]
+auto 
+Hack::Computer::remove_watchpoint( word_t first, word_t last ) -> void
+{
+   if ( last >= RAM_SIZE || first > last )
+   {
+      throw std::out_of_range( "RAM: Watchpoint out of bounds: " + std::to_string( first ) + "-" + std::to_string( last ) );
+   }
+
+   if ( watches_.empty() )
+   {
+      return;
+   }
+
+   for ( auto address = std::size_t{ first }; address <= last; ++address )
+   {
+      watch_count_      -= watches_[address] != 0;
+      watches_[address]  = 0;
+   }
+
+   // the pages the range touched keep the bits of the words still watched in them
+   for ( auto page = first / Memory::page_size; page <= last / Memory::page_size; ++page )
+   {
+      auto const begin = watches_.begin() + static_cast<std::ptrdiff_t>( page * Memory::page_size );
+      auto const end   = watches_.begin() + static_cast<std::ptrdiff_t>( std::min( ( page + 1 ) * Memory::page_size, RAM_SIZE ) );
+
+      watch_pages_[page] = std::accumulate( begin, end, std::uint8_t{ 0 }, []( std::uint8_t bits, std::uint8_t word ) { return static_cast<std::uint8_t>( bits | word ); } );
+   }
+}
+
+
+auto 
+Hack::Computer::clear_watchpoints() -> void
+{
+   watches_.clear();
+   watch_pages_.fill( 0u );
+   watch_count_ = 0;
+}
+
+
+// the accesses watched at address, std::nullopt if it is not watched
+auto 
+Hack::Computer::watchpoint( word_t address ) const -> std::optional<Access>
+{
+   if ( address >= RAM_SIZE )
+   {
+      throw std::out_of_range( "RAM: Watchpoint out of bounds: " + std::to_string( address ) );
+   }
+
+   if ( watches_.empty() || watches_[address] == 0 )
+   {
+      return std::nullopt;
+   }
+
+   return static_cast<Access>( watches_[address] );
+}
+
+
+auto 
+Hack::Computer::watch_hit() const noexcept -> std::optional<Watch_Hit> const&
+{
+   return watch_hit_;
+}
+
+
+/**
+ * @brief   Start recording what each instruction overwrites
+ * 
+ * @param capacity   words of records to keep, the oldest are dropped beyond it, see Journal.h
+ * @param interval   instructions between the snapshots kept for rewinding further than the records
+ * 
+ *    The journal starts with a snapshot of the current state.  While it is enabled every engine
+ *    interprets and keyboard poll loops are executed, so a run is slower.  Changes made other
+ *    than by executing instructions, to RAM or registers, are not recorded.
+ */
+auto 
+Hack::Computer::enable_journal( std::size_t capacity, std::uint64_t interval ) -> void
+{
+   journal_ = std::make_unique<Journal>( capacity, interval );
+   journal_->clear( instructions_ );
+   journal_->add_checkpoint( snapshot() );
+}
+
+
+auto 
+Hack::Computer::disable_journal() -> void
+{
+   journal_.reset();
+}
+
+
+auto 
+Hack::Computer::journal_enabled() const noexcept -> bool
+{
+   return journal_ != nullptr;
+}
+
+
+auto 
+Hack::Computer::journal_depth() const noexcept -> std::uint64_t
+{
+   return journal_ && journal_->end() == instructions_ ? journal_->depth() : 0u;
+}
+
+
+/**
+ * @brief   Undo the last instructions executed
+ * 
+ * @param count   the number of instructions to undo
+ * @return std::uint64_t   the number undone, 0 without a journal
+ * 
+ *    Up to journal_depth() instructions are undone one by one, each costs a record.  Further back
+ *    the computer returns to the newest snapshot taken at or before the instruction asked for, so
+ *    more than count may be undone then, or to the oldest snapshot kept if there is none.  Faults
+ *    are cleared.
+ */
+auto 
+Hack::Computer::rewind( std::uint64_t count ) -> std::uint64_t
+{
+   if ( !journal_ || count == 0 )
+   {
+      return 0;
+   }
+
+   // the records end where the computer was last recorded, not where a reset or load left it
+   if ( journal_->end() != instructions_ )
+   {
+      journal_->clear( instructions_ );
+   }
+
+   auto const start  = instructions_;
+   auto const target = start - std::min( count, start );
+
+   clear_fault();
+
+   while ( instructions_ > target && journal_->depth() > 0 )
+   {
+      auto const entry = journal_->pop();
+
+      if ( entry.written & Decoded_Instruction::dest_A ) { cpu_.set_A_Register( entry.A ); }
+      if ( entry.written & Decoded_Instruction::dest_D ) { cpu_.set_D_Register( entry.D ); }
+      if ( entry.written & Decoded_Instruction::dest_M ) { RAM_.unchecked( cpu_.A_Register() & Memory::address_mask ) = entry.M; }
+      if ( entry.alu )                                   { cpu_.set_ALU_Output( entry.ALU_output ); }
+
+      pc_ = entry.pc;
+      cpu_.set_PC( entry.pc );
+      --instructions_;
+   }
+
+   auto const* const checkpoint = instructions_ > target ? journal_->checkpoint( target ) : nullptr;
+
+   if ( checkpoint && checkpoint->header().instructions < instructions_ )
+   {
+      load_state( *checkpoint );
+      journal_->discard_records( instructions_ );
+   }
+
+   journal_->discard_checkpoints( instructions_ );
+
+   return start - instructions_;
+}
+
+
+/**
+ * @brief   What the computer is doing
+ * 
+ * @return Status    Halted in a halt loop, Faulted when pc is outside of ROM or the last fault has
+ *                   not been cleared, otherwise Running
+ */
+auto 
+Hack::Computer::status() const -> Status
+{
+   if ( in_halt_loop() )
+   {
+      return Status::Halted;
+   }
+
+   if ( fault_ || ( pc_ >= ROM_SIZE && bounds_check_ != Bounds_Check::Masked ) )
+   {
+      return Status::Faulted;
+   }
+
+   return Status::Running;
+}
+
+
+/**
+ * @brief   Is pc where a loop that only jumps to itself starts
+ * 
+ * @return true   the instruction at pc is an unconditional jump without dest to pc itself, or pc
+ *                is @pc followed by such a jump, as in (END) @END 0;JMP
+ * 
+ *    No engine executes the loop, so a computer stopped in it is not in the state of a real machine
+ *    spinning there: at @END the A register and ALU_output() still hold the values left by the
+ *    instruction before the loop, where the machine would hold END and the result of the jump's
+ *    comp.  RAM, D and pc are the same, and the program can never change them again.
+ */
+auto 
+Hack::Computer::in_halt_loop() const -> bool
+{
+   if ( pc_ >= ROM_SIZE )
+   {
+      return false;
+   }
+
+   auto const instruction = decode( rom_->words_[pc_] );
+
+   if ( instruction.is_a_instruction() )
+   {
+      return instruction.word == pc_ && pc_ + 1u < ROM_SIZE && decode( rom_->words_[pc_ + 1u] ).is_halt_jump();
+   }
+
+   return instruction.is_halt_jump() && cpu_.A_Register() == pc_;
+}
+
+
+/**
+ * @brief   Select the engine used to execute instructions
+ * 
+ * @param engine  the engine to use from the next instruction on
+ */
+auto 
+Hack::Computer::set_engine( Engine engine ) -> void
+{
+   if ( engine == Engine::Threaded && !threaded_ )
+   {
+      threaded_ = std::make_unique<Threaded_Engine>( RAM_ );
+      threaded_->load( rom_->words_ );
+   }
+
+   if ( engine == Engine::JIT && !jit_ && JIT_Engine::supported() )
+   {
+      jit_ = std::make_unique<JIT_Engine>( RAM_ );
+      jit_->load( rom_->words_ );
+   }
+
+   if ( engine == Engine::Tiered && tier_.empty() )
+   {
+      hotness_.assign( ROM_SIZE, 0u );
+      tier_.assign( ROM_SIZE, Tier::Interpreter );
+   }
+
+   engine_ = engine;
+}
+
+
+auto 
+Hack::Computer::jit_supported() noexcept -> bool
+{
+   return JIT_Engine::supported();
+}
+
+
+/**
+ * @brief   Select how a pc outside of ROM and an M access outside of RAM are handled
+ * 
+ * @param check   Throwing, Flagging or Masked for trusted ROMs, see Bounds_Check
+ */
+auto 
+Hack::Computer::set_bounds_check( Bounds_Check check ) -> void
+{
+   bounds_check_ = check;
+   clear_fault();
+}
+
+
+/**
+ * @brief   Set how often a block entry must execute before Engine::Tiered promotes it
+ * 
+ * @param predecoded  executions in the interpreter before the block is run by threaded handlers
+ * @param native      further executions before the block is compiled to native code
+ */
+auto 
+Hack::Computer::set_tier_thresholds( std::uint32_t predecoded, std::uint32_t native ) -> void
+{
+   predecoded_threshold_ = predecoded;
+   native_threshold_     = native;
+}
+
+
+/**
+ * @brief   Get the tier of the block entered at address
+ * 
+ * @throws std::out_of_range if address is not a valid ROM address
+ */
+auto 
+Hack::Computer::tier( word_t address ) const -> Tier
+{
+   if ( address >= ROM_SIZE )
+   {
+      throw std::out_of_range( "ROM: Tier address out of bounds: " + std::to_string( address ) );
+   }
+
+   return tier_.empty() ? Tier::Interpreter : tier_[address];
+}
+
+
+/**
+ * @brief   Get the number of times the block entered at address has executed in its current tier
+ * 
+ * @throws std::out_of_range if address is not a valid ROM address
+ */
+auto 
+Hack::Computer::hotness( word_t address ) const -> std::uint32_t
+{
+   if ( address >= ROM_SIZE )
+   {
+      throw std::out_of_range( "ROM: Hotness address out of bounds: " + std::to_string( address ) );
+   }
+
+   return hotness_.empty() ? 0u : hotness_[address];
+}
+
+
+auto 
+Hack::Computer::tier_statistics() const noexcept -> Tier_Statistics const&
+{
+   return tier_statistics_;
+}
+
+/**
+ * @brief   Get the decoded instruction at the given ROM address
+ * 
+ * @param address                      ROM address of the instruction
+ * @return Decoded_Instruction const&  the decoded instruction
+ * @throws std::out_of_range if address is not a valid ROM address
+ * 
+ *    ROM() hands out a mutable reference, so writes cannot be observed when they happen.  Instead
+ *    each entry remembers the word it was decoded from and a stale entry is re-decoded on use.
+ */
+auto 
+Hack::Computer::decoded( word_t address ) -> Decoded_Instruction const&
+{
+   if ( address >= ROM_SIZE )
+   {
+      throw std::out_of_range( "ROM: Instruction fetch out of bounds: " + std::to_string( address ) );
+   }
+
+   return refresh( address );
+}
+
+
+/**
+ * @brief   Get the ROM for writing
+ * 
+ * @return ROM_t&   this computer's own copy of the ROM, made now if the image is shared
+ */
+auto 
+Hack::Computer::ROM() -> ROM_t&
+{
+   rom_written_ = true;
+
+   return unshare_rom().words_;
+}
+
+
+// ----------------------------------------- Implementation ---------------------------------------
+
+// the image, copied first unless this computer is its only user
+auto 
+Hack::Computer::unshare_rom() -> Shared_ROM&
+{
+   if ( rom_.use_count() > 1 )
+   {
+      attach_rom( std::make_shared<Shared_ROM>( *rom_ ) );
+   }
+
+   return *rom_;
+}
+
+
+// decode the unshared image, entries in decoded were decoded already
+auto 
+Hack::Computer::decode_rom( std::span<Decoded_Instruction const> decoded ) -> void
+{
+   namespace rng = std::ranges;
+
+   auto&      words = rom_->words_;
+   auto const rest  = rng::copy( decoded, rom_->decoded_.begin() ).out;
+
+   std::transform( words.begin() + static_cast<std::ptrdiff_t>( decoded.size() ), words.end(), rest,
+                   []( word_t instruction ) { return decode( instruction ); } );
+   rom_written_ = false;
+   reload_rom();
+}
+
+
+// forget the tiers and the journal of the previous program and load the engines from the image
+auto 
+Hack::Computer::reload_rom() -> void
+{
+   namespace rng = std::ranges;
+
+   rng::fill( hotness_, 0u );
+   rng::fill( tier_, Tier::Interpreter );
+   tier_statistics_ = Tier_Statistics{};
+
+   if ( threaded_ )
+   {
+      threaded_->load( rom_->words_ );
+   }
+
+   if ( jit_ )
+   {
+      jit_->load( rom_->words_ );
+   }
+
+   if ( idioms_ )
+   {
+      idioms_->load( rom_->words_ );
+   }
+
+   if ( journal_ )
+   {
+      journal_->clear( 0 );
+   }
+}
+
+
+// the state of snapshot, the journal is left to the caller
+auto 
+Hack::Computer::load_state( Snapshot const& snapshot ) -> void
+{
+   auto const& header = snapshot.header_;
+
+   RAM_.restore( snapshot.ram_ );
+   cpu_.set_A_Register( header.A );
+   cpu_.set_D_Register( header.D );
+   cpu_.set_ALU_Output( header.ALU_output );
+   cpu_.set_PC( header.cpu_pc );
+
+   pc_           = header.pc;
+   instructions_ = header.instructions;
+   skipped_      = header.skipped;
+   fault_.reset();
+
+   if ( header.flags & Snapshot::has_fault )
+   {
+      fault_ = Fault{ header.fault_pc, header.fault_address, ( header.flags & Snapshot::fault_fetch ) != 0 };
+   }
+}
+
+
+// the decoded entry for address, re-decoded if the ROM word has changed, address < Memory::buffer_size,
+// the words of a shared image cannot change so its entries are never written here
+auto 
+Hack::Computer::refresh( std::size_t address ) -> Decoded_Instruction const&
+{
+   auto const instruction = address < ROM_SIZE ? words_[address] : word_t{ 0 };
+   auto&      entry       = decoded_[address];
+
+   if ( entry.word != instruction )
+   {
+      entry = decode( instruction );
+   }
+
+   return entry;
+}
+
+
+/**
+ * @brief   Execute the next instruction from the decode table
+ * 
+ * @return true   unless pc is in a halt loop, which is not executed, or a fault was recorded under
+ *                Bounds::Flagging
+ */
+template <Hack::Bounds::Policy Policy>
+auto 
+Hack::Computer::interpret() -> bool
+{
+   if constexpr ( std::same_as<Policy, Bounds::Masked> )
+   {
+      pc_ &= rom_mask;
+   }
+   else if ( pc_ >= ROM_SIZE ) [[unlikely]]
+   {
+      if constexpr ( std::same_as<Policy, Bounds::Throwing> )
+      {
+         throw std::out_of_range( "ROM: Instruction fetch out of bounds: " + std::to_string( pc_ ) );
+      }
+      else
+      {
+         fault_ = Fault{ pc_, pc_, true };
+         return false;
+      }
+   }
+
+   auto const& instruction = refresh( pc_ );
+   auto const  pc          = pc_;
+
+   // @P at P, or a 0;JMP with A holding P, may start a halt loop
+   if ( ( instruction.word == pc || ( instruction.is_halt_jump() && cpu_.A_Register() == pc ) ) && in_halt_loop() )
+   {
+      return false;
+   }
+
+   // an M access outside of RAM is not executed, pc and the count stay at it as when one throws
+   if constexpr ( std::same_as<Policy, Bounds::Flagging> )
+   {
+      if ( ( instruction.reads_M() || instruction.writes_M() ) && cpu_.A_Register() >= RAM_SIZE ) [[unlikely]]
+      {
+         fault_ = Fault{ pc, cpu_.A_Register(), false };
+         return false;
+      }
+   }
+
+   cpu_.set_PC( pc_ );
+   pc_ = cpu_.execute_instruction<Policy>( instruction );
+   ++instructions_;
+   return true;
+}
+
+
+// execute up to count instructions from the decode table, the loop is instantiated for each policy
+template <Hack::Bounds::Policy Policy>
+auto 
+Hack::Computer::interpret( std::uint64_t count ) -> void
+{
+   for ( ; count > 0; --count )
+   {
+      if ( !interpret<Policy>() )
+      {
+         return;
+      }
+   }
+}
+
+
+/**
+ * @brief   Execute up to count instructions from the decode table, recording each in the journal
+ * 
+ * @param count   the maximum number of instructions to execute
+ * 
+ *    The values an instruction may overwrite are read before it executes and recorded once it
+ *    has, an instruction that throws or is not executed leaves no record.  An M access outside
+ *    of RAM writes no RAM word, so none is recorded for it.
+ */
+template <Hack::Bounds::Policy Policy>
+auto 
+Hack::Computer::journaled( std::uint64_t count ) -> void
+{
+   if ( journal_->end() != instructions_ )
+   {
+      journal_->clear( instructions_ );
+   }
+
+   for ( ; count > 0; --count )
+   {
+      auto const pc    = std::same_as<Policy, Bounds::Masked> ? static_cast<word_t>( pc_ & rom_mask ) : pc_;
+      auto const A     = cpu_.A_Register();
+      auto       entry = Journal::Entry{ .pc = pc, .written = 0, .alu = false, .A = A, .D = cpu_.D_Register(), .M = 0,
+                                         .ALU_output = cpu_.ALU_Output() };
+
+      if ( pc < ROM_SIZE || std::same_as<Policy, Bounds::Masked> )
+      {
+         auto const& instruction = refresh( pc );
+
+         entry.written = instruction.is_a_instruction() ? Decoded_Instruction::dest_A : instruction.dest;
+         entry.alu     = !instruction.is_a_instruction();
+
+         if ( instruction.writes_M() )
+         {
+            if ( std::same_as<Policy, Bounds::Masked> || A < RAM_SIZE )
+            {
+               entry.M = RAM_.unchecked( A & Memory::address_mask );
+            }
+            else
+            {
+               entry.written &= static_cast<std::uint8_t>( ~Decoded_Instruction::dest_M );
+            }
+         }
+      }
+
+      auto const start    = instructions_;
+      auto const executed = interpret<Policy>();
+
+      if ( instructions_ != start )
+      {
+         journal_->push( entry, instructions_ );
+
+         if ( instructions_ % journal_->interval() == 0 )
+         {
+            journal_->add_checkpoint( snapshot() );
+         }
+      }
+
+      if ( !executed )
+      {
+         return;
+      }
+   }
+}
+
+// execute the next instruction under the selected bounds check
+auto 
+Hack::Computer::interpret() -> bool
+{
+   switch ( bounds_check_ )
+   {
+      case Bounds_Check::Throwing:  return interpret<Bounds::Throwing>();
+      case Bounds_Check::Flagging:  return interpret<Bounds::Flagging>();
+      case Bounds_Check::Masked:    return interpret<Bounds::Masked>();
+   }
+
+   return false;
+}
+
+
+auto 
+Hack::Computer::run_batches( std::uint64_t max_instructions, std::optional<Clock::time_point> deadline ) -> Run_Result
+{
+   auto const start    = instructions_;
+   auto const executed = [&] { return instructions_ - start; };
+   auto const faulted  = [&]
+   {
+      return Run_Result{ fault_->fetch ? Stop_Reason::PC_Out_Of_ROM : Stop_Reason::Memory_Out_Of_Range, executed() };
+   };
+
+   // breakpoints and watchpoints are looked for only while one is set
+   auto const checked = breakpoint_count_ > 0 || watch_count_ > 0;
+
+   clear_fault();
+   watch_hit_.reset();
+
+   try
+   {
+      while ( true )
+      {
+         if ( pc_ >= ROM_SIZE && bounds_check_ != Bounds_Check::Masked )
+         {
+            if ( bounds_check_ == Bounds_Check::Flagging )
+            {
+               fault_ = Fault{ pc_, pc_, true };
+            }
+            return { Stop_Reason::PC_Out_Of_ROM, executed() };
+         }
+
+         if ( in_halt_loop() )
+         {
+            return { Stop_Reason::Halted, executed() };
+         }
+
+         if ( executed() >= max_instructions )
+         {
+            return { Stop_Reason::Budget, executed() };
+         }
+
+         if ( deadline && Clock::now() >= *deadline )
+         {
+            return { Stop_Reason::Deadline, executed() };
+         }
+
+         if ( !checked )
+         {
+            if ( auto const period = keyboard_wait( max_instructions - executed() ) )
+            {
+               if ( deadline )
+               {
+                  return { Stop_Reason::Keyboard_Wait, executed() };
+               }
+
+               // every iteration leaves the computer as it was, only the count advances, unless
+               // the journal has to record them
+               if ( !journal_ )
+               {
+                  auto const skip = ( max_instructions - executed() ) / period * period;
+
+                  instructions_ += skip;
+                  skipped_      += skip;
+               }
+            }
+         }
+
+         auto const batch = std::min( max_instructions - executed(), batch_size );
+
+         if ( !checked )
+         {
+            execute( batch );
+         }
+         else if ( auto const reason = run_checked( batch, executed() == 0, [] { return false; } ) )
+         {
+            return { *reason, executed() };
+         }
+
+         if ( fault_ )
+         {
+            return faulted();
+         }
+      }
+   }
+   catch ( std::out_of_range const& )
+   {
+      record_thrown_fault();
+
+      return faulted();
+   }
+}
+
+
+// why a run that no breakpoint, watchpoint or predicate stopped has ended
+auto 
+Hack::Computer::end_of_run( std::uint64_t executed ) const -> Run_Result
+{
+   if ( fault_ )
+   {
+      return { fault_->fetch ? Stop_Reason::PC_Out_Of_ROM : Stop_Reason::Memory_Out_Of_Range, executed };
+   }
+
+   return { in_halt_loop() ? Stop_Reason::Halted : Stop_Reason::Budget, executed };
+}
+
+
+// record the std::out_of_range a run caught as fault(), the failing instruction has not executed
+auto 
+Hack::Computer::record_thrown_fault() -> void
+{
+   fault_ = pc_ >= ROM_SIZE ? Fault{ pc_, pc_, true } : Fault{ pc_, cpu_.A_Register(), false };
+}
+
+
+// does the breakpoint at address stop a run, it is unconditional or one of its conditions holds
+auto 
+Hack::Computer::breaks_at( word_t address ) const -> bool
+{
+   auto const found = conditions_.find( address );
+
+   if ( found == conditions_.end() )
+   {
+      return true;
+   }
+
+   auto const A = cpu_.A_Register();
+   auto const D = cpu_.D_Register();
+
+   return std::ranges::any_of( found->second, [&]( Condition const& condition ) { return condition( A, D, address, RAM_ ); } );
+}
+
+
+// the watched accesses of the instruction at pc, if it makes any, read from the decode table
+auto 
+Hack::Computer::watched_access() -> std::optional<Watch_Hit>
+{
+   auto const pc = bounds_check_ == Bounds_Check::Masked ? static_cast<word_t>( pc_ & rom_mask ) : pc_;
+
+   if ( pc >= ROM_SIZE )
+   {
+      return std::nullopt;
+   }
+
+   auto const& instruction = refresh( pc );
+   auto const  address     = bounds_check_ == Bounds_Check::Masked ? cpu_.A_Register() & Memory::address_mask : cpu_.A_Register();
+   auto const  accesses    = ( instruction.reads_M()  ? static_cast<unsigned>( Access::Read )  : 0u ) |
+                             ( instruction.writes_M() ? static_cast<unsigned>( Access::Write ) : 0u );
+
+   if ( accesses == 0 || address >= RAM_SIZE || ( watch_pages_[address / Memory::page_size] & accesses ) == 0 )
+   {
+      return std::nullopt;
+   }
+
+   if ( auto const watched = watches_[address] & accesses )
+   {
+      return Watch_Hit{ pc, static_cast<word_t>( address ), static_cast<Access>( watched ) };
+   }
+
+   return std::nullopt;
+}
+
+/**
+ * @brief   The keyboard poll loop pc is in, @KBD D=M @LOOP D;JEQ
+ * 
+ *    The loop is a straight run of at most max_poll_loop instructions, ending in a jump whose
+ *    address is set by an A-instruction in the run, back to its start.  No instruction in it
+ *    writes M, so the only memory that can change between iterations is the keyboard.
+ */
+auto 
+Hack::Computer::poll_loop() const -> std::optional<Poll_Loop>
+{
+   if ( pc_ >= ROM_SIZE )
+   {
+      return std::nullopt;
+   }
+
+   // the jump that ends the run pc is in
+   auto jump = std::size_t{ pc_ };
+
+   while ( jump < ROM_SIZE && jump - pc_ < max_poll_loop && !decode( rom_->words_[jump] ).is_jump() )
+   {
+      ++jump;
+   }
+
+   if ( jump >= ROM_SIZE || jump - pc_ >= max_poll_loop )
+   {
+      return std::nullopt;
+   }
+
+   // the A-instruction that sets its address
+   auto address = jump;
+
+   while ( address > 0 && jump - address < max_poll_loop )
+   {
+      auto const instruction = decode( rom_->words_[--address] );
+
+      if ( instruction.is_a_instruction() )
+      {
+         break;
+      }
+
+      if ( instruction.is_jump() || ( instruction.dest & Decoded_Instruction::dest_A ) )
+      {
+         return std::nullopt;
+      }
+   }
+
+   auto const head = rom_->words_[address];
+
+   if ( !decode( head ).is_a_instruction() || head > pc_ || head > address || jump - head >= max_poll_loop )
+   {
+      return std::nullopt;
+   }
+
+   for ( auto idx = std::size_t{ head }; idx <= jump; ++idx )
+   {
+      auto const instruction = decode( rom_->words_[idx] );
+
+      if ( instruction.writes_M() || ( idx < jump && instruction.is_jump() ) )
+      {
+         return std::nullopt;
+      }
+   }
+
+   return Poll_Loop{ head, static_cast<word_t>( jump - head + 1 ) };
+}
+
+
+/**
+ * @brief   Is the computer waiting in a keyboard poll loop that it can only leave when the keyboard
+ *          changes
+ * 
+ * @param budget           instructions that may be executed to find out
+ * @return std::uint64_t   the number of instructions in one iteration of the loop, 0 if the computer
+ *                         is not waiting or the budget does not cover two iterations
+ * 
+ *    Executes to the start of the loop and one iteration of it.  When that leaves the registers as
+ *    they were every further iteration does the same, until the keyboard changes.
+ */
+auto 
+Hack::Computer::keyboard_wait( std::uint64_t budget ) -> std::uint64_t
+{
+   auto const loop = poll_loop();
+
+   if ( !loop )
+   {
+      return 0;
+   }
+
+   auto const period = std::uint64_t{ loop->length };
+   auto const align  = pc_ == loop->head ? 0u : std::uint64_t{ loop->head } + loop->length - pc_;
+
+   if ( budget < align + period * 2 )
+   {
+      return 0;
+   }
+
+   execute( align );
+
+   auto const A          = cpu_.A_Register();
+   auto const D          = cpu_.D_Register();
+   auto const ALU_output = cpu_.ALU_Output();
+
+   if ( pc_ != loop->head )
+   {
+      return 0;
+   }
+
+   execute( period );
+
+   auto const unchanged = pc_ == loop->head && cpu_.A_Register() == A && cpu_.D_Register() == D &&
+                          cpu_.ALU_Output() == ALU_output && !fault_;
+
+   return unchanged ? period : 0;
+}
+
+
+/**
+ * @brief   Execute count instructions, each block in the tier its entry address has reached
+ * 
+ *    Every block starts in the interpreter.  Executions are counted at block entries, the
+ *    instruction at the start of a run and every instruction following a jump, and an entry that
+ *    reaches a threshold is promoted to the next tier.  A run stays in one tier until it reaches
+ *    an entry of another tier, and is timed as a whole.
+ */
+auto 
+Hack::Computer::execute_tiered( std::uint64_t count ) -> void
+{
+   while ( count > 0 && !in_halt_loop() )
+   {
+      // a pc outside of ROM fails in the interpreter
+      auto const tier  = pc_ < ROM_SIZE ? tier_[pc_] : Tier::Interpreter;
+      auto const start = Clock::now();
+      auto const built = tier_statistics_.promotion_time;
+
+      auto const before = instructions_;
+
+      try
+      {
+         run_tier( tier, count );
+      }
+      catch ( std::out_of_range const& )
+      {
+         if ( bounds_check_ == Bounds_Check::Throwing )
+         {
+            throw;
+         }
+
+         // the threaded handlers always check, the interpreter applies the policy
+         if ( instructions_ - before < count )
+         {
+            interpret();
+         }
+      }
+
+      auto const executed = instructions_ - before;
+      auto const index    = static_cast<std::size_t>( tier );
+
+      tier_statistics_.instructions[index] += executed;
+      tier_statistics_.time[index]         += Clock::now() - start - ( tier_statistics_.promotion_time - built );
+
+      count -= executed;
+
+      if ( fault_ )
+      {
+         return;
+      }
+   }
+}
+
+
+/**
+ * @brief   Execute instructions in tier until a block entry of another tier is reached
+ * 
+ *    At least one instruction executes unless tier is Native and its block has been discarded, or
+ *    a fault is recorded under Bounds_Check::Flagging.
+ */
+auto 
+Hack::Computer::run_tier( Tier tier, std::uint64_t count ) -> void
+{
+   auto const start    = instructions_;
+   auto const executed = [&] { return instructions_ - start; };
+
+   switch ( tier )
+   {
+      case Tier::Interpreter:
+      {
+         auto entry = true;
+
+         do
+         {
+            auto const address = pc_;
+
+            if ( !interpret() )
+            {
+               break;
+            }
+
+            // a masked pc may have executed from outside of ROM
+            auto const in_rom = address < ROM_SIZE;
+
+            if ( entry && in_rom && ++hotness_[address] >= predecoded_threshold_ )
+            {
+               promote( address, Tier::Predecoded );
+            }
+
+            entry = in_rom && decoded_[address].is_jump();
+
+         }
+         while ( executed() < count && pc_ < ROM_SIZE && ( tier_[pc_] == Tier::Interpreter || !entry ) );
+
+         break;
+      }
+
+      case Tier::Predecoded:
+      {
+         do
+         {
+            auto const address = pc_;
+            auto const before  = instructions_;
+
+            threaded_->run_block( cpu_, rom_->words_, pc_, count - executed(), instructions_ );
+
+            // stopped at a halt loop
+            if ( instructions_ == before )
+            {
+               break;
+            }
+
+            if ( ++hotness_[address] >= native_threshold_ && jit_supported() )
+            {
+               promote( address, Tier::Native );
+            }
+         }
+         while ( executed() < count && pc_ < ROM_SIZE && tier_[pc_] == Tier::Predecoded );
+
+         break;
+      }
+
+      case Tier::Native:
+      {
+         instructions_ += jit_->run( cpu_, rom_->words_, pc_, count, false );
+
+         if ( executed() == 0 )
+         {
+            if ( !jit_->compiled( pc_ ) )
+            {
+               // ROM has been written, the block warms up again from the interpreter
+               tier_[pc_]    = Tier::Interpreter;
+               hotness_[pc_] = 0;
+               ++tier_statistics_.demotions;
+
+               break;
+            }
+
+            // the budget does not cover the block, or its first instruction needs the interpreter
+            interpret();
+         }
+
+         break;
+      }
+
+      case Tier::Idiom:
+      {
+         auto const head   = pc_;
+         auto const length = idioms_->length( rom_->words_, head );
+
+         if ( length == 0 )
+         {
+            // ROM has been written, the loop warms up again from the interpreter
+            tier_[head]    = Tier::Interpreter;
+            hotness_[head] = 0;
+            ++tier_statistics_.demotions;
+
+            break;
+         }
+
+         instructions_ += idioms_->run( cpu_, head, count );
+
+         if ( executed() > 0 )
+         {
+            break;
+         }
+
+         // the iteration leaves the loop, would fault or does not fit in the budget
+         do
+         {
+            if ( !interpret() )
+            {
+               break;
+            }
+         }
+         while ( executed() < count && pc_ > head && pc_ < head + length );
+
+         break;
+      }
+   }
+}
+
+
+// build the form of the block entered at address for tier, the block stays in its tier on failure
+auto 
+Hack::Computer::promote( word_t address, Tier tier ) -> void
+{
+   auto const start = Clock::now();
+
+   switch ( tier )
+   {
+      case Tier::Interpreter:
+      {
+         break;
+      }
+
+      case Tier::Predecoded:
+      {
+         if ( !idioms_ )
+         {
+            idioms_ = std::make_unique<Loop_Idioms>( RAM_ );
+            idioms_->load( rom_->words_ );
+         }
+
+         // a loop that can run in bulk goes straight to it
+         if ( idioms_->recognise( rom_->words_, address ) != Loop_Idioms::Kind::None )
+         {
+            tier = Tier::Idiom;
+            break;
+         }
+
+         if ( !threaded_ )
+         {
+            threaded_ = std::make_unique<Threaded_Engine>( RAM_ );
+            threaded_->load( rom_->words_ );
+         }
+         break;
+      }
+
+      case Tier::Idiom:
+      {
+         break;
+      }
+
+      case Tier::Native:
+      {
+         if ( !jit_ )
+         {
+            jit_ = std::make_unique<JIT_Engine>( RAM_ );
+            jit_->load( rom_->words_ );
+         }
+
+         if ( !jit_->prepare( rom_->words_, address ) )
+         {
+            hotness_[address] = 0;        // try again after another native_threshold_ executions
+            tier_statistics_.promotion_time += Clock::now() - start;
+            return;
+         }
+         break;
+      }
+   }
+
+   tier_[address]    = tier;
+   hotness_[address] = 0;
+   ++tier_statistics_.promotions[static_cast<std::size_t>( tier )];
+   tier_statistics_.promotion_time += Clock::now() - start;
+}
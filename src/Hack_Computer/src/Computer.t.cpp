@@ -9,15 +9,24 @@
  * 
  */
 #include "Hack/Computer.h"
+#include "Hack/Test_Programs.h"
 
 #include <algorithm>          // equal
 #include <catch2/catch_all.hpp>
 #include <cstdint>
+#include <filesystem>   // temp_directory_path
+#include <fstream>      // ofstream
 #include <iostream>
 #include <iterator>
+#include <memory>       // make_shared
 
 #include <numeric>      // iota
+#include <random>       // random_device
 #include <sstream>      // string_stream
+#include <stdexcept>    // invalid_argument, runtime_error
+#include <string>       // to_string
+#include <thread>       // thread
+#include <utility>      // as_const
 #include <vector>
 
 TEST_CASE( "Computer: Load ROM" )
@@ -66,4 +75,1143 @@ TEST_CASE( "Computer: Load ROM" )
          REQUIRE( rng::equal( instructions, computer.ROM() ) );
       }
    }
-}
\ No newline at end of file
+}
+
+namespace
+{
+   // RAM[2] = RAM[0] + RAM[1], then loop forever
+   auto const add_program = std::vector<std::uint16_t>
+   {
+      0x0000,     // @0
+      0xFC10,     // D=M
+      0x0001,     // @1
+      0xF090,     // D=D+M
+      0x0002,     // @2
+      0xE308,     // M=D
+      0x0006,     // @6
+      0xEA87      // 0;JMP
+   };
+}
+
+
+TEST_CASE( "Computer: execute" )
+{
+   using namespace Hack;
+
+   auto computer = Computer();
+   computer.load_rom( add_program );
+
+   computer.RAM()[0] = 19;
+   computer.RAM()[1] = 23;
+
+   SECTION( "run program" )
+   {
+      for ( auto count = 0; count < 8; ++count )
+      {
+         computer.execute();
+      }
+
+      REQUIRE( computer.RAM()[2] == 42 );
+      REQUIRE( computer.pc()     == 6 );
+   }
+
+   SECTION( "writes through ROM() are seen by the next execute" )
+   {
+      computer.ROM()[3] = 0xF4D0;     // D=D-M
+
+      for ( auto count = 0; count < 6; ++count )
+      {
+         computer.execute();
+      }
+
+      REQUIRE( computer.decoded( 3 ) == decode( 0xF4D0 ) );
+      REQUIRE( computer.RAM()[2] == static_cast<std::uint16_t>( 19 - 23 ) );
+   }
+
+   SECTION( "execution continues from a pc set through pc()" )
+   {
+      computer.pc() = 2;
+      computer.execute();
+
+      REQUIRE( computer.A_Register() == 1 );
+      REQUIRE( computer.pc()         == 3 );
+   }
+
+   SECTION( "decoded table is rebuilt by load_rom" )
+   {
+      computer.load_rom( std::vector<std::uint16_t>{ 0xEA87 } );
+
+      REQUIRE( computer.decoded( 0 ) == decode( 0xEA87 ) );
+      REQUIRE( computer.decoded( 1 ) == decode( 0xFC10 ) );
+   }
+}
+
+
+namespace
+{
+   auto require_same_state( Hack::Computer const& lhs, Hack::Computer const& rhs ) -> void
+   {
+      REQUIRE( lhs.pc()         == rhs.pc() );
+      REQUIRE( lhs.A_Register() == rhs.A_Register() );
+      REQUIRE( lhs.D_Register() == rhs.D_Register() );
+      REQUIRE( lhs.ALU_output() == rhs.ALU_output() );
+      REQUIRE( std::equal( lhs.RAM().ram_begin(), lhs.RAM().ram_end(), rhs.RAM().ram_begin() ) );
+   }
+}
+
+
+TEST_CASE( "Computer: tiered engine" )
+{
+   using namespace Hack;
+
+   auto interpreted = Computer();
+   auto tiered      = Computer();
+
+   interpreted.load_rom( Test_Programs::multiply_looping );
+   tiered.load_rom( Test_Programs::multiply_looping );
+   tiered.set_engine( Computer::Engine::Tiered );
+   tiered.set_tier_thresholds( 4, 16 );
+
+   for ( auto* computer : { &interpreted, &tiered } )
+   {
+      computer->RAM()[0] = 300;
+      computer->RAM()[1] = 200;
+   }
+
+   auto const hot_tier = Computer::jit_supported() ? Computer::Tier::Native : Computer::Tier::Predecoded;
+
+   SECTION( "short runs stay in the interpreter" )
+   {
+      tiered.execute( 12 );
+      interpreted.execute( 12 );
+
+      require_same_state( interpreted, tiered );
+
+      auto const& statistics = tiered.tier_statistics();
+
+      REQUIRE( statistics.instructions[0] == 12 );
+      REQUIRE( statistics.promotions[1]   == 0 );
+      REQUIRE( tiered.tier( 2 ) == Computer::Tier::Interpreter );
+      REQUIRE( tiered.hotness( 0 ) == 1 );      // the start of the run
+      REQUIRE( tiered.hotness( 2 ) == 0 );      // reached without a jump
+      REQUIRE( tiered.hotness( 6 ) == 1 );      // follows D;JEQ
+   }
+
+   SECTION( "hot blocks are promoted and results match the interpreter at every budget" )
+   {
+      for ( auto const budget : { 1u, 3u, 5u, 17u, 64u, 100u, 1'000u, 10'000u } )
+      {
+         tiered.execute( budget );
+         interpreted.execute( budget );
+
+         require_same_state( interpreted, tiered );
+      }
+
+      auto const& statistics = tiered.tier_statistics();
+
+      REQUIRE( tiered.RAM()[2] == static_cast<std::uint16_t>( 300 * 200 ) );
+      REQUIRE( tiered.tier( 2 ) == hot_tier );
+      REQUIRE( tiered.tier( 6 ) == hot_tier );
+      REQUIRE( statistics.promotions[1] >= 2 );
+      REQUIRE( statistics.instructions[0] + statistics.instructions[1] + statistics.instructions[2] == 11'190 );
+
+      if ( Computer::jit_supported() )
+      {
+         REQUIRE( statistics.promotions[2] >= 2 );
+         REQUIRE( statistics.instructions[2] > statistics.instructions[0] );
+      }
+   }
+
+   SECTION( "a ROM write sends a native block back to the interpreter" )
+   {
+      tiered.execute( 5'000 );
+      interpreted.execute( 5'000 );
+
+      for ( auto* computer : { &interpreted, &tiered } )
+      {
+         computer->ROM()[3] = 0xEC10;      // @1  D=A   instead of D=M, the loop no longer ends
+      }
+
+      tiered.execute( 5'000 );
+      interpreted.execute( 5'000 );
+
+      require_same_state( interpreted, tiered );
+
+      if ( Computer::jit_supported() )
+      {
+         REQUIRE( tiered.tier_statistics().demotions >= 1 );
+      }
+   }
+
+   SECTION( "load_rom starts over in the interpreter" )
+   {
+      tiered.execute( 5'000 );
+      tiered.load_rom( Test_Programs::multiply_looping );
+
+      REQUIRE( tiered.tier( 2 ) == Computer::Tier::Interpreter );
+      REQUIRE( tiered.tier_statistics().instructions[0] == 0 );
+   }
+}
+
+
+TEST_CASE( "Computer: run" )
+{
+   using namespace Hack;
+   using Stop_Reason = Computer::Stop_Reason;
+
+   auto computer = Computer();
+   computer.load_rom( add_program );
+
+   computer.RAM()[0] = 19;
+   computer.RAM()[1] = 23;
+
+   SECTION( "stops when the budget is exhausted" )
+   {
+      auto const result = computer.run( 5 );
+
+      REQUIRE( result.reason   == Stop_Reason::Budget );
+      REQUIRE( result.executed == 5 );
+      REQUIRE( computer.instruction_count() == 5 );
+      REQUIRE( computer.pc() == 5 );
+   }
+
+   SECTION( "stops at a halt loop" )
+   {
+      auto const first = computer.run( 6 );
+
+      REQUIRE( first.reason   == Stop_Reason::Halted );
+      REQUIRE( first.executed == 6 );
+      REQUIRE( computer.in_halt_loop() );
+
+      auto const second = computer.run( 1'000 );
+
+      REQUIRE( second.reason   == Stop_Reason::Halted );
+      REQUIRE( second.executed == 0 );
+      REQUIRE( computer.RAM()[2] == 42 );
+
+      REQUIRE( computer.status() == Computer::Status::Halted );
+
+      // the halt loop itself is never executed
+      computer.execute( 1'000 );
+
+      REQUIRE( computer.instruction_count() == 6 );
+
+      for ( auto const engine : { Computer::Engine::Interpreter, Computer::Engine::Threaded,
+                                  Computer::Engine::JIT,         Computer::Engine::Tiered } )
+      {
+         computer.reset();
+         computer.set_engine( engine );
+         computer.RAM()[0] = 19;
+         computer.RAM()[1] = 23;
+
+         REQUIRE( computer.status() == Computer::Status::Running );
+
+         auto const third = computer.run( 1'000'000 );
+
+         REQUIRE( third.reason   == Stop_Reason::Halted );
+         REQUIRE( third.executed == 6 );
+         REQUIRE( computer.pc()  == 6 );
+      }
+   }
+
+   SECTION( "stops at a jump to itself" )
+   {
+      // @3 M=D @4 0;JMP  jumps to  (4) 0;JMP  with A = 4
+      computer.load_rom( std::vector<std::uint16_t>{ 0x0003, 0xE308, 0x0004, 0xEA87, 0xEA87 } );
+
+      for ( auto const engine : { Computer::Engine::Interpreter, Computer::Engine::Threaded,
+                                  Computer::Engine::JIT,         Computer::Engine::Tiered } )
+      {
+         computer.reset();
+         computer.set_engine( engine );
+
+         auto const result = computer.run( 1'000'000 );
+
+         REQUIRE( result.reason   == Stop_Reason::Halted );
+         REQUIRE( result.executed == 4 );
+         REQUIRE( computer.pc()   == 4 );
+      }
+   }
+
+   SECTION( "stops at a breakpoint and resumes from it" )
+   {
+      computer.add_breakpoint( 4 );
+
+      REQUIRE( computer.has_breakpoint( 4 ) );
+
+      auto const first = computer.run( 1'000 );
+
+      REQUIRE( first.reason   == Stop_Reason::Breakpoint );
+      REQUIRE( first.executed == 4 );
+      REQUIRE( computer.pc()  == 4 );
+
+      auto const second = computer.run( 1'000 );
+
+      REQUIRE( second.reason   == Stop_Reason::Halted );
+      REQUIRE( computer.RAM()[2] == 42 );
+
+      computer.remove_breakpoint( 4 );
+      REQUIRE_FALSE( computer.has_breakpoint( 4 ) );
+   }
+
+   SECTION( "reports a pc past the end of ROM" )
+   {
+      computer.load_rom( std::vector<std::uint16_t>{ 0x7FFF, 0xEA87 } );      // @32767  0;JMP
+
+      auto const result = computer.run( 10 );
+
+      REQUIRE( result.reason   == Stop_Reason::PC_Out_Of_ROM );
+      REQUIRE( result.executed == 2 );
+   }
+
+   SECTION( "reports an out of range M access" )
+   {
+      computer.load_rom( std::vector<std::uint16_t>{ 0x7FFF, 0xFC10 } );      // @32767  D=M
+
+      auto const result = computer.run( 10 );
+
+      REQUIRE( result.reason   == Stop_Reason::Memory_Out_Of_Range );
+      REQUIRE( result.executed == 1 );
+      REQUIRE( computer.pc()   == 1 );
+      REQUIRE( computer.status() == Computer::Status::Faulted );
+      REQUIRE( computer.fault()->address == 0x7FFF );
+   }
+
+   SECTION( "run_until a predicate holds" )
+   {
+      auto const result = computer.run_until( []( Computer const& c ) { return c.RAM()[2] == 42; }, 1'000 );
+
+      REQUIRE( result.reason   == Stop_Reason::Predicate );
+      REQUIRE( result.executed == 6 );
+   }
+
+   SECTION( "run_until a predicate stops at breakpoints and resumes from them" )
+   {
+      computer.load_rom( Test_Programs::counting );
+      computer.RAM()[0] = 0;
+      computer.add_breakpoint( 1 );
+
+      auto const counted = []( Computer const& c ) { return c.RAM()[0] == 5; };
+      auto const first   = computer.run_until( counted, 100 );
+
+      REQUIRE( first.reason   == Stop_Reason::Breakpoint );
+      REQUIRE( first.executed == 1 );
+      REQUIRE( computer.pc()  == 1 );
+
+      auto const second = computer.run_until( counted, 100 );
+
+      REQUIRE( second.reason     == Stop_Reason::Breakpoint );
+      REQUIRE( second.executed   == 4 );
+      REQUIRE( computer.RAM()[0] == 1 );
+
+      computer.remove_breakpoint( 1 );
+
+      auto const third = computer.run_until( counted, 100 );
+
+      REQUIRE( third.reason      == Stop_Reason::Predicate );
+      REQUIRE( third.executed    == 13 );
+      REQUIRE( computer.RAM()[0] == 5 );
+   }
+
+   SECTION( "run_until a deadline that has passed" )
+   {
+      auto const result = computer.run_until( Computer::Clock::now() );
+
+      REQUIRE( result.reason   == Stop_Reason::Deadline );
+      REQUIRE( result.executed == 0 );
+   }
+
+   SECTION( "every engine stops in the same state" )
+   {
+      auto interpreted = Computer();
+      interpreted.load_rom( Test_Programs::multiply_looping );
+      interpreted.RAM()[0] = 300;
+      interpreted.RAM()[1] = 200;
+
+      auto const expected = interpreted.run( 100'000 );
+
+      for ( auto const engine : { Computer::Engine::Threaded, Computer::Engine::JIT, Computer::Engine::Tiered } )
+      {
+         computer.load_rom( Test_Programs::multiply_looping );
+         computer.reset();
+         computer.set_engine( engine );
+         computer.RAM()[0] = 300;
+         computer.RAM()[1] = 200;
+
+         auto const result = computer.run( 100'000 );
+
+         REQUIRE( result.reason   == expected.reason );
+         REQUIRE( result.executed == expected.executed );
+         require_same_state( interpreted, computer );
+      }
+   }
+}
+
+
+TEST_CASE( "Computer: bounds check policies" )
+{
+   using namespace Hack;
+   using Stop_Reason  = Computer::Stop_Reason;
+   using Bounds_Check = Computer::Bounds_Check;
+
+   auto const engines = { Computer::Engine::Interpreter, Computer::Engine::Threaded,
+                          Computer::Engine::JIT,         Computer::Engine::Tiered };
+
+   // A = 5 + 16384 + 16384, one past the address space
+   auto const wrapping = std::vector<std::uint16_t>
+   {
+      0x0005, 0xEC10,                     // @5      D=A
+      0x4000, 0xE090,                     // @16384  D=D+A
+      0x4000, 0xE090,                     // @16384  D=D+A
+      0xE320, 0xEFC8                      // A=D     M=1
+   };
+
+   auto computer = Computer();
+
+   REQUIRE( computer.bounds_check() == Bounds_Check::Throwing );
+
+   SECTION( "throwing is the default" )
+   {
+      computer.load_rom( wrapping );
+
+      REQUIRE_THROWS_AS( computer.execute( 8 ), std::out_of_range );
+      REQUIRE( computer.pc() == 7 );
+   }
+
+   SECTION( "flagging records the fault and stops" )
+   {
+      for ( auto const engine : engines )
+      {
+         computer.set_engine( engine );
+         computer.set_bounds_check( Bounds_Check::Flagging );
+         computer.load_rom( std::vector<std::uint16_t>{ 0x7FFF, 0xFC10 } );      // @32767  D=M
+
+         REQUIRE_NOTHROW( computer.execute( 10 ) );
+         REQUIRE( computer.fault().has_value() );
+         REQUIRE( computer.fault()->pc      == 1 );
+         REQUIRE( computer.fault()->address == 0x7FFF );
+         REQUIRE_FALSE( computer.fault()->fetch );
+         REQUIRE( computer.instruction_count() == 1 );
+         REQUIRE( computer.pc() == 1 );
+
+         computer.load_rom( std::vector<std::uint16_t>{ 0x7FFF, 0xEA87 } );      // @32767  0;JMP
+
+         auto const result = computer.run( 10 );
+
+         REQUIRE( result.reason   == Stop_Reason::PC_Out_Of_ROM );
+         REQUIRE( result.executed == 2 );
+         REQUIRE( computer.fault()->fetch );
+         REQUIRE( computer.fault()->address == 0x7FFF );
+
+         computer.clear_fault();
+         REQUIRE_FALSE( computer.fault().has_value() );
+      }
+   }
+
+   SECTION( "masked addresses wrap without checks" )
+   {
+      for ( auto const engine : engines )
+      {
+         computer.set_engine( engine );
+         computer.set_bounds_check( Bounds_Check::Masked );
+         computer.load_rom( wrapping );
+         computer.reset();
+
+         REQUIRE_NOTHROW( computer.execute( 8 ) );
+         REQUIRE( computer.RAM()[5] == 1 );
+         REQUIRE( computer.pc() == 8 );
+      }
+   }
+}
+
+
+TEST_CASE( "Computer: keyboard poll loops are fast-forwarded" )
+{
+   using namespace Hack;
+   using Stop_Reason = Computer::Stop_Reason;
+
+   // wait for a key, RAM[5] = key
+   auto const wait_for_key = std::vector<std::uint16_t>
+   {
+      0x6000, 0xFC10, 0x0000, 0xE302,     // (LOOP) @KBD  D=M  @LOOP  D;JEQ
+      0x0005, 0xE308,                     // @5  M=D
+      0x0006, 0xEA87                      // (END) @END 0;JMP
+   };
+
+   for ( auto const engine : { Computer::Engine::Interpreter, Computer::Engine::Threaded,
+                               Computer::Engine::JIT,         Computer::Engine::Tiered } )
+   {
+      auto computer = Computer();
+      auto spinning = Computer();
+
+      computer.load_rom( wait_for_key );
+      spinning.load_rom( wait_for_key );
+      computer.set_engine( engine );
+
+      // start part way through an iteration
+      computer.execute( 2 );
+      spinning.execute( 2 );
+
+      auto const result = computer.run( 1'000'001 );
+
+      spinning.execute( 1'000'001 );
+
+      REQUIRE( result.reason   == Stop_Reason::Budget );
+      REQUIRE( result.executed == 1'000'001 );
+      REQUIRE( computer.skipped_instructions() > 990'000 );
+      REQUIRE( computer.instruction_count() == spinning.instruction_count() );
+      REQUIRE( computer.pc()         == spinning.pc() );
+      REQUIRE( computer.A_Register() == spinning.A_Register() );
+      REQUIRE( computer.D_Register() == spinning.D_Register() );
+      REQUIRE( computer.ALU_output() == spinning.ALU_output() );
+
+      REQUIRE( computer.run_until( Computer::Clock::now() + std::chrono::hours( 1 ) ).reason == Stop_Reason::Keyboard_Wait );
+
+      computer.keyboard() = 'K';
+
+      REQUIRE( computer.run( 1'000'000 ).reason == Stop_Reason::Halted );
+      REQUIRE( computer.RAM()[5] == 'K' );
+   }
+}
+
+
+TEST_CASE( "Computer: shared ROM images" )
+{
+   using namespace Hack;
+
+   auto const image = std::make_shared<Shared_ROM>( add_program );
+   auto       fleet = std::vector<Computer>( 8 );
+
+   for ( auto& computer : fleet )
+   {
+      computer.load_rom( image );
+   }
+
+   REQUIRE( image.use_count() == 9 );
+   REQUIRE( image->decoded()[3] == decode( add_program[3] ) );
+
+   SECTION( "every computer runs the one image" )
+   {
+      for ( auto const engine : { Computer::Engine::Interpreter, Computer::Engine::Threaded,
+                                  Computer::Engine::JIT,         Computer::Engine::Tiered } )
+      {
+         auto& computer = fleet[static_cast<std::size_t>( engine )];
+
+         computer.set_engine( engine );
+         computer.RAM()[0] = static_cast<std::uint16_t>( engine );
+         computer.RAM()[1] = 40;
+
+         REQUIRE( computer.run( 100 ).reason == Computer::Stop_Reason::Halted );
+         REQUIRE( computer.RAM()[2] == 40 + static_cast<std::uint16_t>( engine ) );
+         REQUIRE( &std::as_const( computer ).ROM() == &image->words() );
+      }
+
+      REQUIRE( image.use_count() == 9 );
+   }
+
+   SECTION( "writing through ROM() copies the image first" )
+   {
+      auto& computer = fleet[0];
+
+      computer.ROM()[5] = 0xE310;     // D=M writes D instead of M
+
+      REQUIRE( image.use_count() == 8 );
+      REQUIRE( image->words()[5] == 0xE308 );
+      REQUIRE( &std::as_const( computer ).ROM() != &image->words() );
+
+      computer.RAM()[1] = 7;
+      fleet[1].RAM()[1] = 7;
+      computer.execute( 8 );
+      fleet[1].execute( 8 );
+
+      REQUIRE( computer.RAM()[2] == 0 );
+      REQUIRE( fleet[1].RAM()[2] == 7 );
+
+      // the copy is this computer's own now
+      auto const* const words = &std::as_const( computer ).ROM();
+
+      computer.ROM()[6] = 0x0000;
+
+      REQUIRE( &std::as_const( computer ).ROM() == words );
+   }
+
+   SECTION( "clearing or reloading detaches from the image" )
+   {
+      fleet[0].clear_rom();
+      fleet[1].load_rom( add_program );
+
+      REQUIRE( image.use_count() == 7 );
+      REQUIRE( fleet[0].ROM()[0] == 0 );
+      REQUIRE( fleet[1].ROM()[1] == 0xFC10 );
+      REQUIRE( image->words()[1] == 0xFC10 );
+
+      REQUIRE_THROWS_AS( fleet[2].load_rom( std::shared_ptr<Shared_ROM>() ), std::invalid_argument );
+   }
+}
+
+
+TEST_CASE( "Computer: fork" )
+{
+   using namespace Hack;
+   using Engine = Computer::Engine;
+
+   auto parent = Computer();
+
+   parent.load_rom( Test_Programs::multiply );
+   parent.set_engine( Engine::Tiered );
+   parent.RAM()[0] = 1'000;
+   parent.RAM()[1] = 3;
+   parent.execute( 4'321 );
+
+   auto children = parent.fork( 4 );
+
+   REQUIRE( children.size() == 4 );
+
+   for ( auto const& child : children )
+   {
+      REQUIRE( child->pc()                == parent.pc() );
+      REQUIRE( child->A_Register()        == parent.A_Register() );
+      REQUIRE( child->D_Register()        == parent.D_Register() );
+      REQUIRE( child->instruction_count() == parent.instruction_count() );
+      REQUIRE( child->engine()            == Engine::Tiered );
+      REQUIRE( child->RAM()[2]            == parent.RAM()[2] );
+      REQUIRE( &std::as_const( *child ).ROM() == &std::as_const( parent ).ROM() );
+   }
+
+   SECTION( "children run on their own threads without touching each other or the parent" )
+   {
+      auto threads = std::vector<std::thread>();
+
+      for ( auto idx = 0uz; idx < children.size(); ++idx )
+      {
+         threads.emplace_back( [&child = *children[idx], idx]
+         {
+            child.set_engine( static_cast<Engine>( idx ) );
+
+            // the last child doubles the rest of the product
+            if ( idx == 3 )
+            {
+               child.RAM()[1] = 6;
+            }
+
+            child.run( 1'000'000 );
+         } );
+      }
+
+      for ( auto& thread : threads )
+      {
+         thread.join();
+      }
+
+      REQUIRE( parent.RAM()[1] == 3 );
+
+      parent.run( 1'000'000 );
+
+      REQUIRE( parent.RAM()[2] == 3'000 );
+
+      for ( auto idx = 0uz; idx < 3; ++idx )
+      {
+         REQUIRE( children[idx]->status()  == Computer::Status::Halted );
+         REQUIRE( children[idx]->RAM()[2]  == 3'000 );
+         REQUIRE( children[idx]->instruction_count() == parent.instruction_count() );
+      }
+
+      REQUIRE( children[3]->RAM()[2] > 3'000 );
+      REQUIRE( children[3]->RAM()[1] == 6 );
+   }
+
+   SECTION( "a ROM written before the fork is decoded for every child" )
+   {
+      auto& rom = parent.ROM();
+
+      rom[9] = 0xF1C8;     // M=M-D instead of M=D+M
+
+      auto child = parent.fork();
+
+      child->RAM()[0] = 2;
+      child->RAM()[1] = 5;
+      child->RAM()[2] = 0;
+      child->pc()     = 2;
+      child->run( 1'000 );
+
+      REQUIRE( child->RAM()[2] == 65'526 );  // 0 - 5 - 5
+      REQUIRE( child->decoded( 9 ) == decode( 0xF1C8 ) );
+   }
+}
+
+
+TEST_CASE( "Computer: snapshots" )
+{
+   using namespace Hack;
+   using Snapshot = Computer::Snapshot;
+
+   auto computer = Computer();
+
+   computer.load_rom( Test_Programs::multiply );
+   computer.RAM()[0] = 500;
+   computer.RAM()[1] = 7;
+   computer.screen_begin()[9] = 0x00FF;
+   computer.keyboard()        = 'k';
+   computer.execute( 1'234 );
+
+   auto const pc       = computer.pc();
+   auto const A        = computer.A_Register();
+   auto const D        = computer.D_Register();
+   auto const ALU      = computer.ALU_output();
+   auto const count    = computer.instruction_count();
+   auto const product  = computer.RAM()[2];
+   auto const snapshot = computer.snapshot();
+
+   REQUIRE( snapshot.header().magic == Snapshot::file_magic );
+   REQUIRE( snapshot.header().pc    == pc );
+
+   computer.run( 1'000'000 );
+
+   auto const halted_count = computer.instruction_count();
+
+   REQUIRE( computer.RAM()[2] == 3'500 );
+
+   auto const require_restored = [&]( Computer const& restored )
+   {
+      REQUIRE( restored.pc()                == pc );
+      REQUIRE( restored.A_Register()        == A );
+      REQUIRE( restored.D_Register()        == D );
+      REQUIRE( restored.ALU_output()        == ALU );
+      REQUIRE( restored.instruction_count() == count );
+      REQUIRE( restored.RAM()[2]            == product );
+      REQUIRE( restored.screen_cbegin()[9]  == 0x00FF );
+      REQUIRE( restored.keyboard()          == 'k' );
+   };
+
+   SECTION( "a restored computer continues as the original did" )
+   {
+      computer.restore( snapshot );
+      require_restored( computer );
+
+      computer.run( 1'000'000 );
+
+      REQUIRE( computer.RAM()[2] == 3'500 );
+      REQUIRE( computer.instruction_count() == halted_count );
+   }
+
+   SECTION( "any computer running the same program can be restored" )
+   {
+      auto other = Computer();
+
+      other.load_rom( Test_Programs::multiply );
+      other.set_engine( Computer::Engine::Tiered );
+      other.restore( snapshot );
+      require_restored( other );
+
+      other.run( 1'000'000 );
+
+      REQUIRE( other.RAM()[2] == 3'500 );
+   }
+
+   SECTION( "faults are part of the state" )
+   {
+      computer.set_bounds_check( Computer::Bounds_Check::Flagging );
+      computer.A_Register() = 0x7FFF;
+      computer.pc() = 9;
+      computer.execute();
+      computer.RAM().access<Bounds::Flagging>( 0x7FFE ) = 1;
+
+      auto const faulted = computer.snapshot();
+
+      computer.clear_fault();
+      computer.restore( faulted );
+
+      REQUIRE( computer.fault().has_value() );
+      REQUIRE( computer.fault()->address == 0x7FFF );
+      REQUIRE( computer.RAM().fault() == 0x7FFE );
+   }
+
+   SECTION( "snapshot files" )
+   {
+      auto const path = std::filesystem::temp_directory_path() / ( "hack_snapshot_" + std::to_string( std::random_device()() ) );
+
+      snapshot.save( path );
+
+      REQUIRE( std::filesystem::file_size( path ) == Snapshot::file_size );
+
+      auto const loaded = Snapshot::load( path );
+
+      REQUIRE( loaded.header().instructions == count );
+
+      computer.restore( loaded );
+      require_restored( computer );
+
+      // the file is mapped privately, running on does not change it
+      computer.run( 1'000'000 );
+      computer.restore( Snapshot::load( path ) );
+      require_restored( computer );
+
+      std::filesystem::resize_file( path, Snapshot::file_size - 2 );
+
+      REQUIRE_THROWS_AS( Snapshot::load( path ), std::runtime_error );
+
+      std::ofstream( path, std::ios::binary | std::ios::trunc ) << "not a snapshot";
+
+      REQUIRE_THROWS_AS( Snapshot::load( path ), std::runtime_error );
+      REQUIRE_THROWS_AS( Snapshot::load( path.string() + ".missing" ), std::runtime_error );
+
+      std::filesystem::remove( path );
+   }
+}
+
+
+TEST_CASE( "Computer: reverse execution" )
+{
+   using namespace Hack;
+
+   struct State
+   {
+      std::uint16_t pc, A, D, ALU;
+      std::uint64_t count;
+      std::vector<std::uint16_t> ram;
+
+      auto operator==( State const& ) const -> bool = default;
+   };
+
+   auto const state = []( Computer const& computer )
+   {
+      return State{ computer.pc(), computer.A_Register(), computer.D_Register(), computer.ALU_output(),
+                    computer.instruction_count(), std::vector<std::uint16_t>( computer.RAM().ram_cbegin(), computer.RAM().ram_cbegin() + 16 ) };
+   };
+
+   auto computer = Computer();
+
+   computer.load_rom( Test_Programs::multiply );
+   computer.RAM()[0] = 300;
+   computer.RAM()[1] = 7;
+
+   SECTION( "without a journal nothing is recorded" )
+   {
+      computer.execute( 100 );
+
+      REQUIRE_FALSE( computer.journal_enabled() );
+      REQUIRE( computer.journal_depth() == 0 );
+      REQUIRE( computer.rewind( 10 ) == 0 );
+      REQUIRE( computer.instruction_count() == 100 );
+   }
+
+   SECTION( "every instruction can be undone one at a time" )
+   {
+      computer.enable_journal();
+
+      auto states = std::vector<State>{ state( computer ) };
+
+      for ( auto step = 0; step < 2'000; ++step )
+      {
+         computer.execute();
+         states.push_back( state( computer ) );
+      }
+
+      REQUIRE( computer.journal_depth() == 2'000 );
+
+      for ( auto step = states.size() - 1; step > 0; --step )
+      {
+         REQUIRE( computer.rewind( 1 ) == 1 );
+         REQUIRE( state( computer ) == states[step - 1] );
+      }
+
+      REQUIRE( computer.journal_depth() == 0 );
+      REQUIRE( computer.rewind( 1 ) == 0 );
+
+      // running again records the same run
+      computer.run( 1'000'000 );
+
+      auto const count = computer.instruction_count();
+
+      REQUIRE( computer.RAM()[2] == 2'100 );
+      REQUIRE( computer.rewind( count - 1'000 ) == count - 1'000 );
+      REQUIRE( state( computer ) == states[1'000] );
+   }
+
+   SECTION( "a rewound computer runs on as the original did" )
+   {
+      computer.set_engine( Computer::Engine::Tiered );
+      computer.enable_journal();
+      computer.run( 3'000 );
+
+      auto const expected = state( computer );
+
+      REQUIRE( computer.rewind( 1'210 ) == 1'210 );
+      REQUIRE( computer.instruction_count() == 1'790 );
+
+      computer.run( 1'210 );
+
+      REQUIRE( state( computer ) == expected );
+
+      computer.run( 1'000'000 );
+
+      REQUIRE( computer.RAM()[2] == 2'100 );
+   }
+
+   SECTION( "A, D and M written by one instruction are all undone" )
+   {
+      // @5, AMD=M+1, @0, 0;JMP
+      computer.load_rom( std::vector<std::uint16_t>{ 0x0005, 0xFDF8, 0x0000, 0xEA87 } );
+      computer.RAM()[5] = 40;
+      computer.enable_journal();
+
+      auto const before = state( computer );
+
+      computer.execute( 400 );
+
+      REQUIRE( computer.RAM()[5] == 140 );
+      REQUIRE( computer.rewind( 400 ) == 400 );
+      REQUIRE( state( computer ) == before );
+   }
+
+   SECTION( "further back than the records the computer returns to a checkpoint" )
+   {
+      computer.RAM()[0] = 30'000;
+      computer.enable_journal( 1, 10'000 );
+      computer.run( 100'000 );
+
+      // two chunks of records hold one to two thousand instructions
+      REQUIRE( computer.journal_depth() > 500 );
+      REQUIRE( computer.journal_depth() < 10'000 );
+
+      REQUIRE( computer.rewind( 500 ) == 500 );
+
+      auto const recent = state( computer );
+
+      computer.run( 500 );
+
+      REQUIRE( computer.rewind( 45'000 ) == 50'000 );
+      REQUIRE( computer.instruction_count() == 50'000 );
+
+      computer.run( 49'500 );
+
+      REQUIRE( state( computer ) == recent );
+
+      // the last eight checkpoints are kept, the oldest is at 30'000
+      REQUIRE( computer.rewind( 1'000'000 ) == 69'500 );
+      REQUIRE( computer.instruction_count() == 30'000 );
+      REQUIRE( computer.rewind( 1 ) == 0 );
+   }
+
+   SECTION( "a reset or a new program starts a new journal" )
+   {
+      computer.enable_journal();
+      computer.execute( 100 );
+      computer.reset();
+
+      REQUIRE( computer.journal_depth() == 0 );
+      REQUIRE( computer.rewind( 50 ) == 0 );
+
+      computer.execute( 100 );
+      computer.load_rom( Test_Programs::multiply );
+
+      REQUIRE( computer.journal_depth() == 0 );
+      REQUIRE( computer.journal_enabled() );
+
+      computer.disable_journal();
+
+      REQUIRE( computer.rewind( 50 ) == 0 );
+   }
+
+   SECTION( "keyboard poll loops are executed and recorded" )
+   {
+      // (LOOP) @KBD, D=M, @LOOP, D;JEQ
+      computer.load_rom( std::vector<std::uint16_t>{ 0x6000, 0xFC10, 0x0000, 0xE302 } );
+      computer.enable_journal();
+
+      REQUIRE( computer.run( 10'000 ).executed == 10'000 );
+      REQUIRE( computer.skipped_instructions() == 0 );
+      REQUIRE( computer.rewind( 10'000 ) == 10'000 );
+   }
+}
+
+
+TEST_CASE( "Computer: watchpoints" )
+{
+   using namespace Hack;
+   using Access      = Computer::Access;
+   using Stop_Reason = Computer::Stop_Reason;
+
+   // @5, D=A, @20, M=D, @20, D=M, @16390, M=D, @21, M=M+1, (END) @10, 0;JMP
+   auto const program = std::vector<std::uint16_t>
+   {
+      0x0005, 0xEC10, 0x0014, 0xE308, 0x0014, 0xFC10, 0x4006, 0xE308, 0x0015, 0xFDC8, 0x000A, 0xEA87
+   };
+
+   auto computer = Computer();
+
+   computer.load_rom( program );
+
+   auto const engine = GENERATE( Computer::Engine::Interpreter, Computer::Engine::Tiered );
+
+   computer.set_engine( engine );
+
+   SECTION( "without watchpoints a run is not stopped" )
+   {
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Halted );
+      REQUIRE_FALSE( computer.watch_hit() );
+   }
+
+   SECTION( "a write stops the run after the instruction" )
+   {
+      computer.add_watchpoint( 20, 20 );
+
+      auto const result = computer.run( 1'000 );
+
+      REQUIRE( result.reason   == Stop_Reason::Watchpoint );
+      REQUIRE( result.executed == 4 );
+      REQUIRE( computer.RAM()[20] == 5 );
+      REQUIRE( computer.watch_hit()->pc      == 3 );
+      REQUIRE( computer.watch_hit()->address == 20 );
+      REQUIRE( computer.watch_hit()->access  == Access::Write );
+
+      // reads are not watched
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Halted );
+      REQUIRE_FALSE( computer.watch_hit() );
+   }
+
+   SECTION( "reads, and both accesses of one instruction" )
+   {
+      computer.add_watchpoint( 20, 21, Access::Read );
+
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Watchpoint );
+      REQUIRE( computer.watch_hit()->pc     == 5 );
+      REQUIRE( computer.watch_hit()->access == Access::Read );
+
+      computer.add_watchpoint( 21, 21, Access::Write );
+
+      REQUIRE( computer.watchpoint( 21 ) == Access::Read_Write );
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Watchpoint );
+      REQUIRE( computer.watch_hit()->pc     == 9 );
+      REQUIRE( computer.watch_hit()->access == Access::Read_Write );
+      REQUIRE( computer.RAM()[21] == 1 );
+   }
+
+   SECTION( "a range such as the screen" )
+   {
+      computer.add_watchpoint( Computer::screen_start_address, Computer::screen_end_address - 1 );
+
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Watchpoint );
+      REQUIRE( computer.watch_hit()->address == 16'390 );
+
+      computer.reset();
+      computer.remove_watchpoint( 16'384, 16'390 );
+
+      REQUIRE_FALSE( computer.watchpoint( 16'390 ) );
+      REQUIRE( computer.watchpoint( 16'391 ) == Access::Write );
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Halted );
+
+      computer.reset();
+      computer.clear_watchpoints();
+
+      REQUIRE_FALSE( computer.watchpoint( 16'391 ) );
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Halted );
+   }
+
+   SECTION( "a keyboard poll loop is executed while its reads are watched" )
+   {
+      // (WAIT) @KBD, D=M, @WAIT, D;JEQ
+      computer.load_rom( std::vector<std::uint16_t>{ 0x6000, 0xFC10, 0x0000, 0xE302 } );
+      computer.add_watchpoint( Computer::screen_end_address, Computer::screen_end_address, Access::Read );
+
+      REQUIRE( computer.run( 1'000'000 ).executed == 2 );
+      REQUIRE( computer.watch_hit()->address == Memory::keyboard_address );
+      REQUIRE( computer.run( 4 ).executed == 4 );
+      REQUIRE( computer.skipped_instructions() == 0 );
+   }
+
+   SECTION( "watchpoints are checked" )
+   {
+      REQUIRE_THROWS_AS( computer.add_watchpoint( 0, Computer::RAM_SIZE ), std::out_of_range );
+      REQUIRE_THROWS_AS( computer.add_watchpoint( 5, 4 ), std::out_of_range );
+      REQUIRE_THROWS_AS( computer.remove_watchpoint( 0, Computer::RAM_SIZE ), std::out_of_range );
+      REQUIRE_THROWS_AS( computer.watchpoint( Computer::RAM_SIZE ), std::out_of_range );
+   }
+}
+
+
+TEST_CASE( "Computer: conditional breakpoints" )
+{
+   using namespace Hack;
+   using Stop_Reason = Computer::Stop_Reason;
+
+   // (LOOP) @16, M=M+1, @LOOP, 0;JMP
+   auto const program = std::vector<std::uint16_t>{ 0x0010, 0xFDC8, 0x0000, 0xEA87 };
+
+   auto computer = Computer();
+
+   computer.load_rom( program );
+
+   auto const engine = GENERATE( Computer::Engine::Interpreter, Computer::Engine::Tiered );
+
+   computer.set_engine( engine );
+
+   SECTION( "stops when the condition holds at the address" )
+   {
+      computer.add_breakpoint( 1, Condition( "RAM[16] == 100" ) );
+
+      REQUIRE( computer.has_breakpoint( 1 ) );
+      REQUIRE( computer.breakpoint_conditions( 1 ).size() == 1 );
+
+      auto const result = computer.run( 10'000 );
+
+      REQUIRE( result.reason   == Stop_Reason::Breakpoint );
+      REQUIRE( result.executed == 401 );
+      REQUIRE( computer.pc()   == 1 );
+      REQUIRE( computer.RAM()[16] == 100 );
+
+      // it does not hold again within the budget
+      REQUIRE( computer.run( 10'000 ).reason == Stop_Reason::Budget );
+   }
+
+   SECTION( "any of the conditions at an address stops the run" )
+   {
+      computer.add_breakpoint( 1, Condition( "M == 300" ) );
+      computer.add_breakpoint( 1, Condition( "M == 200" ) );
+
+      REQUIRE( computer.run( 10'000 ).reason == Stop_Reason::Breakpoint );
+      REQUIRE( computer.RAM()[16] == 200 );
+
+      REQUIRE( computer.run( 10'000 ).reason == Stop_Reason::Breakpoint );
+      REQUIRE( computer.RAM()[16] == 300 );
+   }
+
+   SECTION( "an unconditional breakpoint ignores conditions" )
+   {
+      computer.add_breakpoint( 1, Condition( "0" ) );
+      computer.add_breakpoint( 1 );
+
+      REQUIRE( computer.breakpoint_conditions( 1 ).empty() );
+      REQUIRE( computer.run( 10'000 ).executed == 1 );
+
+      computer.add_breakpoint( 1, Condition( "0" ) );
+
+      REQUIRE( computer.breakpoint_conditions( 1 ).empty() );
+      REQUIRE( computer.run( 10'000 ).executed == 4 );
+   }
+
+   SECTION( "removing the breakpoint drops its conditions" )
+   {
+      computer.add_breakpoint( 1, Condition( "1" ) );
+      computer.remove_breakpoint( 1 );
+
+      REQUIRE( computer.breakpoint_conditions( 1 ).empty() );
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Budget );
+
+      computer.add_breakpoint( 1, Condition( "1" ) );
+      computer.clear_breakpoints();
+
+      REQUIRE( computer.breakpoint_conditions( 1 ).empty() );
+      REQUIRE( computer.run( 1'000 ).reason == Stop_Reason::Budget );
+   }
+
+   SECTION( "a fork keeps the conditions" )
+   {
+      computer.add_breakpoint( 1, Condition( "RAM[16] == 10" ) );
+
+      auto const child = computer.fork();
+
+      REQUIRE( child->run( 10'000 ).reason == Stop_Reason::Breakpoint );
+      REQUIRE( child->RAM()[16] == 10 );
+   }
+}
@@ -0,0 +1,400 @@
+/**
+ * @file    Condition.cpp
+ * @author  William Weston
+ * @brief   A condition on the state of a Hack computer, compiled once for conditional breakpoints
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Condition.h"
+
+#include <algorithm>    // for equal
+#include <array>        // for array
+#include <cctype>       // for isalpha, isdigit, isspace, tolower
+#include <charconv>     // for from_chars
+#include <stdexcept>    // for invalid_argument
+
+
+namespace
+{
+   // a word as the ALU sees it
+   constexpr auto as_signed( std::uint16_t word ) noexcept -> std::int32_t
+   {
+      return static_cast<std::int16_t>( word );
+   }
+
+   // sums wrap rather than overflow, however long the expression
+   constexpr auto wrap( std::uint32_t value ) noexcept -> std::int32_t
+   {
+      return static_cast<std::int32_t>( value );
+   }
+
+   constexpr auto is_name_char( char c ) noexcept -> bool
+   {
+      return std::isalpha( static_cast<unsigned char>( c ) ) != 0;
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+// recursive descent over the grammar in Condition.h, emitting postfix code as it goes
+class Hack::Condition::Parser
+{
+public:
+   Parser( std::string_view text, std::vector<Instruction>& code )
+      : text_( text ),
+        code_( code )
+   {}
+
+   auto parse() -> void
+   {
+      parse_or();
+      skip_space();
+
+      if ( position_ != text_.size() )
+      {
+         fail( "unexpected text" );
+      }
+   }
+
+private:
+   std::string_view          text_;
+   std::vector<Instruction>& code_;
+   std::size_t               position_{ 0 };
+   std::size_t               depth_{ 0 };
+
+   [[noreturn]] auto fail( std::string const& what ) const -> void
+   {
+      throw std::invalid_argument( "Condition: " + what + " at column " + std::to_string( position_ + 1 ) + ": " + std::string( text_ ) );
+   }
+
+   auto skip_space() noexcept -> void
+   {
+      while ( position_ < text_.size() && std::isspace( static_cast<unsigned char>( text_[position_] ) ) )
+      {
+         ++position_;
+      }
+   }
+
+   // consume token if it is next, a name only when it is not the start of a longer one
+   auto accept( std::string_view token ) -> bool
+   {
+      skip_space();
+
+      auto const rest = text_.substr( position_ );
+
+      if ( rest.size() < token.size() ||
+           !std::equal( token.begin(), token.end(), rest.begin(),
+                        []( char t, char c ) { return t == std::tolower( static_cast<unsigned char>( c ) ); } ) )
+      {
+         return false;
+      }
+
+      if ( is_name_char( token.front() ) && rest.size() > token.size() && is_name_char( rest[token.size()] ) )
+      {
+         return false;
+      }
+
+      position_ += token.size();
+      return true;
+   }
+
+   auto expect( std::string_view token ) -> void
+   {
+      if ( !accept( token ) )
+      {
+         fail( "expected '" + std::string( token ) + "'" );
+      }
+   }
+
+   auto emit( Op op, std::int32_t operand = 0 ) -> void
+   {
+      switch ( op )
+      {
+         case Op::Constant: case Op::A: case Op::D: case Op::M: case Op::PC: case Op::RAM_At:
+            ++depth_;
+            break;
+
+         case Op::RAM: case Op::Negate: case Op::Not:
+            break;
+
+         default:
+            --depth_;
+            break;
+      }
+
+      if ( depth_ > max_depth )
+      {
+         fail( "expression too deep" );
+      }
+
+      code_.push_back( Instruction{ op, operand } );
+   }
+
+   auto parse_or() -> void
+   {
+      parse_and();
+
+      while ( accept( "||" ) || accept( "or" ) )
+      {
+         parse_and();
+         emit( Op::Or );
+      }
+   }
+
+   auto parse_and() -> void
+   {
+      parse_not();
+
+      while ( accept( "&&" ) || accept( "and" ) )
+      {
+         parse_not();
+         emit( Op::And );
+      }
+   }
+
+   auto parse_not() -> void
+   {
+      if ( accept( "!=" ) )
+      {
+         fail( "expected a value" );
+      }
+
+      if ( accept( "!" ) || accept( "not" ) )
+      {
+         parse_not();
+         emit( Op::Not );
+         return;
+      }
+
+      parse_compare();
+   }
+
+   auto parse_compare() -> void
+   {
+      struct Comparison
+      {
+         std::string_view token;
+         Op               op;
+      };
+
+      // the longer tokens first, so that <= is not taken for <
+      static constexpr auto comparisons = std::array<Comparison, 7>
+      {{
+         { "==", Op::Equal }, { "!=", Op::Not_Equal }, { "<=", Op::Less_Equal }, { ">=", Op::Greater_Equal },
+         { "<",  Op::Less  }, { ">",  Op::Greater   }, { "=",  Op::Equal }
+      }};
+
+      parse_sum();
+
+      for ( auto const& [token, op] : comparisons )
+      {
+         if ( accept( token ) )
+         {
+            parse_sum();
+            emit( op );
+            return;
+         }
+      }
+   }
+
+   auto parse_sum() -> void
+   {
+      parse_unary();
+
+      while ( true )
+      {
+         if ( accept( "+" ) )
+         {
+            parse_unary();
+            emit( Op::Add );
+         }
+         else if ( accept( "-" ) )
+         {
+            parse_unary();
+            emit( Op::Subtract );
+         }
+         else
+         {
+            return;
+         }
+      }
+   }
+
+   auto parse_unary() -> void
+   {
+      if ( accept( "-" ) )
+      {
+         parse_unary();
+         emit( Op::Negate );
+         return;
+      }
+
+      parse_primary();
+   }
+
+   auto parse_primary() -> void
+   {
+      skip_space();
+
+      if ( position_ < text_.size() && std::isdigit( static_cast<unsigned char>( text_[position_] ) ) )
+      {
+         emit( Op::Constant, parse_number() );
+         return;
+      }
+
+      if ( accept( "(" ) )
+      {
+         parse_or();
+         expect( ")" );
+         return;
+      }
+
+      if ( accept( "ram" ) )
+      {
+         expect( "[" );
+         parse_sum();
+         expect( "]" );
+
+         // a constant address is folded into the load
+         if ( code_.back().op == Op::Constant )
+         {
+            code_.back().op = Op::RAM_At;
+            return;
+         }
+
+         emit( Op::RAM );
+         return;
+      }
+
+      if ( accept( "pc" ) ) { emit( Op::PC ); return; }
+      if ( accept( "a" ) )  { emit( Op::A );  return; }
+      if ( accept( "d" ) )  { emit( Op::D );  return; }
+      if ( accept( "m" ) )  { emit( Op::M );  return; }
+
+      fail( "expected a value" );
+   }
+
+   // a word, decimal or 0x hexadecimal, as the ALU sees it
+   auto parse_number() -> std::int32_t
+   {
+      auto base = 10;
+
+      if ( text_.substr( position_, 2 ) == "0x" || text_.substr( position_, 2 ) == "0X" )
+      {
+         base       = 16;
+         position_ += 2;
+      }
+
+      auto       value        = unsigned{ 0 };
+      auto const* const first = text_.data() + position_;
+      auto const* const last  = text_.data() + text_.size();
+      auto const [end, error] = std::from_chars( first, last, value, base );
+
+      if ( error != std::errc() || value > 0xFFFF || ( end != last && is_name_char( *end ) && base == 10 ) )
+      {
+         fail( "expected a number from 0 to 65535" );
+      }
+
+      position_ += static_cast<std::size_t>( end - first );
+
+      return as_signed( static_cast<word_t>( value ) );
+   }
+};
+
+
+/**
+ * @brief   Compile a condition
+ *
+ * @param expression   in the language of Condition.h, e.g. RAM[256] > 1000 && D == 0
+ * @throws std::invalid_argument if expression is not a condition
+ */
+Hack::Condition::Condition( std::string_view expression )
+   : text_( expression )
+{
+   Parser( text_, code_ ).parse();
+}
+
+
+/**
+ * @brief   Evaluate the condition
+ *
+ * @param A     the A register
+ * @param D     the D register
+ * @param pc    the address of the next instruction
+ * @param ram   the words read by M and RAM[n]
+ * @return true if its value is not 0
+ */
+auto
+Hack::Condition::operator()( word_t A, word_t D, word_t pc, Memory const& ram ) const noexcept -> bool
+{
+   auto const load = [&ram]( std::int32_t address ) noexcept -> std::int32_t
+   {
+      return address >= 0 && address < std::int32_t{ Memory::address_space }
+           ? as_signed( ram.unchecked( static_cast<Memory::size_type>( address ) ) )
+           : 0;
+   };
+
+   auto stack = std::array<std::int32_t, max_depth>{};
+   auto top   = 0uz;      // the values on the stack
+
+   for ( auto const& [op, operand] : code_ )
+   {
+      if ( op == Op::Constant || op == Op::A || op == Op::D || op == Op::M || op == Op::PC || op == Op::RAM_At )
+      {
+         switch ( op )
+         {
+            case Op::A:      stack[top] = as_signed( A );                 break;
+            case Op::D:      stack[top] = as_signed( D );                 break;
+            case Op::M:      stack[top] = load( std::int32_t{ A } );      break;
+            case Op::PC:     stack[top] = std::int32_t{ pc };             break;
+            case Op::RAM_At: stack[top] = load( operand );                break;
+            default:         stack[top] = operand;                        break;
+         }
+
+         ++top;
+         continue;
+      }
+
+      auto& x = stack[top - 1];
+
+      switch ( op )
+      {
+         case Op::RAM:      x = load( x );                                        continue;
+         case Op::Negate:   x = wrap( 0u - static_cast<std::uint32_t>( x ) );    continue;
+         case Op::Not:      x = x == 0;                                           continue;
+         default:                                                                 break;
+      }
+
+      auto const y = stack[--top];
+      auto&      l = stack[top - 1];
+
+      switch ( op )
+      {
+         case Op::Add:           l = wrap( static_cast<std::uint32_t>( l ) + static_cast<std::uint32_t>( y ) ); break;
+         case Op::Subtract:      l = wrap( static_cast<std::uint32_t>( l ) - static_cast<std::uint32_t>( y ) ); break;
+         case Op::Equal:         l = l == y;          break;
+         case Op::Not_Equal:     l = l != y;          break;
+         case Op::Less:          l = l <  y;          break;
+         case Op::Less_Equal:    l = l <= y;          break;
+         case Op::Greater:       l = l >  y;          break;
+         case Op::Greater_Equal: l = l >= y;          break;
+         case Op::And:           l = l != 0 && y != 0; break;
+         case Op::Or:            l = l != 0 || y != 0; break;
+         default:                                      break;
+      }
+   }
+
+   return stack[0] != 0;
+}
+
+
+auto
+Hack::Condition::text() const noexcept -> std::string const&
+{
+   return text_;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file    Condition.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Condition.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Condition.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <stdexcept>    // invalid_argument
+#include <string>
+
+
+TEST_CASE( "Computer: Condition evaluates over registers and RAM" )
+{
+   using namespace Hack;
+
+   auto ram = Memory();
+
+   ram[256] = 1'001;
+   ram[20]  = 0xFFFF;      // -1
+
+   // A = 20, D = 0, pc = 120
+   auto const holds = [&ram]( char const* expression )
+   {
+      return Condition( expression )( 20, 0, 120, ram );
+   };
+
+   SECTION( "registers, M and RAM" )
+   {
+      REQUIRE( holds( "PC == 120 && RAM[256] > 1000 && D == 0" ) );
+      REQUIRE( holds( "pc = 120 and ram[0x100] > 1000 and not d" ) );
+      REQUIRE( holds( "A == 20" ) );
+      REQUIRE( holds( "M == -1" ) );
+      REQUIRE( holds( "M == 0xFFFF" ) );
+      REQUIRE( holds( "RAM[A] == M" ) );
+      REQUIRE( holds( "RAM[A + 236] == 1001" ) );
+      REQUIRE_FALSE( holds( "RAM[256] > 1001" ) );
+      REQUIRE_FALSE( holds( "D" ) );
+   }
+
+   SECTION( "words outside RAM read as 0" )
+   {
+      REQUIRE( holds( "RAM[24577] == 0" ) );
+      REQUIRE( holds( "RAM[-1] == 0" ) );
+      REQUIRE( holds( "RAM[D - 1] == 0" ) );
+   }
+
+   SECTION( "arithmetic does not wrap at 16 bits" )
+   {
+      REQUIRE( holds( "32767 + 1 > 32767" ) );
+      REQUIRE( holds( "-32768 - 1 < -32768" ) );
+      REQUIRE( holds( "--5 == 5" ) );
+   }
+
+   SECTION( "precedence" )
+   {
+      REQUIRE( holds( "1 || 0 && 0" ) );
+      REQUIRE_FALSE( holds( "(1 || 0) && 0" ) );
+      REQUIRE( holds( "!0 == 1" ) );                   // ! applies to the comparison
+      REQUIRE( holds( "1 + 2 == 3 and 5 - 2 - 1 == 2" ) );
+      REQUIRE( holds( "(1 < 2) + (2 >= 2) + (3 != 3) == 2" ) );
+   }
+
+   SECTION( "the text is kept" )
+   {
+      REQUIRE( Condition( "D == 0" ).text() == "D == 0" );
+   }
+}
+
+
+TEST_CASE( "Computer: Condition rejects malformed expressions" )
+{
+   using namespace Hack;
+
+   for ( auto const* const expression : { "", "D ==", "RAM[1", "(D", "D D", "Dx == 1", "RAM 1", "65536",
+                                          "12ab", "D != != 1", "X" } )
+   {
+      INFO( expression );
+      REQUIRE_THROWS_AS( Condition( expression ), std::invalid_argument );
+   }
+
+   SECTION( "the error names the column" )
+   {
+      auto message = std::string();
+
+      try
+      {
+         Condition( "D == 0 &&" );
+      }
+      catch ( std::invalid_argument const& error )
+      {
+         message = error.what();
+      }
+
+      REQUIRE( message.find( "column 10" ) != std::string::npos );
+   }
+
+   SECTION( "the depth of an expression is limited" )
+   {
+      auto nested = std::string();
+
+      for ( auto i = 0uz; i != Condition::max_depth; ++i )
+      {
+         nested += "1 + (";
+      }
+
+      nested += "1" + std::string( Condition::max_depth, ')' );
+
+      REQUIRE_THROWS_AS( Condition( nested ), std::invalid_argument );
+      REQUIRE_NOTHROW( Condition( "1 + (1 + (1 + 1))" ) );
+   }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file    Decoder.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Decoder.h
+ * @version 0.1
+ * @date    2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include "Hack/Decoder.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+
+
+TEST_CASE( "Computer: decode" )
+{
+   using namespace Hack;
+   using Op = Decoded_Instruction;
+
+   SECTION( "default constructed entry is the decoding of @0" )
+   {
+      STATIC_REQUIRE( decode( 0 ) == Decoded_Instruction{} );
+   }
+
+   SECTION( "A-instruction" )
+   {
+      auto const decoded = decode( 0b0111'1111'1111'1111 );       // @32767
+
+      REQUIRE( decoded.is_a_instruction() );
+      REQUIRE( decoded.word == 32'767 );
+      REQUIRE_FALSE( decoded.reads_M() );
+      REQUIRE_FALSE( decoded.writes_M() );
+      REQUIRE_FALSE( decoded.is_jump() );
+   }
+
+   SECTION( "C-instruction: AM=M+1" )
+   {
+      auto const decoded = decode( 0b1111'1101'1110'1000 );
+
+      REQUIRE_FALSE( decoded.is_a_instruction() );
+      REQUIRE( decoded.operand == Op::Operand::M_Register );
+      REQUIRE( decoded.comp    == 0b11'0111 );
+      REQUIRE( decoded.dest    == ( Op::dest_A | Op::dest_M ) );
+      REQUIRE( decoded.jump    == 0 );
+      REQUIRE( decoded.reads_M() );
+      REQUIRE( decoded.writes_M() );
+   }
+
+   SECTION( "C-instruction: D;JGE" )
+   {
+      auto const decoded = decode( 0b1110'0011'0000'0011 );
+
+      REQUIRE( decoded.operand == Op::Operand::A_Register );
+      REQUIRE( decoded.comp    == 0b00'1100 );
+      REQUIRE( decoded.dest    == 0 );
+      REQUIRE( decoded.jump    == ( Op::jump_gt | Op::jump_eq ) );
+      REQUIRE_FALSE( decoded.reads_M() );
+      REQUIRE_FALSE( decoded.writes_M() );
+      REQUIRE( decoded.is_jump() );
+   }
+}
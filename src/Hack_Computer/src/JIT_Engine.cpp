@@ -0,0 +1,663 @@
+/**
+ * @file    JIT_Engine.cpp
+ * @author  William Weston
+ * @brief   x86-64 basic-block JIT for the Hack CPU
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Register assignment inside native code, System V calling convention:
+ *
+ *       rdi    Context*                   r8d    A register
+ *       rsi    RAM base address           r9d    D register
+ *       eax    ALU x input, ALU output    r10d   ALU output register
+ *       ecx    ALU y input                r11d   A before the current instruction (M address)
+ *       rdx    remaining budget
+ *
+ *    A and D are kept zero extended to 32 bits.
+ *
+ *    The arena starts with the dispatcher, which loads the registers from the Context and jumps
+ *    to the block at the next pc, or stores the registers and returns when there is no block or
+ *    the budget cannot cover it.  Each block is preceded by its length in instructions:
+ *
+ *       [ length : 8 bytes ] entry:  sub rdx, length  ...  mov eax, next  jmp dispatch
+ */
+#include "JIT_Engine.h"
+
+#include "Decoder.h"          // for decode, Decoded_Instruction
+
+#include <algorithm>          // for count_if, equal, fill
+#include <cstddef>            // for byte, offsetof, size_t
+#include <cstring>            // for memcpy
+#include <initializer_list>   // for initializer_list
+#include <utility>            // for move
+#include <vector>             // for vector
+
+#if defined( HACK_COMPUTER_ENABLE_JIT ) && defined( __x86_64__ ) && defined( __linux__ )
+   #define HACK_JIT_NATIVE 1
+   #include <sys/mman.h>      // for mmap, mprotect, munmap
+   #include <unistd.h>        // for sysconf
+#else
+   #define HACK_JIT_NATIVE 0
+#endif
+
+
+namespace
+{
+   using word_t = Hack::JIT_Engine::word_t;
+   using Op     = Hack::Decoded_Instruction;
+
+   constexpr auto arena_size = std::size_t{ 4 } << 20;
+
+   // x86 condition codes for cmovcc, indexed by the Hack jump bits lt eq gt
+   constexpr std::uint8_t cmov_condition[] =
+   {
+      0x00,       // never, not used
+      0x4F,       // JGT   cmovg
+      0x44,       // JEQ   cmove
+      0x4D,       // JGE   cmovge
+      0x4C,       // JLT   cmovl
+      0x45,       // JNE   cmovne
+      0x4E,       // JLE   cmovle
+      0x00        // JMP   unconditional, not used
+   };
+
+   class Emitter final
+   {
+   public:
+      auto emit( std::initializer_list<std::uint8_t> bytes ) -> void
+      {
+         code_.insert( code_.end(), bytes );
+      }
+
+      auto imm32( std::uint32_t value ) -> void
+      {
+         for ( auto shift = 0; shift < 32; shift += 8 )
+         {
+            code_.push_back( static_cast<std::uint8_t>( value >> shift ) );
+         }
+      }
+
+      // emit a zero displacement to be patched later, returns its position
+      auto rel32() -> std::size_t
+      {
+         auto const position = code_.size();
+         imm32( 0 );
+         return position;
+      }
+
+      // make the displacement at position refer to target
+      auto patch( std::size_t position, std::size_t target ) -> void
+      {
+         auto const displacement = static_cast<std::uint32_t>( static_cast<std::int64_t>( target ) -
+                                                               static_cast<std::int64_t>( position + 4 ) );
+         for ( auto idx = 0uz; idx < 4; ++idx )
+         {
+            code_[position + idx] = static_cast<std::uint8_t>( displacement >> ( 8 * idx ) );
+         }
+      }
+
+      // emit a displacement to an arena offset, resolved by relocate()
+      auto rel32_arena( std::size_t target ) -> void
+      {
+         relocations_.push_back( { rel32(), target } );
+      }
+
+      // the code will be placed at arena offset origin
+      auto relocate( std::size_t origin ) -> void
+      {
+         for ( auto const& [position, target] : relocations_ )
+         {
+            patch( position, target - origin );
+         }
+      }
+
+      auto set( std::size_t position, std::uint8_t value ) -> void
+      {
+         code_[position] = value;
+      }
+
+      auto size() const noexcept -> std::size_t             { return code_.size(); }
+      auto code() const noexcept -> std::vector<std::uint8_t> const& { return code_; }
+
+   private:
+      struct Relocation
+      {
+         std::size_t position;
+         std::size_t target;
+      };
+
+      std::vector<std::uint8_t> code_{};
+      std::vector<Relocation>   relocations_{};
+   };
+
+
+   // y operand, ALU and dest of a C-instruction, leaves the ALU output in eax
+   auto emit_c_instruction( Emitter& out, Op const& instruction ) -> void
+   {
+      out.emit( { 0x45, 0x89, 0xC3 } );                              // mov   r11d, r8d
+
+      if ( instruction.reads_M() )
+      {
+         out.emit( { 0x42, 0x0F, 0xB7, 0x0C, 0x46 } );               // movzx ecx, word [rsi + r8*2]
+      }
+      else
+      {
+         out.emit( { 0x44, 0x89, 0xC1 } );                           // mov   ecx, r8d
+      }
+
+      out.emit( { 0x44, 0x89, 0xC8 } );                              // mov   eax, r9d
+
+      if ( instruction.comp & Op::comp_zx ) { out.emit( { 0x31, 0xC0 } ); }    // xor   eax, eax
+      if ( instruction.comp & Op::comp_nx ) { out.emit( { 0xF7, 0xD0 } ); }    // not   eax
+      if ( instruction.comp & Op::comp_zy ) { out.emit( { 0x31, 0xC9 } ); }    // xor   ecx, ecx
+      if ( instruction.comp & Op::comp_ny ) { out.emit( { 0xF7, 0xD1 } ); }    // not   ecx
+
+      if ( instruction.comp & Op::comp_f )
+      {
+         out.emit( { 0x01, 0xC8 } );                                 // add   eax, ecx
+      }
+      else
+      {
+         out.emit( { 0x21, 0xC8 } );                                 // and   eax, ecx
+      }
+
+      if ( instruction.comp & Op::comp_no ) { out.emit( { 0xF7, 0xD0 } ); }    // not   eax
+
+      out.emit( { 0x0F, 0xB7, 0xC0 } );                              // movzx eax, ax
+      out.emit( { 0x41, 0x89, 0xC2 } );                              // mov   r10d, eax
+
+      if ( instruction.dest & Op::dest_A ) { out.emit( { 0x41, 0x89, 0xC0 } ); }              // mov r8d, eax
+      if ( instruction.dest & Op::dest_D ) { out.emit( { 0x41, 0x89, 0xC1 } ); }              // mov r9d, eax
+      if ( instruction.dest & Op::dest_M ) { out.emit( { 0x66, 0x42, 0x89, 0x04, 0x5E } ); }  // mov [rsi + r11*2], ax
+   }
+
+
+   // leaves the next pc in eax
+   auto emit_jump( Emitter& out, Op const& instruction, word_t next ) -> void
+   {
+      if ( instruction.jump == ( Op::jump_lt | Op::jump_eq | Op::jump_gt ) )
+      {
+         out.emit( { 0x44, 0x89, 0xC0 } );                           // mov   eax, r8d
+         return;
+      }
+
+      out.emit( { 0x66, 0x85, 0xC0 } );                              // test  ax, ax
+      out.emit( { 0xB8 } );                                          // mov   eax, next
+      out.imm32( next );
+      out.emit( { 0x41, 0x0F, cmov_condition[instruction.jump], 0xC0 } );     // cmovcc eax, r8d
+   }
+
+}  // namespace
+
+
+// -------------------------------------------- API -----------------------------------------------
+
+
+Hack::JIT_Engine::JIT_Engine( Memory& memory )
+   :  RAM_{ memory },
+      direct_limit_{ Memory::keyboard_address },
+      blocks_{},
+      block_at_{},
+      entries_{},
+      compiled_words_{ 0 },
+      arena_{ nullptr },
+      arena_used_{ 0 },
+      dispatcher_{ nullptr },
+      dispatch_{ 0 },
+      exit_{ 0 }
+{
+#if HACK_JIT_NATIVE
+   auto* const memory_map = ::mmap( nullptr, arena_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+   if ( memory_map != MAP_FAILED )
+   {
+      arena_ = static_cast<std::byte*>( memory_map );
+   }
+#endif
+}
+
+
+Hack::JIT_Engine::~JIT_Engine() noexcept
+{
+#if HACK_JIT_NATIVE
+   if ( arena_ )
+   {
+      ::munmap( arena_, arena_size );
+   }
+#endif
+}
+
+
+/**
+ * @brief   Can native code be generated and executed on this host
+ *
+ * @return true   on x86-64 Linux when built with HACK_COMPUTER_ENABLE_JIT
+ */
+auto
+Hack::JIT_Engine::supported() noexcept -> bool
+{
+   return HACK_JIT_NATIVE;
+}
+
+
+/**
+ * @brief   Discard all compiled blocks, the next run of each block compiles it from rom
+ *
+ * @param rom  the instruction ROM
+ */
+auto
+Hack::JIT_Engine::load( std::span<word_t const> rom ) -> void
+{
+   block_at_.assign( rom.size(), no_block );
+   entries_.assign( rom.size(), nullptr );
+   reset();
+}
+
+
+/**
+ * @brief   Run native blocks starting at pc
+ *
+ * @param cpu              supplies and receives the A, D and ALU output registers
+ * @param rom              the instruction ROM
+ * @param pc               address of the first instruction, receives the address of the next one
+ * @param budget           the maximum number of instructions that may be executed
+ * @param compile_missing  compile blocks that are reached but not compiled, otherwise stop there
+ * @return std::uint64_t   the number of instructions executed, 0 if the interpreter must execute
+ *                         the instruction at pc
+ *
+ *    Checking every block against ROM costs as much as executing the compiled words once, so a
+ *    run with a budget smaller than that checks each block as it is entered and returns to C++
+ *    between blocks instead of chaining them.
+ */
+auto
+Hack::JIT_Engine::run( CPU& cpu, std::span<word_t const> rom, word_t& pc, std::uint64_t budget,
+                       bool compile_missing ) -> std::uint64_t
+{
+   if ( entries_.size() != rom.size() )
+   {
+      load( rom );
+   }
+
+   if ( !dispatcher_ )
+   {
+      return 0;
+   }
+
+   auto const chained = budget >= compiled_words_;
+
+   if ( chained )
+   {
+      for ( auto const& block : blocks_ )
+      {
+         if ( entries_[block.address] && !valid( rom, block ) )
+         {
+            discard( block );                         // ROM has been written, recompile on next use
+         }
+      }
+   }
+
+   auto context  = Context{ RAM_.data(), 0, entries_.data(), cpu.A_Register(), cpu.D_Register(),
+                            cpu.ALU_Output(), pc, 0 };
+   auto executed = std::uint64_t{ 0 };
+
+   while ( executed < budget && context.pc < rom.size() && !context.fault )
+   {
+      auto const& entry = entries_[context.pc];
+
+      if ( !entry && ( !compile_missing || !compile( rom, context.pc ) ) )
+      {
+         break;
+      }
+
+      auto const& block = blocks_[block_at_[context.pc]];
+
+      if ( !chained && !valid( rom, block ) )
+      {
+         discard( block );
+         break;
+      }
+
+      auto const remaining = budget - executed;
+
+      if ( block.words.size() > remaining )
+      {
+         break;
+      }
+
+      context.budget = chained ? remaining : block.words.size();
+      auto const before = context.budget;
+
+      context.pc = static_cast<word_t>( dispatcher_( &context ) );
+      executed  += before - context.budget;
+   }
+
+   pc = context.pc;
+
+   cpu.set_A_Register( context.A );
+   cpu.set_D_Register( context.D );
+   cpu.set_ALU_Output( context.ALU_output );
+   cpu.set_PC( pc );
+
+   return executed;
+}
+
+
+/**
+ * @brief   Compile the block starting at pc unless there is one already
+ *
+ * @return true   there is a block at pc, it is checked against ROM when it is run
+ */
+auto
+Hack::JIT_Engine::prepare( std::span<word_t const> rom, word_t pc ) -> bool
+{
+   if ( entries_.size() != rom.size() )
+   {
+      load( rom );
+   }
+
+   if ( pc >= rom.size() || !dispatcher_ )
+   {
+      return false;
+   }
+
+   return entries_[pc] || compile( rom, pc );
+}
+
+
+auto
+Hack::JIT_Engine::compiled( word_t address ) const noexcept -> bool
+{
+   return address < entries_.size() && entries_[address];
+}
+
+
+auto
+Hack::JIT_Engine::compiled_blocks() const noexcept -> std::size_t
+{
+   return static_cast<std::size_t>( std::ranges::count_if( blocks_, [this]( Block const& block )
+   {
+      return entries_[block.address] != nullptr;
+   } ) );
+}
+
+
+// ----------------------------------------- Implementation ---------------------------------------
+
+
+/**
+ * @brief   Translate the instructions from pc up to and including the first jump
+ *
+ * @return true   the block at pc is compiled and entered in entries_
+ */
+auto
+Hack::JIT_Engine::compile( [[maybe_unused]] std::span<word_t const> rom, [[maybe_unused]] word_t pc ) -> bool
+{
+#if HACK_JIT_NATIVE
+   struct Fault
+   {
+      std::size_t   patch;       // position of the rel32 of the branch to the fault exit
+      std::uint32_t index;       // instructions executed before the faulting one
+      word_t        address;
+   };
+
+   auto out    = Emitter();
+   auto faults = std::vector<Fault>();
+   auto words  = std::vector<word_t>();
+
+   // the length header, filled in once the block is complete
+   out.imm32( 0 );
+   out.imm32( 0 );
+
+   out.emit( { 0x48, 0x83, 0xEA } );                                 // sub   rdx, length
+   auto const length_immediate = out.size();
+   out.emit( { 0x00 } );
+
+   // @P 0;JMP at P, a run stops where the halt loop starts
+   auto const halt_loop = [&]( std::size_t at )
+   {
+      return rom[at] == at && at + 1 < rom.size() && decode( rom[at + 1] ).is_halt_jump();
+   };
+
+   if ( halt_loop( pc ) )
+   {
+      return false;
+   }
+
+   auto address = static_cast<std::size_t>( pc );
+   auto jumped  = false;
+
+   while ( address < rom.size() && words.size() < max_block_length && !jumped && !( address != pc && halt_loop( address ) ) )
+   {
+      auto const instruction = decode( rom[address] );
+
+      if ( instruction.is_a_instruction() )
+      {
+         out.emit( { 0x41, 0xB8 } );                                 // mov   r8d, value
+         out.imm32( instruction.word );
+      }
+      else
+      {
+         if ( instruction.reads_M() || instruction.writes_M() )
+         {
+            out.emit( { 0x41, 0x81, 0xF8 } );                        // cmp   r8d, direct_limit
+            out.imm32( direct_limit_ );
+            out.emit( { 0x0F, 0x87 } );                              // ja    fault
+            faults.push_back( { out.rel32(), static_cast<std::uint32_t>( words.size() ), static_cast<word_t>( address ) } );
+         }
+
+         // a jump to itself is a halt loop, leave before it
+         if ( instruction.is_halt_jump() )
+         {
+            out.emit( { 0x41, 0x81, 0xF8 } );                        // cmp   r8d, address
+            out.imm32( static_cast<std::uint32_t>( address ) );
+            out.emit( { 0x0F, 0x84 } );                              // je    fault
+            faults.push_back( { out.rel32(), static_cast<std::uint32_t>( words.size() ), static_cast<word_t>( address ) } );
+         }
+
+         emit_c_instruction( out, instruction );
+
+         if ( instruction.is_jump() )
+         {
+            emit_jump( out, instruction, static_cast<word_t>( address + 1 ) );
+            jumped = true;
+         }
+      }
+
+      words.push_back( rom[address] );
+      ++address;
+   }
+
+   if ( !jumped )
+   {
+      out.emit( { 0xB8 } );                                          // mov   eax, next
+      out.imm32( static_cast<std::uint32_t>( address ) );
+   }
+
+   out.emit( { 0xE9 } );                                             // jmp   dispatch
+   out.rel32_arena( dispatch_ );
+
+   for ( auto const& fault : faults )
+   {
+      out.patch( fault.patch, out.size() );
+      out.emit( { 0x48, 0x83, 0xC2, static_cast<std::uint8_t>( words.size() - fault.index ) } );   // add rdx, not executed
+      out.emit( { 0xB8 } );                                          // mov   eax, address
+      out.imm32( fault.address );
+      out.emit( { 0xC6, 0x47, 0x20, 0x01 } );                        // mov   byte [rdi + fault], 1
+      out.emit( { 0xE9 } );                                          // jmp   exit
+      out.rel32_arena( exit_ );
+   }
+
+   out.set( 0,                static_cast<std::uint8_t>( words.size() ) );
+   out.set( length_immediate, static_cast<std::uint8_t>( words.size() ) );
+
+   // a block discarded at pc gives up its space when the new code fits, place() may discard every block
+   auto const reuse    = block_at_[pc] != no_block && out.size() <= blocks_[block_at_[pc]].capacity;
+   auto const offset   = reuse ? blocks_[block_at_[pc]].offset   : place( out.size() );
+   auto const capacity = reuse ? blocks_[block_at_[pc]].capacity : arena_used_ - offset;
+
+   out.relocate( offset );
+
+   if ( !install( out.code(), offset ) )
+   {
+      return false;
+   }
+
+   auto block = Block{ pc, std::move( words ), offset, capacity };
+
+   if ( block_at_[pc] == no_block )
+   {
+      block_at_[pc] = static_cast<std::uint32_t>( blocks_.size() );
+      blocks_.push_back( std::move( block ) );
+   }
+   else
+   {
+      blocks_[block_at_[pc]] = std::move( block );
+   }
+
+   compiled_words_ += blocks_[block_at_[pc]].words.size();
+   entries_[pc]     = arena_ + offset + 8;
+
+   return true;
+#else
+   return false;
+#endif
+}
+
+
+auto
+Hack::JIT_Engine::valid( std::span<word_t const> rom, Block const& block ) const -> bool
+{
+   return std::ranges::equal( block.words, rom.subspan( block.address, block.words.size() ) );
+}
+
+
+/**
+ * @brief   Stop running block until it is recompiled, its slot and space are kept for that
+ */
+auto
+Hack::JIT_Engine::discard( Block const& block ) noexcept -> void
+{
+   entries_[block.address] = nullptr;
+   compiled_words_        -= block.words.size();
+}
+
+
+/**
+ * @brief   Reserve size bytes of the arena, discarding all blocks when it is full
+ *
+ * @return std::size_t  the arena offset of the reservation
+ */
+auto
+Hack::JIT_Engine::place( std::size_t size ) -> std::size_t
+{
+   if ( arena_used_ + size > arena_size )
+   {
+      reset();
+   }
+
+   auto const offset = arena_used_;
+   arena_used_ = ( offset + size + 15 ) / 16 * 16;
+
+   return offset;
+}
+
+
+/**
+ * @brief   Copy code into the arena, keeping it either writable or executable, never both
+ */
+auto
+Hack::JIT_Engine::install( [[maybe_unused]] std::span<std::uint8_t const> code, [[maybe_unused]] std::size_t offset ) -> bool
+{
+#if HACK_JIT_NATIVE
+   static auto const page_size = static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+
+   auto const begin = offset / page_size * page_size;
+   auto const end   = offset + code.size();
+
+   if ( ::mprotect( arena_ + begin, end - begin, PROT_READ | PROT_WRITE ) != 0 )
+   {
+      return false;
+   }
+
+   std::memcpy( arena_ + offset, code.data(), code.size() );
+
+   return ::mprotect( arena_ + begin, end - begin, PROT_READ | PROT_EXEC ) == 0;
+#else
+   return false;
+#endif
+}
+
+
+/**
+ * @brief   Discard all blocks and emit the dispatcher at the start of the arena
+ */
+auto
+Hack::JIT_Engine::reset() -> void
+{
+   blocks_.clear();
+   std::ranges::fill( block_at_, no_block );
+   std::ranges::fill( entries_, nullptr );
+   compiled_words_ = 0;
+   arena_used_     = 0;
+   dispatcher_     = nullptr;
+
+#if HACK_JIT_NATIVE
+   static_assert( offsetof( Context, ram )        ==  0 );
+   static_assert( offsetof( Context, budget )     ==  8 );
+   static_assert( offsetof( Context, entries )    == 16 );
+   static_assert( offsetof( Context, A )          == 24 );
+   static_assert( offsetof( Context, D )          == 26 );
+   static_assert( offsetof( Context, ALU_output ) == 28 );
+   static_assert( offsetof( Context, pc )         == 30 );
+   static_assert( offsetof( Context, fault )      == 32 );
+
+   if ( !arena_ )
+   {
+      return;
+   }
+
+   auto out = Emitter();
+
+   out.emit( { 0x48, 0x8B, 0x37 } );                                 // mov   rsi, [rdi + ram]
+   out.emit( { 0x48, 0x8B, 0x57, 0x08 } );                           // mov   rdx, [rdi + budget]
+   out.emit( { 0x44, 0x0F, 0xB7, 0x47, 0x18 } );                     // movzx r8d,  word [rdi + A]
+   out.emit( { 0x44, 0x0F, 0xB7, 0x4F, 0x1A } );                     // movzx r9d,  word [rdi + D]
+   out.emit( { 0x44, 0x0F, 0xB7, 0x57, 0x1C } );                     // movzx r10d, word [rdi + ALU_output]
+   out.emit( { 0x0F, 0xB7, 0x47, 0x1E } );                           // movzx eax,  word [rdi + pc]
+
+   // eax holds the next pc
+   dispatch_ = out.size();
+   out.emit( { 0x3D } );                                             // cmp   eax, rom size
+   out.imm32( static_cast<std::uint32_t>( entries_.size() ) );
+   out.emit( { 0x0F, 0x83 } );                                       // jae   exit
+   auto const past_rom = out.rel32();
+   out.emit( { 0x48, 0x8B, 0x4F, 0x10 } );                           // mov   rcx, [rdi + entries]
+   out.emit( { 0x48, 0x8B, 0x0C, 0xC1 } );                           // mov   rcx, [rcx + rax*8]
+   out.emit( { 0x48, 0x85, 0xC9 } );                                 // test  rcx, rcx
+   out.emit( { 0x0F, 0x84 } );                                       // jz    exit
+   auto const no_entry = out.rel32();
+   out.emit( { 0x48, 0x3B, 0x51, 0xF8 } );                           // cmp   rdx, [rcx - 8]
+   out.emit( { 0x0F, 0x82 } );                                       // jb    exit
+   auto const no_budget = out.rel32();
+   out.emit( { 0xFF, 0xE1 } );                                       // jmp   rcx
+
+   exit_ = out.size();
+   out.patch( past_rom,  exit_ );
+   out.patch( no_entry,  exit_ );
+   out.patch( no_budget, exit_ );
+   out.emit( { 0x66, 0x44, 0x89, 0x47, 0x18 } );                     // mov   [rdi + A], r8w
+   out.emit( { 0x66, 0x44, 0x89, 0x4F, 0x1A } );                     // mov   [rdi + D], r9w
+   out.emit( { 0x66, 0x44, 0x89, 0x57, 0x1C } );                     // mov   [rdi + ALU_output], r10w
+   out.emit( { 0x48, 0x89, 0x57, 0x08 } );                           // mov   [rdi + budget], rdx
+   out.emit( { 0xC3 } );                                             // ret
+
+   auto const offset = place( out.size() );
+
+   if ( install( out.code(), offset ) )
+   {
+      dispatcher_ = reinterpret_cast<Native>( arena_ + offset );
+   }
+#endif
+}
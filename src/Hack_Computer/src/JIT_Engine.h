@@ -0,0 +1,128 @@
+/**
+ * @file    JIT_Engine.h
+ * @author  William Weston
+ * @brief   x86-64 basic-block JIT for the Hack CPU
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Straight-line runs of Hack instructions, ending at the first jump-enabled C-instruction, are
+ *    translated into native code that keeps A, D and the ALU output in host registers and reads
+ *    and writes RAM directly.
+ *
+ *    Blocks are chained in native code: the end of a block looks up the block at the next pc and
+ *    jumps straight to it while the instruction budget covers the whole of that block, so the
+ *    registers stay in host registers across a run.  A block only runs when all of it fits in
+ *    the budget, so the machine state is exact at every boundary the caller can observe.  An M
+ *    access outside of directly addressable RAM leaves the block before the instruction with the
+ *    state of the preceding instruction, so that the caller can execute it with the interpreter.
+ *    A halt loop, @P 0;JMP at P or a 0;JMP with A holding its own address, is never entered.
+ *
+ *    Each block keeps a copy of the ROM words it was compiled from.  ROM cannot change during a
+ *    run, so blocks are checked against ROM when a run starts and a block whose ROM has been
+ *    written is discarded.  The caller then interprets the instruction and the block is
+ *    recompiled from the new ROM on its next use.
+ *    The recompiled block takes the place of the discarded one, and its arena space when the new
+ *    code fits, so there is never more than a block per address.  Space that cannot be reused is
+ *    reclaimed when the arena is full, by discarding every block.
+ *
+ *    Only available on x86-64 Linux, see supported().
+ */
+#ifndef HACK_EMULATOR_2026_10_16_JIT_ENGINE_H
+#define HACK_EMULATOR_2026_10_16_JIT_ENGINE_H
+
+#include "CPU.h"        // for CPU
+#include "Memory.h"     // for Memory
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint16_t, uint32_t, uint64_t
+#include <span>         // for span
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class JIT_Engine final
+{
+public:
+   using word_t = std::uint16_t;
+
+   static constexpr auto max_block_length = 64uz;
+
+   explicit JIT_Engine( Memory& memory );
+   ~JIT_Engine() noexcept;
+
+   JIT_Engine( JIT_Engine const& )                    = delete;
+   JIT_Engine( JIT_Engine&& )                         = delete;
+   auto operator=( JIT_Engine const& ) -> JIT_Engine& = delete;
+   auto operator=( JIT_Engine&& )      -> JIT_Engine& = delete;
+
+   // can native code be generated and executed on this host
+   static auto supported() noexcept -> bool;
+
+   // discard all compiled blocks
+   auto load( std::span<word_t const> rom ) -> void;
+
+   // run native blocks starting at pc within budget, returns the number of instructions executed
+   auto run( CPU& cpu, std::span<word_t const> rom, word_t& pc, std::uint64_t budget,
+             bool compile_missing = true ) -> std::uint64_t;
+
+   // compile the block starting at pc unless there is one already
+   auto prepare( std::span<word_t const> rom, word_t pc ) -> bool;
+
+   // is there a block starting at address that has not been discarded
+   auto compiled( word_t address ) const noexcept -> bool;
+
+   // the blocks that have not been discarded
+   auto compiled_blocks() const noexcept -> std::size_t;
+
+private:
+   // state shared with generated code, the offsets are part of the generated code
+   struct Context
+   {
+      word_t*             ram;
+      std::uint64_t       budget;        // instructions that may still be executed
+      void const* const*  entries;       // native entry point of the block at each address
+      word_t              A;
+      word_t              D;
+      word_t              ALU_output;
+      word_t              pc;
+      std::uint8_t        fault;         // left a block before an M access outside of direct_limit_ or a halt loop
+   };
+
+   using Native = auto (*)( Context* context ) -> std::uint32_t;
+
+   struct Block
+   {
+      word_t              address;
+      std::vector<word_t> words;         // the ROM words the block was compiled from
+      std::size_t         offset;        // of its code in the arena
+      std::size_t         capacity;      // arena bytes reserved for its code
+   };
+
+   static constexpr auto no_block = ~std::uint32_t{ 0 };
+
+   Memory&                    RAM_;
+   word_t                     direct_limit_;     // highest address generated code may access
+   std::vector<Block>         blocks_;           // discarded blocks stay until recompiled at their address
+   std::vector<std::uint32_t> block_at_;         // index into blocks_ by address
+   std::vector<void const*>   entries_;          // native entry by address, nullptr when there is no valid block
+   std::size_t                compiled_words_;   // of the blocks that have not been discarded
+   std::byte*                 arena_;            // executable memory, starts with the dispatcher
+   std::size_t                arena_used_;
+   Native                     dispatcher_;       // enters the block at Context::pc
+   std::size_t                dispatch_;         // arena offset blocks jump to with the next pc in eax
+   std::size_t                exit_;             // arena offset that leaves native code
+
+   auto compile( std::span<word_t const> rom, word_t pc ) -> bool;
+   auto valid( std::span<word_t const> rom, Block const& block ) const -> bool;
+   auto discard( Block const& block ) noexcept -> void;
+   auto place( std::size_t size ) -> std::size_t;
+   auto install( std::span<std::uint8_t const> code, std::size_t offset ) -> bool;
+   auto reset() -> void;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_JIT_ENGINE_H
@@ -0,0 +1,202 @@
+/**
+ * @file    JIT_Engine.t.cpp
+ * @author  William Weston
+ * @brief   Test file for JIT_Engine.h
+ * @version 0.1
+ * @date    2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include "JIT_Engine.h"
+
+#include "Hack/Computer.h"
+#include "Hack/CPU.h"
+#include "Hack/Memory.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <random>
+#include <stdexcept>          // out_of_range
+#include <vector>
+
+
+namespace
+{
+   using Hack::Test_Programs::multiply_looping;
+
+   auto require_same_state( Hack::Computer const& lhs, Hack::Computer const& rhs ) -> void
+   {
+      REQUIRE( lhs.pc()         == rhs.pc() );
+      REQUIRE( lhs.A_Register() == rhs.A_Register() );
+      REQUIRE( lhs.D_Register() == rhs.D_Register() );
+      REQUIRE( lhs.ALU_output() == rhs.ALU_output() );
+      REQUIRE( std::equal( lhs.RAM().ram_begin(), lhs.RAM().ram_end(), rhs.RAM().ram_begin() ) );
+      REQUIRE( std::equal( lhs.screen_begin(), lhs.screen_end(), rhs.screen_begin() ) );
+   }
+}
+
+
+TEST_CASE( "Computer: JIT engine" )
+{
+   using namespace Hack;
+
+   auto interpreted = Computer();
+   auto jit         = Computer();
+
+   interpreted.load_rom( multiply_looping );
+   jit.load_rom( multiply_looping );
+   jit.set_engine( Computer::Engine::JIT );
+
+   REQUIRE( jit.engine() == Computer::Engine::JIT );
+
+   for ( auto* computer : { &interpreted, &jit } )
+   {
+      computer->RAM()[0] = 123;
+      computer->RAM()[1] = 45;
+   }
+
+   SECTION( "batched execution matches the interpreter at every budget" )
+   {
+      for ( auto const budget : { 1u, 2u, 3u, 7u, 10u, 64u, 1'000u } )
+      {
+         interpreted.execute( budget );
+         jit.execute( budget );
+
+         require_same_state( interpreted, jit );
+      }
+
+      interpreted.execute( 10'000 );
+      jit.execute( 10'000 );
+
+      require_same_state( interpreted, jit );
+      REQUIRE( jit.RAM()[2] == 123 * 45 );
+   }
+
+   SECTION( "single stepping" )
+   {
+      for ( auto count = 0; count < 500; ++count )
+      {
+         interpreted.execute();
+         jit.execute();
+
+         require_same_state( interpreted, jit );
+      }
+   }
+
+   SECTION( "modified ROM is not run from the stale block" )
+   {
+      jit.execute( 100 );
+      interpreted.execute( 100 );
+
+      for ( auto* computer : { &interpreted, &jit } )
+      {
+         computer->ROM()[9] = 0xF1C8;      // @2  M=M-D   instead of M=D+M
+      }
+
+      jit.execute( 1'000 );
+      interpreted.execute( 1'000 );
+
+      require_same_state( interpreted, jit );
+
+      for ( auto* computer : { &interpreted, &jit } )
+      {
+         computer->ROM()[9] = 0xF088;      // restore M=D+M
+      }
+
+      // budgets smaller than the compiled code check blocks one at a time
+      for ( auto count = 0; count < 100; ++count )
+      {
+         jit.execute( 5 );
+         interpreted.execute( 5 );
+
+         require_same_state( interpreted, jit );
+      }
+   }
+
+   SECTION( "ROM rewritten again and again keeps a block per address" )
+   {
+      auto ram    = Memory();
+      auto cpu    = CPU( ram );
+      auto engine = JIT_Engine( ram );
+      auto rom    = multiply_looping;
+
+      ram[1] = 10'000;
+
+      for ( auto count = 0; count < 1'000; ++count )
+      {
+         auto pc = std::uint16_t{ 0 };
+
+         rom[9] = count % 2 == 0 ? 0xF1C8 : 0xF088;      // M=M-D and M=D+M in turn
+
+         static_cast<void>( engine.run( cpu, rom, pc, 100 ) );
+      }
+
+      REQUIRE( engine.compiled_blocks() <= 4 );
+   }
+
+   SECTION( "out of range M access throws with the state of the preceding instruction" )
+   {
+      auto const rom = std::vector<std::uint16_t>
+      {
+         0x0005, 0xEDD0,      // @5      D=A+1
+         0x7FFF, 0xFC10       // @32767  D=M
+      };
+
+      interpreted.load_rom( rom );
+      jit.load_rom( rom );
+
+      REQUIRE_THROWS_AS( interpreted.execute( 10 ), std::out_of_range );
+      REQUIRE_THROWS_AS( jit.execute( 10 ), std::out_of_range );
+
+      require_same_state( interpreted, jit );
+      REQUIRE( jit.pc() == 3 );
+   }
+}
+
+
+TEST_CASE( "Computer: JIT engine agrees with the interpreter on random programs" )
+{
+   using namespace Hack;
+
+   auto generator   = std::mt19937( 2026 );
+   auto instruction = std::uniform_int_distribution<std::uint16_t>( 0xE000, 0xFFFF );
+   auto address     = std::uniform_int_distribution<std::uint16_t>( 0, 63 );
+   auto coin        = std::bernoulli_distribution( 0.5 );
+
+   for ( auto program = 0; program < 200; ++program )
+   {
+      auto rom = std::vector<std::uint16_t>( 64 );
+
+      // every C-instruction follows an A-instruction inside the program so M stays in range, and
+      // those writing A do not jump so that jumps stay in the program
+      for ( auto idx = 0uz; idx < rom.size(); ++idx )
+      {
+         rom[idx] = ( idx % 2 == 0 || coin( generator ) ) ? address( generator ) : instruction( generator );
+
+         if ( rom[idx] & 0b0000'0000'0010'0000 )
+         {
+            rom[idx] &= 0b1111'1111'1111'1000;
+         }
+      }
+
+      auto interpreted = Computer();
+      auto jit         = Computer();
+
+      interpreted.load_rom( rom );
+      jit.load_rom( rom );
+      jit.set_engine( Computer::Engine::JIT );
+
+      for ( auto cell = 0; cell < 64; ++cell )
+      {
+         interpreted.RAM()[static_cast<std::size_t>( cell )] = static_cast<std::uint16_t>( cell * 977 );
+         jit.RAM()[static_cast<std::size_t>( cell )]         = static_cast<std::uint16_t>( cell * 977 );
+      }
+
+      interpreted.execute( 5'000 );
+      jit.execute( 5'000 );
+
+      require_same_state( interpreted, jit );
+   }
+}
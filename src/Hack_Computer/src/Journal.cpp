@@ -0,0 +1,215 @@
+/**
+ * @file    Journal.cpp
+ * @author  William Weston
+ * @brief   The state each executed instruction overwrote, so that execution can be rewound
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Journal.h"
+
+#include "Decoder.h"    // for Decoded_Instruction
+
+#include <algorithm>    // for fill, max
+#include <bit>          // for popcount
+#include <utility>      // for move
+
+
+namespace
+{
+   using Entry  = Hack::Journal::Entry;
+   using word_t = Hack::Journal::word_t;
+
+   constexpr auto dest_A  = Hack::Decoded_Instruction::dest_A;
+   constexpr auto dest_D  = Hack::Decoded_Instruction::dest_D;
+   constexpr auto dest_M  = Hack::Decoded_Instruction::dest_M;
+   constexpr auto tag_alu = word_t{ 0b1000 };
+
+   // the words the record of entry takes, its tag and pc included
+   constexpr auto record_size( Entry const& entry ) noexcept -> std::size_t
+   {
+      return 2uz + static_cast<std::size_t>( std::popcount( entry.written ) ) + ( entry.alu ? 1uz : 0uz );
+   }
+
+   static_assert( Hack::Journal::chunk_words <= 0xFFFF, "chunk ends fit in a word" );
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Journal::Journal( std::size_t capacity, std::uint64_t interval )
+   : words_( std::max( 2uz, ( capacity + chunk_words - 1 ) / chunk_words ) * chunk_words ),
+     records_( words_.size() / chunk_words ),
+     ends_( records_.size() ),
+     interval_( std::max( std::uint64_t{ 1 }, interval ) )
+{}
+
+
+/**
+ * @brief   Record the state an instruction overwrote
+ *
+ * @param entry   the values before it executed
+ * @param count   the instruction count after it executed
+ *
+ *    When the ring is full the oldest chunk of records is dropped.
+ */
+auto
+Hack::Journal::push( Entry const& entry, std::uint64_t count ) -> void
+{
+   auto const size = record_size( entry );
+
+   if ( fill_ + size > chunk_words )
+   {
+      next_chunk();
+   }
+
+   auto* out = words_.data() + last_ * chunk_words + fill_;
+
+   if ( entry.written & dest_A ) { *out++ = entry.A; }
+   if ( entry.written & dest_D ) { *out++ = entry.D; }
+   if ( entry.written & dest_M ) { *out++ = entry.M; }
+   if ( entry.alu )              { *out++ = entry.ALU_output; }
+
+   *out++ = entry.pc;
+   *out   = static_cast<word_t>( entry.written | ( entry.alu ? tag_alu : 0u ) );
+
+   fill_ += size;
+   ++records_[last_];
+   ++depth_;
+   end_ = count;
+}
+
+
+/**
+ * @brief   Take the newest record
+ *
+ * @return Entry   the values its instruction overwrote, end() is one less after
+ */
+auto
+Hack::Journal::pop() -> Entry
+{
+   while ( records_[last_] == 0 )
+   {
+      last_ = ( last_ + records_.size() - 1 ) % records_.size();
+      fill_ = ends_[last_];
+   }
+
+   auto const* in    = words_.data() + last_ * chunk_words + fill_;
+   auto const  tag   = *--in;
+   auto        entry = Entry{ .pc = *--in, .written = static_cast<std::uint8_t>( tag & 0b111 ), .alu = ( tag & tag_alu ) != 0,
+                              .A = 0, .D = 0, .M = 0, .ALU_output = 0 };
+
+   if ( entry.alu )              { entry.ALU_output = *--in; }
+   if ( entry.written & dest_M ) { entry.M = *--in; }
+   if ( entry.written & dest_D ) { entry.D = *--in; }
+   if ( entry.written & dest_A ) { entry.A = *--in; }
+
+   fill_ -= record_size( entry );
+   --records_[last_];
+   --depth_;
+   --end_;
+
+   return entry;
+}
+
+
+auto
+Hack::Journal::clear( std::uint64_t count ) noexcept -> void
+{
+   discard_records( count );
+   checkpoints_.clear();
+}
+
+
+auto
+Hack::Journal::discard_records( std::uint64_t count ) noexcept -> void
+{
+   std::ranges::fill( records_, 0u );
+   first_ = 0;
+   last_  = 0;
+   fill_  = 0;
+   depth_ = 0;
+   end_   = count;
+}
+
+
+auto
+Hack::Journal::discard_checkpoints( std::uint64_t count ) noexcept -> void
+{
+   while ( !checkpoints_.empty() && checkpoints_.back().header().instructions > count )
+   {
+      checkpoints_.pop_back();
+   }
+}
+
+
+auto
+Hack::Journal::depth() const noexcept -> std::uint64_t
+{
+   return depth_;
+}
+
+
+auto
+Hack::Journal::end() const noexcept -> std::uint64_t
+{
+   return end_;
+}
+
+
+auto
+Hack::Journal::interval() const noexcept -> std::uint64_t
+{
+   return interval_;
+}
+
+
+// keep snapshot, dropping the oldest checkpoint beyond max_checkpoints
+auto
+Hack::Journal::add_checkpoint( Computer::Snapshot snapshot ) -> void
+{
+   checkpoints_.push_back( std::move( snapshot ) );
+
+   if ( checkpoints_.size() > max_checkpoints )
+   {
+      checkpoints_.pop_front();
+   }
+}
+
+
+auto
+Hack::Journal::checkpoint( std::uint64_t count ) const noexcept -> Computer::Snapshot const*
+{
+   for ( auto it = checkpoints_.rbegin(); it != checkpoints_.rend(); ++it )
+   {
+      if ( it->header().instructions <= count )
+      {
+         return &*it;
+      }
+   }
+
+   return checkpoints_.empty() ? nullptr : &checkpoints_.front();
+}
+
+
+// ----------------------------------------- Implementation ---------------------------------------
+
+// start writing the next chunk of the ring, dropping its records if it is the oldest
+auto
+Hack::Journal::next_chunk() noexcept -> void
+{
+   ends_[last_] = static_cast<word_t>( fill_ );
+   last_        = ( last_ + 1 ) % records_.size();
+   fill_        = 0;
+
+   if ( last_ == first_ )
+   {
+      depth_  -= records_[first_];
+      first_   = ( first_ + 1 ) % records_.size();
+   }
+
+   records_[last_] = 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file    Journal.h
+ * @author  William Weston
+ * @brief   The state each executed instruction overwrote, so that execution can be rewound
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    An instruction overwrites at most A, D, one RAM word, the ALU output and pc, so undoing it
+ *    needs only their old values.  Each record holds the ones it overwrote as 16-bit words,
+ *    followed by the old pc and a tag saying which are present, and is read back from its tag:
+ *
+ *       A-instruction      A  pc  tag                              3 words
+ *       C-instruction      [A] [D] [M]  ALU  pc  tag               3 to 6 words
+ *
+ *    The address of M is not recorded: it is A before the instruction, which is A again once A
+ *    has been undone.
+ *
+ *    Records fill fixed size chunks of a ring, none spans two.  When the ring is full the oldest
+ *    chunk is dropped whole, so memory is bounded by the capacity and undoing n instructions
+ *    reads n records.  Further back than the records reach, the journal keeps the last few
+ *    snapshots taken every checkpoint interval.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_JOURNAL_H
+#define HACK_EMULATOR_2026_10_16_JOURNAL_H
+
+#include "Computer.h"   // for Computer::Snapshot
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint8_t, uint16_t, uint32_t, uint64_t
+#include <deque>        // for deque
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class Journal final
+{
+public:
+   using word_t = std::uint16_t;
+
+   // the state one instruction overwrote
+   struct Entry
+   {
+      word_t       pc;
+      std::uint8_t written;        // Decoded_Instruction::dest bits of the registers recorded below
+      bool         alu;            // a C-instruction, ALU_output is recorded
+      word_t       A;
+      word_t       D;
+      word_t       M;              // RAM[A]
+      word_t       ALU_output;
+   };
+
+   static constexpr std::size_t chunk_words     = 4'096;     // words of records dropped at a time
+   static constexpr std::size_t max_checkpoints = 8;
+
+   // capacity words of records, rounded up to at least two chunks, and a snapshot every interval instructions
+   Journal( std::size_t capacity, std::uint64_t interval );
+
+   // record the instruction that brought the instruction count to count
+   auto push( Entry const& entry, std::uint64_t count ) -> void;
+
+   // the newest record, depth() > 0
+   auto pop() -> Entry;
+
+   // drop every record and checkpoint, the next record brings the instruction count past count
+   auto clear( std::uint64_t count ) noexcept -> void;
+
+   // drop every record, keeping the checkpoints
+   auto discard_records( std::uint64_t count ) noexcept -> void;
+
+   // drop the checkpoints taken after count, they belong to a run that has been rewound
+   auto discard_checkpoints( std::uint64_t count ) noexcept -> void;
+
+   // the records, the instructions that can be undone one by one
+   auto depth()    const noexcept -> std::uint64_t;
+
+   // the instruction count after the newest record, the computer must be there to undo it
+   auto end()      const noexcept -> std::uint64_t;
+
+   auto interval() const noexcept -> std::uint64_t;
+
+   auto add_checkpoint( Computer::Snapshot snapshot ) -> void;
+
+   // the newest checkpoint taken at or before count, else the oldest, nullptr if there are none
+   auto checkpoint( std::uint64_t count ) const noexcept -> Computer::Snapshot const*;
+
+private:
+   std::vector<word_t>        words_;              // the ring of chunks
+   std::vector<std::uint32_t> records_;            // in each chunk
+   std::vector<word_t>        ends_;               // the words used in each chunk
+   std::size_t                first_{ 0 };         // the oldest chunk
+   std::size_t                last_{ 0 };          // the chunk being written
+   std::size_t                fill_{ 0 };          // the words used in last_
+   std::uint64_t              depth_{ 0 };
+   std::uint64_t              end_{ 0 };
+   std::uint64_t              interval_;
+
+   std::deque<Computer::Snapshot> checkpoints_{};  // oldest first
+
+   auto next_chunk() noexcept -> void;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_JOURNAL_H
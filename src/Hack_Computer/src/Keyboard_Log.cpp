@@ -0,0 +1,214 @@
+/**
+ * @file    Keyboard_Log.cpp
+ * @author  William Weston
+ * @brief   Keyboard input tied to the instruction count, so that a session can be replayed exactly
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Keyboard_Log.h"
+
+#include <algorithm>    // for min, upper_bound
+#include <fstream>      // for ifstream, ofstream
+#include <iterator>     // for prev
+#include <limits>       // for numeric_limits
+#include <sstream>      // for istringstream
+#include <stdexcept>    // for runtime_error
+#include <string>       // for getline, operator+, string
+
+
+namespace
+{
+   constexpr auto header = "hack-keyboard-log 1";
+
+   auto bad_log( std::filesystem::path const& path, std::size_t line_no ) -> std::runtime_error
+   {
+      return std::runtime_error( "Not a keyboard log: " + path.string() + " line " + std::to_string( line_no ) );
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+auto
+Hack::Keyboard_Log::record( Computer const& computer ) -> void
+{
+   record( computer.instruction_count(), computer.keyboard() );
+}
+
+
+/**
+ * @brief   Note the key held at an instruction count
+ *
+ * @param instruction   the instruction count the key was set at
+ * @param key           the keyboard word
+ *
+ *    Nothing is added while the key is the one already in the log.  An instruction count below
+ *    the last event's means the computer was reset or rewound, the events after it are dropped.
+ */
+auto
+Hack::Keyboard_Log::record( std::uint64_t instruction, word_t key ) -> void
+{
+   while ( !events_.empty() && events_.back().instruction > instruction )
+   {
+      events_.pop_back();
+   }
+
+   if ( !events_.empty() && events_.back().instruction == instruction )
+   {
+      events_.pop_back();
+   }
+
+   auto const previous = events_.empty() ? word_t{ 0 } : events_.back().key;
+
+   if ( key != previous )
+   {
+      events_.push_back( Event{ instruction, key } );
+   }
+}
+
+
+auto
+Hack::Keyboard_Log::events() const noexcept -> std::span<Event const>
+{
+   return events_;
+}
+
+
+auto
+Hack::Keyboard_Log::empty() const noexcept -> bool
+{
+   return events_.empty();
+}
+
+
+auto
+Hack::Keyboard_Log::clear() noexcept -> void
+{
+   events_.clear();
+}
+
+
+/**
+ * @brief   Write the log to a file
+ *
+ * @param path    where to write it
+ * @throws std::runtime_error if it cannot be written
+ */
+auto
+Hack::Keyboard_Log::save( std::filesystem::path const& path ) const -> void
+{
+   auto file = std::ofstream( path, std::ios::trunc );
+
+   file << header << '\n';
+
+   for ( auto const& event : events_ )
+   {
+      file << event.instruction << ' ' << event.key << '\n';
+   }
+
+   file.close();
+
+   if ( !file )
+   {
+      throw std::runtime_error( "Could not write keyboard log " + path.string() );
+   }
+}
+
+
+/**
+ * @brief   Read a log written by save()
+ *
+ * @param path            the file to read
+ * @return Keyboard_Log   its events
+ * @throws std::runtime_error if path cannot be read, or holds anything but events in order
+ */
+auto
+Hack::Keyboard_Log::load( std::filesystem::path const& path ) -> Keyboard_Log
+{
+   auto input = std::ifstream( path );
+   auto line  = std::string();
+   auto log   = Keyboard_Log();
+
+   if ( !input.is_open() )
+   {
+      throw std::runtime_error( "Could not read keyboard log " + path.string() );
+   }
+
+   if ( !std::getline( input, line ) || line != header )
+   {
+      throw bad_log( path, 1 );
+   }
+
+   for ( auto line_no = 2uz; std::getline( input, line ); ++line_no )
+   {
+      auto fields      = std::istringstream( line );
+      auto instruction = std::uint64_t{ 0 };
+      auto key         = unsigned{ 0 };
+      auto rest        = std::string();
+
+      if ( !( fields >> instruction >> key ) || fields >> rest || key > std::numeric_limits<word_t>::max() ||
+           ( !log.events_.empty() && log.events_.back().instruction >= instruction ) )
+      {
+         throw bad_log( path, line_no );
+      }
+
+      log.events_.push_back( Event{ instruction, static_cast<word_t>( key ) } );
+   }
+
+   return log;
+}
+
+
+/**
+ * @brief   Run a computer with the keyboard of a recorded session
+ *
+ * @param computer           in the state the session started from, or one it passed through
+ * @param log                the keys of the session
+ * @param max_instructions   the maximum number of instructions to execute
+ * @return Computer::Run_Result   as Computer::run() returns it, Stop_Reason::Budget once
+ *                                max_instructions have executed
+ *
+ *    The keyboard is first set to the key of the last event at or before the instruction count,
+ *    if there is one.  The computer then runs up to each later event, which is applied before the
+ *    next instruction, so keyboard poll loops are still fast-forwarded between events.
+ */
+auto
+Hack::replay( Computer& computer, Keyboard_Log const& log, std::uint64_t max_instructions ) -> Computer::Run_Result
+{
+   using Event = Keyboard_Log::Event;
+
+   auto const events   = log.events();
+   auto       next     = std::ranges::upper_bound( events, computer.instruction_count(), {}, &Event::instruction );
+   auto       executed = std::uint64_t{ 0 };
+
+   if ( next != events.begin() )
+   {
+      computer.keyboard() = std::prev( next )->key;
+   }
+
+   while ( true )
+   {
+      auto budget = max_instructions - executed;
+
+      if ( next != events.end() )
+      {
+         budget = std::min( budget, next->instruction - computer.instruction_count() );
+      }
+
+      auto const result = computer.run( budget );
+
+      executed += result.executed;
+
+      if ( result.reason != Computer::Stop_Reason::Budget || executed == max_instructions )
+      {
+         return { result.reason, executed };
+      }
+
+      computer.keyboard() = next->key;
+      ++next;
+   }
+}
@@ -0,0 +1,161 @@
+/**
+ * @file    Keyboard_Log.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Keyboard_Log.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Keyboard_Log.h"
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>    // equal
+#include <cstdint>
+#include <filesystem>   // temp_directory_path
+#include <fstream>      // ofstream
+#include <random>       // random_device
+#include <stdexcept>    // runtime_error
+#include <string>       // to_string
+#include <utility>      // pair
+#include <vector>
+
+
+TEST_CASE( "Computer: Keyboard_Log records changes of the key" )
+{
+   using namespace Hack;
+   using Event = Keyboard_Log::Event;
+
+   auto log = Keyboard_Log();
+
+   log.record( 0, 0 );
+   log.record( 10, 'a' );
+   log.record( 20, 'a' );
+   log.record( 30, 0 );
+
+   REQUIRE( log.events().size() == 2 );
+   REQUIRE( log.events()[0] == Event{ 10, 'a' } );
+   REQUIRE( log.events()[1] == Event{ 30, 0 } );
+
+   SECTION( "a key set twice at one instruction keeps the last" )
+   {
+      log.record( 30, 'b' );
+
+      REQUIRE( log.events().size() == 2 );
+      REQUIRE( log.events()[1] == Event{ 30, 'b' } );
+
+      log.record( 30, 'a' );
+
+      REQUIRE( log.events().size() == 1 );
+   }
+
+   SECTION( "a computer that was reset drops the events after it" )
+   {
+      log.record( 15, 'c' );
+
+      REQUIRE( log.events().size() == 2 );
+      REQUIRE( log.events()[1] == Event{ 15, 'c' } );
+
+      log.clear();
+
+      REQUIRE( log.empty() );
+   }
+
+   SECTION( "save and load" )
+   {
+      auto const path = std::filesystem::temp_directory_path() / ( "hack_keys_" + std::to_string( std::random_device()() ) );
+
+      log.save( path );
+
+      auto const loaded = Keyboard_Log::load( path );
+
+      REQUIRE( std::ranges::equal( loaded.events(), log.events() ) );
+
+      std::ofstream( path, std::ios::trunc ) << "hack-keyboard-log 1\n20 65\n10 66\n";
+
+      REQUIRE_THROWS_AS( Keyboard_Log::load( path ), std::runtime_error );
+
+      std::ofstream( path, std::ios::trunc ) << "hack-keyboard-log 1\n20 65536\n";
+
+      REQUIRE_THROWS_AS( Keyboard_Log::load( path ), std::runtime_error );
+
+      std::ofstream( path, std::ios::trunc ) << "20 65\n";
+
+      REQUIRE_THROWS_AS( Keyboard_Log::load( path ), std::runtime_error );
+
+      std::filesystem::remove( path );
+
+      REQUIRE_THROWS_AS( Keyboard_Log::load( path ), std::runtime_error );
+   }
+}
+
+
+TEST_CASE( "Computer: replay a keyboard session" )
+{
+   using namespace Hack;
+
+   // (LOOP) @KBD, D=M, @1, M=D+M, @LOOP, 0;JMP     RAM[1] sums the key at every iteration
+   auto const sum_keys = std::vector<std::uint16_t>{ 0x6000, 0xFC10, 0x0001, 0xF088, 0x0000, 0xEA87 };
+
+   SECTION( "every key reaches the program at the instruction it was recorded at" )
+   {
+      auto session = Computer();
+      auto log     = Keyboard_Log();
+
+      session.load_rom( sum_keys );
+
+      // a frame at a time, the key changes between frames
+      auto const frames = std::vector<std::pair<std::uint64_t, std::uint16_t>>
+      {
+         { 1'001, 'h' }, { 77, 'h' }, { 5'003, 0 }, { 12, 'i' }, { 9'999, 0 }, { 1, 130 }, { 40'000, 0 }
+      };
+
+      for ( auto const& [instructions, key] : frames )
+      {
+         session.keyboard() = key;
+         log.record( session );
+         session.run( instructions );
+      }
+
+      for ( auto const engine : { Computer::Engine::Interpreter, Computer::Engine::Threaded, Computer::Engine::Tiered } )
+      {
+         auto computer = Computer();
+
+         computer.load_rom( sum_keys );
+         computer.set_engine( engine );
+
+         auto const result = replay( computer, log, session.instruction_count() );
+
+         REQUIRE( result.reason   == Computer::Stop_Reason::Budget );
+         REQUIRE( result.executed == session.instruction_count() );
+         REQUIRE( computer.RAM()[1] == session.RAM()[1] );
+         REQUIRE( computer.pc()     == session.pc() );
+      }
+   }
+
+   SECTION( "poll loops are fast-forwarded up to the next key" )
+   {
+      // (WAIT) @KBD, D=M, @WAIT, D;JEQ, @2, M=D, (END) @6, 0;JMP
+      auto const wait_key = std::vector<std::uint16_t>{ 0x6000, 0xFC10, 0x0000, 0xE302, 0x0002, 0xE308, 0x0006, 0xEA87 };
+
+      auto log = Keyboard_Log();
+
+      log.record( 10'000'001, 'q' );
+
+      auto computer = Computer();
+
+      computer.load_rom( wait_key );
+
+      auto const result = replay( computer, log, 1'000'000'000 );
+
+      REQUIRE( result.reason   == Computer::Stop_Reason::Halted );
+      REQUIRE( computer.RAM()[2] == 'q' );
+      REQUIRE( computer.skipped_instructions() > 9'000'000 );
+
+      // the key was read by the first D=M after instruction 10'000'001, at most one iteration later
+      REQUIRE( result.executed > 10'000'001 );
+      REQUIRE( result.executed <= 10'000'001 + 4 + 4 );
+   }
+}
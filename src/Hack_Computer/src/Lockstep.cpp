@@ -0,0 +1,774 @@
+/**
+ * @file    Lockstep.cpp
+ * @author  William Weston
+ * @brief   Runs 8, 16 or 32 Hack machines on one ROM in lockstep, in structure-of-arrays form
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Lockstep.h"
+
+#include "ALU.h"           // for ALU, ALU_in
+#include "Decoder.h"       // for Decoded_Instruction, decode
+#include "Memory.h"        // for Memory
+
+#include <algorithm>       // for max, min_element
+#include <array>           // for array
+#include <bit>             // for countr_zero, popcount
+#include <cstddef>         // for size_t
+#include <stdexcept>       // for out_of_range
+#include <string>          // for operator+, to_string
+#include <utility>         // for move
+#include <vector>          // for vector
+
+#if defined( HACK_COMPUTER_ENABLE_SIMD ) && defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+   #define HACK_LOCKSTEP_X86 1
+#else
+   #define HACK_LOCKSTEP_X86 0
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+   #define HACK_LOCKSTEP_INLINE [[gnu::always_inline]] inline
+#else
+   #define HACK_LOCKSTEP_INLINE inline
+#endif
+
+
+template <std::size_t Lanes>
+struct Hack::Lockstep_Machines
+{
+   using word_t = std::uint16_t;
+   using mask_t = std::uint32_t;     // bit i for machine i
+   using Status = Computer::Status;
+
+   // a word of every machine, aligned for vector loads
+   struct alignas( Lanes * sizeof( word_t ) ) Row
+   {
+      std::array<word_t, Lanes> words{};
+   };
+
+   // running machines that share a pc
+   struct Group
+   {
+      word_t pc;
+      mask_t lanes;
+   };
+
+   std::shared_ptr<Shared_ROM const> rom{ Shared_ROM::empty() };
+   std::vector<bool>                 halts = std::vector<bool>( Shared_ROM::size );     // @P 0;JMP starts at P
+
+   std::vector<Row>                  ram = std::vector<Row>( Memory::buffer_size );     // padded, A is masked to index it
+   Row                               A{};
+   Row                               D{};
+   Row                               pc{};
+   std::array<std::uint64_t, Lanes>  instructions{};
+   std::array<Status, Lanes>         status{};
+   std::vector<Group>                groups{};      // of run()
+
+   auto place( std::size_t lane ) -> void;
+};
+
+
+namespace
+{
+   using word_t = std::uint16_t;
+   using mask_t = std::uint32_t;
+   using Op     = Hack::Decoded_Instruction;
+
+   template <std::size_t Lanes>
+   using Machines = Hack::Lockstep_Machines<Lanes>;
+
+   template <std::size_t Lanes>
+   using Row = typename Machines<Lanes>::Row;
+
+   template <std::size_t Lanes>
+   using Group = typename Machines<Lanes>::Group;
+
+   constexpr auto no_limit = std::uint32_t{ 1 } << 16;     // above every pc
+
+   // why the step loop returned
+   enum class Event : std::uint8_t
+   {
+      Budget,        // the group has executed its budget
+      Limit,         // pc reached the lowest pc of another group, the group yields or merges with it
+      Diverged,      // the last instruction took the lanes to different addresses, their pcs are in Machines::pc
+      Halted,        // lanes is in a halt loop, which has not executed
+      Faulted        // lanes fetch outside of ROM or access M outside of RAM, the instruction has not executed
+   };
+
+   struct Exit
+   {
+      Event         event;
+      mask_t        lanes;        // the lanes of Halted and Faulted
+      std::uint64_t executed;     // steps of the group
+   };
+
+   template <std::size_t Lanes>
+   using Step_Loop = auto (*)( Machines<Lanes>& machines, Group<Lanes>& group, std::uint64_t budget, std::uint32_t limit ) -> Exit;
+
+
+   // every word of select is all ones for the lanes of lanes and zero for the others
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto expand( mask_t lanes ) -> Row<Lanes>
+   {
+      auto select = Row<Lanes>();
+
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         select.words[lane] = static_cast<word_t>( 0u - ( ( lanes >> lane ) & 1u ) );
+      }
+
+      return select;
+   }
+
+   // target = value in the lanes of select, as it was in the others
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto blend( Row<Lanes>& target, Row<Lanes> const& value, Row<Lanes> const& select ) -> void
+   {
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         target.words[lane] = static_cast<word_t>( ( value.words[lane] & select.words[lane] ) | ( target.words[lane] & ~select.words[lane] ) );
+      }
+   }
+
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto blend( Row<Lanes>& target, word_t value, Row<Lanes> const& select ) -> void
+   {
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         target.words[lane] = static_cast<word_t>( ( value & select.words[lane] ) | ( target.words[lane] & ~select.words[lane] ) );
+      }
+   }
+
+   // do the lanes of select all hold value
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto uniform( Row<Lanes> const& row, word_t value, Row<Lanes> const& select ) -> bool
+   {
+      auto difference = word_t{ 0 };
+
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         difference |= static_cast<word_t>( ( row.words[lane] ^ value ) & select.words[lane] );
+      }
+
+      return difference == 0;
+   }
+
+   // the lanes of select whose word satisfies predicate
+   template <std::size_t Lanes, typename Predicate>
+   HACK_LOCKSTEP_INLINE auto lanes_where( Row<Lanes> const& row, mask_t select, Predicate predicate ) -> mask_t
+   {
+      auto lanes = mask_t{ 0 };
+
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         lanes |= static_cast<mask_t>( predicate( row.words[lane] ) ) << lane;
+      }
+
+      return lanes & select;
+   }
+
+   // the ALU of ALU.h on every lane, comp is the same for all of them
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto alu( std::uint8_t comp, Row<Lanes> const& x, Row<Lanes> const& y ) -> Row<Lanes>
+   {
+      auto const zx = ( comp & Op::comp_zx ) != 0;
+      auto const nx = ( comp & Op::comp_nx ) != 0;
+      auto const zy = ( comp & Op::comp_zy ) != 0;
+      auto const ny = ( comp & Op::comp_ny ) != 0;
+      auto const f  = ( comp & Op::comp_f  ) != 0;
+      auto const no = ( comp & Op::comp_no ) != 0;
+
+      auto out = Row<Lanes>();
+
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         out.words[lane] = Hack::ALU( Hack::ALU_in{ x.words[lane], y.words[lane], zx, nx, zy, ny, f, no } ).out;
+      }
+
+      return out;
+   }
+
+   // the lanes of select whose ALU output satisfies jump, see CPU::do_c_instruction
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto jumping( std::uint8_t jump, Row<Lanes> const& out, mask_t select ) -> mask_t
+   {
+      constexpr auto sign_bit = word_t{ 0b1000'0000'0000'0000 };
+
+      return lanes_where<Lanes>( out, select, [jump]( word_t word )
+      {
+         auto const condition = ( word & sign_bit ) ? Op::jump_lt : ( word == 0 ? Op::jump_eq : Op::jump_gt );
+
+         return ( jump & condition ) != 0;
+      } );
+   }
+
+
+   /**
+    * @brief   Step a group until it executes budget instructions, its pc reaches limit, or an
+    *          instruction would take its lanes apart
+    *
+    * @param budget   instructions each lane may still execute, more than 0
+    * @param limit    the lowest pc of the other groups, or no_limit
+    *
+    *    group.pc and the pcs of its lanes are current on return, and the steps are added to their
+    *    instruction counts.  Every lane of the group executes the instruction at pc, M is read and
+    *    written through a single row when A is the same in all of them.
+    */
+   template <std::size_t Lanes>
+   HACK_LOCKSTEP_INLINE auto step( Machines<Lanes>& machines, Group<Lanes>& group, std::uint64_t budget, std::uint32_t limit ) -> Exit
+   {
+      auto const  lanes   = group.lanes;
+      auto const  select  = expand<Lanes>( lanes );
+      auto const  first   = static_cast<std::size_t>( std::countr_zero( lanes ) );
+      auto const  decoded = machines.rom->decoded();
+      auto const& halts   = machines.halts;
+
+      auto& A   = machines.A;
+      auto& D   = machines.D;
+      auto& ram = machines.ram;
+
+      auto pc   = group.pc;
+      auto exit = Exit{ Event::Budget, 0, 0 };
+
+      for ( ; exit.executed != budget; ++exit.executed )
+      {
+         if ( pc >= limit )
+         {
+            exit.event = Event::Limit;
+            break;
+         }
+
+         if ( pc >= Hack::Shared_ROM::size )
+         {
+            exit = Exit{ Event::Faulted, lanes, exit.executed };
+            break;
+         }
+
+         auto const& op = decoded[pc];
+
+         if ( op.is_a_instruction() )
+         {
+            if ( halts[pc] )
+            {
+               exit = Exit{ Event::Halted, lanes, exit.executed };
+               break;
+            }
+
+            blend<Lanes>( A, op.word, select );
+            ++pc;
+            continue;
+         }
+
+         // A as it is before the instruction, shared by every lane or not
+         auto const a0      = A.words[first];
+         auto const shared  = uniform<Lanes>( A, a0, select );
+
+         if ( op.is_halt_jump() )
+         {
+            auto const halting = shared ? ( a0 == pc ? lanes : 0 )
+                                        : lanes_where<Lanes>( A, lanes, [pc]( word_t word ) { return word == pc; } );
+
+            if ( halting != 0 )
+            {
+               exit = Exit{ Event::Halted, halting, exit.executed };
+               break;
+            }
+         }
+
+         auto* row = static_cast<Row<Lanes>*>( nullptr );     // the M of every lane, when A is shared
+
+         if ( op.reads_M() || op.writes_M() )
+         {
+            auto const outside = shared ? ( a0 >= Hack::Memory::address_space ? lanes : 0 )
+                                        : lanes_where<Lanes>( A, lanes, []( word_t word ) { return word >= Hack::Memory::address_space; } );
+
+            if ( outside != 0 )
+            {
+               exit = Exit{ Event::Faulted, outside, exit.executed };
+               break;
+            }
+
+            row = shared ? &ram[a0] : nullptr;
+         }
+
+         auto y = A;
+
+         if ( op.reads_M() )
+         {
+            if ( row )
+            {
+               y = *row;
+            }
+            else
+            {
+               for ( auto lane = 0uz; lane != Lanes; ++lane )
+               {
+                  y.words[lane] = ram[A.words[lane] & Hack::Memory::address_mask].words[lane];
+               }
+            }
+         }
+
+         auto const out = alu<Lanes>( op.comp, D, y );
+
+         if ( op.dest & Op::dest_M )
+         {
+            if ( row )
+            {
+               blend<Lanes>( *row, out, select );
+            }
+            else
+            {
+               for ( auto remaining = lanes; remaining != 0; remaining &= remaining - 1 )
+               {
+                  auto const lane = static_cast<std::size_t>( std::countr_zero( remaining ) );
+
+                  ram[A.words[lane]].words[lane] = out.words[lane];
+               }
+            }
+         }
+
+         if ( op.dest & Op::dest_A ) { blend<Lanes>( A, out, select ); }
+         if ( op.dest & Op::dest_D ) { blend<Lanes>( D, out, select ); }
+
+         if ( op.jump == 0 )
+         {
+            ++pc;
+            continue;
+         }
+
+         auto const taken = jumping<Lanes>( op.jump, out, lanes );
+
+         if ( taken == 0 )
+         {
+            ++pc;
+            continue;
+         }
+
+         auto const target = A.words[first];
+
+         if ( taken == lanes && ( ( !( op.dest & Op::dest_A ) && shared ) || uniform<Lanes>( A, target, select ) ) )
+         {
+            pc = target;
+            continue;
+         }
+
+         // some lanes fall through, or the lanes jump to different addresses
+         for ( auto lane = 0uz; lane != Lanes; ++lane )
+         {
+            if ( ( lanes >> lane ) & 1u )
+            {
+               machines.pc.words[lane] = ( ( taken >> lane ) & 1u ) ? A.words[lane] : static_cast<word_t>( pc + 1 );
+            }
+         }
+
+         exit.event = Event::Diverged;
+         ++exit.executed;
+         break;
+      }
+
+      group.pc = pc;
+
+      if ( exit.event != Event::Diverged )
+      {
+         blend<Lanes>( machines.pc, pc, select );
+      }
+
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         machines.instructions[lane] += ( ( lanes >> lane ) & 1u ) * exit.executed;
+      }
+
+      return exit;
+   }
+
+
+   template <std::size_t Lanes>
+   auto step_baseline( Machines<Lanes>& machines, Group<Lanes>& group, std::uint64_t budget, std::uint32_t limit ) -> Exit
+   {
+      return step<Lanes>( machines, group, budget, limit );
+   }
+
+#if HACK_LOCKSTEP_X86
+   template <std::size_t Lanes>
+   [[gnu::target( "avx2" )]]
+   auto step_avx2( Machines<Lanes>& machines, Group<Lanes>& group, std::uint64_t budget, std::uint32_t limit ) -> Exit
+   {
+      return step<Lanes>( machines, group, budget, limit );
+   }
+
+   template <std::size_t Lanes>
+   [[gnu::target( "avx512f,avx512bw,avx512vl" )]]
+   auto step_avx512( Machines<Lanes>& machines, Group<Lanes>& group, std::uint64_t budget, std::uint32_t limit ) -> Exit
+   {
+      return step<Lanes>( machines, group, budget, limit );
+   }
+#endif
+
+   auto selected_width() noexcept -> std::string_view
+   {
+#if HACK_LOCKSTEP_X86
+      __builtin_cpu_init();
+
+      if ( __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512bw" ) && __builtin_cpu_supports( "avx512vl" ) )
+      {
+         return "avx512";
+      }
+
+      if ( __builtin_cpu_supports( "avx2" ) )
+      {
+         return "avx2";
+      }
+#endif
+      return "baseline";
+   }
+
+   // the widest step loop the host can run, selected once
+   template <std::size_t Lanes>
+   auto step_loop() noexcept -> Step_Loop<Lanes>
+   {
+      static auto const loop = []
+      {
+#if HACK_LOCKSTEP_X86
+         auto const width = selected_width();
+
+         if ( width == "avx512" ) { return &step_avx512<Lanes>; }
+         if ( width == "avx2" )   { return &step_avx2<Lanes>; }
+#endif
+         return &step_baseline<Lanes>;
+      }();
+
+      return loop;
+   }
+
+   auto check( std::size_t machine, std::size_t machines ) -> void
+   {
+      if ( machine >= machines )
+      {
+         throw std::out_of_range( "Lockstep: no machine " + std::to_string( machine ) );
+      }
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+// add lane to the group at its pc, or start one there
+template <std::size_t Lanes>
+auto
+Hack::Lockstep_Machines<Lanes>::place( std::size_t lane ) -> void
+{
+   auto const at  = pc.words[lane];
+   auto const bit = mask_t{ 1 } << lane;
+
+   for ( auto& group : groups )
+   {
+      if ( group.pc == at )
+      {
+         group.lanes |= bit;
+         return;
+      }
+   }
+
+   groups.push_back( Group{ at, bit } );
+}
+
+
+template <std::size_t Lanes>
+Hack::Lockstep<Lanes>::Lockstep()
+   : machines_( std::make_unique<Lockstep_Machines<Lanes>>() )
+{
+   machines_->status.fill( Status::Running );
+}
+
+
+template <std::size_t Lanes>
+Hack::Lockstep<Lanes>::Lockstep( std::shared_ptr<Shared_ROM const> image )
+   : Lockstep()
+{
+   load_rom( std::move( image ) );
+}
+
+
+template <std::size_t Lanes>
+Hack::Lockstep<Lanes>::~Lockstep() = default;
+
+
+/**
+ * @brief   Run the program of image on every machine
+ *
+ * @param image   shared with any computers that run it, see Shared_ROM.h
+ *
+ *    The machines are reset.
+ */
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::load_rom( std::shared_ptr<Shared_ROM const> image ) -> void
+{
+   auto& machines = *machines_;
+   auto const& words = image->words();
+
+   machines.rom = std::move( image );
+
+   for ( auto address = 0uz; address != Shared_ROM::size; ++address )
+   {
+      machines.halts[address] = words[address] == address && address + 1 < Shared_ROM::size && decode( words[address + 1] ).is_halt_jump();
+   }
+
+   reset();
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::reset() -> void
+{
+   auto& machines = *machines_;
+
+   std::ranges::fill( machines.ram, typename Lockstep_Machines<Lanes>::Row{} );
+   machines.A  = {};
+   machines.D  = {};
+   machines.pc = {};
+   machines.instructions.fill( 0 );
+   machines.status.fill( Status::Running );
+   machines.groups.clear();
+}
+
+
+/**
+ * @brief   Execute up to max_instructions on each running machine
+ *
+ * @param max_instructions   the budget of each machine, as Computer::run() takes it
+ * @return Run_Result        the instructions and group steps executed
+ *
+ *    A machine stops when it has executed max_instructions, with Status::Running, where a halt loop
+ *    starts, with Status::Halted, and where it fetches outside of ROM or accesses M outside of RAM,
+ *    with Status::Faulted.  The run returns once every machine has stopped.  A halted or faulted
+ *    machine stays stopped until reset().
+ */
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::run( std::uint64_t max_instructions ) -> Run_Result
+{
+   auto&       machines = *machines_;
+   auto&       groups   = machines.groups;
+   auto const  start    = machines.instructions;
+   auto const  loop     = step_loop<Lanes>();
+   auto        result   = Run_Result{ 0, 0 };
+
+   groups.clear();
+
+   for ( auto lane = 0uz; lane != Lanes; ++lane )
+   {
+      if ( machines.status[lane] == Status::Running )
+      {
+         machines.place( lane );
+      }
+   }
+
+   while ( !groups.empty() )
+   {
+      // the lowest pc steps first, the next lowest is where it yields or merges
+      auto const lowest = static_cast<std::size_t>( std::ranges::min_element( groups, {}, &Lockstep_Machines<Lanes>::Group::pc ) - groups.begin() );
+      auto       limit  = no_limit;
+
+      for ( auto index = 0uz; index != groups.size(); ++index )
+      {
+         if ( index != lowest )
+         {
+            limit = std::min<std::uint32_t>( limit, groups[index].pc );
+         }
+      }
+
+      // lanes merged from other groups may have executed more of their budget
+      auto& group = groups[lowest];
+      auto  used  = std::uint64_t{ 0 };
+
+      for ( auto lane = 0uz; lane != Lanes; ++lane )
+      {
+         if ( ( group.lanes >> lane ) & 1u )
+         {
+            if ( machines.instructions[lane] - start[lane] >= max_instructions )
+            {
+               group.lanes &= ~( std::uint32_t{ 1 } << lane );
+            }
+            else
+            {
+               used = std::max( used, machines.instructions[lane] - start[lane] );
+            }
+         }
+      }
+
+      if ( group.lanes == 0 )
+      {
+         groups.erase( groups.begin() + static_cast<std::ptrdiff_t>( lowest ) );
+         continue;
+      }
+
+      auto const exit = loop( machines, group, max_instructions - used, limit );
+
+      result.executed += exit.executed * static_cast<std::uint64_t>( std::popcount( group.lanes ) );
+      result.steps    += exit.executed;
+
+      switch ( exit.event )
+      {
+         case Event::Budget:
+            break;
+
+         case Event::Limit:
+         case Event::Diverged:
+         {
+            if ( exit.event == Event::Limit && group.pc != limit )
+            {
+               break;
+            }
+
+            // rejoin the lanes to the groups at their pcs
+            auto const rejoining = group.lanes;
+
+            groups.erase( groups.begin() + static_cast<std::ptrdiff_t>( lowest ) );
+
+            for ( auto remaining = rejoining; remaining != 0; remaining &= remaining - 1 )
+            {
+               machines.place( static_cast<std::size_t>( std::countr_zero( remaining ) ) );
+            }
+            break;
+         }
+
+         case Event::Halted:
+         case Event::Faulted:
+         {
+            for ( auto remaining = exit.lanes; remaining != 0; remaining &= remaining - 1 )
+            {
+               machines.status[static_cast<std::size_t>( std::countr_zero( remaining ) )] = exit.event == Event::Halted ? Status::Halted : Status::Faulted;
+            }
+
+            group.lanes &= ~exit.lanes;
+
+            if ( group.lanes == 0 )
+            {
+               groups.erase( groups.begin() + static_cast<std::ptrdiff_t>( lowest ) );
+            }
+            break;
+         }
+      }
+   }
+
+   return result;
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::RAM( std::size_t machine, word_t address ) const -> word_t
+{
+   check( machine, Lanes );
+
+   if ( address >= Memory::address_space )
+   {
+      throw std::out_of_range( "Lockstep: RAM access out of bounds: " + std::to_string( address ) );
+   }
+
+   return machines_->ram[address].words[machine];
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::set_RAM( std::size_t machine, word_t address, word_t value ) -> void
+{
+   check( machine, Lanes );
+
+   if ( address >= Memory::address_space )
+   {
+      throw std::out_of_range( "Lockstep: RAM access out of bounds: " + std::to_string( address ) );
+   }
+
+   machines_->ram[address].words[machine] = value;
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::A_Register( std::size_t machine ) const -> word_t
+{
+   check( machine, Lanes );
+
+   return machines_->A.words[machine];
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::D_Register( std::size_t machine ) const -> word_t
+{
+   check( machine, Lanes );
+
+   return machines_->D.words[machine];
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::pc( std::size_t machine ) const -> word_t
+{
+   check( machine, Lanes );
+
+   return machines_->pc.words[machine];
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::instruction_count( std::size_t machine ) const -> std::uint64_t
+{
+   check( machine, Lanes );
+
+   return machines_->instructions[machine];
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::status( std::size_t machine ) const -> Status
+{
+   check( machine, Lanes );
+
+   return machines_->status[machine];
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::groups() const -> std::size_t
+{
+   auto pcs = std::vector<word_t>();
+
+   for ( auto lane = 0uz; lane != Lanes; ++lane )
+   {
+      if ( machines_->status[lane] == Status::Running && std::ranges::find( pcs, machines_->pc.words[lane] ) == pcs.end() )
+      {
+         pcs.push_back( machines_->pc.words[lane] );
+      }
+   }
+
+   return pcs.size();
+}
+
+
+template <std::size_t Lanes>
+auto
+Hack::Lockstep<Lanes>::vector_width() noexcept -> std::string_view
+{
+   static auto const width = selected_width();
+
+   return width;
+}
+
+
+template class Hack::Lockstep<8>;
+template class Hack::Lockstep<16>;
+template class Hack::Lockstep<32>;
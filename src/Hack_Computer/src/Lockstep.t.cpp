@@ -0,0 +1,184 @@
+/**
+ * @file    Lockstep.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Lockstep.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Lockstep.h"
+
+#include "Hack/Computer.h"
+#include "Hack/Shared_ROM.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>             // make_shared
+#include <stdexcept>          // out_of_range
+#include <utility>            // pair
+#include <vector>
+
+
+namespace
+{
+   using Hack::Test_Programs::multiply;
+
+   // RAM[p] = p for p from RAM[0] up to RAM[0] + RAM[1], through a pointer
+   auto const fill = std::vector<std::uint16_t>
+   {
+      0x0001, 0xFC10, 0x0010, 0xE308,     // @1  D=M  @16  M=D               (count)
+      0x0010, 0xFC10, 0x0012, 0xE302,     // @16 D=M  @18  D;JEQ             (loop)
+      0x0000, 0xFC10, 0xE320, 0xE308,     // @0  D=M  A=D  M=D
+      0x0000, 0xFDC8, 0x0010, 0xFC88,     // @0  M=M+1  @16  M=M-1
+      0x0004, 0xEA87,                     // @4  0;JMP
+      0x0012, 0xEA87                      // @18 0;JMP
+   };
+
+   // run a Computer from the same RAM as machine and compare them
+   template <std::size_t Lanes>
+   auto require_same( Hack::Lockstep<Lanes> const& lockstep, std::size_t machine, std::vector<std::uint16_t> const& program,
+                      std::vector<std::pair<std::uint16_t, std::uint16_t>> const& ram, std::uint64_t budget ) -> void
+   {
+      auto computer = Hack::Computer();
+
+      computer.load_rom( program );
+      computer.set_bounds_check( Hack::Computer::Bounds_Check::Flagging );
+
+      for ( auto const& [address, value] : ram )
+      {
+         computer.RAM()[address] = value;
+      }
+
+      computer.run( budget );
+
+      REQUIRE( lockstep.pc( machine )                == computer.pc() );
+      REQUIRE( lockstep.A_Register( machine )        == computer.A_Register() );
+      REQUIRE( lockstep.D_Register( machine )        == computer.D_Register() );
+      REQUIRE( lockstep.instruction_count( machine ) == computer.instruction_count() );
+      REQUIRE( lockstep.status( machine )            == computer.status() );
+
+      for ( auto address = 0u; address != 64u; ++address )
+      {
+         REQUIRE( lockstep.RAM( machine, static_cast<std::uint16_t>( address ) ) == computer.RAM()[address] );
+      }
+   }
+}
+
+
+TEMPLATE_TEST_CASE_SIG( "Lockstep: machines that diverge match independent computers", "", ( std::size_t Lanes ), 8, 16, 32 )
+{
+   auto lockstep = Hack::Lockstep<Lanes>( std::make_shared<Hack::Shared_ROM const>( multiply ) );
+
+   auto const ram = []( std::size_t machine )
+   {
+      return std::vector<std::pair<std::uint16_t, std::uint16_t>>{
+         { 0, static_cast<std::uint16_t>( machine % 5 ) },
+         { 1, static_cast<std::uint16_t>( 3 + machine ) } };
+   };
+
+   for ( auto machine = 0uz; machine != Lanes; ++machine )
+   {
+      for ( auto const& [address, value] : ram( machine ) )
+      {
+         lockstep.set_RAM( machine, address, value );
+      }
+   }
+
+   SECTION( "to the end" )
+   {
+      auto const result = lockstep.run( 1'000 );
+
+      REQUIRE( result.steps < result.executed );
+      REQUIRE( lockstep.groups() == 0 );
+
+      for ( auto machine = 0uz; machine != Lanes; ++machine )
+      {
+         REQUIRE( lockstep.status( machine ) == Hack::Computer::Status::Halted );
+         REQUIRE( lockstep.RAM( machine, 2 ) == ( machine % 5 ) * ( 3 + machine ) );
+         require_same( lockstep, machine, multiply, ram( machine ), 1'000 );
+      }
+   }
+
+   SECTION( "within a budget" )
+   {
+      for ( auto const budget : { 1u, 7u, 20u, 33u } )
+      {
+         lockstep.reset();
+
+         for ( auto machine = 0uz; machine != Lanes; ++machine )
+         {
+            for ( auto const& [address, value] : ram( machine ) )
+            {
+               lockstep.set_RAM( machine, address, value );
+            }
+         }
+
+         lockstep.run( budget );
+
+         for ( auto machine = 0uz; machine != Lanes; ++machine )
+         {
+            require_same( lockstep, machine, multiply, ram( machine ), budget );
+         }
+      }
+   }
+}
+
+
+TEST_CASE( "Lockstep: M accesses through different addresses" )
+{
+   auto lockstep = Hack::Lockstep<16>( std::make_shared<Hack::Shared_ROM const>( fill ) );
+
+   auto const ram = []( std::size_t machine )
+   {
+      return std::vector<std::pair<std::uint16_t, std::uint16_t>>{
+         { 0, static_cast<std::uint16_t>( 20 + machine ) },
+         { 1, static_cast<std::uint16_t>( machine % 4 + 1 ) } };
+   };
+
+   for ( auto machine = 0uz; machine != 16; ++machine )
+   {
+      for ( auto const& [address, value] : ram( machine ) )
+      {
+         lockstep.set_RAM( machine, address, value );
+      }
+   }
+
+   lockstep.run( 500 );
+
+   for ( auto machine = 0uz; machine != 16; ++machine )
+   {
+      require_same( lockstep, machine, fill, ram( machine ), 500 );
+   }
+}
+
+
+TEST_CASE( "Lockstep: faults stop only the machines that make them" )
+{
+   using Status = Hack::Computer::Status;
+
+   // @0 A=M D=M @0 0;JMP, with RAM[0] outside of RAM in machine 3
+   auto lockstep = Hack::Lockstep<8>( std::make_shared<Hack::Shared_ROM const>( std::vector<std::uint16_t>{ 0x0000, 0xFC20, 0xFC10, 0x0000, 0xEA87 } ) );
+
+   lockstep.set_RAM( 3, 0, 30'000 );
+
+   auto const result = lockstep.run( 10 );
+
+   REQUIRE( lockstep.status( 3 ) == Status::Faulted );
+   REQUIRE( lockstep.pc( 3 ) == 2 );
+   REQUIRE( lockstep.instruction_count( 3 ) == 2 );
+   REQUIRE( lockstep.status( 0 ) == Status::Running );
+   REQUIRE( lockstep.instruction_count( 0 ) == 10 );
+   REQUIRE( result.executed == 7 * 10 + 2 );
+
+   lockstep.run( 10 );
+
+   REQUIRE( lockstep.instruction_count( 3 ) == 2 );
+   REQUIRE( lockstep.instruction_count( 0 ) == 20 );
+
+   REQUIRE_THROWS_AS( lockstep.RAM( 8, 0 ), std::out_of_range );
+   REQUIRE_THROWS_AS( lockstep.RAM( 0, Hack::Memory::address_space ), std::out_of_range );
+}
@@ -0,0 +1,878 @@
+/**
+ * @file    Loop_Idioms.cpp
+ * @author  William Weston
+ * @brief   Recognises loops that can be run as bulk operations
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Loop_Idioms.h"
+
+#include "Decoder.h"       // for Decoded_Instruction, decode
+
+#include <algorithm>       // for all_of, any_of, count_if, equal, fill_n, find_if, min, none_of
+#include <array>           // for array
+#include <cstddef>         // for size_t
+#include <cstdint>         // for uint8_t, uint32_t, uint64_t
+#include <cstring>         // for memmove
+#include <optional>        // for optional, nullopt
+#include <utility>         // for move
+#include <vector>          // for vector
+
+
+namespace
+{
+   using word_t = Hack::Loop_Idioms::word_t;
+   using Op     = Hack::Decoded_Instruction;
+
+   constexpr auto max_bases = Hack::Loop_Idioms::max_bases;
+   constexpr auto all_jumps = std::uint8_t{ Op::jump_lt | Op::jump_eq | Op::jump_gt };
+   constexpr auto sign_bit  = word_t{ 0b1000'0000'0000'0000 };
+
+   // a word with only base index set
+   template <typename Linear>
+   constexpr auto basis( std::size_t index ) -> Linear
+   {
+      auto value = Linear{};
+      value.coefficients[index] = 1;
+      return value;
+   }
+
+   // !value, which is -value - 1
+   constexpr auto complement( auto value )
+   {
+      value.constant = static_cast<word_t>( ~value.constant );
+
+      for ( auto& coefficient : value.coefficients )
+      {
+         coefficient = static_cast<word_t>( -coefficient );
+      }
+
+      return value;
+   }
+
+   constexpr auto sum( auto lhs, auto const& rhs )
+   {
+      lhs.constant = static_cast<word_t>( lhs.constant + rhs.constant );
+
+      for ( auto idx = 0uz; idx < max_bases; ++idx )
+      {
+         lhs.coefficients[idx] = static_cast<word_t>( lhs.coefficients[idx] + rhs.coefficients[idx] );
+      }
+
+      return lhs;
+   }
+
+   constexpr auto is_constant( auto const& value ) -> bool
+   {
+      return std::ranges::all_of( value.coefficients, []( word_t coefficient ) { return coefficient == 0; } );
+   }
+
+   // the ALU on sums of bases, std::nullopt when the result is not one: an AND of two words that
+   // are not both constant, unless one of them is all zeros or all ones
+   template <typename Linear>
+   constexpr auto alu( std::uint8_t comp, Linear x, Linear y ) -> std::optional<Linear>
+   {
+      auto const mask = []( Linear const& value )
+      {
+         return is_constant( value ) && ( value.constant == 0 || value.constant == word_t{ 0xFFFF } );
+      };
+
+      if ( comp & Op::comp_zx ) { x = Linear{}; }
+      if ( comp & Op::comp_nx ) { x = complement( x ); }
+      if ( comp & Op::comp_zy ) { y = Linear{}; }
+      if ( comp & Op::comp_ny ) { y = complement( y ); }
+
+      auto out = Linear{};
+
+      if ( comp & Op::comp_f )
+      {
+         out = sum( x, y );
+      }
+      else if ( mask( x ) )
+      {
+         out = x.constant == 0 ? x : y;
+      }
+      else if ( mask( y ) )
+      {
+         out = y.constant == 0 ? y : x;
+      }
+      else
+      {
+         return std::nullopt;
+      }
+
+      if ( comp & Op::comp_no )
+      {
+         out = complement( out );
+      }
+
+      return out;
+   }
+
+   // the value of a sum of bases
+   constexpr auto evaluate( auto const& value, std::array<word_t, max_bases> const& bases ) -> word_t
+   {
+      auto result = std::uint32_t{ value.constant };
+
+      for ( auto idx = 0uz; idx < max_bases; ++idx )
+      {
+         result += std::uint32_t{ value.coefficients[idx] } * bases[idx];
+      }
+
+      return static_cast<word_t>( result );
+   }
+
+   constexpr auto taken( std::uint8_t jump, word_t value ) -> bool
+   {
+      auto const condition = ( value & sign_bit ) ? Op::jump_lt : ( value == 0 ? Op::jump_eq : Op::jump_gt );
+
+      return ( jump & condition ) != 0;
+   }
+}
+
+
+// ------------------------------------------- API ------------------------------------------------
+
+
+Hack::Loop_Idioms::Loop_Idioms( Memory& memory )
+   : RAM_{ memory },
+     loops_{},
+     loop_at_{}
+{
+}
+
+
+/**
+ * @brief   Forget all analysed loops, each is analysed again from rom when it is next recognised
+ *
+ * @param rom  the instruction ROM
+ */
+auto
+Hack::Loop_Idioms::load( std::span<word_t const> rom ) -> void
+{
+   loops_.clear();
+   loop_at_.assign( rom.size(), no_loop );
+}
+
+
+/**
+ * @brief   Analyse the loop starting at head
+ *
+ * @return Kind   how the loop runs in bulk, Kind::None if it cannot
+ */
+auto
+Hack::Loop_Idioms::recognise( std::span<word_t const> rom, word_t head ) -> Kind
+{
+   if ( loop_at_.size() != rom.size() )
+   {
+      load( rom );
+   }
+
+   if ( head >= rom.size() )
+   {
+      return Kind::None;
+   }
+
+   if ( auto const* loop = find( rom, head ) )
+   {
+      return loop->kind;
+   }
+
+   auto loop = analyse( rom, head );
+
+   if ( !loop )
+   {
+      return Kind::None;
+   }
+
+   auto const kind = loop->kind;
+
+   if ( loop_at_[head] == no_loop )
+   {
+      loop_at_[head] = static_cast<std::uint32_t>( loops_.size() );
+      loops_.push_back( std::move( *loop ) );
+   }
+   else
+   {
+      loops_[loop_at_[head]] = std::move( *loop );       // analysed from ROM that has since been written
+   }
+
+   return kind;
+}
+
+
+auto
+Hack::Loop_Idioms::kind( std::span<word_t const> rom, word_t head ) const noexcept -> Kind
+{
+   auto const* loop = find( rom, head );
+
+   return loop ? loop->kind : Kind::None;
+}
+
+
+auto
+Hack::Loop_Idioms::length( std::span<word_t const> rom, word_t head ) const noexcept -> std::size_t
+{
+   auto const* loop = find( rom, head );
+
+   return loop ? loop->words.size() : 0;
+}
+
+
+/**
+ * @brief   Run whole iterations of the loop at head in bulk
+ *
+ * @param cpu             receives the A, D and ALU output registers of the last iteration
+ * @param head            the head of a loop whose length() is not 0
+ * @param budget          the maximum number of instructions the iterations may account for
+ * @return std::uint64_t  the number of instructions the iterations account for, a multiple of the
+ *                        loop length, pc is head again after them
+ */
+auto
+Hack::Loop_Idioms::run( CPU& cpu, word_t head, std::uint64_t budget ) -> std::uint64_t
+{
+   auto const& loop       = loops_[loop_at_[head]];
+   auto const  length     = loop.words.size();
+   auto const  iterations = budget / length;
+
+   if ( iterations == 0 )
+   {
+      return 0;
+   }
+
+   auto last = Bases{};
+   auto const done = loop.kind == Kind::General ? run_general( loop, iterations, last ) : run_affine( loop, iterations, last );
+
+   if ( done > 0 )
+   {
+      // the back edge jumps to head and is the last ALU operation
+      cpu.set_A_Register( head );
+      cpu.set_ALU_Output( evaluate( loop.back.value, last ) );
+
+      if ( loop.D )
+      {
+         cpu.set_D_Register( evaluate( *loop.D, last ) );
+      }
+   }
+
+   return done * length;
+}
+
+
+// ----------------------------------------- Implementation ---------------------------------------
+
+
+auto
+Hack::Loop_Idioms::find( std::span<word_t const> rom, word_t head ) const noexcept -> Loop const*
+{
+   if ( head >= loop_at_.size() || loop_at_[head] == no_loop || loop_at_.size() != rom.size() )
+   {
+      return nullptr;
+   }
+
+   auto const& loop = loops_[loop_at_[head]];
+
+   if ( loop.words.size() > rom.size() - head || !std::ranges::equal( loop.words, rom.subspan( head, loop.words.size() ) ) )
+   {
+      return nullptr;
+   }
+
+   return &loop;
+}
+
+
+/**
+ * @brief   Execute one iteration of the loop at head symbolically
+ *
+ * @return std::optional<Loop>   the summary of an iteration, std::nullopt if the instructions from
+ *                               head are not a loop that can run in bulk
+ */
+auto
+Hack::Loop_Idioms::analyse( std::span<word_t const> rom, word_t head ) -> std::optional<Loop>
+{
+   namespace rng = std::ranges;
+
+   auto loop = Loop{ .head = head, .kind = Kind::None, .words = {}, .bases = {}, .stores = {}, .exits = {}, .back = {}, .D = {} };
+
+   // A and D hold the values the loop is entered with until it writes them, which it may not read
+   auto A       = std::optional<Linear>{};
+   auto D       = std::optional<Linear>{};
+   auto targets = std::vector<std::size_t>{};
+
+   // the cell at address, added as a base when first used
+   auto const cell = [&]( word_t address ) -> Base*
+   {
+      auto const found = rng::find_if( loop.bases, [=]( Base const& base ) { return !base.load && base.address == address; } );
+
+      if ( found != loop.bases.end() )
+      {
+         return &*found;
+      }
+
+      if ( address >= Memory::address_space || loop.bases.size() == max_bases )
+      {
+         return nullptr;
+      }
+
+      loop.bases.push_back( Base{ .load    = false,
+                                  .address = address,
+                                  .pointer = {},
+                                  .stores  = 0,
+                                  .update  = basis<Linear>( loop.bases.size() ) } );
+
+      return &loop.bases.back();
+   };
+
+   auto const read = [&]( Linear const& address ) -> std::optional<Linear>
+   {
+      if ( is_constant( address ) )
+      {
+         auto const* base = cell( address.constant );
+
+         return base ? std::optional{ base->update } : std::nullopt;
+      }
+
+      // forwarded from the latest store to the same address, unless a store after it may alias
+      // it, stores through the same pointer at another offset never do
+      auto stores = std::uint32_t{ 0 };
+
+      for ( auto idx = loop.stores.size(); idx-- > 0; )
+      {
+         auto const& store = loop.stores[idx];
+
+         if ( store.address.coefficients != address.coefficients )
+         {
+            stores |= std::uint32_t{ 1 } << idx;
+         }
+         else if ( store.address.constant == address.constant )
+         {
+            return stores == 0 ? std::optional{ store.value } : std::nullopt;
+         }
+      }
+
+      if ( loop.bases.size() == max_bases )
+      {
+         return std::nullopt;
+      }
+
+      loop.bases.push_back( Base{ .load = true, .address = 0, .pointer = address, .stores = stores, .update = {} } );
+
+      return basis<Linear>( loop.bases.size() - 1 );
+   };
+
+   auto const write = [&]( Linear const& address, Linear const& value ) -> bool
+   {
+      if ( is_constant( address ) )
+      {
+         auto* base = cell( address.constant );
+
+         if ( base )
+         {
+            base->update = value;
+         }
+
+         return base != nullptr;
+      }
+
+      if ( loop.stores.size() == max_stores )
+      {
+         return false;
+      }
+
+      loop.stores.push_back( Store{ .address = address, .value = value } );
+
+      return true;
+   };
+
+   for ( auto pc = std::size_t{ head }; pc < rom.size() && pc - head < max_length; ++pc )
+   {
+      auto const instruction = decode( rom[pc] );
+
+      loop.words.push_back( rom[pc] );
+
+      if ( instruction.kind == Op::Kind::A_Instruction )
+      {
+         A = Linear{ .constant = instruction.word, .coefficients = {} };
+         continue;
+      }
+
+      auto const uses_x = ( instruction.comp & Op::comp_zx ) == 0;
+      auto const uses_y = ( instruction.comp & Op::comp_zy ) == 0;
+
+      if ( ( uses_x && !D ) || ( ( uses_y || instruction.reads_M() || instruction.writes_M() ) && !A ) )
+      {
+         return std::nullopt;
+      }
+
+      // M is read whether or not the ALU uses it
+      auto const y   = instruction.reads_M() ? read( *A ) : ( uses_y ? A : Linear{} );
+      auto const out = y ? alu( instruction.comp, uses_x ? *D : Linear{}, *y ) : std::nullopt;
+
+      if ( !out || ( instruction.writes_M() && !write( *A, *out ) ) )
+      {
+         return std::nullopt;
+      }
+
+      if ( instruction.dest & Op::dest_A )
+      {
+         A = out;
+      }
+
+      if ( instruction.dest & Op::dest_D )
+      {
+         D = out;
+      }
+
+      if ( !instruction.is_jump() )
+      {
+         continue;
+      }
+
+      if ( !A || !is_constant( *A ) )
+      {
+         return std::nullopt;
+      }
+
+      if ( A->constant == head )
+      {
+         // every other jump has to leave the loop
+         if ( rng::any_of( targets, [=]( std::size_t target ) { return target > head && target <= pc; } ) )
+         {
+            return std::nullopt;
+         }
+
+         loop.back = Branch{ .value = *out, .jump = instruction.jump };
+         loop.D    = D;
+         loop.kind = classify( loop );
+
+         return loop;
+      }
+
+      // a loop that always leaves in its first iteration is not worth running in bulk
+      if ( instruction.jump == all_jumps )
+      {
+         return std::nullopt;
+      }
+
+      loop.exits.push_back( Branch{ .value = *out, .jump = instruction.jump } );
+      targets.push_back( A->constant );
+   }
+
+   return std::nullopt;
+}
+
+
+/**
+ * @brief   Select the cheapest way of running an analysed loop
+ */
+auto
+Hack::Loop_Idioms::classify( Loop const& loop ) -> Kind
+{
+   namespace rng = std::ranges;
+
+   auto const count = loop.bases.size();
+
+   // the bases that may differ between iterations
+   auto varying = std::array<bool, max_bases>{};
+
+   for ( auto idx = 0uz; idx < count; ++idx )
+   {
+      varying[idx] = loop.bases[idx].load || loop.bases[idx].update != basis<Linear>( idx );
+   }
+
+   auto const invariant = [&]( Linear const& value )
+   {
+      for ( auto idx = 0uz; idx < count; ++idx )
+      {
+         if ( varying[idx] && value.coefficients[idx] != 0 )
+         {
+            return false;
+         }
+      }
+
+      return true;
+   };
+
+   auto const loads_nothing = [&]( Linear const& value )
+   {
+      for ( auto idx = 0uz; idx < count; ++idx )
+      {
+         if ( loop.bases[idx].load && value.coefficients[idx] != 0 )
+         {
+            return false;
+         }
+      }
+
+      return true;
+   };
+
+   auto const referenced = [&]( std::size_t index )
+   {
+      auto const uses = [=]( Linear const& value ) { return value.coefficients[index] != 0; };
+
+      return rng::any_of( loop.bases,  [&]( Base const& base )   { return uses( base.pointer ) || uses( base.update ); } ) ||
+             rng::any_of( loop.stores, [&]( Store const& store ) { return uses( store.address ) || uses( store.value ); } ) ||
+             rng::any_of( loop.exits,  [&]( Branch const& exit ) { return uses( exit.value ); } ) ||
+             uses( loop.back.value ) || ( loop.D && uses( *loop.D ) );
+   };
+
+   // every cell either steps by an invariant amount or is only written, with an invariant value
+   for ( auto idx = 0uz; idx < count; ++idx )
+   {
+      auto const& base = loop.bases[idx];
+
+      if ( base.load || !varying[idx] )
+      {
+         continue;
+      }
+
+      auto step = base.update;
+      step.coefficients[idx] = static_cast<word_t>( step.coefficients[idx] - 1 );
+
+      if ( !invariant( step ) && !( !referenced( idx ) && invariant( base.update ) ) )
+      {
+         return Kind::General;
+      }
+   }
+
+   if ( !rng::all_of( loop.exits, [&]( Branch const& exit ) { return loads_nothing( exit.value ); } ) ||
+        !loads_nothing( loop.back.value ) )
+   {
+      return Kind::General;
+   }
+
+   auto const loads = rng::count_if( loop.bases, []( Base const& base ) { return base.load; } );
+
+   if ( loop.stores.empty() )
+   {
+      return loads == 0 ? Kind::Affine : Kind::General;
+   }
+
+   if ( loop.stores.size() > 1 || loads > 1 || !loads_nothing( loop.stores.front().address ) )
+   {
+      return Kind::General;
+   }
+
+   auto const& store = loop.stores.front();
+
+   if ( loads == 0 )
+   {
+      return invariant( store.value ) ? Kind::Fill : Kind::General;
+   }
+
+   auto const load = static_cast<std::size_t>( rng::find_if( loop.bases, []( Base const& base ) { return base.load; } ) - loop.bases.begin() );
+   auto const& source = loop.bases[load];
+
+   return source.stores == 0 && loads_nothing( source.pointer ) && store.value == basis<Linear>( load ) ? Kind::Copy
+                                                                                                      : Kind::General;
+}
+
+
+/**
+ * @brief   Run iterations of a Fill, Copy or Affine loop with closed forms
+ *
+ * @return std::uint64_t   the number of iterations run, at most iterations
+ *
+ *    Every word the loop computes is a sum of invariants and cells that step by an invariant
+ *    amount, so in iteration k it is its value in the first iteration plus k times its step.
+ */
+auto
+Hack::Loop_Idioms::run_affine( Loop const& loop, std::uint64_t iterations, Bases& last ) -> std::uint64_t
+{
+   auto* const ram   = RAM_.data();
+   auto const  count = loop.bases.size();
+
+   auto values = Bases{};
+   auto steps  = Bases{};
+
+   for ( auto idx = 0uz; idx < count; ++idx )
+   {
+      if ( !loop.bases[idx].load )
+      {
+         values[idx] = ram[loop.bases[idx].address];
+      }
+   }
+
+   for ( auto idx = 0uz; idx < count; ++idx )
+   {
+      if ( !loop.bases[idx].load )
+      {
+         steps[idx] = static_cast<word_t>( evaluate( loop.bases[idx].update, values ) - values[idx] );
+      }
+   }
+
+   auto const step_of = [&]( Linear const& value )
+   {
+      return static_cast<word_t>( evaluate( value, steps ) - value.constant );
+   };
+
+   // pointer accesses from start stepping by step stay in RAM and clear of the cells for at most limit iterations
+   auto limit = iterations;
+
+   auto const clear = [&]( word_t start, word_t step )
+   {
+      auto span = std::uint64_t{ 0 };
+
+      if ( start < Memory::address_space )
+      {
+         span = step == 1 ? Memory::address_space - start : start + 1u;
+      }
+
+      for ( auto const& base : loop.bases )
+      {
+         if ( !base.load )
+         {
+            span = std::min<std::uint64_t>( span, static_cast<word_t>( step == 1 ? base.address - start : start - base.address ) );
+         }
+      }
+
+      limit = std::min( limit, span );
+   };
+
+   auto store  = word_t{ 0 };
+   auto source = word_t{ 0 };
+   auto stride = word_t{ 0 };
+
+   if ( loop.kind != Kind::Affine )
+   {
+      auto const& target = loop.stores.front();
+
+      store  = evaluate( target.address, values );
+      stride = step_of( target.address );
+
+      if ( stride != 1 && stride != word_t{ 0xFFFF } )
+      {
+         return run_general( loop, iterations, last );
+      }
+
+      clear( store, stride );
+   }
+
+   if ( loop.kind == Kind::Copy )
+   {
+      auto const& load = *std::ranges::find_if( loop.bases, []( Base const& base ) { return base.load; } );
+
+      source = evaluate( load.pointer, values );
+
+      if ( step_of( load.pointer ) != stride )
+      {
+         return run_general( loop, iterations, last );
+      }
+
+      clear( source, stride );
+   }
+
+   // the loop continues in iteration k while no exit is taken and the back edge is
+   struct Test
+   {
+      word_t         value;
+      word_t         step;
+      std::uint8_t   jump;
+   };
+
+   auto tests = std::vector<Test>{};
+
+   for ( auto const& exit : loop.exits )
+   {
+      tests.push_back( Test{ evaluate( exit.value, values ), step_of( exit.value ), exit.jump } );
+   }
+
+   auto const back = Test{ evaluate( loop.back.value, values ), step_of( loop.back.value ), loop.back.jump };
+
+   auto const continues = [&]( std::uint64_t k )
+   {
+      auto const at = [=]( Test const& test ) { return static_cast<word_t>( test.value + k * test.step ); };
+
+      return std::ranges::none_of( tests, [&]( Test const& test ) { return taken( test.jump, at( test ) ); } ) &&
+             taken( back.jump, at( back ) );
+   };
+
+   // the tested words repeat every 2^16 iterations at most
+   constexpr auto period = std::uint64_t{ 1 } << 16;
+
+   auto done = std::uint64_t{ 0 };
+
+   while ( done < limit && done < period && continues( done ) )
+   {
+      ++done;
+   }
+
+   if ( done == period )
+   {
+      done = limit;
+   }
+
+   if ( done == 0 )
+   {
+      return 0;
+   }
+
+   auto const first = [&]( word_t start ) { return stride == 1 ? start : static_cast<word_t>( start - ( done - 1 ) ); };
+
+   if ( loop.kind == Kind::Fill )
+   {
+      std::fill_n( ram + first( store ), done, evaluate( loop.stores.front().value, values ) );
+   }
+   else if ( loop.kind == Kind::Copy )
+   {
+      // a copy whose destination runs ahead of its source reads what earlier iterations wrote
+      auto const ahead = stride == 1 ? static_cast<word_t>( store - source ) : static_cast<word_t>( source - store );
+
+      if ( ahead > 0 && ahead < done )
+      {
+         for ( auto k = std::uint64_t{ 0 }; k < done; ++k )
+         {
+            ram[static_cast<word_t>( store + k * stride )] = ram[static_cast<word_t>( source + k * stride )];
+         }
+      }
+      else
+      {
+         std::memmove( ram + first( store ), ram + first( source ), done * sizeof( word_t ) );
+      }
+   }
+
+   last = values;
+
+   for ( auto idx = 0uz; idx < count; ++idx )
+   {
+      auto const& base = loop.bases[idx];
+
+      if ( base.load )
+      {
+         // the word copied by the last iteration
+         last[idx] = ram[static_cast<word_t>( store + ( done - 1 ) * stride )];
+         continue;
+      }
+
+      // a cell that is only written holds the invariant value of every iteration
+      auto const stepping = base.update.coefficients[idx] == 1;
+
+      last[idx]         = stepping ? static_cast<word_t>( values[idx] + ( done - 1 ) * steps[idx] ) : values[idx];
+      ram[base.address] = stepping ? static_cast<word_t>( values[idx] + done * steps[idx] ) : evaluate( base.update, values );
+   }
+
+   return done;
+}
+
+
+/**
+ * @brief   Run iterations of a loop by evaluating its summary once for each
+ *
+ * @return std::uint64_t   the number of iterations run, at most iterations
+ */
+auto
+Hack::Loop_Idioms::run_general( Loop const& loop, std::uint64_t iterations, Bases& last ) -> std::uint64_t
+{
+   auto* const ram   = RAM_.data();
+   auto const  count = loop.bases.size();
+
+   auto values    = Bases{};
+   auto updated   = Bases{};
+   auto addresses = std::array<word_t, max_stores>{};
+   auto words     = std::array<word_t, max_stores>{};
+
+   for ( auto idx = 0uz; idx < count; ++idx )
+   {
+      if ( !loop.bases[idx].load )
+      {
+         values[idx] = ram[loop.bases[idx].address];
+      }
+   }
+
+   // cells are kept in values until the end, so pointer accesses must not reach them
+   auto const accessible = [&]( word_t address )
+   {
+      return address < Memory::address_space &&
+             std::ranges::none_of( loop.bases, [=]( Base const& base ) { return !base.load && base.address == address; } );
+   };
+
+   // runs an iteration unless it leaves the loop or a pointer access is not accessible
+   auto const iterate = [&]
+   {
+      for ( auto idx = 0uz; idx < count; ++idx )
+      {
+         auto const& base = loop.bases[idx];
+
+         if ( !base.load )
+         {
+            continue;
+         }
+
+         auto const address = evaluate( base.pointer, values );
+
+         if ( !accessible( address ) )
+         {
+            return false;
+         }
+
+         for ( auto store = 0uz; store < loop.stores.size(); ++store )
+         {
+            if ( ( base.stores >> store & 1u ) && evaluate( loop.stores[store].address, values ) == address )
+            {
+               return false;
+            }
+         }
+
+         values[idx] = ram[address];
+      }
+
+      for ( auto const& exit : loop.exits )
+      {
+         if ( taken( exit.jump, evaluate( exit.value, values ) ) )
+         {
+            return false;
+         }
+      }
+
+      if ( !taken( loop.back.jump, evaluate( loop.back.value, values ) ) )
+      {
+         return false;
+      }
+
+      for ( auto store = 0uz; store < loop.stores.size(); ++store )
+      {
+         addresses[store] = evaluate( loop.stores[store].address, values );
+         words[store]     = evaluate( loop.stores[store].value, values );
+
+         if ( !accessible( addresses[store] ) )
+         {
+            return false;
+         }
+      }
+
+      for ( auto idx = 0uz; idx < count; ++idx )
+      {
+         updated[idx] = loop.bases[idx].load ? values[idx] : evaluate( loop.bases[idx].update, values );
+      }
+
+      for ( auto store = 0uz; store < loop.stores.size(); ++store )
+      {
+         ram[addresses[store]] = words[store];
+      }
+
+      last   = values;
+      values = updated;
+
+      return true;
+   };
+
+   auto done = std::uint64_t{ 0 };
+
+   while ( done < iterations && iterate() )
+   {
+      ++done;
+   }
+
+   for ( auto const& base : loop.bases )
+   {
+      if ( !base.load )
+      {
+         ram[base.address] = values[static_cast<std::size_t>( &base - loop.bases.data() )];
+      }
+   }
+
+   return done;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file    Loop_Idioms.h
+ * @author  William Weston
+ * @brief   Recognises loops that can be run as bulk operations
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A loop here is a straight run of instructions from a head to a jump back to it, with any
+ *    other jumps in it leaving the loop forwards.  One iteration of it is executed symbolically:
+ *    every value it computes is kept as a sum of multiples of the words it reads at fixed
+ *    addresses (cells) and through pointers (loads), modulo 2^16.  A loop is accepted when all of
+ *    its values are of that form, it reads A and D only after writing them, and every memory
+ *    address, jump target and branch condition is known from the words it reads.
+ *
+ *    Three shapes are run with closed forms:
+ *
+ *       •  Fill         RAM[p] = v, p += 1 or p -= 1          a single std::fill
+ *       •  Copy         RAM[q] = RAM[p], p and q step as one  a single memmove
+ *       •  Affine       counters and accumulators only        x += n * step, so a multiply by
+ *                                                             repeated addition costs a multiply
+ *
+ *    every other accepted loop is run by evaluating its summary once per iteration.
+ *
+ *    Iterations only run in bulk while none of them leaves the loop, all of their memory accesses
+ *    are inside RAM and no pointer access hits a cell.  The caller executes the iteration that
+ *    leaves the loop, or faults, itself.  Since a loop writes A and D before it reads them, the
+ *    registers after the last bulk iteration are evaluated from its summary like RAM is.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_LOOP_IDIOMS_H
+#define HACK_EMULATOR_2026_10_16_LOOP_IDIOMS_H
+
+#include "CPU.h"        // for CPU
+#include "Memory.h"     // for Memory
+
+#include <array>        // for array
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint16_t, uint8_t, uint32_t, uint64_t
+#include <optional>     // for optional
+#include <span>         // for span
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class Loop_Idioms final
+{
+public:
+   using word_t = std::uint16_t;
+
+   enum class Kind : std::uint8_t
+   {
+      None,       // not a loop that can run in bulk
+      Fill,       // stores one value through a pointer that steps by one
+      Copy,       // stores the word loaded through one pointer through another, both step by one
+      Affine,     // no memory access through pointers, every cell steps by a loop invariant amount
+      General     // evaluated once per iteration
+   };
+
+   static constexpr auto max_length = 64uz;      // instructions in a loop
+   static constexpr auto max_bases  = 8uz;       // cells and loads a loop may read
+
+   explicit Loop_Idioms( Memory& memory );
+
+   // forget all analysed loops
+   auto load( std::span<word_t const> rom ) -> void;
+
+   // analyse the loop starting at head unless it has been already, Kind::None if it cannot run in bulk
+   auto recognise( std::span<word_t const> rom, word_t head ) -> Kind;
+
+   // the kind of the loop recognised at head, Kind::None if there is none or its ROM has been written
+   auto kind( std::span<word_t const> rom, word_t head ) const noexcept -> Kind;
+
+   // the number of instructions in the loop recognised at head, 0 if there is none or its ROM has been written
+   auto length( std::span<word_t const> rom, word_t head ) const noexcept -> std::size_t;
+
+   // run whole iterations of the current loop at head within budget, returns the number of instructions they account for
+   auto run( CPU& cpu, word_t head, std::uint64_t budget ) -> std::uint64_t;
+
+private:
+   // constant + sum of coefficients[i] * base i
+   struct Linear
+   {
+      word_t                            constant{};
+      std::array<word_t, max_bases>     coefficients{};
+
+      friend constexpr auto operator==( Linear const&, Linear const& ) -> bool = default;
+   };
+
+   // an ALU output tested by a jump
+   struct Branch
+   {
+      Linear         value;
+      std::uint8_t   jump;
+   };
+
+   // a word the loop reads, the cell at a fixed address or a word loaded through a pointer
+   struct Base
+   {
+      bool           load;
+      word_t         address;       // of the cell
+      Linear         pointer;       // address of the load, in terms of the bases before it
+      std::uint32_t  stores;        // bit i set when pointer must differ from the address of stores[i] at run time
+      Linear         update;        // the value of the cell at the end of an iteration
+   };
+
+   struct Store
+   {
+      Linear         address;
+      Linear         value;
+   };
+
+   struct Loop
+   {
+      word_t                  head;
+      Kind                    kind;
+      std::vector<word_t>     words;      // the ROM words the loop was analysed from
+      std::vector<Base>       bases;      // in the order they are first read, so loads are in program order
+      std::vector<Store>      stores;     // through pointers, in program order
+      std::vector<Branch>     exits;      // leave the loop when taken
+      Branch                  back;       // continues the loop when taken
+      std::optional<Linear>   D;          // at the end of an iteration, std::nullopt if the loop does not write D
+   };
+
+   using Bases = std::array<word_t, max_bases>;
+
+   static constexpr auto max_stores = 32uz;
+   static constexpr auto no_loop    = ~std::uint32_t{ 0 };
+
+   Memory&                    RAM_;
+   std::vector<Loop>          loops_;
+   std::vector<std::uint32_t> loop_at_;      // index into loops_ by address, no_loop if head is not analysed
+
+   auto find( std::span<word_t const> rom, word_t head ) const noexcept -> Loop const*;
+   // both return the number of iterations run and the values of the bases in the last of them
+   auto run_affine( Loop const& loop, std::uint64_t iterations, Bases& last ) -> std::uint64_t;
+   auto run_general( Loop const& loop, std::uint64_t iterations, Bases& last ) -> std::uint64_t;
+
+   static auto analyse( std::span<word_t const> rom, word_t head ) -> std::optional<Loop>;
+   static auto classify( Loop const& loop ) -> Kind;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_LOOP_IDIOMS_H
@@ -0,0 +1,272 @@
+/**
+ * @file    Loop_Idioms.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Loop_Idioms.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Loop_Idioms.h"
+
+#include "Hack/Computer.h"
+#include "Hack/CPU.h"
+#include "Hack/Memory.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+#include <algorithm>          // all_of, equal
+#include <cstdint>
+#include <stdexcept>          // out_of_range
+#include <vector>
+
+
+namespace
+{
+   // RAM[p] = -1 for p from SCREEN up to KBD
+   auto const fill = std::vector<std::uint16_t>
+   {
+      0x4000, 0xEC10, 0x0010, 0xE308,     // @16384  D=A  @16  M=D
+      0x0010, 0xFC20, 0xEE88,             // @16  A=M  M=-1                  (loop)
+      0x0010, 0xFDD8,                     // @16  MD=M+1
+      0x6000, 0xE4D0, 0x0004, 0xE304,     // @24576  D=D-A  @4  D;JLT
+      0x000D, 0xEA87                      // @13  0;JMP
+   };
+
+   // RAM[200..249] = RAM[100..149]
+   auto const copy = std::vector<std::uint16_t>
+   {
+      0x0064, 0xEC10, 0x0010, 0xE308,     // @100  D=A  @16  M=D
+      0x00C8, 0xEC10, 0x0011, 0xE308,     // @200  D=A  @17  M=D
+      0x0032, 0xEC10, 0x0012, 0xE308,     // @50   D=A  @18  M=D
+      0x0010, 0xFC20, 0xFC10,             // @16  A=M  D=M                   (loop)
+      0x0011, 0xFC20, 0xE308,             // @17  A=M  M=D
+      0x0010, 0xFDC8, 0x0011, 0xFDC8,     // @16  M=M+1  @17  M=M+1
+      0x0012, 0xFC98, 0x000C, 0xE301,     // @18  MD=M-1  @12  D;JGT
+      0x001A, 0xEA87                      // @26  0;JMP
+   };
+
+   using Hack::Test_Programs::multiply;
+
+   // RAM[0] = the sum of RAM[100..149]
+   auto const sum = std::vector<std::uint16_t>
+   {
+      0x0064, 0xEC10, 0x0010, 0xE308,     // @100  D=A  @16  M=D
+      0x0000, 0xEA88,                     // @0  M=0
+      0x0010, 0xFC20, 0xFC10,             // @16  A=M  D=M                   (loop)
+      0x0000, 0xF088,                     // @0  M=D+M
+      0x0010, 0xFDD8,                     // @16  MD=M+1
+      0x0096, 0xE4D0, 0x0006, 0xE304,     // @150  D=D-A  @6  D;JLT
+      0x0011, 0xEA87                      // @17  0;JMP
+   };
+
+   auto require_same_state( Hack::Computer const& lhs, Hack::Computer const& rhs ) -> void
+   {
+      REQUIRE( lhs.pc()                == rhs.pc() );
+      REQUIRE( lhs.A_Register()        == rhs.A_Register() );
+      REQUIRE( lhs.D_Register()        == rhs.D_Register() );
+      REQUIRE( lhs.ALU_output()        == rhs.ALU_output() );
+      REQUIRE( lhs.instruction_count() == rhs.instruction_count() );
+      REQUIRE( std::equal( lhs.RAM().ram_begin(), lhs.RAM().ram_end(), rhs.RAM().ram_begin() ) );
+      REQUIRE( std::equal( lhs.screen_begin(), lhs.screen_end(), rhs.screen_begin() ) );
+   }
+}
+
+
+TEST_CASE( "Computer: loop idioms are recognised" )
+{
+   using namespace Hack;
+   using Kind = Loop_Idioms::Kind;
+
+   auto ram    = Memory();
+   auto cpu    = CPU( ram );
+   auto idioms = Loop_Idioms( ram );
+
+   REQUIRE( idioms.recognise( fill, 4 )      == Kind::Fill );
+   REQUIRE( idioms.recognise( copy, 12 )     == Kind::Copy );
+   REQUIRE( idioms.recognise( multiply, 2 )  == Kind::Affine );
+   REQUIRE( idioms.recognise( sum, 6 )       == Kind::General );
+
+   SECTION( "instructions that do not form a loop are refused" )
+   {
+      REQUIRE( idioms.recognise( fill, 0 ) == Kind::None );      // jumps into its middle
+
+      // reads D before writing it
+      auto const counter = std::vector<std::uint16_t>{ 0xE7D0, 0x0000, 0xE305 };      // D=D-1  @0  D;JNE
+
+      REQUIRE( idioms.recognise( counter, 0 ) == Kind::None );
+
+      // the exit jumps back into the loop
+      auto const reentered = std::vector<std::uint16_t>
+      {
+         0x0001, 0xFC10, 0x0004, 0xE302,     // @1  D=M  @4  D;JEQ
+         0x0001, 0xFC88, 0x0000, 0xEA87      // @1  M=M-1  @0  0;JMP
+      };
+
+      REQUIRE( idioms.recognise( reentered, 0 ) == Kind::None );
+   }
+
+   SECTION( "a loop is forgotten when its ROM is written" )
+   {
+      auto rom = fill;
+
+      REQUIRE( idioms.recognise( rom, 4 ) == Kind::Fill );
+      REQUIRE( idioms.length( rom, 4 )    == 9 );
+
+      rom[6] = 0xEA88;     // M=0 instead of M=-1
+
+      REQUIRE( idioms.kind( rom, 4 )   == Kind::None );
+      REQUIRE( idioms.length( rom, 4 ) == 0 );
+      REQUIRE( idioms.recognise( rom, 4 ) == Kind::Fill );
+   }
+
+   SECTION( "bulk iterations update memory and registers within the budget" )
+   {
+      ram[16] = static_cast<std::uint16_t>( Memory::screen_start_address );
+
+      REQUIRE( idioms.recognise( fill, 4 ) == Kind::Fill );
+      REQUIRE( idioms.run( cpu, 4, 9 * 10 + 8 ) == 9 * 10 );
+      REQUIRE( ram[16] == Memory::screen_start_address + 10 );
+      REQUIRE( cpu.A_Register() == 4 );
+      REQUIRE( cpu.D_Register() == static_cast<std::uint16_t>( Memory::screen_start_address + 10 - Memory::keyboard_address ) );
+      REQUIRE( cpu.ALU_Output() == cpu.D_Register() );
+      REQUIRE( std::all_of( ram.screen_begin(), ram.screen_begin() + 10, []( auto word ) { return word == 0xFFFF; } ) );
+      REQUIRE( ram.screen_begin()[10] == 0 );
+
+      // the iteration that leaves the loop is never run in bulk
+      REQUIRE( idioms.run( cpu, 4, 100'000 ) == 9 * ( Memory::keyboard_address - Memory::screen_start_address - 11 ) );
+      REQUIRE( ram[16] == Memory::keyboard_address - 1 );
+      REQUIRE( ram[Memory::keyboard_address - 1] == 0 );
+   }
+}
+
+
+TEST_CASE( "Computer: hot loops run as bulk operations under the tiered engine" )
+{
+   using namespace Hack;
+
+   auto interpreted = Computer();
+   auto tiered      = Computer();
+
+   tiered.set_engine( Computer::Engine::Tiered );
+   tiered.set_tier_thresholds( 4, 16 );
+
+   auto const compare = [&]( std::vector<std::uint16_t> const& rom, std::uint16_t head )
+   {
+      interpreted.load_rom( rom );
+      tiered.load_rom( rom );
+
+      for ( auto cell = 0; cell < 256; ++cell )
+      {
+         interpreted.RAM()[static_cast<std::size_t>( cell )] = static_cast<std::uint16_t>( cell * 977 );
+         tiered.RAM()[static_cast<std::size_t>( cell )]      = static_cast<std::uint16_t>( cell * 977 );
+      }
+
+      for ( auto* computer : { &interpreted, &tiered } )
+      {
+         computer->RAM()[0] = 123;
+         computer->RAM()[1] = 45;
+      }
+
+      for ( auto const budget : { 1u, 3u, 5u, 17u, 64u, 100u, 1'000u, 10'000u, 100'000u } )
+      {
+         interpreted.execute( budget );
+         tiered.execute( budget );
+
+         require_same_state( interpreted, tiered );
+      }
+
+      REQUIRE( tiered.tier( head ) == Computer::Tier::Idiom );
+      REQUIRE( tiered.tier_statistics().instructions[3] > tiered.tier_statistics().instructions[0] );
+   };
+
+   SECTION( "fill" )
+   {
+      compare( fill, 4 );
+
+      REQUIRE( std::all_of( tiered.screen_begin(), tiered.screen_end(), []( auto word ) { return word == 0xFFFF; } ) );
+   }
+
+   SECTION( "fill downwards" )
+   {
+      auto rom = fill;
+
+      rom[0]  = 0x5FFF;       // @24575
+      rom[8]  = 0xFC98;       // MD=M-1
+      rom[9]  = 0x4000;       // @16384
+      rom[12] = 0xE303;       // D;JGE
+
+      compare( rom, 4 );
+
+      REQUIRE( std::all_of( tiered.screen_begin(), tiered.screen_end(), []( auto word ) { return word == 0xFFFF; } ) );
+   }
+
+   SECTION( "copy" )
+   {
+      compare( copy, 12 );
+
+      REQUIRE( std::equal( tiered.RAM().ram_begin() + 100, tiered.RAM().ram_begin() + 150, tiered.RAM().ram_begin() + 200 ) );
+   }
+
+   SECTION( "copy onto itself one word ahead repeats the first word" )
+   {
+      auto rom = copy;
+
+      rom[4] = 0x0065;        // @101
+
+      compare( rom, 12 );
+
+      REQUIRE( std::all_of( tiered.RAM().ram_begin() + 100, tiered.RAM().ram_begin() + 151,
+                            []( auto word ) { return word == static_cast<std::uint16_t>( 100 * 977 ); } ) );
+   }
+
+   SECTION( "multiply" )
+   {
+      compare( multiply, 2 );
+
+      REQUIRE( tiered.RAM()[2] == 123 * 45 );
+   }
+
+   SECTION( "sum" )
+   {
+      compare( sum, 6 );
+   }
+
+   SECTION( "a ROM write sends the loop back to the interpreter" )
+   {
+      interpreted.load_rom( fill );
+      tiered.load_rom( fill );
+
+      interpreted.execute( 1'000 );
+      tiered.execute( 1'000 );
+
+      for ( auto* computer : { &interpreted, &tiered } )
+      {
+         computer->ROM()[6] = 0xEA88;      // M=0 instead of M=-1
+      }
+
+      interpreted.execute( 1'000 );
+      tiered.execute( 1'000 );
+
+      require_same_state( interpreted, tiered );
+      REQUIRE( tiered.tier_statistics().demotions >= 1 );
+   }
+
+   SECTION( "a fill running off the end of RAM throws where the interpreter does" )
+   {
+      auto rom = fill;
+
+      rom[0] = 0x5DC0;        // @24000
+      rom[9] = 0x7530;        // @30000
+
+      interpreted.load_rom( rom );
+      tiered.load_rom( rom );
+
+      REQUIRE_THROWS_AS( interpreted.execute( 100'000 ), std::out_of_range );
+      REQUIRE_THROWS_AS( tiered.execute( 100'000 ), std::out_of_range );
+
+      require_same_state( interpreted, tiered );
+      REQUIRE( tiered.tier( 4 ) == Computer::Tier::Idiom );
+   }
+}
@@ -0,0 +1,394 @@
+/**
+ * @file    Memory.cpp
+ * @author  William Weston
+ * @brief   Memory Module for Hack Computer
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Memory.h"
+
+#include <algorithm>    // for all_of, copy_n
+#include <cstring>      // for memcpy
+#include <new>          // for bad_alloc
+#include <stdexcept>    // for runtime_error
+#include <string>       // for operator+
+#include <utility>      // for exchange, move
+
+#if defined( __linux__ )
+   #define HACK_MEMORY_MAPPED 1
+   #include <fcntl.h>         // for open, O_RDONLY
+   #include <sys/mman.h>      // for memfd_create, mmap, munmap
+   #include <sys/stat.h>      // for fstat
+   #include <unistd.h>        // for close, ftruncate, pread, pwrite, sysconf
+#else
+   #define HACK_MEMORY_MAPPED 0
+   #include <fstream>         // for ifstream
+#endif
+
+
+namespace
+{
+   using value_type = Hack::Memory::value_type;
+
+   constexpr auto buffer_bytes = std::size_t{ Hack::Memory::buffer_size } * sizeof( value_type );
+   constexpr auto page_bytes   = std::size_t{ Hack::Memory::page_size }   * sizeof( value_type );
+
+   static_assert( buffer_bytes % page_bytes == 0 );
+
+   // a zeroed buffer of buffer_size words
+   auto allocate() -> value_type*
+   {
+#if HACK_MEMORY_MAPPED
+      auto* const memory = mmap( nullptr, buffer_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+      if ( memory == MAP_FAILED )
+      {
+         throw std::bad_alloc();
+      }
+
+      return static_cast<value_type*>( memory );
+#else
+      return new value_type[Hack::Memory::buffer_size]{};
+#endif
+   }
+
+   auto release( value_type* words ) noexcept -> void
+   {
+#if HACK_MEMORY_MAPPED
+      munmap( words, buffer_bytes );
+#else
+      delete[] words;
+#endif
+   }
+
+   auto unreadable( std::filesystem::path const& file ) -> std::runtime_error
+   {
+      return std::runtime_error( "Could not read memory from " + file.string() );
+   }
+
+#if HACK_MEMORY_MAPPED
+   // a memory file holding words, -1 if the host cannot make one, pages of zeros are left as holes
+   auto write_file( value_type const* words ) noexcept -> int
+   {
+      auto const file = memfd_create( "hack_ram", MFD_CLOEXEC );
+
+      if ( file < 0 )
+      {
+         return -1;
+      }
+
+      if ( ftruncate( file, static_cast<off_t>( buffer_bytes ) ) != 0 )
+      {
+         close( file );
+         return -1;
+      }
+
+      for ( auto offset = 0uz; offset < buffer_bytes; offset += page_bytes )
+      {
+         auto const* const page = words + offset / sizeof( value_type );
+
+         if ( std::all_of( page, page + Hack::Memory::page_size, []( value_type word ) { return word == 0; } ) )
+         {
+            continue;
+         }
+
+         auto const* bytes   = reinterpret_cast<char const*>( page );
+         auto       written  = 0uz;
+
+         while ( written < page_bytes )
+         {
+            auto const result = pwrite( file, bytes + written, page_bytes - written, static_cast<off_t>( offset + written ) );
+
+            if ( result <= 0 )
+            {
+               close( file );
+               return -1;
+            }
+
+            written += static_cast<std::size_t>( result );
+         }
+      }
+
+      return file;
+   }
+#endif
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Memory::Memory()
+   : words_( allocate() )
+{}
+
+
+/**
+ * @brief   Make a copy of the memory a snapshot was taken of
+ *
+ * @param snapshot   the words and fault to start from
+ * @throws std::bad_alloc if the buffer cannot be mapped
+ *
+ *    A shared snapshot is mapped privately, so no words are copied here: a page is copied by the
+ *    host the first time this memory writes it, and the snapshot may be destroyed at any time.
+ */
+Hack::Memory::Memory( Snapshot const& snapshot )
+   : words_( nullptr ),
+     fault_( snapshot.fault_ )
+{
+#if HACK_MEMORY_MAPPED
+   if ( snapshot.shared() )
+   {
+      auto* const memory = mmap( nullptr, buffer_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, snapshot.file_,
+                                 static_cast<off_t>( snapshot.offset_ ) );
+
+      if ( memory == MAP_FAILED )
+      {
+         throw std::bad_alloc();
+      }
+
+      words_ = static_cast<value_type*>( memory );
+      return;
+   }
+#endif
+
+   words_ = allocate();
+   std::copy_n( snapshot.words_.data(), buffer_size, words_ );
+}
+
+
+Hack::Memory::Memory( Memory const& other )
+   : words_( allocate() ),
+     fault_( other.fault_ ),
+     scratch_( other.scratch_ )
+{
+   std::memcpy( words_, other.words_, buffer_bytes );
+}
+
+
+auto
+Hack::Memory::operator=( Memory const& other ) -> Memory&
+{
+   if ( this != &other )
+   {
+      std::memcpy( words_, other.words_, buffer_bytes );
+      fault_   = other.fault_;
+      scratch_ = other.scratch_;
+   }
+
+   return *this;
+}
+
+
+Hack::Memory::~Memory()
+{
+   release( words_ );
+}
+
+
+/**
+ * @brief   Take a snapshot of the words and fault of this memory
+ *
+ * @return Snapshot   shared() unless the host cannot make a memory file, then a copy of the words
+ *
+ *    Taking a snapshot writes each page that is not all zeros once, however many memories are
+ *    made from it afterwards.
+ */
+auto
+Hack::Memory::snapshot() const -> Snapshot
+{
+   auto snapshot = Snapshot();
+
+   snapshot.fault_ = fault_;
+
+#if HACK_MEMORY_MAPPED
+   snapshot.file_ = write_file( words_ );
+
+   if ( snapshot.shared() )
+   {
+      return snapshot;
+   }
+#endif
+
+   snapshot.words_.assign( words_, words_ + buffer_size );
+
+   return snapshot;
+}
+
+
+/**
+ * @brief   Restore the words and fault of a snapshot
+ *
+ * @param snapshot   taken of any memory, or opened from a file
+ * @throws std::bad_alloc if a shared snapshot cannot be mapped, this memory is unchanged then
+ *
+ *    A shared snapshot is mapped in place of the buffer, as Memory( Snapshot const& ) does, so
+ *    data() and the iterators change.  Otherwise its words are copied.
+ */
+auto
+Hack::Memory::restore( Snapshot const& snapshot ) -> void
+{
+#if HACK_MEMORY_MAPPED
+   if ( snapshot.shared() )
+   {
+      auto* const memory = mmap( nullptr, buffer_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, snapshot.file_,
+                                 static_cast<off_t>( snapshot.offset_ ) );
+
+      if ( memory == MAP_FAILED )
+      {
+         throw std::bad_alloc();
+      }
+
+      release( std::exchange( words_, static_cast<value_type*>( memory ) ) );
+      fault_ = snapshot.fault_;
+      return;
+   }
+#endif
+
+   std::copy_n( snapshot.words_.data(), buffer_size, words_ );
+   fault_ = snapshot.fault_;
+}
+
+
+Hack::Memory::Snapshot::Snapshot( Snapshot&& other ) noexcept
+   : file_( std::exchange( other.file_, -1 ) ),
+     offset_( other.offset_ ),
+     words_( std::move( other.words_ ) ),
+     fault_( other.fault_ )
+{}
+
+
+auto
+Hack::Memory::Snapshot::operator=( Snapshot&& other ) noexcept -> Snapshot&
+{
+   if ( this != &other )
+   {
+#if HACK_MEMORY_MAPPED
+      if ( file_ >= 0 )
+      {
+         close( file_ );
+      }
+#endif
+
+      file_   = std::exchange( other.file_, -1 );
+      offset_ = other.offset_;
+      words_  = std::move( other.words_ );
+      fault_  = other.fault_;
+   }
+
+   return *this;
+}
+
+
+Hack::Memory::Snapshot::~Snapshot()
+{
+#if HACK_MEMORY_MAPPED
+   if ( file_ >= 0 )
+   {
+      close( file_ );
+   }
+#endif
+}
+
+
+/**
+ * @brief   Open the words of a memory stored in a file
+ *
+ * @param file     holds buffer_size words at offset, in the byte order of the host
+ * @param offset   where they start, a multiple of 64K so that any host can map them
+ * @param fault    the fault of the memory they were taken from
+ * @return Snapshot   shared, so the words are mapped rather than read, unless the host cannot map
+ * @throws std::runtime_error if file cannot be opened or is too short
+ */
+auto
+Hack::Memory::Snapshot::open( std::filesystem::path const& file, std::uint64_t offset, std::optional<size_type> fault ) -> Snapshot
+{
+   auto snapshot = Snapshot();
+
+   snapshot.fault_ = fault;
+
+#if HACK_MEMORY_MAPPED
+   snapshot.file_ = ::open( file.c_str(), O_RDONLY | O_CLOEXEC );
+
+   struct stat status {};
+
+   if ( !snapshot.shared() || fstat( snapshot.file_, &status ) != 0 ||
+        static_cast<std::uint64_t>( status.st_size ) < offset + buffer_bytes )
+   {
+      throw unreadable( file );
+   }
+
+   snapshot.offset_ = offset;
+
+   if ( offset % static_cast<std::uint64_t>( sysconf( _SC_PAGESIZE ) ) != 0 )
+   {
+      snapshot.words_.resize( buffer_size );
+      snapshot.read( snapshot.words_ );
+      close( std::exchange( snapshot.file_, -1 ) );
+   }
+#else
+   auto input = std::ifstream( file, std::ios::binary );
+
+   snapshot.words_.resize( buffer_size );
+
+   if ( !input.seekg( static_cast<std::streamoff>( offset ) ) ||
+        !input.read( reinterpret_cast<char*>( snapshot.words_.data() ), static_cast<std::streamsize>( buffer_bytes ) ) )
+   {
+      throw unreadable( file );
+   }
+#endif
+
+   return snapshot;
+}
+
+
+auto
+Hack::Memory::Snapshot::shared() const noexcept -> bool
+{
+   return file_ >= 0;
+}
+
+
+/**
+ * @brief   Copy the words of the snapshot
+ *
+ * @param words   receives buffer_size words
+ * @throws std::runtime_error if the file of a shared snapshot cannot be read
+ */
+auto
+Hack::Memory::Snapshot::read( std::span<value_type> words ) const -> void
+{
+#if HACK_MEMORY_MAPPED
+   if ( shared() )
+   {
+      auto* const bytes = reinterpret_cast<char*>( words.data() );
+      auto        done  = 0uz;
+
+      while ( done < buffer_bytes )
+      {
+         auto const result = pread( file_, bytes + done, buffer_bytes - done, static_cast<off_t>( offset_ + done ) );
+
+         if ( result <= 0 )
+         {
+            throw std::runtime_error( "Could not read memory snapshot" );
+         }
+
+         done += static_cast<std::size_t>( result );
+      }
+
+      return;
+   }
+#endif
+
+   std::copy_n( words_.data(), buffer_size, words.data() );
+}
+
+
+auto
+Hack::Memory::Snapshot::fault() const noexcept -> std::optional<size_type>
+{
+   return fault_;
+}
@@ -13,6 +13,7 @@
 #include <catch2/catch_all.hpp>
 
 #include <stdexcept>          // out_of_range
+#include <utility>            // move
 
 TEST_CASE( "Computer: Memory::operator[]" )
 {
@@ -84,4 +85,164 @@ TEST_CASE( "Computer: Memory::at( size_type )" )
 
       REQUIRE( mem.keyboard() == 1 );
    }
-}
\ No newline at end of file
+}
+TEST_CASE( "Computer: Memory::unchecked( size_type )" )
+{
+   using namespace Hack;
+
+   auto mem = Memory();
+
+   SECTION( "reaches the same words as operator[]" )
+   {
+      mem.unchecked( 5 )                              = 1;
+      mem.unchecked( Memory::screen_start_address + 7 ) = 2;
+      mem.unchecked( Memory::keyboard_address )       = 3;
+
+      REQUIRE( mem[5] == 1 );
+      REQUIRE( mem[Memory::screen_start_address + 7] == 2 );
+      REQUIRE( mem.keyboard() == 3 );
+   }
+
+   SECTION( "addresses are masked to 15 bits" )
+   {
+      mem.unchecked( 0x8000 + 12 ) = 4;
+
+      REQUIRE( mem[12] == 4 );
+   }
+}
+
+TEST_CASE( "Computer: Memory::access<Policy>( size_type )" )
+{
+   using namespace Hack;
+
+   auto mem = Memory();
+
+   mem[12] = 7;
+
+   SECTION( "every policy reaches the address space" )
+   {
+      REQUIRE( mem.access<Bounds::Throwing>( 12 ) == 7 );
+      REQUIRE( mem.access<Bounds::Flagging>( 12 ) == 7 );
+      REQUIRE( mem.access<Bounds::Masked>( 12 )   == 7 );
+      REQUIRE_FALSE( mem.fault().has_value() );
+   }
+
+   SECTION( "outside of the address space" )
+   {
+      REQUIRE_THROWS_AS( mem.access<Bounds::Throwing>( Memory::address_space ), std::out_of_range );
+      REQUIRE( mem.access<Bounds::Masked>( 0x8000 + 12 ) == 7 );
+
+      mem.access<Bounds::Flagging>( Memory::address_space + 1 ) = 9;
+      mem.access<Bounds::Flagging>( Memory::address_space + 2 ) = 9;
+
+      REQUIRE( mem.fault() == Memory::address_space + 1 );
+      REQUIRE( mem.access<Bounds::Flagging>( Memory::address_space + 1 ) == 0 );
+
+      mem.clear_fault();
+      REQUIRE_FALSE( mem.fault().has_value() );
+   }
+}
+
+TEST_CASE( "Computer: Memory layout" )
+{
+   using namespace Hack;
+
+   auto mem = Memory();
+
+   SECTION( "ram, screen and keyboard are contiguous at their addresses" )
+   {
+      REQUIRE( mem.ram_begin()    == mem.data() );
+      REQUIRE( mem.ram_end()      == mem.screen_begin() );
+      REQUIRE( mem.screen_begin() == mem.data() + Memory::screen_start_address );
+      REQUIRE( mem.screen_end()   == &mem.keyboard() );
+   }
+
+   SECTION( "clearing one area leaves the others" )
+   {
+      mem[0]                            = 1;
+      mem[Memory::screen_start_address] = 2;
+      mem[Memory::keyboard_address]     = 3;
+
+      mem.clear_screen();
+
+      REQUIRE( mem[0] == 1 );
+      REQUIRE( mem[Memory::screen_start_address] == 0 );
+      REQUIRE( mem.keyboard() == 3 );
+
+      mem.clear_ram();
+
+      REQUIRE( mem[0] == 0 );
+      REQUIRE( mem.keyboard() == 3 );
+   }
+}
+
+TEST_CASE( "Computer: Memory snapshots" )
+{
+   using namespace Hack;
+
+   auto mem = Memory();
+
+   mem[1]                                = 10;
+   mem[Memory::screen_start_address + 3] = 20;
+   mem.keyboard()                        = 30;
+   mem.access<Bounds::Flagging>( Memory::address_space ) = 1;
+
+   auto snapshot = mem.snapshot();
+
+   mem[1] = 11;
+
+   auto first  = Memory( snapshot );
+   auto second = Memory( snapshot );
+
+   SECTION( "copies start with the words and fault at the snapshot" )
+   {
+      for ( auto const* copy : { &first, &second } )
+      {
+         REQUIRE( ( *copy )[1] == 10 );
+         REQUIRE( ( *copy )[Memory::screen_start_address + 3] == 20 );
+         REQUIRE( copy->keyboard() == 30 );
+         REQUIRE( ( *copy )[Memory::page_size * 5] == 0 );
+         REQUIRE( copy->fault() == Memory::address_space );
+      }
+   }
+
+   SECTION( "writes stay in the memory that makes them" )
+   {
+      first[1]                                = 12;
+      second[Memory::screen_start_address + 3] = 21;
+      first.unchecked( Memory::page_size * 5 ) = 5;
+
+      REQUIRE( mem[1]    == 11 );
+      REQUIRE( first[1]  == 12 );
+      REQUIRE( second[1] == 10 );
+      REQUIRE( first[Memory::screen_start_address + 3]  == 20 );
+      REQUIRE( second[Memory::screen_start_address + 3] == 21 );
+      REQUIRE( second[Memory::page_size * 5] == 0 );
+   }
+
+   SECTION( "copies outlive the snapshot and can be snapshot themselves" )
+   {
+      {
+         auto const moved = std::move( snapshot );
+      }
+
+      first[2] = 7;
+
+      auto const grandchild = Memory( first.snapshot() );
+
+      REQUIRE( grandchild[1] == 10 );
+      REQUIRE( grandchild[2] == 7 );
+   }
+
+   SECTION( "copy construction and assignment copy every word" )
+   {
+      auto copy = mem;
+
+      REQUIRE( copy[1] == 11 );
+
+      copy = first;
+
+      REQUIRE( copy[1] == 10 );
+      REQUIRE( copy.keyboard() == 30 );
+   }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file    Shared_ROM.cpp
+ * @author  William Weston
+ * @brief   A ROM and its decode table, shared read only by the computers that run it
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Shared_ROM.h"
+
+#include <algorithm>    // for copy, transform
+#include <cstddef>      // for ptrdiff_t
+#include <stdexcept>    // for invalid_argument, runtime_error
+#include <string>       // for operator+, to_string
+
+
+namespace
+{
+   // the entries of a ROM of zeros are default constructed rather than decoded
+   static_assert( Hack::decode( 0 ) == Hack::Decoded_Instruction{} );
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+/**
+ * @brief   Build the image of a program
+ *
+ * @param instructions   the program, instruction 0 first
+ * @param decoded        decode( instructions[i] ) for every instruction, or empty to decode them here
+ * @throws std::runtime_error if instructions do not fit in ROM, std::invalid_argument if decoded
+ *         is given without an entry for every instruction
+ */
+Hack::Shared_ROM::Shared_ROM( std::span<word_t const> instructions, std::span<Decoded_Instruction const> decoded )
+{
+   namespace rng = std::ranges;
+
+   if ( instructions.size() > size )
+   {
+      throw std::runtime_error( "ROM overflow: " + std::to_string( instructions.size() ) );
+   }
+
+   if ( !decoded.empty() && decoded.size() != instructions.size() )
+   {
+      throw std::invalid_argument( "Decode table does not match ROM: " + std::to_string( decoded.size() ) );
+   }
+
+   rng::copy( instructions, words_.begin() );
+
+   if ( !decoded.empty() )
+   {
+      rng::copy( decoded, decoded_.begin() );
+      return;
+   }
+
+   rng::transform( instructions, decoded_.begin(), []( word_t instruction ) { return decode( instruction ); } );
+}
+
+
+auto
+Hack::Shared_ROM::empty() -> std::shared_ptr<Shared_ROM> const&
+{
+   static auto const image = std::make_shared<Shared_ROM>();
+
+   return image;
+}
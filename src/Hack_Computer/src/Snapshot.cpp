@@ -0,0 +1,170 @@
+/**
+ * @file    Snapshot.cpp
+ * @author  William Weston
+ * @brief   The state of a Hack Computer, in memory or in a file
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A snapshot file is its Header followed, at ram_offset, by the Memory::buffer_size words of
+ *    RAM as they are in memory.  Loading reads and checks the header and maps the words, so a
+ *    restore copies no more of RAM than the computer goes on to write.
+ */
+#include "Computer.h"
+
+#include <filesystem>       // for remove, rename, file_size
+#include <fstream>          // for ifstream, ofstream
+#include <functional>       // for hash
+#include <optional>         // for optional, nullopt
+#include <stdexcept>        // for runtime_error
+#include <string>           // for operator+, to_string
+#include <system_error>     // for error_code
+#include <thread>           // for this_thread
+#include <type_traits>      // for is_trivially_copyable_v
+#include <utility>          // for move
+#include <vector>           // for vector
+
+#if defined( __linux__ )
+   #include <fcntl.h>          // for open, O_RDONLY
+   #include <unistd.h>         // for close, fsync, getpid
+#endif
+
+
+namespace
+{
+   using Snapshot = Hack::Computer::Snapshot;
+   using Header   = Snapshot::Header;
+
+   static_assert( std::is_trivially_copyable_v<Header> );
+   static_assert( sizeof( Header ) % 8 == 0 && sizeof( Header ) <= Snapshot::ram_offset, "Header has no padding and fits before RAM" );
+
+   // a name next to path that no other writer uses
+   auto temporary_for( std::filesystem::path const& path ) -> std::filesystem::path
+   {
+      auto temporary = path;
+
+#if defined( __linux__ )
+      temporary += ".tmp-" + std::to_string( getpid() ) + "-" + std::to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) );
+#else
+      temporary += ".tmp-" + std::to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) );
+#endif
+
+      return temporary;
+   }
+
+   // flush a closed file to the disk, so that a checkpoint survives a crash of the host
+   auto sync( [[maybe_unused]] std::filesystem::path const& path ) noexcept -> bool
+   {
+#if defined( __linux__ )
+      auto const file = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+
+      if ( file < 0 )
+      {
+         return false;
+      }
+
+      auto const synced = fsync( file ) == 0;
+
+      close( file );
+      return synced;
+#else
+      return true;
+#endif
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Computer::Snapshot::Snapshot( Header const& header, Memory::Snapshot ram ) noexcept
+   : header_( header ),
+     ram_( std::move( ram ) )
+{}
+
+
+/**
+ * @brief   Write the snapshot to a file
+ *
+ * @param path    where to write it
+ * @throws std::runtime_error if it cannot be written, path is left as it was
+ *
+ *    The snapshot is written to a temporary file next to path, flushed to the disk and renamed
+ *    over path, so that a reader or a restart after a crash finds either the previous file or
+ *    all of this one.
+ */
+auto
+Hack::Computer::Snapshot::save( std::filesystem::path const& path ) const -> void
+{
+   auto const temporary = temporary_for( path );
+   auto       words     = std::vector<word_t>( Memory::buffer_size );
+   auto       ignored   = std::error_code();
+
+   ram_.read( words );
+
+   {
+      auto file = std::ofstream( temporary, std::ios::binary | std::ios::trunc );
+
+      file.write( reinterpret_cast<char const*>( &header_ ), sizeof( header_ ) );
+      file.seekp( ram_offset );
+      file.write( reinterpret_cast<char const*>( words.data() ), static_cast<std::streamsize>( words.size() * sizeof( word_t ) ) );
+      file.close();
+
+      if ( !file || !sync( temporary ) )
+      {
+         std::filesystem::remove( temporary, ignored );
+         throw std::runtime_error( "Could not write snapshot " + path.string() );
+      }
+   }
+
+   auto error = std::error_code();
+
+   std::filesystem::rename( temporary, path, error );
+
+   if ( error )
+   {
+      std::filesystem::remove( temporary, ignored );
+      throw std::runtime_error( "Could not write snapshot " + path.string() + ": " + error.message() );
+   }
+}
+
+
+/**
+ * @brief   Load a snapshot file
+ *
+ * @param path        written by save()
+ * @return Snapshot   whose RAM is mapped from path where the host can map it
+ * @throws std::runtime_error if path cannot be read, is truncated or is not a snapshot of this format
+ */
+auto
+Hack::Computer::Snapshot::load( std::filesystem::path const& path ) -> Snapshot
+{
+   auto input  = std::ifstream( path, std::ios::binary );
+   auto header = Header{};
+
+   if ( !input.read( reinterpret_cast<char*>( &header ), sizeof( header ) ) )
+   {
+      throw std::runtime_error( "Could not read snapshot " + path.string() );
+   }
+
+   auto       error = std::error_code();
+   auto const size  = std::filesystem::file_size( path, error );
+
+   if ( header.magic != file_magic || header.format != format_version || header.ram_offset != ram_offset ||
+        header.ram_words != Memory::buffer_size || header.file_size != file_size || error || size != file_size )
+   {
+      throw std::runtime_error( "Not a snapshot of this format: " + path.string() );
+   }
+
+   auto const ram_fault = header.flags & has_ram_fault ? std::optional<Memory::size_type>( header.ram_fault ) : std::nullopt;
+
+   return Snapshot( header, Memory::Snapshot::open( path, header.ram_offset, ram_fault ) );
+}
+
+
+auto
+Hack::Computer::Snapshot::header() const noexcept -> Header const&
+{
+   return header_;
+}
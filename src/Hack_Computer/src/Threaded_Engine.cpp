@@ -0,0 +1,577 @@
+/**
+ * @file    Threaded_Engine.cpp
+ * @author  William Weston
+ * @brief   Threaded-dispatch execution engine for the Hack CPU
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Threaded_Engine.h"
+
+#include "ALU.h"           // for ALU, ALU_in
+#include "Decoder.h"       // for Decoded_Instruction
+
+#include <array>           // for array
+#include <cstddef>         // for size_t
+#include <stdexcept>       // for out_of_range
+#include <string>          // for operator+, to_string
+#include <utility>         // for index_sequence, make_index_sequence
+
+
+namespace
+{
+   using word_t    = Hack::Threaded_Engine::word_t;
+   using Registers = Hack::Threaded_Engine::Registers;
+   using Handler   = Hack::Threaded_Engine::Handler;
+   using Fused     = Hack::Threaded_Engine::Fused_Handler;
+   using Op        = Hack::Decoded_Instruction;
+
+   constexpr auto handler_count = std::size_t{ 1 } << 13;     // a cccccc ddd jjj
+   constexpr auto jump_mask     = word_t{ 0b1000'0000'0000'0111 };
+
+   // the comp codes of the 18 ALU operations, see ALU.h
+   constexpr auto is_documented_comp( std::size_t comp ) -> bool
+   {
+      switch ( comp )
+      {
+         case 0b101010:  case 0b111111:  case 0b111010:  case 0b001100:  case 0b110000:  case 0b001101:
+         case 0b110001:  case 0b001111:  case 0b110011:  case 0b011111:  case 0b110111:  case 0b001110:
+         case 0b110010:  case 0b000010:  case 0b010011:  case 0b000111:  case 0b000000:  case 0b010101:
+            return true;
+         default:
+            return false;
+      }
+   }
+
+   constexpr auto alu( std::uint8_t comp, word_t x, word_t y ) -> Hack::ALU_out
+   {
+      return Hack::ALU( Hack::ALU_in{ x, y,
+                                      ( comp & Op::comp_zx ) != 0, ( comp & Op::comp_nx ) != 0,
+                                      ( comp & Op::comp_zy ) != 0, ( comp & Op::comp_ny ) != 0,
+                                      ( comp & Op::comp_f  ) != 0, ( comp & Op::comp_no ) != 0 } );
+   }
+
+   // the jump bits selected by the sign of the ALU output
+   constexpr auto condition( Hack::ALU_out const& result ) -> std::uint8_t
+   {
+      return result.ng ? Op::jump_lt : ( result.zr ? Op::jump_eq : Op::jump_gt );
+   }
+
+
+   auto a_instruction( Registers& registers, Hack::Memory&, word_t word, word_t pc ) -> word_t
+   {
+      registers.A = word;
+
+      return static_cast<word_t>( pc + 1 );
+   }
+
+   // all fields of the instruction are known at compile time
+   template <std::size_t Index>
+   auto c_instruction( Registers& registers, Hack::Memory& ram, word_t, word_t pc ) -> word_t
+   {
+      constexpr auto from_M = ( Index >> 12 ) & 0b1;
+      constexpr auto comp   = static_cast<std::uint8_t>( ( Index >> 6 ) & 0b11'1111 );
+      constexpr auto dest   = static_cast<std::uint8_t>( ( Index >> 3 ) & 0b111 );
+      constexpr auto jump   = static_cast<std::uint8_t>( Index & 0b111 );
+
+      auto const y      = from_M ? ram[registers.A] : registers.A;
+      auto const result = alu( comp, registers.D, y );
+
+      // M first, an access that throws leaves the registers as they were
+      if constexpr ( dest & Op::dest_M ) { ram[registers.A] = result.out; }
+
+      registers.ALU_output = result.out;
+
+      if constexpr ( dest & Op::dest_A ) { registers.A = result.out; }
+      if constexpr ( dest & Op::dest_D ) { registers.D = result.out; }
+
+      if constexpr ( jump == 0 )
+      {
+         return static_cast<word_t>( pc + 1 );
+      }
+      else if constexpr ( jump == ( Op::jump_lt | Op::jump_eq | Op::jump_gt ) )
+      {
+         return registers.A;
+      }
+      else
+      {
+         return ( jump & condition( result ) ) ? registers.A : static_cast<word_t>( pc + 1 );
+      }
+   }
+
+   // comp codes that the ALU accepts but that name no Hack operation
+   auto c_instruction_generic( Registers& registers, Hack::Memory& ram, word_t word, word_t pc ) -> word_t
+   {
+      auto const instruction = Hack::decode( word );
+
+      auto const y      = instruction.reads_M() ? ram[registers.A] : registers.A;
+      auto const result = alu( instruction.comp, registers.D, y );
+
+      if ( instruction.dest & Op::dest_M ) { ram[registers.A] = result.out; }
+
+      registers.ALU_output = result.out;
+
+      if ( instruction.dest & Op::dest_A ) { registers.A = result.out; }
+      if ( instruction.dest & Op::dest_D ) { registers.D = result.out; }
+
+      return ( instruction.jump & condition( result ) ) ? registers.A : static_cast<word_t>( pc + 1 );
+   }
+
+   // a C-instruction with any jump bit set
+   constexpr auto is_jump( word_t word ) -> bool
+   {
+      return ( word & jump_mask ) > 0b1000'0000'0000'0000;
+   }
+
+   constexpr auto accesses_M( word_t word ) -> bool
+   {
+      return ( word & 0b0001'0000'0000'0000 ) != 0 || ( word & ( Op::dest_M << 3 ) ) != 0;
+   }
+
+
+   // @X followed by Second
+   template <word_t Second>
+   auto fused_pair( Registers& registers, Hack::Memory& ram, word_t word, word_t& pc ) -> std::uint32_t
+   {
+      registers.A = word;
+      pc          = c_instruction<Second & ( handler_count - 1 )>( registers, ram, word, static_cast<word_t>( pc + 1 ) );
+
+      return 2;
+   }
+
+   // @X followed by Second and Third, Third may address M through an A computed by Second
+   template <word_t Second, word_t Third>
+   auto fused_triple( Registers& registers, Hack::Memory& ram, word_t word, word_t& pc ) -> std::uint32_t
+   {
+      static_assert( !is_jump( Second ), "a jump ends the group" );
+
+      registers.A = word;
+      pc          = c_instruction<Second & ( handler_count - 1 )>( registers, ram, word, static_cast<word_t>( pc + 1 ) );
+
+      if constexpr ( accesses_M( Third ) )
+      {
+         if ( registers.A >= Hack::Memory::address_space )
+         {
+            return 2;
+         }
+      }
+
+      pc = c_instruction<Third & ( handler_count - 1 )>( registers, ram, word, pc );
+
+      return 3;
+   }
+
+   // @P 0;JMP at P, executes nothing so that the run stops where the program has ended
+   auto halt( Registers&, Hack::Memory&, word_t, word_t& ) -> std::uint32_t
+   {
+      return 0;
+   }
+
+   // 0;JMP, executes nothing when it would jump to itself
+   auto halt_jump( Registers& registers, Hack::Memory& ram, word_t word, word_t& pc ) -> std::uint32_t
+   {
+      if ( registers.A == pc )
+      {
+         return 0;
+      }
+
+      pc = Hack::Threaded_Engine::handler( word )( registers, ram, word, pc );
+
+      return 1;
+   }
+
+   struct Group
+   {
+      word_t second;
+      word_t third;        // 0 for a pair
+      Fused  handler;
+   };
+
+   // the stack and segment idioms of VM translator output, triples first
+   constexpr auto groups = std::array
+   {
+      Group{ 0xFCA8, 0xFC10, &fused_triple<0xFCA8, 0xFC10> },     // @SP  AM=M-1  D=M        pop into D
+      Group{ 0xFC20, 0xE308, &fused_triple<0xFC20, 0xE308> },     // @SP  A=M     M=D        push D
+      Group{ 0xFCA0, 0xF088, &fused_triple<0xFCA0, 0xF088> },     // @SP  A=M-1   M=D+M      add
+      Group{ 0xFCA0, 0xF1C8, &fused_triple<0xFCA0, 0xF1C8> },     // @SP  A=M-1   M=M-D      sub
+      Group{ 0xFCA0, 0xFC10, &fused_triple<0xFCA0, 0xFC10> },     // @SP  A=M-1   D=M
+      Group{ 0xFDE8, 0xECA0, &fused_triple<0xFDE8, 0xECA0> },     // @SP  AM=M+1  A=A-1
+      Group{ 0xFC10, 0x0000, &fused_pair<0xFC10> },               // @X   D=M
+      Group{ 0xEC10, 0x0000, &fused_pair<0xEC10> },               // @X   D=A
+      Group{ 0xFC20, 0x0000, &fused_pair<0xFC20> },               // @X   A=M
+      Group{ 0xFCA0, 0x0000, &fused_pair<0xFCA0> },               // @X   A=M-1
+      Group{ 0xE308, 0x0000, &fused_pair<0xE308> },               // @X   M=D
+      Group{ 0xFCA8, 0x0000, &fused_pair<0xFCA8> },               // @X   AM=M-1
+      Group{ 0xFDE8, 0x0000, &fused_pair<0xFDE8> },               // @X   AM=M+1
+      Group{ 0xFDC8, 0x0000, &fused_pair<0xFDC8> },               // @X   M=M+1
+      Group{ 0xFC88, 0x0000, &fused_pair<0xFC88> },               // @X   M=M-1
+      Group{ 0xEA88, 0x0000, &fused_pair<0xEA88> },               // @X   M=0
+      Group{ 0xEE88, 0x0000, &fused_pair<0xEE88> },               // @X   M=-1
+      Group{ 0xF090, 0x0000, &fused_pair<0xF090> },               // @X   D=D+M
+      Group{ 0xF4D0, 0x0000, &fused_pair<0xF4D0> },               // @X   D=D-M
+      Group{ 0xF1D0, 0x0000, &fused_pair<0xF1D0> },               // @X   D=M-D
+      Group{ 0xF088, 0x0000, &fused_pair<0xF088> },               // @X   M=D+M
+      Group{ 0xE090, 0x0000, &fused_pair<0xE090> },               // @X   D=D+A
+      Group{ 0xE0A0, 0x0000, &fused_pair<0xE0A0> },               // @X   A=D+A
+      Group{ 0xEA87, 0x0000, &fused_pair<0xEA87> },               // @X   0;JMP
+      Group{ 0xE301, 0x0000, &fused_pair<0xE301> },               // @X   D;JGT
+      Group{ 0xE302, 0x0000, &fused_pair<0xE302> },               // @X   D;JEQ
+      Group{ 0xE303, 0x0000, &fused_pair<0xE303> },               // @X   D;JGE
+      Group{ 0xE304, 0x0000, &fused_pair<0xE304> },               // @X   D;JLT
+      Group{ 0xE305, 0x0000, &fused_pair<0xE305> },               // @X   D;JNE
+      Group{ 0xE306, 0x0000, &fused_pair<0xE306> },               // @X   D;JLE
+      Group{ 0xE307, 0x0000, &fused_pair<0xE307> }                // @X   D;JMP
+   };
+
+   template <std::size_t Index>
+   consteval auto select_handler() -> Handler
+   {
+      if constexpr ( is_documented_comp( ( Index >> 6 ) & 0b11'1111 ) )
+      {
+         return &c_instruction<Index>;
+      }
+      else
+      {
+         return &c_instruction_generic;
+      }
+   }
+
+   template <std::size_t... Index>
+   consteval auto make_handler_table( std::index_sequence<Index...> ) -> std::array<Handler, handler_count>
+   {
+      return { select_handler<Index>()... };
+   }
+
+   constexpr auto handler_table = make_handler_table( std::make_index_sequence<handler_count>{} );
+
+}  // namespace
+
+
+// -------------------------------------------- API -----------------------------------------------
+
+
+Hack::Threaded_Engine::Threaded_Engine( Memory& memory )
+   :  RAM_{ memory },
+      code_{}
+{
+
+}
+
+
+/**
+ * @brief   Translate the ROM into threaded code
+ *
+ * @param rom  the instruction ROM
+ */
+auto
+Hack::Threaded_Engine::load( std::span<word_t const> rom ) -> void
+{
+   code_.resize( rom.size() );
+
+   for ( auto idx = 0uz; idx < rom.size(); ++idx )
+   {
+      code_[idx] = translate( rom, idx );
+   }
+}
+
+
+/**
+ * @brief   Execute the instruction at pc
+ *
+ * @param cpu     supplies and receives the A, D and ALU output registers
+ * @param rom     the instruction ROM
+ * @param pc      address of the instruction to execute
+ * @return word_t address of the next instruction
+ * @throws std::out_of_range for a pc outside of ROM or an M access outside of RAM
+ */
+auto
+Hack::Threaded_Engine::execute( CPU& cpu, std::span<word_t const> rom, word_t pc ) -> word_t
+{
+   auto counter = std::uint64_t{ 0 };
+
+   run( cpu, rom, pc, 1, counter );
+
+   return pc;
+}
+
+
+/**
+ * @brief   Execute count instructions starting at pc
+ *
+ * @param cpu      supplies and receives the A, D and ALU output registers
+ * @param rom      the instruction ROM
+ * @param pc       address of the first instruction, receives the address of the next one
+ * @param count    number of instructions to execute
+ * @param counter  advanced by the number of instructions completed, also when one fails
+ * @throws std::out_of_range for a pc outside of ROM or an M access outside of RAM, cpu and pc then
+ *         hold the state at the failing instruction
+ * 
+ *    The registers are held in a local for the whole run and written back once.  A fused group
+ *    runs when the instructions remaining cover all of it.
+ */
+auto
+Hack::Threaded_Engine::run( CPU& cpu, std::span<word_t const> rom, word_t& pc, std::uint64_t count,
+                            std::uint64_t& counter ) -> void
+{
+   auto registers = Registers{ cpu.A_Register(), cpu.D_Register(), cpu.ALU_Output() };
+   auto remaining = count;
+
+   auto const store = [&]
+   {
+      cpu.set_A_Register( registers.A );
+      cpu.set_D_Register( registers.D );
+      cpu.set_ALU_Output( registers.ALU_output );
+      cpu.set_PC( pc );
+      counter += count - remaining;
+   };
+
+   try
+   {
+      while ( remaining > 0 )
+      {
+         auto const& instruction = op( rom, pc );
+
+         if ( instruction.fused && remaining >= instruction.length )
+         {
+            auto const done = instruction.fused( registers, RAM_, instruction.word, pc );
+
+            if ( done == 0 )
+            {
+               break;
+            }
+            remaining -= done;
+         }
+         else
+         {
+            pc = instruction.handler( registers, RAM_, instruction.word, pc );
+            --remaining;
+         }
+      }
+   }
+   catch ( ... )
+   {
+      store();
+      throw;
+   }
+
+   store();
+}
+
+
+/**
+ * @brief   Execute the block starting at pc, up to and including its first jump instruction
+ *
+ * @param cpu              supplies and receives the A, D and ALU output registers
+ * @param rom              the instruction ROM
+ * @param pc               address of the first instruction, receives the address of the next one
+ * @param budget           the maximum number of instructions to execute
+ * @param counter          advanced by the number of instructions completed, also when one fails
+ * @throws std::out_of_range for a pc outside of ROM or an M access outside of RAM, cpu and pc then
+ *         hold the state at the failing instruction
+ */
+auto
+Hack::Threaded_Engine::run_block( CPU& cpu, std::span<word_t const> rom, word_t& pc, std::uint64_t budget,
+                                  std::uint64_t& counter ) -> void
+{
+   auto registers = Registers{ cpu.A_Register(), cpu.D_Register(), cpu.ALU_Output() };
+   auto executed  = std::uint64_t{ 0 };
+
+   auto const store = [&]
+   {
+      cpu.set_A_Register( registers.A );
+      cpu.set_D_Register( registers.D );
+      cpu.set_ALU_Output( registers.ALU_output );
+      cpu.set_PC( pc );
+      counter += executed;
+   };
+
+   try
+   {
+      while ( executed < budget )
+      {
+         auto const& instruction = op( rom, pc );
+
+         if ( instruction.fused && budget - executed >= instruction.length )
+         {
+            auto const done = instruction.fused( registers, RAM_, instruction.word, pc );
+            auto const last = instruction.words == 1 ? instruction.word : instruction.group[instruction.words - 2uz];
+
+            executed += done;
+
+            if ( done == 0 || ( done == instruction.length && is_jump( last ) ) )
+            {
+               break;
+            }
+            continue;
+         }
+
+         pc = instruction.handler( registers, RAM_, instruction.word, pc );
+         ++executed;
+
+         if ( is_jump( instruction.word ) )
+         {
+            break;
+         }
+      }
+   }
+   catch ( ... )
+   {
+      store();
+      throw;
+   }
+
+   store();
+}
+
+
+/**
+ * @brief   Select the handler that executes an instruction
+ *
+ * @param instruction   the instruction
+ * @return Handler      handler specialised for the instruction's fields
+ */
+auto
+Hack::Threaded_Engine::handler( word_t instruction ) noexcept -> Handler
+{
+   if ( !( instruction & 0b1000'0000'0000'0000 ) )
+   {
+      return &a_instruction;
+   }
+
+   return handler_table[instruction & ( handler_count - 1 )];
+}
+
+
+/**
+ * @brief   The length of the fused group starting at address
+ *
+ * @param address       a ROM address
+ * @return std::size_t  the number of instructions in the group, 0 if none starts at address
+ */
+auto
+Hack::Threaded_Engine::fused( word_t address ) const noexcept -> std::size_t
+{
+   if ( address >= code_.size() || code_[address].words < 2 || halts( address ) )
+   {
+      return 0;
+   }
+
+   return code_[address].length;
+}
+
+
+// does a halt loop start at address, @P 0;JMP at P, or a 0;JMP that is one when A holds its address
+auto
+Hack::Threaded_Engine::halts( word_t address ) const noexcept -> bool
+{
+   return address < code_.size() && ( code_[address].fused == &halt || code_[address].fused == &halt_jump );
+}
+
+
+// ----------------------------------------- Implementation ---------------------------------------
+
+
+auto
+Hack::Threaded_Engine::op( std::span<word_t const> rom, word_t pc ) -> Op const&
+{
+   if ( pc >= rom.size() )
+   {
+      throw std::out_of_range( "ROM: Instruction fetch out of bounds: " + std::to_string( pc ) );
+   }
+
+   if ( code_.size() != rom.size() )
+   {
+      load( rom );
+   }
+
+   auto& entry = code_[pc];
+
+   // ROM has been written since translation
+   if ( !current( rom, pc, entry ) )
+   {
+      entry = translate( rom, pc );
+   }
+
+   return entry;
+}
+
+
+// the handler for the word at pc, and the fused group starting there if there is one
+auto
+Hack::Threaded_Engine::translate( std::span<word_t const> rom, std::size_t pc ) noexcept -> Op
+{
+   auto const word  = rom[pc];
+   auto       entry = Op{ handler( word ), word, nullptr, 1, 1, {} };
+
+   if ( decode( word ).is_halt_jump() )
+   {
+      entry.fused = &halt_jump;
+      return entry;
+   }
+
+   if ( ( word & 0b1000'0000'0000'0000 ) || pc + 1 >= rom.size() )
+   {
+      return entry;
+   }
+
+   auto const second = rom[pc + 1];
+   auto const third  = pc + 2 < rom.size() ? rom[pc + 2] : word_t{ 0 };
+
+   if ( decode( second ).is_halt_jump() )
+   {
+      if ( word == pc )
+      {
+         entry.fused = &halt;
+         entry.words = 2;
+         entry.group = { second, 0 };
+         return entry;
+      }
+
+      // @P+1 0;JMP enters a halt loop at P+1, which must not run inside the group
+      if ( word == pc + 1 )
+      {
+         return entry;
+      }
+   }
+
+   // the second instruction addresses M at word, which must be in RAM for the group not to throw
+   if ( accesses_M( second ) && word >= Memory::address_space )
+   {
+      return entry;
+   }
+
+   for ( auto const& group : groups )
+   {
+      if ( group.second == second && ( group.third == 0 || group.third == third ) )
+      {
+         entry.fused  = group.handler;
+         entry.length = group.third == 0 ? 2 : 3;
+         entry.words  = entry.length;
+         entry.group  = { second, group.third };
+         break;
+      }
+   }
+
+   return entry;
+}
+
+
+// has the ROM at pc been written since entry was translated
+auto
+Hack::Threaded_Engine::current( std::span<word_t const> rom, std::size_t pc, Op const& entry ) noexcept -> bool
+{
+   if ( entry.word != rom[pc] )
+   {
+      return false;
+   }
+
+   if ( !entry.fused )
+   {
+      return true;
+   }
+
+   return ( entry.words < 2 || rom[pc + 1] == entry.group[0] ) &&
+          ( entry.words < 3 || rom[pc + 2] == entry.group[1] );
+}
@@ -0,0 +1,105 @@
+/**
+ * @file    Threaded_Engine.h
+ * @author  William Weston
+ * @brief   Threaded-dispatch execution engine for the Hack CPU
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Every ROM word is translated into a handler specialised at compile time for its operand, comp,
+ *    dest and jump fields.  Executing an instruction is then a single indirect call through the
+ *    handler stored for the current pc, with no decoding and no field tests left at run time.
+ *
+ *    The handler table is indexed by the low 13 bits of a C-instruction: a cccccc ddd jjj.
+ *    Comp codes outside of the 18 documented ALU operations fall back to a generic handler.
+ *
+ *    An A-instruction followed by one of the C-instructions, or pairs of them, that VM translator
+ *    output is made of (@SP AM=M-1 D=M, @R13 M=D, @LOOP D;JNE ...) is also given a fused handler
+ *    that executes the whole group in one dispatch.  A group only runs fused when the budget covers
+ *    all of it, so single stepping sees every instruction boundary, and an instruction in it that
+ *    would access M outside of RAM is left to its own handler.
+ *
+ *    The halt loop every program ends in, @P 0;JMP at P or a 0;JMP with A holding its own address,
+ *    is given a handler that executes nothing, so a run stops where it is entered.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_THREADED_ENGINE_H
+#define HACK_EMULATOR_2026_10_16_THREADED_ENGINE_H
+
+#include "CPU.h"        // for CPU
+#include "Memory.h"     // for Memory
+
+#include <array>        // for array
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint16_t, uint8_t, uint32_t, uint64_t
+#include <span>         // for span
+#include <vector>       // for vector
+
+namespace Hack
+{
+
+class Threaded_Engine final
+{
+public:
+   using word_t = std::uint16_t;
+
+   struct Registers
+   {
+      word_t A;
+      word_t D;
+      word_t ALU_output;
+   };
+
+   // executes one instruction, returns the address of the next one
+   using Handler = auto (*)( Registers& registers, Memory& ram, word_t word, word_t pc ) -> word_t;
+
+   // executes the group starting at pc and advances pc past it, returns the number of instructions executed
+   using Fused_Handler = auto (*)( Registers& registers, Memory& ram, word_t word, word_t& pc ) -> std::uint32_t;
+
+   static constexpr auto max_group_length = 3uz;
+
+   struct Op
+   {
+      Handler                                   handler;
+      word_t                                    word;       // the ROM word this handler was selected for
+      Fused_Handler                             fused;      // nullptr unless a group or a halt loop starts here
+      std::uint8_t                              length;     // instructions in the group, 1 for a halt loop
+      std::uint8_t                              words;      // ROM words the group was selected from
+      std::array<word_t, max_group_length - 1>  group;      // the ROM words after word the group was selected for
+   };
+
+   explicit Threaded_Engine( Memory& memory );
+
+   // translate the whole ROM
+   auto load( std::span<word_t const> rom ) -> void;
+
+   // execute the instruction at pc, returns the address of the next instruction
+   auto execute( CPU& cpu, std::span<word_t const> rom, word_t pc ) -> word_t;
+
+   // execute count instructions starting at pc, or up to a halt loop, counter advances for every instruction completed
+   auto run( CPU& cpu, std::span<word_t const> rom, word_t& pc, std::uint64_t count, std::uint64_t& counter ) -> void;
+
+   // execute up to and including the next jump instruction, at most budget instructions, stops at a halt loop
+   auto run_block( CPU& cpu, std::span<word_t const> rom, word_t& pc, std::uint64_t budget, std::uint64_t& counter ) -> void;
+
+   static auto handler( word_t instruction ) noexcept -> Handler;
+
+   // the number of instructions in the fused group starting at address, 0 if there is none
+   auto fused( word_t address ) const noexcept -> std::size_t;
+
+   // is address the start of a halt loop, or a 0;JMP that is one when A holds its address
+   auto halts( word_t address ) const noexcept -> bool;
+
+private:
+   Memory&         RAM_;
+   std::vector<Op> code_;
+
+   auto op( std::span<word_t const> rom, word_t pc ) -> Op const&;
+
+   static auto translate( std::span<word_t const> rom, std::size_t pc ) noexcept -> Op;
+   static auto current( std::span<word_t const> rom, std::size_t pc, Op const& entry ) noexcept -> bool;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_THREADED_ENGINE_H
@@ -0,0 +1,238 @@
+/**
+ * @file    Threaded_Engine.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Threaded_Engine.h
+ * @version 0.1
+ * @date    2026-10-16
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include "Threaded_Engine.h"
+
+#include "Hack/Computer.h"
+#include "Hack/CPU.h"
+#include "Hack/Memory.h"
+#include "Hack/Test_Programs.h"
+
+#include <catch2/catch_all.hpp>
+#include <algorithm>          // equal
+#include <cstdint>
+#include <stdexcept>          // out_of_range
+#include <vector>
+
+
+TEST_CASE( "Computer: Threaded engine executes every instruction identically to the CPU" )
+{
+   using namespace Hack;
+
+   auto const values = { std::uint16_t{ 0 }, std::uint16_t{ 1 }, std::uint16_t{ 0x7FFF }, std::uint16_t{ 0xFFFF } };
+
+   for ( auto const a_value : { std::uint16_t{ 3 }, std::uint16_t{ 16'384 } } )
+   {
+      for ( auto const d_value : values )
+      {
+         for ( auto word = 0u; word <= 0xFFFF; word += 3 )
+         {
+            auto const instruction = static_cast<std::uint16_t>( word );
+            auto const rom         = std::vector<std::uint16_t>{ 0, 0, 0, 0, instruction };
+
+            auto ram_cpu      = Memory();
+            auto ram_threaded = Memory();
+            auto cpu          = CPU( ram_cpu );
+            auto threaded_cpu = CPU( ram_threaded );
+            auto engine       = Threaded_Engine( ram_threaded );
+
+            engine.load( rom );
+
+            cpu.set_A_Register( a_value );    threaded_cpu.set_A_Register( a_value );
+            cpu.set_D_Register( d_value );    threaded_cpu.set_D_Register( d_value );
+            cpu.M_Register() = d_value;       threaded_cpu.M_Register() = d_value;
+            cpu.set_PC( 4 );
+
+            auto const expected = cpu.execute_instruction( instruction );
+            auto const next     = engine.execute( threaded_cpu, rom, 4 );
+
+            REQUIRE( next == expected );
+            REQUIRE( threaded_cpu.A_Register() == cpu.A_Register() );
+            REQUIRE( threaded_cpu.D_Register() == cpu.D_Register() );
+            REQUIRE( threaded_cpu.ALU_Output() == cpu.ALU_Output() );
+            REQUIRE( ram_threaded[a_value]     == ram_cpu[a_value] );
+         }
+      }
+   }
+}
+
+
+TEST_CASE( "Computer: Threaded engine selected through Computer" )
+{
+   using namespace Hack;
+
+   auto interpreted = Computer();
+   auto threaded    = Computer();
+
+   interpreted.load_rom( Test_Programs::multiply_looping );
+   threaded.load_rom( Test_Programs::multiply_looping );
+   threaded.set_engine( Computer::Engine::Threaded );
+
+   REQUIRE( threaded.engine() == Computer::Engine::Threaded );
+
+   for ( auto* computer : { &interpreted, &threaded } )
+   {
+      computer->RAM()[0] = 7;
+      computer->RAM()[1] = 6;
+   }
+
+   for ( auto count = 0; count < 200; ++count )
+   {
+      interpreted.execute();
+      threaded.execute();
+
+      REQUIRE( threaded.pc()         == interpreted.pc() );
+      REQUIRE( threaded.A_Register() == interpreted.A_Register() );
+      REQUIRE( threaded.D_Register() == interpreted.D_Register() );
+      REQUIRE( threaded.ALU_output() == interpreted.ALU_output() );
+   }
+
+   REQUIRE( threaded.RAM()[2] == 42 );
+
+   SECTION( "engines can be switched mid program" )
+   {
+      threaded.set_engine( Computer::Engine::Interpreter );
+      threaded.pc() = 0;
+      threaded.execute();
+      threaded.execute();
+
+      REQUIRE( threaded.RAM()[2] == 0 );
+      REQUIRE( threaded.pc()     == 2 );
+   }
+
+   SECTION( "writes through ROM() are seen by the next execute" )
+   {
+      threaded.ROM()[0] = 0x0005;      // @5
+      threaded.pc()     = 0;
+      threaded.execute();
+
+      REQUIRE( threaded.A_Register() == 5 );
+   }
+
+   SECTION( "out of range ROM access throws" )
+   {
+      threaded.pc() = Computer::ROM_SIZE;
+
+      REQUIRE_THROWS_AS( threaded.execute(), std::out_of_range );
+   }
+}
+
+
+TEST_CASE( "Computer: Threaded engine fuses VM translator idioms" )
+{
+   using namespace Hack;
+
+   // RAM[17] = RAM[16] + ... + 1, as translated from the VM language
+   auto const sum = std::vector<std::uint16_t>
+   {
+      0x0100, 0xEC10, 0x0000, 0xE308,                             //  0  @256 D=A @SP M=D
+      0x0011, 0xFC10, 0x0000, 0xFC20, 0xE308, 0x0000, 0xFDC8,     //  4  push static 17      (LOOP)
+      0x0010, 0xFC10, 0x0000, 0xFC20, 0xE308, 0x0000, 0xFDC8,     // 11  push static 16
+      0x0000, 0xFCA8, 0xFC10, 0xECA0, 0xF088,                     // 18  add
+      0x0000, 0xFCA8, 0xFC10, 0x0011, 0xE308,                     // 23  pop static 17
+      0x0010, 0xFC10, 0x0000, 0xFC20, 0xE308, 0x0000, 0xFDC8,     // 28  push static 16
+      0x0001, 0xEC10, 0x0000, 0xFC20, 0xE308, 0x0000, 0xFDC8,     // 35  push constant 1
+      0x0000, 0xFCA8, 0xFC10, 0xECA0, 0xF1C8,                     // 42  sub
+      0x0000, 0xFCA8, 0xFC10, 0x0010, 0xE308,                     // 47  pop static 16
+      0x0010, 0xFC10, 0x0000, 0xFC20, 0xE308, 0x0000, 0xFDC8,     // 52  push static 16
+      0x0000, 0xFCA8, 0xFC10, 0x0004, 0xE305,                     // 59  if-goto LOOP
+      0x0040, 0xEA87                                              // 64  (END) @END 0;JMP
+   };
+
+   auto ram    = Memory();
+   auto engine = Threaded_Engine( ram );
+
+   engine.load( sum );
+
+   REQUIRE( engine.fused( 0 )  == 2 );      // @256 D=A
+   REQUIRE( engine.fused( 1 )  == 0 );
+   REQUIRE( engine.fused( 6 )  == 3 );      // @SP A=M M=D
+   REQUIRE( engine.fused( 18 ) == 3 );      // @SP AM=M-1 D=M
+   REQUIRE( engine.fused( 62 ) == 2 );      // @LOOP D;JNE
+   REQUIRE( engine.fused( 64 ) == 0 );      // @END 0;JMP
+   REQUIRE( engine.halts( 64 ) );
+   REQUIRE_FALSE( engine.halts( 62 ) );
+
+   auto interpreted = Computer();
+   auto threaded    = Computer();
+
+   interpreted.load_rom( sum );
+   threaded.load_rom( sum );
+   threaded.set_engine( Computer::Engine::Threaded );
+
+   for ( auto* computer : { &interpreted, &threaded } )
+   {
+      computer->RAM()[16] = 100;
+   }
+
+   auto const require_same_state = [&]
+   {
+      REQUIRE( threaded.pc()                == interpreted.pc() );
+      REQUIRE( threaded.A_Register()        == interpreted.A_Register() );
+      REQUIRE( threaded.D_Register()        == interpreted.D_Register() );
+      REQUIRE( threaded.ALU_output()        == interpreted.ALU_output() );
+      REQUIRE( threaded.instruction_count() == interpreted.instruction_count() );
+      REQUIRE( std::equal( threaded.RAM().ram_begin(), threaded.RAM().ram_end(), interpreted.RAM().ram_begin() ) );
+   };
+
+   SECTION( "every budget stops on the same instruction boundary" )
+   {
+      for ( auto const budget : { 1u, 2u, 3u, 4u, 5u, 7u, 11u, 13u, 100u } )
+      {
+         for ( auto count = 0; count < 20; ++count )
+         {
+            interpreted.execute( budget );
+            threaded.execute( budget );
+
+            require_same_state();
+         }
+      }
+
+      interpreted.execute( 100'000 );
+      threaded.execute( 100'000 );
+
+      require_same_state();
+      REQUIRE( threaded.RAM()[17] == 5'050 );
+      REQUIRE( threaded.pc()      == 64 );
+   }
+
+   SECTION( "a ROM write inside a group is not run from the stale group" )
+   {
+      threaded.execute( 1'000 );
+      interpreted.execute( 1'000 );
+
+      for ( auto* computer : { &interpreted, &threaded } )
+      {
+         computer->ROM()[22] = 0xF1C8;      // M=M-D  instead of M=D+M
+      }
+
+      threaded.execute( 1'000 );
+      interpreted.execute( 1'000 );
+
+      require_same_state();
+   }
+
+   SECTION( "an out of range M access in a group throws at that instruction" )
+   {
+      // @SP AM=M-1 D=M with SP past the end of RAM
+      auto const rom = std::vector<std::uint16_t>{ 0x0000, 0xFCA8, 0xFC10 };
+
+      for ( auto* computer : { &interpreted, &threaded } )
+      {
+         computer->load_rom( rom );
+         computer->RAM()[0] = 0x7FFF;
+
+         REQUIRE_THROWS_AS( computer->execute( 3 ), std::out_of_range );
+      }
+
+      require_same_state();
+      REQUIRE( threaded.pc() == 2 );
+   }
+}
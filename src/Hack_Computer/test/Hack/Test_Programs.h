@@ -0,0 +1,62 @@
+/**
+ * @file    Test_Programs.h
+ * @author  William Weston
+ * @brief   Hand assembled Hack programs shared by the test suites
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef HACK_EMULATOR_2026_10_16_TEST_PROGRAMS_H
+#define HACK_EMULATOR_2026_10_16_TEST_PROGRAMS_H
+
+#include <cstdint>      // for uint16_t
+#include <vector>       // for vector
+
+namespace Hack::Test_Programs
+{
+
+// RAM[2] = RAM[0] * RAM[1] by repeated addition, the loop runs RAM[0] times and then halts
+inline auto const multiply = std::vector<std::uint16_t>
+{
+   0x0002, 0xEA88,                     // @2  M=0
+   0x0000, 0xFC10, 0x000E, 0xE302,     // @0  D=M  @14  D;JEQ             (loop)
+   0x0001, 0xFC10, 0x0002, 0xF088,     // @1  D=M  @2   M=D+M
+   0x0000, 0xFC88,                     // @0  M=M-1
+   0x0002, 0xEA87,                     // @2  0;JMP
+   0x000E, 0xEA87                      // @14 0;JMP                       (end)
+};
+
+// RAM[2] = RAM[0] * RAM[1] by repeated addition, the loop runs RAM[1] times and never halts, once
+// RAM[1] is 0 it keeps testing it
+inline auto const multiply_looping = std::vector<std::uint16_t>
+{
+   0x0002, 0xEA88,                     // @2  M=0
+   0x0001, 0xFC10, 0x000C, 0xE302,     // @1  D=M  @12  D;JEQ             (loop)
+   0x0000, 0xFC10, 0x0002, 0xF088,     // @0  D=M  @2   M=D+M
+   0x0001, 0xFC88,                     // @1  M=M-1
+   0x0002, 0xEA87                      // @2  0;JMP
+};
+
+// RAM[0] counts forever
+inline auto const counting = std::vector<std::uint16_t>
+{
+   0x0000, 0xFDC8,                     // @0  M=M+1                       (loop)
+   0x0000, 0xEA87                      // @0  0;JMP
+};
+
+// RAM[0] = each key pressed, RAM[1] counts them, waits for each key to be released and halts on Q
+inline auto const typing = std::vector<std::uint16_t>
+{
+   0x6000, 0xFC10, 0x0000, 0xE302,     // @KBD D=M  @0   D;JEQ            (wait)
+   0x0000, 0xE308, 0x0001, 0xFDC8,     // @0   M=D  @1   M=M+1
+   0x0051, 0xE4D0, 0x0012, 0xE302,     // @81  D=D-A  @18  D;JEQ
+   0x6000, 0xFC10, 0x000C, 0xE305,     // @KBD D=M  @12  D;JNE            (release)
+   0x0000, 0xEA87,                     // @0   0;JMP
+   0x0012, 0xEA87                      // @18  0;JMP                      (end)
+};
+
+}  // namespace Hack::Test_Programs
+
+#endif      // HACK_EMULATOR_2026_10_16_TEST_PROGRAMS_H
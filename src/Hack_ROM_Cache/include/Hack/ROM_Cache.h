@@ -0,0 +1,94 @@
+/**
+ * @file    ROM_Cache.h
+ * @author  William Weston
+ * @brief   Content addressed on-disk cache of assembled and analysed ROMs
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Programs are cached by the contents of their source, .asm or .hack text, together with the
+ *    version of the tools that built them, so that a restarted process maps the ROM_Image of a
+ *    program it has seen before instead of assembling and analysing it again.  Each entry is a
+ *    file named after the 64-bit key of its source in the cache directory.  A second hash of the
+ *    source is kept in the image and checked when it is mapped; the hashes are not cryptographic,
+ *    so the cache is not meant for directories that untrusted users can write to.
+ *
+ *    Several processes may share a directory.  Entries are written to a temporary file and
+ *    renamed into place, and an entry that cannot be written only costs the next process a miss.
+ *
+ *    Entries are never evicted: the directory grows by one file for every distinct source, and a
+ *    new build of the tools leaves the entries of the previous one behind.  An entry holds little
+ *    more than the ROM and its decode table, so a directory stays small for the programs it is meant
+ *    for.  Deleting any entry, or the whole directory, is always safe and only costs a miss.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_ROM_CACHE_H
+#define HACK_EMULATOR_2026_10_16_ROM_CACHE_H
+
+#include "ROM_Image.h"        // for ROM_Image
+
+#include <cstdint>            // for uint16_t, uint64_t, uint8_t
+#include <filesystem>         // for path
+#include <optional>           // for optional
+#include <string_view>        // for string_view
+#include <vector>             // for vector
+
+namespace Hack
+{
+
+class ROM_Cache final
+{
+public:
+   using word_t = std::uint16_t;
+
+   enum class Format : std::uint8_t
+   {
+      Assembly,      // .asm
+      Binary         // .hack, one instruction per line
+   };
+
+   struct Statistics
+   {
+      std::uint64_t hits   = 0;
+      std::uint64_t misses = 0;
+      std::uint64_t stores = 0;      // misses that were written to the directory
+   };
+
+   // the directory is created when it does not exist
+   explicit ROM_Cache( std::filesystem::path directory );
+
+   // the image of the .asm or .hack file at path, built and stored unless it is cached
+   auto open( std::filesystem::path const& file ) -> ROM_Image;
+
+   // the image of source text, built and stored unless it is cached
+   auto load( std::string_view source, Format format ) -> ROM_Image;
+
+   // the file the image of source is cached in
+   auto entry( std::string_view source, Format format ) const -> std::filesystem::path;
+   auto entry( std::uint64_t source_key )               const -> std::filesystem::path;
+
+   auto directory()  const noexcept -> std::filesystem::path const&;
+   auto statistics() const noexcept -> Statistics const&;
+
+   // the key of source, covers the tool version and ROM_Image::format_version
+   static auto key( std::string_view source, Format format ) -> std::uint64_t;
+
+   // assemble or parse source into ROM words, Hack::Utils::parse_error if it has errors
+   static auto build( std::string_view source, Format format ) -> std::vector<word_t>;
+
+   // $XDG_CACHE_HOME/hack_emulator/roms or $HOME/.cache/hack_emulator/roms, std::nullopt if neither is set
+   static auto default_directory() -> std::optional<std::filesystem::path>;
+
+   // the format of a file by its extension, std::invalid_argument unless it is .asm or .hack
+   static auto format_of( std::filesystem::path const& file ) -> Format;
+
+private:
+   std::filesystem::path directory_;
+   Statistics            statistics_;
+
+   static auto check( std::string_view source, Format format ) -> std::uint64_t;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_ROM_CACHE_H
@@ -0,0 +1,98 @@
+/**
+ * @file    ROM_Image.h
+ * @author  William Weston
+ * @brief   A ROM and the data derived from it, in a form that can be mapped from a file
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    An image is a single block of bytes that can be written to a file and mapped back without
+ *    parsing:
+ *
+ *       Header                     magic, format version, cache key and the size and offset of
+ *                                  every section, see ROM_Image::Header
+ *       ROM                        uint16_t per instruction
+ *       Decoded instructions       Decoded_Instruction per instruction, for Computer::load_rom()
+ *       Block starts               a bit per instruction, set on instruction 0, every static jump
+ *                                  target and every instruction after a jump
+ *       Jump targets               a bit per instruction, set where an A-instruction right before
+ *                                  a jump points
+ *
+ *    Sections start on 8 byte boundaries.  Images are in host byte order and layout, so they are
+ *    only valid on the kind of host that wrote them; the cache key covers the tool version.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_ROM_IMAGE_H
+#define HACK_EMULATOR_2026_10_16_ROM_IMAGE_H
+
+#include "Hack/Decoder.h"     // for Decoded_Instruction
+
+#include <cstddef>            // for byte, size_t
+#include <cstdint>            // for uint16_t, uint32_t, uint64_t
+#include <filesystem>         // for path
+#include <optional>           // for optional
+#include <span>               // for span
+#include <vector>             // for vector
+
+namespace Hack
+{
+
+class ROM_Image final
+{
+public:
+   using word_t = std::uint16_t;
+
+   static constexpr std::uint32_t format_version = 1;
+
+   struct Header
+   {
+      std::uint64_t  magic;
+      std::uint32_t  format;
+      std::uint32_t  rom_size;            // instructions
+      std::uint64_t  key;                 // of the source the image was built from, see ROM_Cache
+      std::uint64_t  check;               // a second hash of the source, guards against key collisions
+      std::uint64_t  file_size;
+      std::uint64_t  decoded_offset;
+      std::uint64_t  block_starts_offset;
+      std::uint64_t  jump_targets_offset;
+   };
+
+   // analyse rom into an image held in memory
+   ROM_Image( std::span<word_t const> rom, std::uint64_t key, std::uint64_t check );
+   ~ROM_Image() noexcept;
+
+   ROM_Image( ROM_Image&& other ) noexcept;
+   auto operator=( ROM_Image&& other ) noexcept -> ROM_Image&;
+
+   ROM_Image( ROM_Image const& )                    = delete;
+   auto operator=( ROM_Image const& ) -> ROM_Image& = delete;
+
+   // map the image file at path read only, std::nullopt unless it is a valid image with key and check
+   static auto map( std::filesystem::path const& path, std::uint64_t key, std::uint64_t check ) -> std::optional<ROM_Image>;
+
+   // write the image to path, replacing any file there in a single step, false on failure
+   auto save( std::filesystem::path const& path ) const -> bool;
+
+   auto rom()                                const noexcept -> std::span<word_t const>;
+   auto decoded()                            const noexcept -> std::span<Decoded_Instruction const>;
+   auto is_block_start( std::size_t address ) const noexcept -> bool;
+   auto is_jump_target( std::size_t address ) const noexcept -> bool;
+
+   auto header()                             const noexcept -> Header const&;
+   auto bytes()                              const noexcept -> std::span<std::byte const>;
+   auto mapped()                             const noexcept -> bool;      // backed by a file rather than memory
+
+private:
+   std::vector<std::byte>  owned_;        // the image when it is held in memory
+   void*                   mapping_;      // the image when it is mapped from a file
+   std::size_t             size_;
+
+   ROM_Image( void* mapping, std::size_t size ) noexcept;
+
+   auto data()                               const noexcept -> std::byte const*;
+   auto bit( std::uint64_t offset, std::size_t address ) const noexcept -> bool;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_ROM_IMAGE_H
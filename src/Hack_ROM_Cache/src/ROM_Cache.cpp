@@ -0,0 +1,285 @@
+/**
+ * @file    ROM_Cache.cpp
+ * @author  William Weston
+ * @brief   Content addressed on-disk cache of assembled and analysed ROMs
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "ROM_Cache.h"
+
+#include "Hack/Assembler.h"                 // for Assembler
+#include "Hack/buildinfo.h"                 // for BuildInfo
+#include "Hack/Utilities/exceptions.hpp"    // for file_error, parse_error, FileErrorData, ParseErrorData
+#include "Hack/Utilities/utilities.hpp"     // for binary_to_uint16
+
+#include <cstdlib>                          // for getenv
+#include <fstream>                          // for ifstream
+#include <iomanip>                          // for setw, setfill
+#include <ios>                              // for hex
+#include <sstream>                          // for istringstream, ostringstream
+#include <stdexcept>                        // for invalid_argument, runtime_error
+#include <string>                           // for string, getline
+#include <system_error>                     // for error_code
+#include <utility>                          // for move
+
+
+namespace
+{
+   using Format = Hack::ROM_Cache::Format;
+
+   // FNV-1a, continued from hash
+   constexpr auto fnv1a( std::uint64_t hash, std::string_view text ) noexcept -> std::uint64_t
+   {
+      for ( auto const c : text )
+      {
+         hash ^= static_cast<unsigned char>( c );
+         hash *= 0x0000'0100'0000'01B3u;
+      }
+
+      return hash;
+   }
+
+   // a multiply and fold hash, independent of FNV-1a
+   constexpr auto fold( std::uint64_t hash, std::string_view text ) noexcept -> std::uint64_t
+   {
+      for ( auto const c : text )
+      {
+         hash  = ( hash ^ static_cast<unsigned char>( c ) ) * 0x9E37'79B9'7F4A'7C15u;
+         hash ^= hash >> 29;
+      }
+
+      return hash;
+   }
+
+   // everything an image depends on besides its source
+   auto tool_version( Format format ) -> std::string
+   {
+      return std::string( Hack::BuildInfo::project_version ) + '/' + std::string( Hack::BuildInfo::commit_sha ) + '/' +
+             std::to_string( Hack::ROM_Image::format_version ) + '/' + ( format == Format::Assembly ? "asm" : "hack" ) + '\n';
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::ROM_Cache::ROM_Cache( std::filesystem::path directory )
+   : directory_( std::move( directory ) ),
+     statistics_()
+{
+   auto error = std::error_code();
+
+   std::filesystem::create_directories( directory_, error );
+
+   if ( error )
+   {
+      throw std::runtime_error( "Could not create ROM cache directory " + directory_.string() + ": " + error.message() );
+   }
+}
+
+
+/**
+ * @brief   The image of a program file
+ *
+ * @param file          a .asm or .hack file
+ * @return ROM_Image    mapped from the cache when it holds the contents of file
+ * @throws Hack::Utils::file_error if file cannot be read, std::invalid_argument for other extensions,
+ *         Hack::Utils::parse_error if it does not assemble or parse
+ */
+auto
+Hack::ROM_Cache::open( std::filesystem::path const& file ) -> ROM_Image
+{
+   auto const format = format_of( file );
+   auto       input  = std::ifstream( file, std::ios::binary );
+
+   if ( !( input && input.is_open() ) )
+   {
+      throw Hack::Utils::file_error( "Could not open file", Hack::Utils::FileErrorData{ file.string() } );
+   }
+
+   auto source = std::ostringstream();
+
+   source << input.rdbuf();
+
+   return load( source.view(), format );
+}
+
+
+/**
+ * @brief   The image of program source text
+ *
+ * @param source        the contents of a .asm or .hack file
+ * @param format        which of the two it is
+ * @return ROM_Image    mapped from the cache on a hit, otherwise built, stored and returned
+ * @throws Hack::Utils::parse_error if source does not assemble or parse
+ */
+auto
+Hack::ROM_Cache::load( std::string_view source, Format format ) -> ROM_Image
+{
+   auto const source_key   = key( source, format );
+   auto const source_check = check( source, format );
+   auto const path         = entry( source_key );
+
+   if ( auto image = ROM_Image::map( path, source_key, source_check ) )
+   {
+      ++statistics_.hits;
+      return std::move( *image );
+   }
+
+   ++statistics_.misses;
+
+   auto image = ROM_Image( build( source, format ), source_key, source_check );
+
+   if ( image.save( path ) )
+   {
+      ++statistics_.stores;
+
+      if ( auto stored = ROM_Image::map( path, source_key, source_check ) )
+      {
+         return std::move( *stored );
+      }
+   }
+
+   return image;
+}
+
+
+auto
+Hack::ROM_Cache::entry( std::string_view source, Format format ) const -> std::filesystem::path
+{
+   return entry( key( source, format ) );
+}
+
+
+auto
+Hack::ROM_Cache::entry( std::uint64_t source_key ) const -> std::filesystem::path
+{
+   auto name = std::ostringstream();
+
+   name << std::hex << std::setw( 16 ) << std::setfill( '0' ) << source_key << ".hackrom";
+
+   return directory_ / name.str();
+}
+
+
+auto
+Hack::ROM_Cache::directory() const noexcept -> std::filesystem::path const&
+{
+   return directory_;
+}
+
+
+auto
+Hack::ROM_Cache::statistics() const noexcept -> Statistics const&
+{
+   return statistics_;
+}
+
+
+auto
+Hack::ROM_Cache::key( std::string_view source, Format format ) -> std::uint64_t
+{
+   return fnv1a( fnv1a( 0xCBF2'9CE4'8422'2325u, tool_version( format ) ), source );
+}
+
+
+auto
+Hack::ROM_Cache::check( std::string_view source, Format format ) -> std::uint64_t
+{
+   return fold( fold( source.size(), tool_version( format ) ), source );
+}
+
+
+/**
+ * @brief   Assemble or parse a program
+ *
+ * @param source    the contents of a .asm or .hack file
+ * @param format    which of the two it is
+ * @return std::vector<word_t>   the ROM words
+ * @throws Hack::Utils::parse_error if source does not assemble or parse
+ */
+auto
+Hack::ROM_Cache::build( std::string_view source, Format format ) -> std::vector<word_t>
+{
+   auto input = std::istringstream( std::string( source ) );
+   auto data  = std::vector<word_t>();
+
+   if ( format == Format::Assembly )
+   {
+      auto asmblr = Hack::Assembler();
+
+      for ( auto const& line : asmblr.assemble( input ) )
+      {
+         auto const binary_optional = Hack::Utils::binary_to_uint16( line );
+
+         // the assembler always produces binary strings
+         if ( !binary_optional )
+         {
+            throw std::runtime_error( "Assembler produced an invalid instruction: " + line );
+         }
+
+         data.push_back( *binary_optional );
+      }
+
+      return data;
+   }
+
+   auto line    = std::string();
+   auto line_no = 1zu;
+
+   while ( std::getline( input, line ) )
+   {
+      auto const binary_optional = Hack::Utils::binary_to_uint16( line );
+
+      if ( !binary_optional )
+      {
+         throw Hack::Utils::parse_error( "Error parsing Hack binary file", Hack::Utils::ParseErrorData{ line, line_no } );
+      }
+
+      data.push_back( *binary_optional );
+      ++line_no;
+   }
+
+   return data;
+}
+
+
+auto
+Hack::ROM_Cache::default_directory() -> std::optional<std::filesystem::path>
+{
+   auto const* const cache_home = std::getenv( "XDG_CACHE_HOME" );
+
+   if ( cache_home != nullptr && *cache_home != '\0' )
+   {
+      return std::filesystem::path( cache_home ) / "hack_emulator" / "roms";
+   }
+
+   auto const* const home = std::getenv( "HOME" );
+
+   if ( home != nullptr && *home != '\0' )
+   {
+      return std::filesystem::path( home ) / ".cache" / "hack_emulator" / "roms";
+   }
+
+   return std::nullopt;
+}
+
+
+auto
+Hack::ROM_Cache::format_of( std::filesystem::path const& file ) -> Format
+{
+   if ( file.extension() == ".asm" )
+   {
+      return Format::Assembly;
+   }
+
+   if ( file.extension() == ".hack" )
+   {
+      return Format::Binary;
+   }
+
+   throw std::invalid_argument( "Not a Hack program: " + file.string() );
+}
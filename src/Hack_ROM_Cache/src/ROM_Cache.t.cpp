@@ -0,0 +1,219 @@
+/**
+ * @file    ROM_Cache.t.cpp
+ * @author  William Weston
+ * @brief   Test file for ROM_Cache.h and ROM_Image.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/ROM_Cache.h"
+#include "Hack/ROM_Image.h"
+
+#include "Hack/Computer.h"
+#include "Hack/Decoder.h"
+#include "Hack/Test_Programs.h"
+#include "Hack/Utilities/exceptions.hpp"
+
+#include <catch2/catch_all.hpp>
+#include <algorithm>          // equal
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>             // random_device
+#include <stdexcept>          // invalid_argument
+#include <string>
+#include <vector>
+
+
+namespace
+{
+   // a scratch cache directory, removed when the test ends
+   struct Scratch_Directory
+   {
+      std::filesystem::path path = std::filesystem::temp_directory_path() / ( "hack_rom_cache_" + std::to_string( std::random_device()() ) );
+
+      Scratch_Directory()                                            = default;
+      Scratch_Directory( Scratch_Directory const& )                  = delete;
+      auto operator=( Scratch_Directory const& ) -> Scratch_Directory& = delete;
+
+      ~Scratch_Directory() { std::filesystem::remove_all( path ); }
+   };
+
+   // R2 = R0 * R1
+   auto const multiply = std::string(
+      "   @R2\n"
+      "   M=0\n"
+      "(LOOP)\n"
+      "   @R0\n"
+      "   D=M\n"
+      "   @END\n"
+      "   D;JEQ\n"
+      "   @R1\n"
+      "   D=M\n"
+      "   @R2\n"
+      "   M=D+M\n"
+      "   @R0\n"
+      "   M=M-1\n"
+      "   @LOOP\n"
+      "   0;JMP\n"
+      "(END)\n"
+      "   @END\n"
+      "   0;JMP\n" );
+}
+
+
+TEST_CASE( "ROM_Cache: images" )
+{
+   using namespace Hack;
+
+   auto const rom = Test_Programs::multiply;
+
+   auto const image = ROM_Image( rom, 1, 2 );
+
+   REQUIRE( !image.mapped() );
+   REQUIRE( std::ranges::equal( image.rom(), rom ) );
+   REQUIRE( image.decoded().size() == rom.size() );
+
+   for ( auto address = 0uz; address < rom.size(); ++address )
+   {
+      REQUIRE( image.decoded()[address] == decode( rom[address] ) );
+   }
+
+   SECTION( "blocks start at 0, at static jump targets and after jumps" )
+   {
+      for ( auto address = 0uz; address < rom.size() + 4; ++address )
+      {
+         auto const start = address == 0 || address == 2 || address == 6 || address == 14;
+
+         REQUIRE( image.is_block_start( address ) == start );
+         REQUIRE( image.is_jump_target( address ) == ( address == 2 || address == 14 ) );
+      }
+   }
+
+   SECTION( "saved images map back unless their key, check or contents differ" )
+   {
+      auto const scratch = Scratch_Directory();
+      auto const path    = scratch.path / "image.hackrom";
+
+      std::filesystem::create_directories( scratch.path );
+
+      REQUIRE( image.save( path ) );
+
+      auto mapped = ROM_Image::map( path, 1, 2 );
+
+      REQUIRE( mapped );
+      REQUIRE( mapped->mapped() );
+      REQUIRE( std::ranges::equal( mapped->bytes(), image.bytes() ) );
+      REQUIRE( mapped->is_jump_target( 14 ) );
+
+      REQUIRE( !ROM_Image::map( path, 3, 2 ) );
+      REQUIRE( !ROM_Image::map( path, 1, 3 ) );
+      REQUIRE( !ROM_Image::map( scratch.path / "missing.hackrom", 1, 2 ) );
+
+      std::filesystem::resize_file( path, image.bytes().size() - 8 );
+
+      REQUIRE( !ROM_Image::map( path, 1, 2 ) );
+
+      // moving keeps the mapping alive
+      auto moved = std::move( *mapped );
+
+      REQUIRE( moved.rom()[4] == 0x000E );
+   }
+
+   SECTION( "a computer loaded with the decode table runs as one that decoded the ROM itself" )
+   {
+      auto decoded = Computer();
+      auto loaded  = Computer();
+
+      decoded.load_rom( rom );
+      loaded.load_rom( image.rom(), image.decoded() );
+
+      for ( auto* computer : { &decoded, &loaded } )
+      {
+         computer->RAM()[0] = 6;
+         computer->RAM()[1] = 7;
+         computer->execute( 1'000 );
+      }
+
+      REQUIRE( loaded.RAM()[2] == 42 );
+      REQUIRE( loaded.pc() == decoded.pc() );
+      REQUIRE( loaded.instruction_count() == decoded.instruction_count() );
+
+      REQUIRE_THROWS_AS( loaded.load_rom( image.rom(), image.decoded().first( 3 ) ), std::invalid_argument );
+   }
+}
+
+
+TEST_CASE( "ROM_Cache: cache" )
+{
+   using namespace Hack;
+   using Format = ROM_Cache::Format;
+
+   auto const scratch = Scratch_Directory();
+   auto       cache   = ROM_Cache( scratch.path / "roms" );
+
+   SECTION( "the first load assembles and stores, later loads map the stored image" )
+   {
+      auto const first = cache.load( multiply, Format::Assembly );
+
+      REQUIRE( cache.statistics().misses == 1 );
+      REQUIRE( cache.statistics().stores == 1 );
+      REQUIRE( std::filesystem::exists( cache.entry( multiply, Format::Assembly ) ) );
+      REQUIRE( cache.entry( multiply, Format::Assembly ) == cache.entry( ROM_Cache::key( multiply, Format::Assembly ) ) );
+
+      // a new process sees the entry too
+      auto       restarted = ROM_Cache( scratch.path / "roms" );
+      auto const second    = restarted.load( multiply, Format::Assembly );
+
+      REQUIRE( restarted.statistics().hits   == 1 );
+      REQUIRE( restarted.statistics().misses == 0 );
+      REQUIRE( second.mapped() );
+      REQUIRE( std::ranges::equal( first.rom(), second.rom() ) );
+      REQUIRE( std::ranges::equal( second.rom(), ROM_Cache::build( multiply, Format::Assembly ) ) );
+   }
+
+   SECTION( "sources differing in one character or in format have their own entries" )
+   {
+      auto const changed = multiply + "\n";
+      auto const binary  = std::string( "0000000000000010\n1110101010001000\n" );
+
+      REQUIRE( ROM_Cache::key( multiply, Format::Assembly ) != ROM_Cache::key( changed, Format::Assembly ) );
+      REQUIRE( ROM_Cache::key( binary, Format::Assembly )   != ROM_Cache::key( binary, Format::Binary ) );
+
+      REQUIRE( cache.load( binary, Format::Binary ).rom().size() == 2 );
+      REQUIRE( cache.load( binary, Format::Binary ).rom()[1]     == 0xEA88 );
+      REQUIRE( cache.statistics().hits   == 1 );
+      REQUIRE( cache.statistics().misses == 1 );
+   }
+
+   SECTION( "a damaged entry is rebuilt" )
+   {
+      auto const path = cache.entry( multiply, Format::Assembly );
+
+      static_cast<void>( cache.load( multiply, Format::Assembly ) );
+
+      std::ofstream( path, std::ios::binary | std::ios::trunc ) << "not an image";
+
+      auto const image = cache.load( multiply, Format::Assembly );
+
+      REQUIRE( cache.statistics().misses == 2 );
+      REQUIRE( image.rom().size() == 16 );
+   }
+
+   SECTION( "files are read by extension and errors are reported as the loaders do" )
+   {
+      auto const file = scratch.path / "Multiply.asm";
+
+      std::ofstream( file ) << multiply;
+
+      REQUIRE( cache.open( file ).rom().size() == 16 );
+      REQUIRE( cache.statistics().misses == 1 );
+
+      REQUIRE_THROWS_AS( cache.open( scratch.path / "Multiply.txt" ), std::invalid_argument );
+      REQUIRE_THROWS_AS( cache.open( scratch.path / "Missing.asm" ), Utils::file_error );
+      REQUIRE_THROWS_AS( cache.load( "0101\n", Format::Binary ), Utils::parse_error );
+      REQUIRE( cache.statistics().stores == 1 );
+   }
+}
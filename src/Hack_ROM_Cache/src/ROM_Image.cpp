@@ -0,0 +1,356 @@
+/**
+ * @file    ROM_Image.cpp
+ * @author  William Weston
+ * @brief   A ROM and the data derived from it, in a form that can be mapped from a file
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "ROM_Image.h"
+
+#include <fcntl.h>            // for open, O_RDONLY
+#include <sys/mman.h>         // for mmap, munmap
+#include <sys/stat.h>         // for fstat
+#include <unistd.h>           // for close, getpid
+
+#include <cstring>            // for memcpy
+#include <fstream>            // for ofstream
+#include <functional>         // for hash
+#include <string>             // for string, to_string
+#include <system_error>       // for error_code
+#include <thread>             // for this_thread
+#include <type_traits>        // for is_trivially_copyable_v
+#include <utility>            // for exchange, move
+
+
+namespace
+{
+   using word_t = Hack::ROM_Image::word_t;
+   using Header = Hack::ROM_Image::Header;
+   using Op     = Hack::Decoded_Instruction;
+
+   static_assert( std::is_trivially_copyable_v<Header> );
+   static_assert( std::is_trivially_copyable_v<Op> );
+
+   // "HACKROM" in the first bytes of the file on a little endian host
+   constexpr auto magic = std::uint64_t{ 0x004D'4F52'4B43'4148 };
+
+   constexpr auto align( std::uint64_t offset ) noexcept -> std::uint64_t
+   {
+      return ( offset + 7u ) & ~std::uint64_t{ 7 };
+   }
+
+   constexpr auto bitmap_words( std::size_t bits ) noexcept -> std::uint64_t
+   {
+      return ( bits + 63u ) / 64u;
+   }
+
+   // the header of an image of rom_size instructions
+   constexpr auto layout( std::size_t rom_size, std::uint64_t key, std::uint64_t check ) noexcept -> Header
+   {
+      auto const rom_offset          = align( sizeof( Header ) );
+      auto const decoded_offset      = align( rom_offset + rom_size * sizeof( word_t ) );
+      auto const block_starts_offset = align( decoded_offset + rom_size * sizeof( Op ) );
+      auto const jump_targets_offset = block_starts_offset + bitmap_words( rom_size ) * sizeof( std::uint64_t );
+      auto const file_size           = jump_targets_offset + bitmap_words( rom_size ) * sizeof( std::uint64_t );
+
+      return {
+         .magic               = magic,
+         .format              = Hack::ROM_Image::format_version,
+         .rom_size            = static_cast<std::uint32_t>( rom_size ),
+         .key                 = key,
+         .check               = check,
+         .file_size           = file_size,
+         .decoded_offset      = decoded_offset,
+         .block_starts_offset = block_starts_offset,
+         .jump_targets_offset = jump_targets_offset
+      };
+   }
+
+   auto set_bit( std::byte* bitmap, std::size_t address ) noexcept -> void
+   {
+      auto word = std::uint64_t{ 0 };
+
+      std::memcpy( &word, bitmap + address / 64u * sizeof( word ), sizeof( word ) );
+      word |= std::uint64_t{ 1 } << ( address % 64u );
+      std::memcpy( bitmap + address / 64u * sizeof( word ), &word, sizeof( word ) );
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+/**
+ * @brief   Build the image of a ROM in memory
+ *
+ * @param rom     the program, instruction 0 first
+ * @param key     the cache key of the source rom was built from
+ * @param check   a second hash of that source
+ */
+Hack::ROM_Image::ROM_Image( std::span<word_t const> rom, std::uint64_t key, std::uint64_t check )
+   : owned_(),
+     mapping_( nullptr ),
+     size_( 0 )
+{
+   auto const header = layout( rom.size(), key, check );
+
+   owned_.resize( header.file_size );
+   size_ = owned_.size();
+
+   auto* const image = owned_.data();
+
+   std::memcpy( image, &header, sizeof( header ) );
+
+   if ( rom.empty() )
+   {
+      return;
+   }
+
+   std::memcpy( image + align( sizeof( Header ) ), rom.data(), rom.size_bytes() );
+
+   auto* const decoded      = image + header.decoded_offset;
+   auto* const block_starts = image + header.block_starts_offset;
+   auto* const jump_targets = image + header.jump_targets_offset;
+
+   set_bit( block_starts, 0 );
+
+   for ( auto address = 0uz; address < rom.size(); ++address )
+   {
+      auto const instruction = decode( rom[address] );
+
+      std::memcpy( decoded + address * sizeof( Op ), &instruction, sizeof( Op ) );
+
+      if ( !instruction.is_jump() )
+      {
+         continue;
+      }
+
+      if ( address + 1 < rom.size() )
+      {
+         set_bit( block_starts, address + 1 );
+      }
+
+      // @target right before the jump, and the jump does not write A first
+      auto const previous = address > 0 ? decode( rom[address - 1] ) : Op();
+
+      if ( address > 0 && previous.is_a_instruction() && !( instruction.dest & Op::dest_A ) && previous.word < rom.size() )
+      {
+         set_bit( block_starts, previous.word );
+         set_bit( jump_targets, previous.word );
+      }
+   }
+}
+
+
+Hack::ROM_Image::ROM_Image( void* mapping, std::size_t size ) noexcept
+   : owned_(),
+     mapping_( mapping ),
+     size_( size )
+{}
+
+
+Hack::ROM_Image::~ROM_Image() noexcept
+{
+   if ( mapping_ != nullptr )
+   {
+      munmap( mapping_, size_ );
+   }
+}
+
+
+Hack::ROM_Image::ROM_Image( ROM_Image&& other ) noexcept
+   : owned_( std::move( other.owned_ ) ),
+     mapping_( std::exchange( other.mapping_, nullptr ) ),
+     size_( std::exchange( other.size_, 0 ) )
+{}
+
+
+auto
+Hack::ROM_Image::operator=( ROM_Image&& other ) noexcept -> ROM_Image&
+{
+   if ( this != &other )
+   {
+      if ( mapping_ != nullptr )
+      {
+         munmap( mapping_, size_ );
+      }
+
+      owned_   = std::move( other.owned_ );
+      mapping_ = std::exchange( other.mapping_, nullptr );
+      size_    = std::exchange( other.size_, 0 );
+   }
+
+   return *this;
+}
+
+
+/**
+ * @brief   Map an image file read only
+ *
+ * @param path    the image file
+ * @param key     the key the image must have been built with
+ * @param check   the second hash the image must have been built with
+ * @return std::optional<ROM_Image>   std::nullopt if the file is missing, truncated, of another
+ *                                    format or built from another source
+ */
+auto
+Hack::ROM_Image::map( std::filesystem::path const& path, std::uint64_t key, std::uint64_t check ) -> std::optional<ROM_Image>
+{
+   auto const fd = open( path.c_str(), O_RDONLY | O_CLOEXEC );
+
+   if ( fd < 0 )
+   {
+      return std::nullopt;
+   }
+
+   struct stat status {};
+
+   if ( fstat( fd, &status ) != 0 || status.st_size < static_cast<off_t>( sizeof( Header ) ) )
+   {
+      close( fd );
+      return std::nullopt;
+   }
+
+   auto const size    = static_cast<std::size_t>( status.st_size );
+   auto* const memory = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+   close( fd );
+
+   if ( memory == MAP_FAILED )
+   {
+      return std::nullopt;
+   }
+
+   auto image  = ROM_Image( memory, size );
+   auto header = Header{};
+
+   std::memcpy( &header, memory, sizeof( header ) );
+
+   if ( header.magic != magic || header.format != format_version || header.key != key || header.check != check )
+   {
+      return std::nullopt;
+   }
+
+   auto const expected = layout( header.rom_size, key, check );
+
+   if ( header.file_size           != size                         || header.file_size      != expected.file_size ||
+        header.decoded_offset      != expected.decoded_offset      ||
+        header.block_starts_offset != expected.block_starts_offset ||
+        header.jump_targets_offset != expected.jump_targets_offset )
+   {
+      return std::nullopt;
+   }
+
+   return image;
+}
+
+
+/**
+ * @brief   Write the image to a file
+ *
+ * @param path    where to write it
+ * @return bool   false if it could not be written
+ *
+ *    The image is written to a temporary file next to path and renamed over it, so that readers
+ *    either see the previous file or all of this one.
+ */
+auto
+Hack::ROM_Image::save( std::filesystem::path const& path ) const -> bool
+{
+   auto temporary = path;
+
+   temporary += ".tmp-" + std::to_string( getpid() ) + "-" + std::to_string( std::hash<std::thread::id>{}( std::this_thread::get_id() ) );
+
+   {
+      auto file = std::ofstream( temporary, std::ios::binary | std::ios::trunc );
+      auto const image = bytes();
+
+      if ( !file.write( reinterpret_cast<char const*>( image.data() ), static_cast<std::streamsize>( image.size() ) ) )
+      {
+         file.close();
+         auto ignored = std::error_code();
+         std::filesystem::remove( temporary, ignored );
+         return false;
+      }
+   }
+
+   auto error = std::error_code();
+
+   std::filesystem::rename( temporary, path, error );
+
+   if ( error )
+   {
+      std::filesystem::remove( temporary, error );
+      return false;
+   }
+
+   return true;
+}
+
+
+auto
+Hack::ROM_Image::rom() const noexcept -> std::span<word_t const>
+{
+   return { reinterpret_cast<word_t const*>( data() + align( sizeof( Header ) ) ), header().rom_size };
+}
+
+
+auto
+Hack::ROM_Image::decoded() const noexcept -> std::span<Decoded_Instruction const>
+{
+   return { reinterpret_cast<Decoded_Instruction const*>( data() + header().decoded_offset ), header().rom_size };
+}
+
+
+auto
+Hack::ROM_Image::is_block_start( std::size_t address ) const noexcept -> bool
+{
+   return address < header().rom_size && bit( header().block_starts_offset, address );
+}
+
+
+auto
+Hack::ROM_Image::is_jump_target( std::size_t address ) const noexcept -> bool
+{
+   return address < header().rom_size && bit( header().jump_targets_offset, address );
+}
+
+
+auto
+Hack::ROM_Image::header() const noexcept -> Header const&
+{
+   return *reinterpret_cast<Header const*>( data() );
+}
+
+
+auto
+Hack::ROM_Image::bytes() const noexcept -> std::span<std::byte const>
+{
+   return { data(), size_ };
+}
+
+
+auto
+Hack::ROM_Image::mapped() const noexcept -> bool
+{
+   return mapping_ != nullptr;
+}
+
+
+auto
+Hack::ROM_Image::data() const noexcept -> std::byte const*
+{
+   return mapping_ != nullptr ? static_cast<std::byte const*>( mapping_ ) : owned_.data();
+}
+
+
+auto
+Hack::ROM_Image::bit( std::uint64_t offset, std::size_t address ) const noexcept -> bool
+{
+   auto const* const words = reinterpret_cast<std::uint64_t const*>( data() + offset );
+
+   return ( words[address / 64u] >> ( address % 64u ) ) & 1u;
+}
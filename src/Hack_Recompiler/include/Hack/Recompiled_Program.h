@@ -0,0 +1,94 @@
+/**
+ * @file    Recompiled_Program.h
+ * @author  William Weston
+ * @brief   Loads and runs a program translated by the Recompiler
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    The shared object built from a translation unit the Recompiler generated is opened with
+ *    dlopen() and its entry points are looked up by prefix.  run() stands in for a loop over
+ *    Computer::execute() on a fixed ROM: it runs on a Memory and a copy of the registers, and
+ *    stops at the same instruction the Computer would stop at.
+ *
+ *    Only available on POSIX hosts.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_RECOMPILED_PROGRAM_H
+#define HACK_EMULATOR_2026_10_16_RECOMPILED_PROGRAM_H
+
+#include "Hack/Memory.h"      // for Memory
+
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint16_t, uint8_t, uint64_t
+#include <span>               // for span
+#include <string>             // for string
+
+namespace Hack
+{
+
+class Recompiled_Program final
+{
+public:
+   using word_t = std::uint16_t;
+
+   struct Registers
+   {
+      word_t   A          = 0;
+      word_t   D          = 0;
+      word_t   ALU_output = 0;
+      word_t   pc         = 0;
+   };
+
+   // why run() returned, the values are part of the generated code
+   enum class Stop_Reason : std::uint8_t
+   {
+      Budget,           // count instructions were executed
+      Halted,           // pc is in a halt loop
+      Memory_Fault,     // the instruction at pc accesses M outside of the address space
+      ROM_Fault         // pc is outside of ROM
+   };
+
+   struct Run_Result
+   {
+      Stop_Reason   reason;
+      std::uint64_t executed;
+   };
+
+   // open the shared object at path, std::runtime_error if it cannot be loaded or lacks the entry points
+   explicit Recompiled_Program( std::string const& path, std::string const& prefix = "hack_recompiled" );
+   ~Recompiled_Program() noexcept;
+
+   Recompiled_Program( Recompiled_Program const& )                    = delete;
+   Recompiled_Program( Recompiled_Program&& )                         = delete;
+   auto operator=( Recompiled_Program const& ) -> Recompiled_Program& = delete;
+   auto operator=( Recompiled_Program&& )      -> Recompiled_Program& = delete;
+
+   // the ROM the program was translated from
+   auto rom() const noexcept -> std::span<word_t const>;
+
+   // execute up to count instructions from registers.pc, stops early at a halt loop or before a fault
+   auto run( Memory& memory, Registers& registers, std::uint64_t count ) const -> Run_Result;
+
+private:
+   // layout of <prefix>_state in the generated code
+   struct State
+   {
+      word_t         A;
+      word_t         D;
+      word_t         ALU_output;
+      word_t         pc;
+      std::uint8_t   stop;
+   };
+
+   using Run_Function = auto (*)( State* state, word_t* ram, std::uint64_t count ) -> std::uint64_t;
+   using ROM_Function = auto (*)( std::size_t* size ) -> word_t const*;
+
+   void*                   handle_;
+   Run_Function            run_;
+   std::span<word_t const> rom_;
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_RECOMPILED_PROGRAM_H
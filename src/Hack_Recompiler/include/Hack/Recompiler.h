@@ -0,0 +1,72 @@
+/**
+ * @file    Recompiler.h
+ * @author  William Weston
+ * @brief   Ahead-of-time translation of Hack programs into C++
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    A ROM is translated into a self-contained C++ translation unit that only needs a C++ compiler
+ *    and <cstdint>, so it can be built into a shared object on hosts where executable memory cannot
+ *    be mapped at run time.  Each instruction becomes a case of a switch on pc, falling through to
+ *    the next one, with A, D and the ALU output kept in locals.  A jump whose target was set by
+ *    the A-instruction before it goes straight to the case of its target.
+ *
+ *    The unit exports two functions with C linkage, named after Options::prefix:
+ *
+ *       •  <prefix>_run( <prefix>_state* state, uint16_t* ram, uint64_t count ) -> uint64_t
+ *
+ *             executes up to count instructions from state->pc on ram, the buffer of a Memory,
+ *             and returns the number executed.  Like Computer::execute() it stops early at a halt
+ *             loop, and it stops before an instruction whose M access or fetch is out of range,
+ *             leaving state as it was after the preceding instruction.  state->stop tells why it
+ *             returned, see Recompiled_Program::Stop_Reason.
+ *
+ *       •  <prefix>_rom( size_t* size ) -> uint16_t const*
+ *
+ *             the ROM the unit was translated from, so that a host can check what it loads.
+ *
+ *    <prefix>_state is { uint16_t A, D, ALU_output, pc; uint8_t stop; }.  Addresses past the end
+ *    of the ROM hold @0 up to Computer::ROM_SIZE, as they do in a Computer.
+ */
+#ifndef HACK_EMULATOR_2026_10_16_RECOMPILER_H
+#define HACK_EMULATOR_2026_10_16_RECOMPILER_H
+
+#include "Hack/Computer.h"    // for Computer
+
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint16_t
+#include <span>               // for span
+#include <string>             // for string
+
+namespace Hack
+{
+
+class Recompiler final
+{
+public:
+   using word_t = std::uint16_t;
+
+   struct Options
+   {
+      std::string prefix = "hack_recompiled";     // of the exported names, a C identifier
+      std::string source = std::string();         // named in the header of the generated unit
+   };
+
+   // the largest ROM that can be translated
+   static constexpr auto max_rom_size = std::size_t{ Computer::ROM_SIZE };
+
+   Recompiler() = default;
+   explicit Recompiler( Options options );
+
+   // translate rom into a C++ translation unit
+   auto translate( std::span<word_t const> rom ) const -> std::string;
+
+private:
+   Options options_ = Options();
+};
+
+}  // namespace Hack
+
+#endif      // HACK_EMULATOR_2026_10_16_RECOMPILER_H
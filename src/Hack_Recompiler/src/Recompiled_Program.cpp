@@ -0,0 +1,113 @@
+/**
+ * @file    Recompiled_Program.cpp
+ * @author  William Weston
+ * @brief   Loads and runs a program translated by the Recompiler
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Recompiled_Program.h"
+
+#include <dlfcn.h>            // for dlopen, dlsym, dlclose, dlerror
+
+#include <stdexcept>          // for runtime_error
+
+
+namespace
+{
+   // the last dl error, dlerror() returns nullptr when there is none
+   auto dl_error() -> std::string
+   {
+      auto const* const error = dlerror();
+
+      return ( error != nullptr ) ? std::string( error ) : std::string( "unknown error" );
+   }
+
+   template <typename Function>
+   auto lookup( void* handle, std::string const& name ) -> Function
+   {
+      auto* const symbol = dlsym( handle, name.c_str() );
+
+      if ( symbol == nullptr )
+      {
+         throw std::runtime_error( "Recompiled program lacks " + name + ": " + dl_error() );
+      }
+
+      return reinterpret_cast<Function>( symbol );
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Recompiled_Program::Recompiled_Program( std::string const& path, std::string const& prefix )
+   : handle_( dlopen( path.c_str(), RTLD_NOW | RTLD_LOCAL ) ),
+     run_( nullptr ),
+     rom_()
+{
+   if ( handle_ == nullptr )
+   {
+      throw std::runtime_error( "Could not load recompiled program " + path + ": " + dl_error() );
+   }
+
+   try
+   {
+      run_ = lookup<Run_Function>( handle_, prefix + "_run" );
+
+      auto       size  = std::size_t{ 0 };
+      auto const words = lookup<ROM_Function>( handle_, prefix + "_rom" )( &size );
+
+      rom_ = std::span<word_t const>( words, size );
+   }
+   catch ( ... )
+   {
+      dlclose( handle_ );
+      throw;
+   }
+}
+
+
+Hack::Recompiled_Program::~Recompiled_Program() noexcept
+{
+   dlclose( handle_ );
+}
+
+
+auto
+Hack::Recompiled_Program::rom() const noexcept -> std::span<word_t const>
+{
+   return rom_;
+}
+
+
+/**
+ * @brief   Execute the next count instructions of the program
+ *
+ * @param memory        RAM the program runs on
+ * @param registers     the registers to start from, updated to where the program stopped
+ * @param count         the most instructions to execute
+ * @return Run_Result   why the program stopped and the number of instructions executed
+ *
+ *    Stops before an instruction that would fault, so registers.pc is the failing instruction
+ *    when the reason is Memory_Fault or ROM_Fault.
+ */
+auto
+Hack::Recompiled_Program::run( Memory& memory, Registers& registers, std::uint64_t count ) const -> Run_Result
+{
+   auto state = State{
+      .A          = registers.A,
+      .D          = registers.D,
+      .ALU_output = registers.ALU_output,
+      .pc         = registers.pc,
+      .stop       = 0
+   };
+
+   auto const executed = run_( &state, memory.data(), count );
+
+   registers = Registers{ .A = state.A, .D = state.D, .ALU_output = state.ALU_output, .pc = state.pc };
+
+   return { static_cast<Stop_Reason>( state.stop ), executed };
+}
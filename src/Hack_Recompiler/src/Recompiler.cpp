@@ -0,0 +1,342 @@
+/**
+ * @file    Recompiler.cpp
+ * @author  William Weston
+ * @brief   Ahead-of-time translation of Hack programs into C++
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Recompiler.h"
+
+#include "Hack/Decoder.h"     // for decode, Decoded_Instruction
+#include "Hack/Memory.h"      // for Memory
+
+#include <algorithm>          // for all_of
+#include <cctype>             // for isalnum, isalpha
+#include <cstddef>            // for size_t
+#include <iomanip>            // for setw, setfill
+#include <ios>                // for hex, dec
+#include <optional>           // for optional, nullopt
+#include <sstream>            // for ostringstream
+#include <stdexcept>          // for invalid_argument, runtime_error
+#include <string_view>        // for string_view
+#include <utility>            // for move
+#include <vector>             // for vector
+
+
+namespace
+{
+   using word_t = Hack::Recompiler::word_t;
+   using Op     = Hack::Decoded_Instruction;
+
+   // a C identifier, so that the exported names are too
+   auto is_identifier( std::string_view name ) -> bool
+   {
+      auto const alpha = []( char c ) { return std::isalpha( static_cast<unsigned char>( c ) ) || c == '_'; };
+      auto const alnum = []( char c ) { return std::isalnum( static_cast<unsigned char>( c ) ) || c == '_'; };
+
+      return !name.empty() && alpha( name.front() ) && std::all_of( name.begin(), name.end(), alnum );
+   }
+
+   // the ALU operation as a C++ expression of D and y, A or ram[A]
+   auto alu_expression( std::uint8_t comp, std::string_view y ) -> std::string
+   {
+      auto const Y = std::string( y );
+
+      switch ( comp )
+      {
+         case 0b101010:  return "0";
+         case 0b111111:  return "1";
+         case 0b111010:  return "0xFFFF";
+         case 0b001100:  return "D";
+         case 0b110000:  return Y;
+         case 0b001101:  return "~D";
+         case 0b110001:  return "~" + Y;
+         case 0b001111:  return "-D";
+         case 0b110011:  return "-" + Y;
+         case 0b011111:  return "D + 1";
+         case 0b110111:  return Y + " + 1";
+         case 0b001110:  return "D - 1";
+         case 0b110010:  return Y + " - 1";
+         case 0b000010:  return "D + " + Y;
+         case 0b010011:  return "D - " + Y;
+         case 0b000111:  return Y + " - D";
+         case 0b000000:  return "D & " + Y;
+         case 0b010101:  return "D | " + Y;
+         default:        break;
+      }
+
+      // an undocumented operation, spelled out as the ALU computes it
+      auto x = std::string( ( comp & Op::comp_zx ) ? "0" : "D" );
+      auto v = ( comp & Op::comp_zy ) ? std::string( "0" ) : Y;
+
+      if ( comp & Op::comp_nx ) { x = "~" + x; }
+      if ( comp & Op::comp_ny ) { v = "~" + v; }
+
+      auto out = "( " + x + ( ( comp & Op::comp_f ) ? " + " : " & " ) + v + " )";
+
+      return ( comp & Op::comp_no ) ? "~" + out : out;
+   }
+
+   // the condition under which the jump bits jump, for a jump that is not unconditional
+   auto jump_condition( std::uint8_t jump ) -> std::string_view
+   {
+      switch ( jump )
+      {
+         case Op::jump_gt:                 return "static_cast<std::int16_t>( out ) > 0";
+         case Op::jump_eq:                 return "out == 0";
+         case Op::jump_gt | Op::jump_eq:   return "static_cast<std::int16_t>( out ) >= 0";
+         case Op::jump_lt:                 return "static_cast<std::int16_t>( out ) < 0";
+         case Op::jump_lt | Op::jump_gt:   return "out != 0";
+         case Op::jump_lt | Op::jump_eq:   return "static_cast<std::int16_t>( out ) <= 0";
+         default:                          return "true";
+      }
+   }
+
+   // the address a jump at address goes to when it follows an A-instruction, nothing can change A in between
+   auto static_target( std::span<word_t const> rom, std::size_t address ) -> std::optional<word_t>
+   {
+      auto const instruction = Hack::decode( rom[address] );
+
+      if ( address == 0 || !instruction.is_jump() || ( instruction.dest & Op::dest_A ) )
+      {
+         return std::nullopt;
+      }
+
+      auto const previous = Hack::decode( rom[address - 1] );
+
+      if ( !previous.is_a_instruction() || previous.word >= rom.size() )
+      {
+         return std::nullopt;
+      }
+
+      return previous.word;
+   }
+
+   // is address the A-instruction of a halt loop, @address 0;JMP
+   auto is_halt_loop( std::span<word_t const> rom, std::size_t address ) -> bool
+   {
+      return rom[address] == address && address + 1 < rom.size() && Hack::decode( rom[address + 1] ).is_halt_jump();
+   }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+
+
+Hack::Recompiler::Recompiler( Options options )
+   : options_( std::move( options ) )
+{
+   if ( !is_identifier( options_.prefix ) )
+   {
+      throw std::invalid_argument( "Recompiler prefix is not an identifier: " + options_.prefix );
+   }
+}
+
+
+/**
+ * @brief   Translate a ROM into a C++ translation unit
+ *
+ * @param rom           the program, instruction 0 first
+ * @return std::string  the source of the translation unit
+ * @throws std::runtime_error   if rom is larger than max_rom_size
+ */
+auto
+Hack::Recompiler::translate( std::span<word_t const> rom ) const -> std::string
+{
+   if ( rom.size() > max_rom_size )
+   {
+      throw std::runtime_error( "ROM overflow: " + std::to_string( rom.size() ) );
+   }
+
+   auto const& prefix = options_.prefix;
+
+   // labels that jumps go to directly
+   auto targets = std::vector<bool>( rom.size() );
+
+   for ( auto address = 0uz; address < rom.size(); ++address )
+   {
+      if ( auto const target = static_target( rom, address ) )
+      {
+         targets[*target] = true;
+      }
+   }
+
+   auto code = std::ostringstream();
+
+   code << "// Generated by Hack_Recompiler" << ( options_.source.empty() ? "" : " from " + options_.source )
+        << ", do not edit\n"
+        << "//\n"
+        << "// " << prefix << "_run() executes up to count instructions, see Hack/Recompiler.h\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "\n"
+        << "struct " << prefix << "_state\n"
+        << "{\n"
+        << "   std::uint16_t  A;\n"
+        << "   std::uint16_t  D;\n"
+        << "   std::uint16_t  ALU_output;\n"
+        << "   std::uint16_t  pc;\n"
+        << "   std::uint8_t   stop;\n"
+        << "};\n"
+        << "\n"
+        << "namespace\n"
+        << "{\n"
+        << "   using word_t = std::uint16_t;\n"
+        << "\n"
+        << "   enum Stop : std::uint8_t { budget, halted, memory_fault, rom_fault };\n"
+        << "\n"
+        << "   constexpr auto address_space = word_t{ " << Memory::address_space << " };\n"
+        << "   constexpr auto rom_limit     = std::uint32_t{ " << max_rom_size << " };\n"
+        << "   constexpr auto rom_size      = std::size_t{ " << rom.size() << " };\n"
+        << "\n"
+        << "   constexpr word_t rom[rom_size + 1] =\n"
+        << "   {";
+
+   for ( auto address = 0uz; address < rom.size(); ++address )
+   {
+      code << ( address % 8 == 0 ? "\n      " : " " )
+           << "0x" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << rom[address] << std::dec << ',';
+   }
+
+   code << ( rom.empty() ? "" : "\n      " ) << "0x0000\n"
+        << "   };\n"
+        << "}\n"
+        << "\n"
+        << "extern \"C\" auto " << prefix << "_rom( std::size_t* size ) -> std::uint16_t const*\n"
+        << "{\n"
+        << "   *size = rom_size;\n"
+        << "   return rom;\n"
+        << "}\n"
+        << "\n"
+        << "extern \"C\" auto " << prefix << "_run( " << prefix << "_state* state, [[maybe_unused]] std::uint16_t* ram, std::uint64_t count ) -> std::uint64_t\n"
+        << "{\n"
+        << "   word_t A    = state->A;\n"
+        << "   word_t D    = state->D;\n"
+        << "   word_t out  = state->ALU_output;\n"
+        << "   word_t pc   = state->pc;\n"
+        << "   auto   left = count;\n"
+        << "   auto   stop = budget;\n"
+        << "\n"
+        << "   for ( ;; )\n"
+        << "   {\n"
+        << "      switch ( pc )\n"
+        << "      {\n";
+
+   auto falls_through = false;      // into the next case
+
+   for ( auto address = 0uz; address < rom.size(); ++address )
+   {
+      auto const instruction = decode( rom[address] );
+      auto const here        = std::to_string( address );
+
+      if ( falls_through )
+      {
+         code << "            [[fallthrough]];\n";
+      }
+
+      code << "         case " << here << ":\n";
+
+      if ( targets[address] )
+      {
+         code << "         L" << here << ":\n";
+      }
+
+      falls_through = true;
+
+      if ( instruction.is_a_instruction() )
+      {
+         if ( is_halt_loop( rom, address ) )
+         {
+            code << "            pc = " << here << "; stop = halted; goto leave;\n";
+            falls_through = false;
+            continue;
+         }
+
+         code << "            if ( left == 0 ) { pc = " << here << "; goto leave; }\n"
+              << "            --left;\n"
+              << "            A = " << instruction.word << ";\n";
+         continue;
+      }
+
+      if ( instruction.is_halt_jump() )
+      {
+         code << "            if ( A == " << here << " ) { pc = " << here << "; stop = halted; goto leave; }\n";
+      }
+
+      code << "            if ( left == 0 ) { pc = " << here << "; goto leave; }\n";
+
+      if ( instruction.reads_M() || instruction.writes_M() )
+      {
+         code << "            if ( A >= address_space ) { pc = " << here << "; stop = memory_fault; goto leave; }\n";
+      }
+
+      auto const y = instruction.reads_M() ? "ram[A]" : "A";
+
+      code << "            --left;\n"
+           << "            out = static_cast<word_t>( " << alu_expression( instruction.comp, y ) << " );\n";
+
+      if ( instruction.dest & Op::dest_M ) { code << "            ram[A] = out;\n"; }
+      if ( instruction.dest & Op::dest_A ) { code << "            A = out;\n"; }
+      if ( instruction.dest & Op::dest_D ) { code << "            D = out;\n"; }
+
+      if ( !instruction.is_jump() )
+      {
+         continue;
+      }
+
+      auto const target        = static_target( rom, address );
+      auto const direct        = target ? "if ( A == " + std::to_string( *target ) + " ) { goto L" + std::to_string( *target ) + "; } "
+                                        : std::string();
+      auto const unconditional = instruction.jump == ( Op::jump_lt | Op::jump_eq | Op::jump_gt );
+
+      if ( unconditional )
+      {
+         code << "            " << direct << "pc = A; continue;\n";
+         falls_through = false;
+      }
+      else
+      {
+         code << "            if ( " << jump_condition( instruction.jump ) << " ) { " << direct << "pc = A; continue; }\n";
+      }
+   }
+
+   // the rest of ROM holds @0, which only sets A
+   if ( falls_through )
+   {
+      code << "            pc = static_cast<word_t>( rom_size );\n"
+           << "            [[fallthrough]];\n";
+   }
+
+   code << "         default:\n"
+        << "            break;\n"
+        << "      }\n"
+        << "\n"
+        << "      if ( pc < rom_limit && left != 0 )\n"
+        << "      {\n"
+        << "         auto const zeros = ( left < rom_limit - pc ) ? left : std::uint64_t{ rom_limit - pc };\n"
+        << "\n"
+        << "         A     = 0;\n"
+        << "         pc    = static_cast<word_t>( pc + zeros );\n"
+        << "         left -= zeros;\n"
+        << "      }\n"
+        << "\n"
+        << "      if ( pc >= rom_limit ) { stop = rom_fault; }\n"
+        << "\n"
+        << "      break;\n"
+        << "   }\n"
+        << "\n"
+        << ( rom.empty() ? "" : "leave:\n" )
+        << "   state->A          = A;\n"
+        << "   state->D          = D;\n"
+        << "   state->ALU_output = out;\n"
+        << "   state->pc         = pc;\n"
+        << "   state->stop       = stop;\n"
+        << "\n"
+        << "   return count - left;\n"
+        << "}\n";
+
+   return code.str();
+}
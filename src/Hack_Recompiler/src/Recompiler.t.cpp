@@ -0,0 +1,156 @@
+/**
+ * @file    Recompiler.t.cpp
+ * @author  William Weston
+ * @brief   Test file for Recompiler.h and Recompiled_Program.h
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "Hack/Recompiler.h"
+#include "Hack/Recompiled_Program.h"
+
+#include "Hack/Computer.h"
+#include "Hack/Memory.h"
+
+#include <catch2/catch_all.hpp>
+#include <algorithm>          // equal
+#include <cstdint>
+#include <stdexcept>          // invalid_argument, out_of_range, runtime_error
+#include <string>
+#include <vector>
+
+
+TEST_CASE( "Recompiler: translation" )
+{
+   using namespace Hack;
+
+   // @2  D=A  @4  D;JGT  @4  0;JMP
+   auto const rom = std::vector<std::uint16_t>{ 0x0002, 0xEC10, 0x0004, 0xE301, 0x0004, 0xEA87 };
+
+   SECTION( "entry points are named after the prefix" )
+   {
+      auto const code = Recompiler( { .prefix = "demo", .source = "Demo.hack" } ).translate( rom );
+
+      REQUIRE( code.find( "from Demo.hack" )                    != std::string::npos );
+      REQUIRE( code.find( "struct demo_state" )                 != std::string::npos );
+      REQUIRE( code.find( "extern \"C\" auto demo_run(" )       != std::string::npos );
+      REQUIRE( code.find( "extern \"C\" auto demo_rom(" )       != std::string::npos );
+      REQUIRE( code.find( "hack_recompiled" )                   == std::string::npos );
+   }
+
+   SECTION( "jumps set by the A-instruction before them go straight to their target" )
+   {
+      auto const code = Recompiler().translate( rom );
+
+      REQUIRE( code.find( "L4:" )                               != std::string::npos );
+      REQUIRE( code.find( "if ( A == 4 ) { goto L4; }" )        != std::string::npos );
+      REQUIRE( code.find( "pc = 4; stop = halted; goto leave;" ) != std::string::npos );
+   }
+
+   SECTION( "prefixes that are not identifiers and oversized ROMs are refused" )
+   {
+      REQUIRE_THROWS_AS( Recompiler( { .prefix = "", .source = "" } ),           std::invalid_argument );
+      REQUIRE_THROWS_AS( Recompiler( { .prefix = "1st", .source = "" } ),        std::invalid_argument );
+      REQUIRE_THROWS_AS( Recompiler( { .prefix = "a-b", .source = "" } ),        std::invalid_argument );
+      REQUIRE_THROWS_AS( Recompiler().translate( std::vector<std::uint16_t>( Recompiler::max_rom_size + 1 ) ),
+                         std::runtime_error );
+   }
+}
+
+
+#ifdef HACK_RECOMPILER_TEST_PROGRAM
+
+TEST_CASE( "Recompiler: a recompiled program stops where the computer does" )
+{
+   using namespace Hack;
+   using Stop_Reason = Recompiled_Program::Stop_Reason;
+
+   auto const program = Recompiled_Program( HACK_RECOMPILER_TEST_PROGRAM );
+
+   auto computer  = Computer();
+   auto memory    = Memory();
+   auto registers = Recompiled_Program::Registers();
+
+   REQUIRE( !program.rom().empty() );
+
+   computer.load_rom( program.rom() );
+
+   auto const start = [&]( std::int16_t mode )
+   {
+      for ( auto* ram : { &computer.RAM(), &memory } )
+      {
+         ( *ram )[0] = 7;
+         ( *ram )[1] = 13;
+         ( *ram )[7] = static_cast<std::uint16_t>( mode );
+      }
+   };
+
+   auto const require_same_state = [&]
+   {
+      REQUIRE( registers.pc         == computer.pc() );
+      REQUIRE( registers.A          == computer.A_Register() );
+      REQUIRE( registers.D          == computer.D_Register() );
+      REQUIRE( registers.ALU_output == computer.ALU_output() );
+      REQUIRE( std::equal( memory.ram_begin(), memory.ram_end(), computer.RAM().ram_begin() ) );
+   };
+
+   SECTION( "the program runs to its halt loop in any number of steps" )
+   {
+      start( 0 );
+
+      auto result = Recompiled_Program::Run_Result{ Stop_Reason::Budget, 0 };
+
+      for ( auto const budget : { 1u, 1u, 2u, 3u, 5u, 8u, 13u, 21u, 34u, 55u, 89u, 144u, 233u, 377u, 100'000u } )
+      {
+         auto const before = computer.instruction_count();
+
+         computer.execute( budget );
+         result = program.run( memory, registers, budget );
+
+         REQUIRE( result.executed == computer.instruction_count() - before );
+         require_same_state();
+      }
+
+      REQUIRE( result.reason == Stop_Reason::Halted );
+      REQUIRE( computer.status() == Computer::Status::Halted );
+      REQUIRE( memory[2] == 7 * 13 );
+      REQUIRE( memory[6] == static_cast<std::uint16_t>( ~( 7 * 13 ) ) );
+      REQUIRE( std::all_of( memory.ram_begin() + 100, memory.ram_begin() + 100 + ( 7 * 13 ) % 16,
+                            []( auto word ) { return word == 0xFFFF; } ) );
+      REQUIRE( memory[100 + ( 7 * 13 ) % 16] == 0 );
+
+      // halted programs do nothing
+      REQUIRE( program.run( memory, registers, 100 ).executed == 0 );
+   }
+
+   SECTION( "an M access outside of the address space stops before the instruction" )
+   {
+      start( 1 );
+
+      REQUIRE_THROWS_AS( computer.execute( 1'000 ), std::out_of_range );
+
+      auto const result = program.run( memory, registers, 1'000 );
+
+      REQUIRE( result.reason   == Stop_Reason::Memory_Fault );
+      REQUIRE( result.executed == computer.instruction_count() );
+      require_same_state();
+   }
+
+   SECTION( "the rest of ROM holds @0 up to its end" )
+   {
+      start( -1 );
+
+      REQUIRE_THROWS_AS( computer.execute( 100'000 ), std::out_of_range );
+
+      auto const result = program.run( memory, registers, 100'000 );
+
+      REQUIRE( result.reason   == Stop_Reason::ROM_Fault );
+      REQUIRE( result.executed == computer.instruction_count() );
+      REQUIRE( registers.pc    == Recompiler::max_rom_size );
+      require_same_state();
+   }
+}
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file    main.cpp
+ * @author  William Weston
+ * @brief   Command line front end of the Recompiler
+ * @version 0.1
+ * @date    2026-10-16
+ *
+ * @copyright Copyright (c) 2026
+ *
+ *    Usage:  Hack_Recompiler_CLI <program.hack | program.asm> [-o <output.cpp>] [--prefix <name>]
+ *
+ *    Writes the translation unit to standard output unless -o is given.  Build it into a shared
+ *    object, e.g. c++ -std=c++20 -O2 -shared -fPIC program.cpp -o program.so, and load it with
+ *    Hack::Recompiled_Program.
+ */
+#include "Hack/Assembler.h"                 // for Assembler
+#include "Hack/Recompiler.h"                // for Recompiler
+#include "Hack/Utilities/exceptions.hpp"    // for parse_error, ParseErrorData
+#include "Hack/Utilities/utilities.hpp"     // for binary_to_uint16
+
+#include <cstdint>                          // for uint16_t
+#include <cstdlib>                          // for EXIT_SUCCESS, EXIT_FAILURE
+#include <exception>                        // for exception
+#include <filesystem>                       // for path
+#include <fstream>                          // for ifstream, ofstream
+#include <iostream>                         // for cout, cerr
+#include <span>                             // for span
+#include <stdexcept>                        // for runtime_error
+#include <string>                           // for string, getline
+#include <string_view>                      // for string_view
+#include <vector>                           // for vector
+
+
+namespace
+{
+   constexpr auto usage = "usage: Hack_Recompiler_CLI <program.hack | program.asm> [-o <output.cpp>] [--prefix <name>]\n";
+
+   auto open( std::string const& path ) -> std::ifstream
+   {
+      auto input = std::ifstream( path );
+
+      if ( !( input && input.is_open() ) )
+      {
+         throw std::runtime_error( "Could not open file " + path );
+      }
+
+      return input;
+   }
+
+   // a Hack binary text file, one instruction per line
+   auto read_hack_file( std::string const& path ) -> std::vector<std::uint16_t>
+   {
+      auto input   = open( path );
+      auto line    = std::string();
+      auto data    = std::vector<std::uint16_t>();
+      auto line_no = 1zu;
+
+      while ( std::getline( input, line ) )
+      {
+         auto const binary_optional = Hack::Utils::binary_to_uint16( line );
+
+         if ( !binary_optional )
+         {
+            throw Hack::Utils::parse_error( "Error parsing Hack binary file", Hack::Utils::ParseErrorData{ line, line_no } );
+         }
+
+         data.push_back( *binary_optional );
+         ++line_no;
+      }
+
+      return data;
+   }
+
+   auto read_asm_file( std::string const& path ) -> std::vector<std::uint16_t>
+   {
+      auto input   = open( path );
+      auto asmblr  = Hack::Assembler();
+      auto data    = std::vector<std::uint16_t>();
+
+      for ( auto const& line : asmblr.assemble( input ) )
+      {
+         auto const binary_optional = Hack::Utils::binary_to_uint16( line );
+
+         // the assembler always produces binary strings
+         if ( !binary_optional )
+         {
+            throw std::runtime_error( "Could not assemble file " + path );
+         }
+
+         data.push_back( *binary_optional );
+      }
+
+      return data;
+   }
+}
+
+
+auto main( int argc, char* argv[] ) -> int
+{
+   auto const args = std::span( argv, static_cast<std::size_t>( argc ) );
+
+   auto input   = std::string();
+   auto output  = std::string();
+   auto options = Hack::Recompiler::Options();
+
+   for ( auto arg = 1zu; arg < args.size(); ++arg )
+   {
+      auto const current   = std::string_view( args[arg] );
+      auto const has_value = arg + 1 < args.size();
+
+      if ( current == "-o" && has_value )
+      {
+         output = args[++arg];
+      }
+      else if ( current == "--prefix" && has_value )
+      {
+         options.prefix = args[++arg];
+      }
+      else if ( input.empty() && !current.starts_with( '-' ) )
+      {
+         input = current;
+      }
+      else
+      {
+         std::cerr << usage;
+         return EXIT_FAILURE;
+      }
+   }
+
+   if ( input.empty() )
+   {
+      std::cerr << usage;
+      return EXIT_FAILURE;
+   }
+
+   try
+   {
+      auto const path = std::filesystem::path( input );
+      auto const rom  = ( path.extension() == ".asm" ) ? read_asm_file( input ) : read_hack_file( input );
+
+      options.source = path.filename().string();
+
+      auto const code = Hack::Recompiler( options ).translate( rom );
+
+      if ( output.empty() )
+      {
+         std::cout << code;
+         return EXIT_SUCCESS;
+      }
+
+      auto file = std::ofstream( output );
+
+      if ( !( file << code ) )
+      {
+         throw std::runtime_error( "Could not write file " + output );
+      }
+   }
+   catch ( Hack::Utils::parse_error const& error )
+   {
+      std::cerr << input << ':' << error.data().line_no << ": " << error.what() << ": " << error.data().text << '\n';
+      return EXIT_FAILURE;
+   }
+   catch ( std::exception const& error )
+   {
+      std::cerr << error.what() << '\n';
+      return EXIT_FAILURE;
+   }
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+// R2 = R0 * R1, then RAM[100..] = -1 for R2 % 16 words, returning through an address kept in R3.
+// R7 > 0 accesses M outside of the address space, R7 < 0 jumps past the end of the program.
+
+   @R7
+   D=M
+   @MEMORY_FAULT
+   D;JGT
+   @ROM_FAULT
+   D;JLT
+
+   @R2
+   M=0
+(LOOP)
+   @R0
+   D=M
+   @FILL_SETUP
+   D;JEQ
+   @R1
+   D=M
+   @R2
+   M=D+M
+   @R0
+   M=M-1
+   @LOOP
+   0;JMP
+
+(FILL_SETUP)
+   @RETURN
+   D=A
+   @R3
+   M=D
+   @100
+   D=A
+   @R4
+   M=D
+   @R2
+   D=M
+   @15
+   D=D&A
+   @R5
+   M=D
+(FILL)
+   @R5
+   D=M
+   @DONE
+   D;JLE
+   @R4
+   A=M
+   M=-1
+   @R4
+   M=M+1
+   @R5
+   M=M-1
+   @FILL
+   0;JMP
+(DONE)
+   @R3
+   A=M
+   0;JMP
+
+(RETURN)
+   @R2
+   D=M
+   @R6
+   M=!D
+(END)
+   @END
+   0;JMP
+
+(MEMORY_FAULT)
+   @30000
+   M=1
+(ROM_FAULT)
+   @20000
+   0;JMP
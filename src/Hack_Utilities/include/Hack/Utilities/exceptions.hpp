@@ -76,6 +76,14 @@ struct ParseErrorData
 
 using parse_error = Exception<ParseErrorData>;
 
+
+struct FileErrorData
+{
+   std::string filename;
+};
+
+using file_error = Exception<FileErrorData>;
+
 } // namespace Hack::Utils
 
 inline std::ostream& operator<<( std::ostream& os, std::source_location const& location )